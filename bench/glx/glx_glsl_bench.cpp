@@ -0,0 +1,174 @@
+#include <atlas/glx/glsl.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace atlas;
+
+namespace
+{
+    namespace fs = std::filesystem;
+
+    // Writes a shader file with a comment, a few uniforms and a function so
+    // that every file has a realistic number of lines to scan.
+    void write_shader(fs::path const& path,
+                      std::string const& name,
+                      std::vector<std::string> const& includes,
+                      bool is_root)
+    {
+        std::ofstream stream{path};
+        stream << "// " << name << ": generated for the shader benchmarks.\n";
+        if (is_root)
+        {
+            stream << "#version 450 core\n\n";
+        }
+
+        for (auto const& include : includes)
+        {
+            stream << fmt::format("#include \"{}\"\n", include);
+        }
+
+        stream << fmt::format("\nuniform vec4 {0}_colour;\n"
+                              "uniform mat4 {0}_transform;\n\n"
+                              "/* Scales and offsets the input. */\n"
+                              "vec4 {0}_apply(vec4 p)\n"
+                              "{{\n",
+                              name);
+        for (int i{0}; i < 16; ++i)
+        {
+            stream << fmt::format("    p = {0}_transform * p + {0}_colour * {1}.0;\n",
+                                  name,
+                                  i);
+        }
+        stream << "    return p;\n}\n";
+    }
+
+    // Shapes of the generated include trees.
+    enum class Tree
+    {
+        // The root includes every other file.
+        wide,
+
+        // Each file includes the next one.
+        deep,
+
+        // Every file on a level includes every file on the next, so most
+        // includes are duplicates.
+        diamond
+    };
+
+    std::string write_tree(fs::path const& directory, Tree tree, int size)
+    {
+        fs::remove_all(directory);
+        fs::create_directories(directory);
+
+        auto file_name = [](int level, int index) {
+            return fmt::format("level{}_{}.glsl", level, index);
+        };
+
+        std::vector<std::string> root_includes;
+        switch (tree)
+        {
+        case Tree::wide:
+            for (int i{0}; i < size; ++i)
+            {
+                auto name = file_name(0, i);
+                write_shader(directory / name, fmt::format("wide{}", i), {}, false);
+                root_includes.push_back(name);
+            }
+            break;
+
+        case Tree::deep:
+            for (int i{0}; i < size; ++i)
+            {
+                std::vector<std::string> includes;
+                if (i + 1 < size)
+                {
+                    includes.push_back(file_name(i + 1, 0));
+                }
+                write_shader(directory / file_name(i, 0),
+                             fmt::format("deep{}", i),
+                             includes,
+                             false);
+            }
+            root_includes.push_back(file_name(0, 0));
+            break;
+
+        case Tree::diamond:
+            for (int level{0}; level < size; ++level)
+            {
+                std::vector<std::string> includes;
+                if (level + 1 < size)
+                {
+                    for (int i{0}; i < size; ++i)
+                    {
+                        includes.push_back(file_name(level + 1, i));
+                    }
+                }
+
+                for (int i{0}; i < size; ++i)
+                {
+                    write_shader(directory / file_name(level, i),
+                                 fmt::format("diamond{}_{}", level, i),
+                                 includes,
+                                 false);
+                }
+            }
+
+            for (int i{0}; i < size; ++i)
+            {
+                root_includes.push_back(file_name(0, i));
+            }
+            break;
+        }
+
+        auto root = directory / "root.glsl";
+        write_shader(root, "root", root_includes, true);
+        return root.string();
+    }
+} // namespace
+
+TEST_CASE("[glsl] - read_shader_source", "[glx]")
+{
+    auto directory = fs::temp_directory_path() / "atlas_glsl_bench";
+
+    auto wide = write_tree(directory / "wide", Tree::wide, 64);
+    BENCHMARK("read_shader_source: 64 files wide")
+    {
+        return glx::read_shader_source(wide);
+    };
+
+    auto deep = write_tree(directory / "deep", Tree::deep, 64);
+    BENCHMARK("read_shader_source: 64 files deep")
+    {
+        return glx::read_shader_source(deep);
+    };
+
+    auto diamond = write_tree(directory / "diamond", Tree::diamond, 8);
+    BENCHMARK("read_shader_source: 8x8 diamond")
+    {
+        return glx::read_shader_source(diamond);
+    };
+
+    // The includes are only found in the last of the search directories.
+    std::vector<std::string> include_dirs;
+    for (int i{0}; i < 3; ++i)
+    {
+        auto empty = directory / fmt::format("empty{}", i);
+        fs::create_directories(empty);
+        include_dirs.push_back(empty.string() + "/");
+    }
+    include_dirs.push_back((directory / "wide").string() + "/");
+    BENCHMARK("read_shader_source: 64 files wide, 4 include directories")
+    {
+        return glx::read_shader_source(wide, include_dirs);
+    };
+
+    fs::remove_all(directory);
+}
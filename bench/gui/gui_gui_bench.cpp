@@ -0,0 +1,113 @@
+#include <atlas/glx/context.hpp>
+#include <atlas/gui/gui.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+#include <array>
+#include <cmath>
+
+namespace gui = atlas::gui;
+namespace glx = atlas::glx;
+
+namespace
+{
+    void error_callback(int code, char const* message)
+    {
+        fmt::print("error ({}):{}\n", code, message);
+    }
+
+    // Builds a frame with the demo window and a window with enough text and
+    // plots to produce a few thousand vertices.
+    void build_frame(gui::UIWindowData& window_data)
+    {
+        gui::start_ui_window_frame(window_data);
+        ImGui::NewFrame();
+
+        ImGui::ShowDemoWindow();
+
+        std::array<float, 128> values;
+        for (std::size_t i{0}; i < values.size(); ++i)
+        {
+            values[i] = std::sin(static_cast<float>(i) * 0.1f);
+        }
+
+        ImGui::SetNextWindowPos(ImVec2{700.0f, 20.0f});
+        ImGui::SetNextWindowSize(ImVec2{500.0f, 680.0f});
+        ImGui::Begin("Benchmark");
+        for (int i{0}; i < 8; ++i)
+        {
+            ImGui::PlotLines("##lines", values.data(), static_cast<int>(values.size()));
+        }
+        for (int i{0}; i < 64; ++i)
+        {
+            ImGui::Text("Line %d: the quick brown fox jumps over the lazy dog", i);
+        }
+        ImGui::End();
+
+        ImGui::Render();
+    }
+} // namespace
+
+TEST_CASE("[gui] - draw path", "[gui]")
+{
+    if (!glx::initialize_glfw(error_callback))
+    {
+        WARN("GLFW could not be initialised, skipping GUI benchmarks");
+        return;
+    }
+
+    glx::WindowSettings settings;
+    settings.size = {1280, 720};
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto window = glx::create_glfw_window(settings);
+    glfwDefaultWindowHints();
+    if (window == nullptr)
+    {
+        WARN("no window could be created, skipping GUI benchmarks");
+        glx::terminate_glfw();
+        return;
+    }
+
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+    REQUIRE(glx::create_gl_context(window, settings.version));
+
+    gui::UIRenderData render_data;
+    gui::UIWindowData window_data;
+
+    ImGui::CreateContext();
+    ImGui::StyleColorsDark();
+    gui::initialize_ui_window_data(window_data);
+    gui::initialize_ui_render_data(render_data);
+    gui::set_ui_window(window_data, window);
+
+    BENCHMARK("build frame")
+    {
+        build_frame(window_data);
+        return ImGui::GetDrawData()->TotalVtxCount;
+    };
+
+    build_frame(window_data);
+    BENCHMARK("render_ui_frame")
+    {
+        gui::render_ui_frame(render_data);
+        glFinish();
+    };
+
+    BENCHMARK("full frame")
+    {
+        glClear(GL_COLOR_BUFFER_BIT);
+        build_frame(window_data);
+        gui::render_ui_frame(render_data);
+        glFinish();
+    };
+
+    gui::destroy_ui_render_data(render_data);
+    gui::destroy_ui_window(window_data);
+    ImGui::DestroyContext();
+
+    glx::destroy_glfw_window(window);
+    glx::terminate_glfw();
+}
@@ -0,0 +1,45 @@
+#include <atlas/jobs/job_system.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace atlas;
+
+TEST_CASE("[JobSystem] - parallel_for", "[jobs]")
+{
+    constexpr std::size_t count{1 << 22};
+    std::vector<float> data(count, 1.0f);
+
+    BENCHMARK("serial sqrt")
+    {
+        for (auto& x : data)
+        {
+            x = std::sqrt(x + 1.0f);
+        }
+        return data[0];
+    };
+
+    for (std::size_t threads : {1, 2, 4, 8})
+    {
+        jobs::JobSystem system{threads};
+        BENCHMARK("parallel_for sqrt " + std::to_string(threads) + " threads")
+        {
+            system.parallel_for(count, 0, [&](std::size_t begin, std::size_t end) {
+                for (auto i = begin; i < end; ++i)
+                {
+                    data[i] = std::sqrt(data[i] + 1.0f);
+                }
+            });
+            return data[0];
+        };
+
+        BENCHMARK("10000 empty jobs " + std::to_string(threads) + " threads")
+        {
+            system.parallel_for(10000, 1, [](std::size_t, std::size_t) {});
+        };
+    }
+}
@@ -0,0 +1,158 @@
+#include <atlas/math/coordinates.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace atlas::math;
+
+namespace
+{
+    std::vector<glm::vec3> make_points(std::size_t count)
+    {
+        // Points spread over every octant and several orders of magnitude.
+        std::vector<glm::vec3> points;
+        for (std::size_t i{0}; i < count; ++i)
+        {
+            float t = static_cast<float>(i) / static_cast<float>(count);
+            float r = glm::pow(10.0f, static_cast<float>(i % 7) - 3.0f);
+            points.emplace_back(r * glm::cos(37.0f * t) * glm::sin(11.0f * t + 0.1f),
+                                r * glm::sin(37.0f * t) * glm::sin(11.0f * t + 0.1f),
+                                r * glm::cos(11.0f * t + 0.1f));
+        }
+        return points;
+    }
+
+    std::vector<glm::vec2> make_points_2d(std::size_t count)
+    {
+        std::vector<glm::vec2> points;
+        for (auto const& p : make_points(count))
+        {
+            points.emplace_back(p.x, p.y);
+        }
+        return points;
+    }
+
+    template<typename Vec, typename Scalar, typename Batch>
+    void run_benchmarks(char const* name,
+                        std::vector<Vec> const& points,
+                        Scalar&& scalar,
+                        Batch&& batch)
+    {
+        std::vector<Vec> out(points.size());
+        std::string prefix{name};
+
+        // Exact runs the same pack loop as fast but keeps the std functions
+        // for the trigonometry, so the difference between the two is the
+        // cost of those functions alone.
+
+        BENCHMARK(prefix + ": scalar x65536")
+        {
+            for (std::size_t i{0}; i < points.size(); ++i)
+            {
+                out[i] = scalar(points[i]);
+            }
+            return out[0];
+        };
+
+        BENCHMARK(prefix + "_batch: exact x65536")
+        {
+            batch(points, out, Accuracy::exact);
+            return out[0];
+        };
+
+        BENCHMARK(prefix + "_batch: fast x65536")
+        {
+            batch(points, out, Accuracy::fast);
+            return out[0];
+        };
+    }
+} // namespace
+
+TEST_CASE("[coordinates] - conversions", "[math]")
+{
+    auto points    = make_points(1 << 16);
+    auto points_2d = make_points_2d(1 << 16);
+
+    // The spherical and cylindrical inputs are the Cartesian points read as
+    // coordinates, which covers every quadrant of the angles.
+    run_benchmarks(
+        "cartesian_to_spherical",
+        points,
+        [](glm::vec3 const& p) { return cartesian_to_spherical(p); },
+        [](auto const& in, auto& out, Accuracy a) {
+            cartesian_to_spherical_batch(in, out, a);
+        });
+
+    run_benchmarks(
+        "spherical_to_cartesian",
+        points,
+        [](glm::vec3 const& p) { return spherical_to_cartesian(p); },
+        [](auto const& in, auto& out, Accuracy a) {
+            spherical_to_cartesian_batch(in, out, a);
+        });
+
+    run_benchmarks(
+        "cartesian_to_cylindrical",
+        points,
+        [](glm::vec3 const& p) { return cartesian_to_cylindrical(p); },
+        [](auto const& in, auto& out, Accuracy a) {
+            cartesian_to_cylindrical_batch(in, out, a);
+        });
+
+    run_benchmarks(
+        "cylindrical_to_cartesian",
+        points,
+        [](glm::vec3 const& p) { return cylindrical_to_cartesian(p); },
+        [](auto const& in, auto& out, Accuracy a) {
+            cylindrical_to_cartesian_batch(in, out, a);
+        });
+
+    run_benchmarks(
+        "cartesian_to_polar",
+        points_2d,
+        [](glm::vec2 const& p) { return cartesian_to_polar(p); },
+        [](auto const& in, auto& out, Accuracy a) {
+            cartesian_to_polar_batch(in, out, a);
+        });
+
+    run_benchmarks(
+        "polar_to_cartesian",
+        points_2d,
+        [](glm::vec2 const& p) { return polar_to_cartesian(p); },
+        [](auto const& in, auto& out, Accuracy a) {
+            polar_to_cartesian_batch(in, out, a);
+        });
+}
+
+TEST_CASE("[coordinates] - batch widths", "[math]")
+{
+    auto points = make_points(1 << 16);
+    std::vector<glm::vec3> out(points.size());
+
+    BENCHMARK("cartesian_to_spherical_batch: fast x4 x65536")
+    {
+        cartesian_to_spherical_batch<4>(points, out, Accuracy::fast);
+        return out[0];
+    };
+
+    BENCHMARK("cartesian_to_spherical_batch: fast native x65536")
+    {
+        cartesian_to_spherical_batch(points, out, Accuracy::fast);
+        return out[0];
+    };
+
+    BENCHMARK("spherical_to_cartesian_batch: fast x4 x65536")
+    {
+        spherical_to_cartesian_batch<4>(points, out, Accuracy::fast);
+        return out[0];
+    };
+
+    BENCHMARK("spherical_to_cartesian_batch: fast native x65536")
+    {
+        spherical_to_cartesian_batch(points, out, Accuracy::fast);
+        return out[0];
+    };
+}
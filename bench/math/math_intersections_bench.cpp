@@ -0,0 +1,48 @@
+#include "test_helpers.hpp"
+
+#include <atlas/math/intersections.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+using namespace atlas::math;
+
+TEST_CASE("[intersections] - triangle", "[math]")
+{
+    auto rays = atlas::test::make_primitive_rays(4096);
+    Triangle tri{glm::vec3{-1.0f, -1.0f, 0.0f},
+                 glm::vec3{1.0f, -0.5f, 0.2f},
+                 glm::vec3{0.0f, 1.0f, -0.2f}};
+
+    BENCHMARK("scalar x4096")
+    {
+        std::size_t hits{0};
+        for (auto const& r : rays)
+        {
+            hits += intersect(r, tri, 0.0f, 100.0f).has_value();
+        }
+        return hits;
+    };
+
+    constexpr auto N = simd::native_width<float>;
+    std::vector<RayPacket<float, N>> packets;
+    for (std::size_t first{0}; first < rays.size(); first += N)
+    {
+        packets.push_back(RayPacket<float, N>::load({rays.data() + first, N}));
+    }
+
+    BENCHMARK("packet x4096")
+    {
+        std::size_t hits{0};
+        simd::Pack<float, N> t;
+        for (auto const& p : packets)
+        {
+            hits += std::popcount(intersect(p, tri, t).bits());
+        }
+        return hits;
+    };
+}
@@ -0,0 +1,203 @@
+#include <atlas/math/solvers.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace atlas::math;
+
+namespace
+{
+    constexpr std::size_t count{4096};
+
+    // A deterministic set of random monic polynomials, stored one array per
+    // coefficient as the batch solvers expect.
+    template<typename T, std::size_t Degree>
+    struct Polynomials
+    {
+        Polynomials()
+        {
+            std::uint32_t state{12345};
+            auto next = [&state]() {
+                state = state * 1664525u + 1013904223u;
+                return static_cast<T>(state >> 8) / static_cast<T>(1 << 24) * T{8} -
+                       T{4};
+            };
+
+            for (std::size_t k{0}; k <= Degree; ++k)
+            {
+                coeffs[k].resize(count);
+            }
+
+            for (std::size_t i{0}; i < count; ++i)
+            {
+                for (std::size_t k{0}; k < Degree; ++k)
+                {
+                    coeffs[k][i] = next();
+                }
+                coeffs[Degree][i] = T{1};
+            }
+
+            for (std::size_t k{0}; k < Degree; ++k)
+            {
+                roots[k].resize(count);
+            }
+            num_roots.resize(count);
+        }
+
+        std::array<T, Degree + 1> get(std::size_t i) const
+        {
+            std::array<T, Degree + 1> c;
+            for (std::size_t k{0}; k <= Degree; ++k)
+            {
+                c[k] = coeffs[k][i];
+            }
+            return c;
+        }
+
+        std::array<std::span<T const>, Degree + 1> coeff_spans() const
+        {
+            std::array<std::span<T const>, Degree + 1> spans;
+            for (std::size_t k{0}; k <= Degree; ++k)
+            {
+                spans[k] = coeffs[k];
+            }
+            return spans;
+        }
+
+        std::array<std::span<T>, Degree> root_spans()
+        {
+            std::array<std::span<T>, Degree> spans;
+            for (std::size_t k{0}; k < Degree; ++k)
+            {
+                spans[k] = roots[k];
+            }
+            return spans;
+        }
+
+        std::array<std::vector<T>, Degree + 1> coeffs;
+        std::array<std::vector<T>, Degree> roots;
+        std::vector<std::size_t> num_roots;
+    };
+
+    template<typename T, std::size_t Degree, typename Scalar, typename Batch>
+    void run_benchmarks(std::string const& name, Scalar&& scalar, Batch&& batch)
+    {
+        Polynomials<T, Degree> polys;
+
+        BENCHMARK(name + ": std::array x4096")
+        {
+            std::size_t total{0};
+            for (std::size_t i{0}; i < count; ++i)
+            {
+                std::array<T, Degree> r{};
+                total += scalar(polys.get(i), r);
+            }
+            return total;
+        };
+
+        BENCHMARK(name + ": std::vector x4096")
+        {
+            std::size_t total{0};
+            std::vector<T> r;
+            for (std::size_t i{0}; i < count; ++i)
+            {
+                auto c = polys.get(i);
+                std::vector<T> v{c.begin(), c.end()};
+                total += scalar(v, r);
+            }
+            return total;
+        };
+
+        auto c = polys.coeff_spans();
+        auto r = polys.root_spans();
+        BENCHMARK(name + "_batch: native x4096")
+        {
+            batch(c, r, std::span<std::size_t>{polys.num_roots});
+            return polys.num_roots[0];
+        };
+    }
+
+    template<typename T>
+    void run_all_benchmarks(std::string const& type)
+    {
+        run_benchmarks<T, 2>(
+            "solve_quadratic<" + type + ">",
+            [](auto const& c, auto& r) { return solve_quadratic(c, r); },
+            [](auto const& c, auto const& r, auto n) {
+                solve_quadratic_batch<T>(c, r, n);
+            });
+
+        run_benchmarks<T, 3>(
+            "solve_cubic<" + type + ">",
+            [](auto const& c, auto& r) { return solve_cubic(c, r); },
+            [](auto const& c, auto const& r, auto n) { solve_cubic_batch<T>(c, r, n); });
+
+        run_benchmarks<T, 4>(
+            "solve_quartic<" + type + ">",
+            [](auto const& c, auto& r) { return solve_quartic(c, r); },
+            [](auto const& c, auto const& r, auto n) {
+                solve_quartic_batch<T>(c, r, n);
+            });
+    }
+} // namespace
+
+TEST_CASE("[solvers] - solve_quadratic/cubic/quartic: double", "[math]")
+{
+    run_all_benchmarks<double>("double");
+}
+
+TEST_CASE("[solvers] - solve_quadratic/cubic/quartic: float", "[math]")
+{
+    run_all_benchmarks<float>("float");
+}
+
+TEST_CASE("[solvers] - fixed polynomials", "[math]")
+{
+    BENCHMARK("solve_quartic: std::vector")
+    {
+        std::vector<double> coefficients{24.0, -50.0, 35.0, -10.0, 1.0};
+        std::vector<double> roots;
+        return solve_quartic(coefficients, roots);
+    };
+
+    BENCHMARK("solve_quartic: std::array")
+    {
+        std::array<double, 5> coefficients{24.0, -50.0, 35.0, -10.0, 1.0};
+        std::array<double, 4> roots{};
+        return solve_quartic(coefficients, roots);
+    };
+
+    BENCHMARK("solve_cubic: std::vector")
+    {
+        std::vector<double> coefficients{-6.0, 11.0, -6.0, 1.0};
+        std::vector<double> roots;
+        return solve_cubic(coefficients, roots);
+    };
+
+    BENCHMARK("solve_cubic: std::array")
+    {
+        std::array<double, 4> coefficients{-6.0, 11.0, -6.0, 1.0};
+        std::array<double, 3> roots{};
+        return solve_cubic(coefficients, roots);
+    };
+
+    BENCHMARK("solve_quadratic: std::vector")
+    {
+        std::vector<double> coefficients{1.0, 0.0, -1.0};
+        std::vector<double> roots;
+        return solve_quadratic(coefficients, roots);
+    };
+
+    BENCHMARK("solve_quadratic: std::array")
+    {
+        std::array<double, 3> coefficients{1.0, 0.0, -1.0};
+        std::array<double, 2> roots{};
+        return solve_quadratic(coefficients, roots);
+    };
+}
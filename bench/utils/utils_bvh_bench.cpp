@@ -0,0 +1,62 @@
+#include "test_helpers.hpp"
+#include "test_shapes.hpp"
+
+#include <atlas/utils/bvh.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+
+using namespace atlas;
+
+TEST_CASE("[bvh] - build and traverse", "[utils]")
+{
+    // Roughly one million triangles.
+    auto mesh = test::make_sphere_pair(448);
+    auto rays = test::make_scene_rays(1 << 16);
+    jobs::JobSystem system;
+
+    BENCHMARK("build BVH4")
+    {
+        return utils::Bvh4{mesh, system};
+    };
+
+    BENCHMARK("build BVH8")
+    {
+        return utils::Bvh8{mesh, system};
+    };
+
+    utils::Bvh4 bvh4{mesh, system};
+    utils::Bvh8 bvh8{mesh, system};
+
+    BENCHMARK("BVH4 closest hit x65536")
+    {
+        std::size_t hits{0};
+        for (auto const& ray : rays)
+        {
+            hits += bvh4.closest_hit(ray).has_value();
+        }
+        return hits;
+    };
+
+    BENCHMARK("BVH8 closest hit x65536")
+    {
+        std::size_t hits{0};
+        for (auto const& ray : rays)
+        {
+            hits += bvh8.closest_hit(ray).has_value();
+        }
+        return hits;
+    };
+
+    BENCHMARK("BVH8 any hit x65536")
+    {
+        std::size_t hits{0};
+        for (auto const& ray : rays)
+        {
+            hits += bvh8.any_hit(ray);
+        }
+        return hits;
+    };
+}
@@ -0,0 +1,24 @@
+#include "test_helpers.hpp"
+
+#include <atlas/utils/image_compare.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace atlas;
+
+TEST_CASE("[image_compare] - compare_images", "[utils]")
+{
+    auto a = test::make_noise_image(1920, 1080, 4, 7);
+    auto b = test::make_noise_image(1920, 1080, 4, 8);
+
+    BENCHMARK("compare_images 1920x1080 RGBA")
+    {
+        return utils::compare_images(a, b);
+    };
+
+    BENCHMARK("scalar errors 1920x1080 RGBA")
+    {
+        return test::scalar_image_errors(a, b);
+    };
+}
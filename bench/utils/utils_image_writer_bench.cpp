@@ -0,0 +1,38 @@
+#include "test_helpers.hpp"
+
+#include <atlas/utils/image_writer.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+#include <filesystem>
+
+using namespace atlas;
+
+TEST_CASE("[image_writer] - write_image", "[utils]")
+{
+    auto directory = std::filesystem::temp_directory_path() / "atlas_image_bench";
+    std::filesystem::create_directories(directory);
+    auto image = test::make_image(1920, 1080, 3);
+
+    BENCHMARK("write_image PNG 1920x1080")
+    {
+        return utils::write_image((directory / "frame.png").string(), image);
+    };
+
+    jobs::JobSystem system;
+    utils::ImageWriter writer{system, 8};
+    BENCHMARK("ImageWriter 8 x PNG 1920x1080")
+    {
+        for (int i{0}; i < 8; ++i)
+        {
+            auto name = fmt::format("frame_{}.png", i);
+            writer.write((directory / name).string(), image);
+        }
+        writer.wait();
+        return writer.written();
+    };
+
+    std::filesystem::remove_all(directory);
+}
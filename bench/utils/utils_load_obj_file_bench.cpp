@@ -0,0 +1,168 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/load_obj_file.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+
+using namespace atlas;
+
+namespace
+{
+    // Heap bytes in use and the most that were in use since the last call to
+    // reset_peak, counted by the operator new and delete below. Peak resident
+    // set size cannot be used for this, since it only ever grows over the
+    // life of the process and so says nothing after the first load.
+    std::atomic<std::size_t> live_bytes{0};
+    std::atomic<std::size_t> peak_bytes{0};
+
+    // Every allocation starts with its size, padded so the memory handed out
+    // keeps the default alignment.
+    constexpr std::size_t header_size{__STDCPP_DEFAULT_NEW_ALIGNMENT__};
+
+    void* counted_allocate(std::size_t size)
+    {
+        auto block = static_cast<unsigned char*>(std::malloc(size + header_size));
+        if (block == nullptr)
+        {
+            return nullptr;
+        }
+
+        *reinterpret_cast<std::size_t*>(block) = size;
+        auto live = live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+        auto peak = peak_bytes.load(std::memory_order_relaxed);
+        while (live > peak &&
+               !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        {}
+        return block + header_size;
+    }
+
+    void counted_free(void* ptr)
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+
+        auto block = static_cast<unsigned char*>(ptr) - header_size;
+        live_bytes.fetch_sub(*reinterpret_cast<std::size_t*>(block),
+                             std::memory_order_relaxed);
+        std::free(block);
+    }
+
+    std::size_t reset_peak()
+    {
+        auto live = live_bytes.load(std::memory_order_relaxed);
+        peak_bytes.store(live, std::memory_order_relaxed);
+        return live;
+    }
+} // namespace
+
+// Replaces the global allocator for the whole benchmark binary. The array and
+// nothrow forms call these by default.
+void* operator new(std::size_t size)
+{
+    if (auto ptr = counted_allocate(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    counted_free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    counted_free(ptr);
+}
+
+TEST_CASE("[load_obj_file] - load_obj_mesh", "[utils]")
+{
+    jobs::JobSystem system;
+    for (std::size_t size : {64, 256})
+    {
+        auto name = fmt::format("atlas_bench_grid_{}.obj", size);
+        auto path = test::write_obj_grid(name, size);
+
+        BENCHMARK(fmt::format("load_obj_mesh {0}x{0} grid", size))
+        {
+            return utils::load_obj_mesh(path);
+        };
+
+        BENCHMARK(fmt::format("load_obj_mesh {0}x{0} grid, welded", size))
+        {
+            return utils::load_obj_mesh(path, {}, 1e-4f);
+        };
+
+        BENCHMARK(fmt::format("load_obj_mesh_parallel {0}x{0} grid", size))
+        {
+            return utils::load_obj_mesh_parallel(path, system);
+        };
+
+        std::filesystem::remove(path);
+    }
+}
+
+TEST_CASE("[load_obj_file] - 1024x1024 grid", "[utils]")
+{
+    constexpr std::size_t size{1024};
+    auto path = test::write_obj_grid("atlas_grid.obj", size);
+
+    auto heap_before = reset_peak();
+    auto start       = std::chrono::steady_clock::now();
+    auto mesh        = utils::load_obj_mesh(path);
+    auto end         = std::chrono::steady_clock::now();
+    auto heap_peak   = peak_bytes.load(std::memory_order_relaxed);
+    auto heap_after  = live_bytes.load(std::memory_order_relaxed);
+
+    REQUIRE(mesh.has_value());
+    REQUIRE(mesh->shapes[0].vertices.size() == (size + 1) * (size + 1));
+    REQUIRE(mesh->shapes[0].indices.size() == size * size * 6);
+
+    auto file_size = std::filesystem::file_size(path);
+    auto mib       = [](std::size_t bytes) {
+        return static_cast<double>(bytes) / (1024.0 * 1024.0);
+    };
+    fmt::print("load_obj_mesh: {:.1f} MiB file, {} ms, peak heap +{:.1f} MiB, "
+               "mesh {:.1f} MiB\n",
+               mib(file_size),
+               std::chrono::duration_cast<std::chrono::milliseconds>(end - start)
+                   .count(),
+               mib(heap_peak - heap_before),
+               mib(heap_after - heap_before));
+    mesh.reset();
+
+    jobs::JobSystem system;
+    BENCHMARK("load_obj_mesh 1024x1024 grid")
+    {
+        return utils::load_obj_mesh(path);
+    };
+
+    BENCHMARK("load_obj_mesh_parallel 1024x1024 grid")
+    {
+        return utils::load_obj_mesh_parallel(path, system);
+    };
+
+    BENCHMARK("stream_obj_mesh 1024x1024 grid")
+    {
+        std::size_t face_count{0};
+        utils::ObjStreamCallbacks callbacks;
+        callbacks.shape_callback = [&](utils::Shape&& shape) {
+            face_count += shape.indices.size() / 3;
+        };
+        utils::stream_obj_mesh(path, callbacks, system);
+        return face_count;
+    };
+
+    std::filesystem::remove(path);
+}
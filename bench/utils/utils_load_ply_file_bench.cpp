@@ -0,0 +1,54 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/load_ply_file.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+#include <filesystem>
+#include <string>
+
+using namespace atlas;
+
+TEST_CASE("[load_ply_file] - load_ply_mesh", "[utils]")
+{
+    constexpr std::size_t size{1024};
+    auto obj_path    = test::write_obj_grid("atlas_bench.obj", size);
+    auto binary_path = test::write_ply_grid(
+        "atlas_bench.ply", size, test::PlyFormat::little_endian, false);
+    auto ascii_path  = test::write_ply_grid(
+        "atlas_bench_ascii.ply", size, test::PlyFormat::ascii, false);
+
+    auto mebibytes = [](std::string const& path) {
+        auto bytes = std::filesystem::file_size(path);
+        return static_cast<double>(bytes) / (1024.0 * 1024.0);
+    };
+    fmt::print("{}x{} grid: OBJ {:.1f} MiB, binary PLY {:.1f} MiB, "
+               "ASCII PLY {:.1f} MiB\n",
+               size,
+               size,
+               mebibytes(obj_path),
+               mebibytes(binary_path),
+               mebibytes(ascii_path));
+
+    jobs::JobSystem system;
+    BENCHMARK("load_obj_mesh_parallel 1024x1024 grid")
+    {
+        return utils::load_obj_mesh_parallel(obj_path, system);
+    };
+
+    BENCHMARK("load_ply_mesh binary 1024x1024 grid")
+    {
+        return utils::load_ply_mesh(binary_path);
+    };
+
+    BENCHMARK("load_ply_mesh ASCII 1024x1024 grid")
+    {
+        return utils::load_ply_mesh(ascii_path);
+    };
+
+    std::filesystem::remove(obj_path);
+    std::filesystem::remove(binary_path);
+    std::filesystem::remove(ascii_path);
+}
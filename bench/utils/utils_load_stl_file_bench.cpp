@@ -0,0 +1,84 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/load_stl_file.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace atlas;
+
+TEST_CASE("[load_stl_file] - load_stl_mesh", "[utils]")
+{
+    constexpr std::size_t size{1024};
+    auto triangles = test::grid_triangles(size);
+    glm::vec3 up{0.0f, 0.0f, 1.0f};
+
+    auto binary_path = test::write_stl_binary("atlas_bench.stl", triangles, up);
+    auto ascii_path  = test::write_file("atlas_bench_ascii.stl",
+                                       test::stl_ascii_solid("grid", triangles, up));
+
+    // The same grid as an OBJ file, with shared positions.
+    auto obj_path = (std::filesystem::temp_directory_path() / "atlas_bench.obj").string();
+    {
+        std::ofstream stream{obj_path};
+        auto step = 1.0f / static_cast<float>(size);
+        for (std::size_t y{0}; y <= size; ++y)
+        {
+            for (std::size_t x{0}; x <= size; ++x)
+            {
+                stream << fmt::format("v {} {} 0\n",
+                                      static_cast<float>(x) * step,
+                                      static_cast<float>(y) * step);
+            }
+        }
+        stream << "vn 0 0 1\n";
+
+        for (std::size_t y{0}; y < size; ++y)
+        {
+            for (std::size_t x{0}; x < size; ++x)
+            {
+                auto a = y * (size + 1) + x + 1;
+                auto b = a + size + 1;
+                stream << fmt::format(
+                    "f {0}//1 {1}//1 {2}//1 {3}//1\n", a, a + 1, b + 1, b);
+            }
+        }
+    }
+
+    auto mebibytes = [](std::string const& path) {
+        auto bytes = std::filesystem::file_size(path);
+        return static_cast<double>(bytes) / (1024.0 * 1024.0);
+    };
+    fmt::print("{}x{} grid: OBJ {:.1f} MiB, binary STL {:.1f} MiB, "
+               "ASCII STL {:.1f} MiB\n",
+               size,
+               size,
+               mebibytes(obj_path),
+               mebibytes(binary_path),
+               mebibytes(ascii_path));
+
+    jobs::JobSystem system;
+    BENCHMARK("load_obj_mesh_parallel 1024x1024 grid")
+    {
+        return utils::load_obj_mesh_parallel(obj_path, system);
+    };
+
+    BENCHMARK("load_stl_mesh binary 1024x1024 grid")
+    {
+        return utils::load_stl_mesh(binary_path);
+    };
+
+    BENCHMARK("load_stl_mesh ASCII 1024x1024 grid")
+    {
+        return utils::load_stl_mesh(ascii_path);
+    };
+
+    std::filesystem::remove(obj_path);
+    std::filesystem::remove(binary_path);
+    std::filesystem::remove(ascii_path);
+}
@@ -0,0 +1,34 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/mesh_cache.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+
+using namespace atlas;
+
+namespace fs = std::filesystem;
+
+TEST_CASE("[mesh_cache] - load_obj_mesh_cached", "[utils]")
+{
+    auto dir       = fs::temp_directory_path();
+    auto cache_dir = (dir / "atlas_mesh_cache").string();
+    auto path      = test::write_obj_grid("atlas_cached_grid.obj", 1024);
+
+    jobs::JobSystem system;
+    BENCHMARK("load_obj_mesh_parallel 1024x1024 grid")
+    {
+        return utils::load_obj_mesh_parallel(path, system);
+    };
+
+    utils::load_obj_mesh_cached(path, system, cache_dir);
+    BENCHMARK("load_obj_mesh_cached 1024x1024 grid")
+    {
+        return utils::load_obj_mesh_cached(path, system, cache_dir);
+    };
+
+    fs::remove(path);
+    fs::remove_all(cache_dir);
+}
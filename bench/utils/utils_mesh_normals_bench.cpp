@@ -0,0 +1,29 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/mesh_normals.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace atlas;
+
+TEST_CASE("[mesh_normals] - generate_normals", "[utils]")
+{
+    auto sphere = test::make_sphere(256);
+
+    jobs::JobSystem system;
+    BENCHMARK("generate_normals 262k triangle sphere")
+    {
+        auto shape = sphere;
+        utils::generate_normals(shape, system);
+        return shape;
+    };
+
+    auto shape = sphere;
+    utils::generate_normals(shape, system);
+    BENCHMARK("generate_tangents 262k triangle sphere")
+    {
+        auto copy = shape;
+        return utils::generate_tangents(copy, system);
+    };
+}
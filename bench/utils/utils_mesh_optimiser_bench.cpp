@@ -0,0 +1,39 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/mesh_optimiser.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+using namespace atlas;
+
+TEST_CASE("[mesh_optimiser] - optimise_mesh", "[utils]")
+{
+    auto original = test::make_grid(512);
+
+    auto shape  = original;
+    auto report = utils::optimise_mesh(shape);
+    fmt::print("optimise_mesh 512x512 grid in row order: ACMR {:.3f} -> {:.3f}, "
+               "ATVR {:.3f} -> {:.3f}\n",
+               report.before.acmr,
+               report.after.acmr,
+               report.before.atvr,
+               report.after.atvr);
+
+    test::shuffle_triangles(original);
+    shape  = original;
+    report = utils::optimise_mesh(shape);
+    fmt::print("optimise_mesh 512x512 grid shuffled: ACMR {:.3f} -> {:.3f}, "
+               "ATVR {:.3f} -> {:.3f}\n",
+               report.before.acmr,
+               report.after.acmr,
+               report.before.atvr,
+               report.after.atvr);
+
+    BENCHMARK("optimise_mesh 512x512 grid")
+    {
+        auto copy = original;
+        return utils::optimise_mesh(copy);
+    };
+}
@@ -0,0 +1,37 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/mesh_simplifier.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+using namespace atlas;
+
+TEST_CASE("[mesh_simplifier] - simplify_shape", "[utils]")
+{
+    auto shape = test::make_sphere(256, 1.0f);
+
+    auto lods = utils::generate_lods(shape, {0.5f, 0.25f, 0.125f, 0.0625f});
+    for (auto const& lod : lods)
+    {
+        fmt::print("sphere LOD: {} triangles, ratio {:.3f}, error {:.5f}\n",
+                   lod.shape.indices.size() / 3,
+                   lod.ratio,
+                   lod.error);
+    }
+
+    BENCHMARK("simplify_shape 262k triangle sphere to 25%")
+    {
+        auto copy = shape;
+        return utils::simplify_shape(copy, 0.25f);
+    };
+
+    utils::ObjMesh mesh;
+    mesh.shapes.assign(8, test::make_sphere(64, 1.0f));
+    jobs::JobSystem system;
+    BENCHMARK("generate_lods 8 spheres")
+    {
+        return utils::generate_lods(mesh, {0.5f, 0.25f}, system);
+    };
+}
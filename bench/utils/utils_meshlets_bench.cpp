@@ -0,0 +1,25 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/meshlets.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace atlas;
+
+TEST_CASE("[meshlets] - build_meshlets", "[utils]")
+{
+    auto shape = test::make_sphere(256);
+
+    BENCHMARK("build_meshlets 262k triangle sphere")
+    {
+        return utils::build_meshlets(shape);
+    };
+
+    auto meshlets = utils::build_meshlets(shape);
+    auto planes   = utils::frustum_planes(glm::mat4{1.0f});
+    BENCHMARK("cull_meshlets 262k triangle sphere")
+    {
+        return utils::cull_meshlets(meshlets, glm::vec3{0.0f, 0.0f, 5.0f}, planes);
+    };
+}
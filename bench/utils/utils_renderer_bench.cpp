@@ -0,0 +1,34 @@
+#include "test_helpers.hpp"
+#include "test_shapes.hpp"
+
+#include <atlas/utils/renderer.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+using namespace atlas;
+
+TEST_CASE("[Renderer] - render", "[utils]")
+{
+    auto mesh = test::make_sphere_on_floor(256);
+    jobs::JobSystem build_system;
+    utils::MeshScene scene{mesh, build_system};
+    test::LookAtCamera camera{glm::vec3{0.0f, 1.0f, 5.0f}, glm::vec3{0.0f}};
+
+    utils::RenderSettings settings;
+    settings.width  = 320;
+    settings.height = 240;
+
+    for (std::size_t threads : {1, 2, 4, 8})
+    {
+        jobs::JobSystem system{threads};
+        utils::Renderer renderer{system, settings};
+        BENCHMARK("render " + std::to_string(threads) + " threads")
+        {
+            renderer.render(scene, camera);
+            return renderer.sample_count();
+        };
+    }
+}
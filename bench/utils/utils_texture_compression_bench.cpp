@@ -0,0 +1,52 @@
+#include "test_helpers.hpp"
+
+#include <atlas/utils/texture_compression.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <stb_image_write.h>
+
+#include <filesystem>
+#include <string>
+
+using namespace atlas;
+
+TEST_CASE("[texture_compression] - compress_level", "[utils]")
+{
+    jobs::JobSystem system;
+    auto level = test::make_texture_level(1024, 1024, 4);
+
+    BENCHMARK("compress_level BC1 1024x1024")
+    {
+        return utils::compress_level(level, 4, utils::BlockFormat::bc1, system);
+    };
+
+    BENCHMARK("compress_level BC3 1024x1024")
+    {
+        return utils::compress_level(level, 4, utils::BlockFormat::bc3, system);
+    };
+
+    BENCHMARK("compress_level BC5 1024x1024")
+    {
+        return utils::compress_level(level, 4, utils::BlockFormat::bc5, system);
+    };
+
+    auto directory = std::filesystem::temp_directory_path() / "atlas_texture_bench";
+    std::filesystem::create_directories(directory);
+    auto image = (directory / "albedo.png").string();
+    stbi_write_png(image.c_str(), 1024, 1024, 4, level.pixels.data(), 0);
+    utils::load_texture_cached(image, utils::BlockFormat::bc1, system);
+
+    BENCHMARK("load_texture + compress_texture BC1 1024x1024")
+    {
+        auto texture = utils::load_texture(image, system);
+        return utils::compress_texture(*texture, utils::BlockFormat::bc1, system);
+    };
+
+    BENCHMARK("load_texture_cached BC1 1024x1024 (hit)")
+    {
+        return utils::load_texture_cached(image, utils::BlockFormat::bc1, system);
+    };
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,67 @@
+#include "test_helpers.hpp"
+
+#include <atlas/utils/texture_loader.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace atlas;
+
+TEST_CASE("[texture_loader] - TextureLoader", "[utils]")
+{
+    constexpr int texture_count{8};
+    std::vector<std::string> paths;
+    for (int i{0}; i < texture_count; ++i)
+    {
+        paths.push_back(
+            test::write_png(fmt::format("atlas_bench_{}.png", i), 1024, 1024, 4));
+    }
+
+    // One worker per hardware thread, since this thread only polls.
+    jobs::JobSystem system{std::thread::hardware_concurrency() + 1};
+
+    BENCHMARK("load_texture 8 1024x1024 textures")
+    {
+        std::size_t levels{0};
+        for (auto const& path : paths)
+        {
+            levels += utils::load_texture(path, system)->levels.size();
+        }
+        return levels;
+    };
+
+    BENCHMARK("TextureLoader 8 1024x1024 textures")
+    {
+        utils::TextureLoader loader{system};
+        for (auto const& path : paths)
+        {
+            loader.request(path);
+        }
+        test::wait_for(loader);
+        return loader.take_ready().size();
+    };
+
+    // What the render thread pays: only the requests, never the decode.
+    utils::TextureLoader loader{system};
+    BENCHMARK("TextureLoader::request 8 textures")
+    {
+        utils::TextureHandle last{0};
+        for (auto const& path : paths)
+        {
+            last = loader.request(path);
+        }
+        return last;
+    };
+    test::wait_for(loader);
+
+    for (auto const& path : paths)
+    {
+        std::filesystem::remove(path);
+    }
+}
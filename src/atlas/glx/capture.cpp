@@ -0,0 +1,175 @@
+#include "capture.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace atlas::glx
+{
+    FramebufferCapture::FramebufferCapture(std::size_t buffer_count) :
+        m_buffers(std::max<std::size_t>(buffer_count, 1))
+    {
+        for (auto& buffer : m_buffers)
+        {
+            glCreateBuffers(1, &buffer.handle);
+        }
+    }
+
+    FramebufferCapture::~FramebufferCapture()
+    {
+        for (auto& buffer : m_buffers)
+        {
+            if (buffer.fence != nullptr)
+            {
+                glDeleteSync(buffer.fence);
+            }
+
+            glDeleteBuffers(1, &buffer.handle);
+        }
+    }
+
+    std::optional<std::uint64_t> FramebufferCapture::capture(
+        GLint x, GLint y, GLsizei width, GLsizei height, CaptureFormat format)
+    {
+        if (m_in_flight.size() == m_buffers.size())
+        {
+            ++m_dropped;
+            return {};
+        }
+
+        auto index   = m_next;
+        auto& buffer = m_buffers[index];
+        auto& frame  = buffer.frame;
+        frame.id     = m_next_id++;
+        frame.width  = width;
+        frame.height = height;
+
+        GLenum pixel_format{GL_RGB};
+        GLenum type{GL_UNSIGNED_BYTE};
+        switch (format)
+        {
+        case CaptureFormat::rgb8:
+            frame.channels = 3;
+            frame.is_float = false;
+            break;
+
+        case CaptureFormat::rgba8:
+            pixel_format   = GL_RGBA;
+            frame.channels = 4;
+            frame.is_float = false;
+            break;
+
+        case CaptureFormat::rgb32f:
+            type           = GL_FLOAT;
+            frame.channels = 3;
+            frame.is_float = true;
+            break;
+        }
+
+        auto size = static_cast<std::size_t>(width) * height * frame.channels *
+                    (frame.is_float ? sizeof(float) : 1);
+        if (size > buffer.capacity)
+        {
+            // Resizing is rare, so mutable storage is good enough.
+            glNamedBufferData(
+                buffer.handle, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_READ);
+            buffer.capacity = size;
+        }
+        frame.pixels.resize(size);
+
+        GLint last_buffer;
+        glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &last_buffer);
+        GLint last_alignment;
+        glGetIntegerv(GL_PACK_ALIGNMENT, &last_alignment);
+        GLint last_row_length;
+        glGetIntegerv(GL_PACK_ROW_LENGTH, &last_row_length);
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.handle);
+        glReadPixels(x, y, width, height, pixel_format, type, nullptr);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, static_cast<GLuint>(last_buffer));
+        glPixelStorei(GL_PACK_ALIGNMENT, last_alignment);
+        glPixelStorei(GL_PACK_ROW_LENGTH, last_row_length);
+
+        buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_in_flight.push_back(index);
+        m_next = (m_next + 1) % m_buffers.size();
+        return frame.id;
+    }
+
+    std::vector<CapturedFrame> FramebufferCapture::update()
+    {
+        // Captures finish in order, so stop at the first one that has not.
+        std::vector<CapturedFrame> frames;
+        while (!m_in_flight.empty())
+        {
+            auto& buffer = m_buffers[m_in_flight.front()];
+            if (glClientWaitSync(buffer.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            {
+                break;
+            }
+
+            if (auto frame = read_back(buffer); frame)
+            {
+                frames.push_back(std::move(*frame));
+            }
+            m_in_flight.pop_front();
+        }
+
+        return frames;
+    }
+
+    std::vector<CapturedFrame> FramebufferCapture::flush()
+    {
+        std::vector<CapturedFrame> frames;
+        while (!m_in_flight.empty())
+        {
+            auto& buffer = m_buffers[m_in_flight.front()];
+            while (glClientWaitSync(buffer.fence,
+                                    GL_SYNC_FLUSH_COMMANDS_BIT,
+                                    GLuint64{1'000'000}) == GL_TIMEOUT_EXPIRED)
+            {}
+
+            if (auto frame = read_back(buffer); frame)
+            {
+                frames.push_back(std::move(*frame));
+            }
+            m_in_flight.pop_front();
+        }
+
+        return frames;
+    }
+
+    std::optional<CapturedFrame> FramebufferCapture::read_back(Buffer& buffer)
+    {
+        glDeleteSync(buffer.fence);
+        buffer.fence = nullptr;
+
+        // The copy out of the mapping is the only work left on this thread;
+        // encoding happens elsewhere.
+        auto frame = std::move(buffer.frame);
+        auto data  = glMapNamedBufferRange(buffer.handle,
+                                          0,
+                                          static_cast<GLsizeiptr>(frame.pixels.size()),
+                                          GL_MAP_READ_BIT);
+        buffer.frame = {};
+        if (data == nullptr)
+        {
+            ++m_dropped;
+            return {};
+        }
+
+        // The store can be lost while mapped (on a mode switch, say), in
+        // which case the copy is garbage and the frame is dropped too.
+        std::memcpy(frame.pixels.data(), data, frame.pixels.size());
+        if (glUnmapNamedBuffer(buffer.handle) == GL_FALSE)
+        {
+            ++m_dropped;
+            return {};
+        }
+
+        return frame;
+    }
+} // namespace atlas::glx
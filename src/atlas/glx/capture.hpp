@@ -0,0 +1,98 @@
+#pragma once
+
+#include <GL/gl3w.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace atlas::glx
+{
+    enum class CaptureFormat
+    {
+        rgb8,
+        rgba8,
+        rgb32f
+    };
+
+    struct CapturedFrame
+    {
+        std::uint64_t id{0};
+        GLsizei width{0};
+        GLsizei height{0};
+        int channels{0};
+        bool is_float{false};
+
+        // Tightly packed rows, bottom to top.
+        std::vector<unsigned char> pixels;
+    };
+
+    // Reads the framebuffer back without stalling the pipeline. Each capture
+    // is read into the next buffer of a ring of pixel pack buffers and
+    // fenced, and update only maps the buffers whose fence has signalled,
+    // which is usually one or two frames later. If every buffer is still in
+    // flight, the capture is dropped instead of waiting on the GPU, so
+    // capturing every frame never slows the render loop down.
+    //
+    // Must be created, updated and destroyed on the thread that owns the
+    // OpenGL context.
+    class FramebufferCapture
+    {
+    public:
+        explicit FramebufferCapture(std::size_t buffer_count = 3);
+        ~FramebufferCapture();
+
+        FramebufferCapture(FramebufferCapture const&)            = delete;
+        FramebufferCapture& operator=(FramebufferCapture const&) = delete;
+
+        // Reads a region of the bound read framebuffer. Returns the id of the
+        // capture, which increases by one with every capture taken, or
+        // nothing if it was dropped.
+        std::optional<std::uint64_t> capture(GLint x,
+                                             GLint y,
+                                             GLsizei width,
+                                             GLsizei height,
+                                             CaptureFormat format = CaptureFormat::rgb8);
+
+        // Copies out the captures that have finished, oldest first. Never
+        // waits on the GPU. Call once per frame. A capture whose buffer
+        // cannot be mapped is dropped rather than returned blank.
+        std::vector<CapturedFrame> update();
+
+        // Waits for every capture in flight and returns them. Meant for
+        // single screenshots and for shutting down.
+        std::vector<CapturedFrame> flush();
+
+        // Number of captures in flight.
+        std::size_t pending() const
+        {
+            return m_in_flight.size();
+        }
+
+        // Number of captures dropped, either because every buffer was in
+        // flight or because the read back failed.
+        std::size_t dropped() const
+        {
+            return m_dropped;
+        }
+
+    private:
+        struct Buffer
+        {
+            GLuint handle{0};
+            std::size_t capacity{0};
+            GLsync fence{nullptr};
+            CapturedFrame frame;
+        };
+
+        std::optional<CapturedFrame> read_back(Buffer& buffer);
+
+        std::vector<Buffer> m_buffers;
+        std::deque<std::size_t> m_in_flight;
+        std::size_t m_next{0};
+        std::uint64_t m_next_id{0};
+        std::size_t m_dropped{0};
+    };
+} // namespace atlas::glx
@@ -0,0 +1,265 @@
+#include "texture.hpp"
+#include "buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace atlas::glx
+{
+    namespace
+    {
+        // S3TC is an extension, so it is not part of the core profile header.
+        constexpr GLenum compressed_rgb_s3tc_dxt1{0x83F0};
+        constexpr GLenum compressed_rgba_s3tc_dxt5{0x83F3};
+        constexpr GLenum compressed_srgb_s3tc_dxt1{0x8C4C};
+        constexpr GLenum compressed_srgb_alpha_s3tc_dxt5{0x8C4F};
+    } // namespace
+
+    PixelFormat pixel_format(int channels, bool is_srgb)
+    {
+        switch (channels)
+        {
+        case 1:
+            return {GL_R8, GL_RED};
+
+        case 2:
+            return {GL_RG8, GL_RG};
+
+        case 3:
+            return {is_srgb ? GLenum{GL_SRGB8} : GLenum{GL_RGB8}, GL_RGB};
+
+        default:
+            return {is_srgb ? GLenum{GL_SRGB8_ALPHA8} : GLenum{GL_RGBA8}, GL_RGBA};
+        }
+    }
+
+    GLuint create_texture_2d(GLsizei width,
+                             GLsizei height,
+                             GLsizei levels,
+                             GLenum internal_format)
+    {
+        GLuint texture;
+        glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+        glTextureStorage2D(texture, levels, internal_format, width, height);
+
+        glTextureParameteri(texture,
+                            GL_TEXTURE_MIN_FILTER,
+                            (levels > 1) ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTextureParameteri(texture, GL_TEXTURE_MAX_LEVEL, levels - 1);
+        return texture;
+    }
+
+    GLenum compressed_format(int bc, bool is_srgb)
+    {
+        switch (bc)
+        {
+        case 1:
+            return is_srgb ? compressed_srgb_s3tc_dxt1 : compressed_rgb_s3tc_dxt1;
+
+        case 3:
+            return is_srgb ? compressed_srgb_alpha_s3tc_dxt5 : compressed_rgba_s3tc_dxt5;
+
+        case 4:
+            return GL_COMPRESSED_RED_RGTC1;
+
+        default:
+            return GL_COMPRESSED_RG_RGTC2;
+        }
+    }
+
+    GLuint create_compressed_texture_2d(GLenum internal_format,
+                                        std::vector<BlockLevel> const& levels)
+    {
+        if (levels.empty())
+        {
+            return 0;
+        }
+
+        auto texture = create_texture_2d(levels.front().width,
+                                         levels.front().height,
+                                         static_cast<GLsizei>(levels.size()),
+                                         internal_format);
+
+        GLint last_buffer;
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &last_buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        for (std::size_t i{0}; i < levels.size(); ++i)
+        {
+            auto const& level = levels[i];
+            glCompressedTextureSubImage2D(texture,
+                                          static_cast<GLint>(i),
+                                          0,
+                                          0,
+                                          level.width,
+                                          level.height,
+                                          internal_format,
+                                          level.size,
+                                          level.blocks);
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, static_cast<GLuint>(last_buffer));
+        return texture;
+    }
+
+    TextureUploader::TextureUploader(std::size_t buffer_size, std::size_t buffer_count) :
+        m_buffer_size{buffer_size},
+        m_buffers(std::max<std::size_t>(buffer_count, 1))
+    {
+        // Coherent mappings make the copies visible without a flush, and the
+        // fences keep them from racing the GPU.
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        for (auto& buffer : m_buffers)
+        {
+            glCreateBuffers(1, &buffer.handle);
+            glNamedBufferStorage(
+                buffer.handle, static_cast<GLsizeiptr>(m_buffer_size), nullptr, flags);
+            buffer.data = static_cast<unsigned char*>(glMapNamedBufferRange(
+                buffer.handle, 0, static_cast<GLsizeiptr>(m_buffer_size), flags));
+        }
+    }
+
+    TextureUploader::~TextureUploader()
+    {
+        for (auto& buffer : m_buffers)
+        {
+            if (buffer.fence != nullptr)
+            {
+                glDeleteSync(buffer.fence);
+            }
+
+            glUnmapNamedBuffer(buffer.handle);
+            glDeleteBuffers(1, &buffer.handle);
+        }
+    }
+
+    void TextureUploader::queue(GLuint texture,
+                                int channels,
+                                std::vector<PixelLevel> levels,
+                                std::shared_ptr<void const> keep_alive)
+    {
+        if (levels.empty())
+        {
+            return;
+        }
+
+        m_queue.push_back({texture,
+                           pixel_format(channels, false).format,
+                           static_cast<std::size_t>(channels),
+                           std::move(levels),
+                           std::move(keep_alive)});
+    }
+
+    std::vector<GLuint> TextureUploader::update()
+    {
+        std::vector<GLuint> finished;
+        if (m_queue.empty())
+        {
+            return finished;
+        }
+
+        // If the GPU is still reading the next buffer, try again next frame
+        // rather than stall.
+        auto& buffer = m_buffers[m_current];
+        if (buffer.fence != nullptr)
+        {
+            if (glClientWaitSync(buffer.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            {
+                return finished;
+            }
+
+            glDeleteSync(buffer.fence);
+            buffer.fence = nullptr;
+        }
+
+        GLint last_buffer;
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &last_buffer);
+        GLint last_alignment;
+        glGetIntegerv(GL_UNPACK_ALIGNMENT, &last_alignment);
+        GLint last_row_length;
+        glGetIntegerv(GL_UNPACK_ROW_LENGTH, &last_row_length);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.handle);
+
+        std::size_t offset{0};
+        while (!m_queue.empty())
+        {
+            auto& upload = m_queue.front();
+            auto& level  = upload.levels[upload.level];
+            auto row     = static_cast<std::size_t>(level.width) * upload.pixel_size;
+            auto source  = static_cast<unsigned char const*>(level.pixels);
+
+            auto rows_left = static_cast<std::size_t>(level.height - upload.row);
+            auto rows_fit  = (m_buffer_size - offset) / row;
+            if (rows_fit == 0 && offset != 0)
+            {
+                break;
+            }
+
+            GLsizei rows;
+            if (rows_fit == 0)
+            {
+                // A single row does not fit in a buffer, so upload the rest
+                // of the level straight from memory.
+                rows = static_cast<GLsizei>(rows_left);
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                glTextureSubImage2D(upload.texture,
+                                    static_cast<GLint>(upload.level),
+                                    0,
+                                    upload.row,
+                                    level.width,
+                                    rows,
+                                    upload.format,
+                                    GL_UNSIGNED_BYTE,
+                                    source + upload.row * row);
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.handle);
+            }
+            else
+            {
+                rows = static_cast<GLsizei>(std::min(rows_left, rows_fit));
+                std::memcpy(buffer.data + offset, source + upload.row * row, rows * row);
+                glTextureSubImage2D(upload.texture,
+                                    static_cast<GLint>(upload.level),
+                                    0,
+                                    upload.row,
+                                    level.width,
+                                    rows,
+                                    upload.format,
+                                    GL_UNSIGNED_BYTE,
+                                    buffer_offset<unsigned char>(offset));
+                offset += rows * row;
+            }
+
+            upload.row += rows;
+            if (upload.row == level.height)
+            {
+                upload.row = 0;
+                ++upload.level;
+            }
+
+            if (upload.level == upload.levels.size())
+            {
+                finished.push_back(upload.texture);
+                m_queue.pop_front();
+            }
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, static_cast<GLuint>(last_buffer));
+        glPixelStorei(GL_UNPACK_ALIGNMENT, last_alignment);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, last_row_length);
+
+        if (offset != 0)
+        {
+            buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            m_current    = (m_current + 1) % m_buffers.size();
+        }
+
+        return finished;
+    }
+} // namespace atlas::glx
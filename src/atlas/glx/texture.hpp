@@ -0,0 +1,116 @@
+#pragma once
+
+#include <GL/gl3w.h>
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace atlas::glx
+{
+    struct PixelFormat
+    {
+        GLenum internal_format;
+        GLenum format;
+    };
+
+    // Format of tightly packed 8-bit pixels with 1 to 4 channels.
+    PixelFormat pixel_format(int channels, bool is_srgb);
+
+    // Creates an immutable 2D texture with trilinear filtering if it has
+    // more than one level.
+    GLuint create_texture_2d(GLsizei width,
+                             GLsizei height,
+                             GLsizei levels,
+                             GLenum internal_format);
+
+    // Internal format of a block compressed texture, given the number of its
+    // BCn format: 1, 3, 4 or 5. BC4 and BC5 have no sRGB variant.
+    GLenum compressed_format(int bc, bool is_srgb);
+
+    struct BlockLevel
+    {
+        GLsizei width{0};
+        GLsizei height{0};
+        void const* blocks{nullptr};
+        GLsizei size{0};
+    };
+
+    // Creates an immutable 2D texture from already compressed levels, with
+    // the same sampling as create_texture_2d. The blocks are uploaded
+    // directly, so they can be freed as soon as this returns.
+    GLuint create_compressed_texture_2d(GLenum internal_format,
+                                        std::vector<BlockLevel> const& levels);
+
+    struct PixelLevel
+    {
+        GLsizei width{0};
+        GLsizei height{0};
+        void const* pixels{nullptr};
+    };
+
+    // Streams pixel data into textures through a ring of persistently mapped
+    // pixel unpack buffers. Each call to update fills at most one buffer and
+    // fences it, so the cost per frame is bounded by the buffer size no
+    // matter how many textures are queued, and a buffer is only reused once
+    // the GPU has finished reading from it. Levels larger than a buffer are
+    // split by rows across several frames.
+    //
+    // Must be created, updated and destroyed on the thread that owns the
+    // OpenGL context.
+    class TextureUploader
+    {
+    public:
+        explicit TextureUploader(std::size_t buffer_size  = std::size_t{16} << 20,
+                                 std::size_t buffer_count = 3);
+        ~TextureUploader();
+
+        TextureUploader(TextureUploader const&)            = delete;
+        TextureUploader& operator=(TextureUploader const&) = delete;
+
+        // Queues every level of texture, which must already have storage for
+        // them. The pixels are 8-bit with the given number of channels and
+        // must stay alive until they have been copied out; keep_alive is
+        // held until then.
+        void queue(GLuint texture,
+                   int channels,
+                   std::vector<PixelLevel> levels,
+                   std::shared_ptr<void const> keep_alive = {});
+
+        // Copies as much of the queue as fits in the next buffer and issues
+        // the uploads. Returns the textures whose last level was issued, which
+        // can be used by any command that follows. Call once per frame.
+        std::vector<GLuint> update();
+
+        // Number of textures still waiting for some of their levels.
+        std::size_t pending() const
+        {
+            return m_queue.size();
+        }
+
+    private:
+        struct Upload
+        {
+            GLuint texture;
+            GLenum format;
+            std::size_t pixel_size;
+            std::vector<PixelLevel> levels;
+            std::shared_ptr<void const> keep_alive;
+            std::size_t level{0};
+            GLsizei row{0};
+        };
+
+        struct Buffer
+        {
+            GLuint handle{0};
+            unsigned char* data{nullptr};
+            GLsync fence{nullptr};
+        };
+
+        std::size_t m_buffer_size;
+        std::vector<Buffer> m_buffers;
+        std::size_t m_current{0};
+        std::deque<Upload> m_queue;
+    };
+} // namespace atlas::glx
@@ -0,0 +1,92 @@
+#include "vertex_layout.hpp"
+
+#include <algorithm>
+
+namespace atlas::glx
+{
+    GLuint create_vertex_array(std::span<VertexAttribute const> attributes,
+                               GLuint binding)
+    {
+        GLuint vao;
+        glCreateVertexArrays(1, &vao);
+
+        for (auto const& attribute : attributes)
+        {
+            glEnableVertexArrayAttrib(vao, attribute.location);
+            if (attribute.kind == AttributeKind::integer)
+            {
+                glVertexArrayAttribIFormat(vao,
+                                           attribute.location,
+                                           attribute.components,
+                                           attribute.type,
+                                           attribute.offset);
+            }
+            else
+            {
+                glVertexArrayAttribFormat(
+                    vao,
+                    attribute.location,
+                    attribute.components,
+                    attribute.type,
+                    attribute.kind == AttributeKind::normalised ? GL_TRUE : GL_FALSE,
+                    attribute.offset);
+            }
+            glVertexArrayAttribBinding(vao, attribute.location, binding);
+        }
+
+        return vao;
+    }
+
+    void bind_vertex_buffers(GLuint vao,
+                             GLuint vertex_buffer,
+                             GLsizei stride,
+                             GLuint element_buffer,
+                             GLintptr offset,
+                             GLuint binding)
+    {
+        glVertexArrayVertexBuffer(vao, binding, vertex_buffer, offset, stride);
+        if (element_buffer != 0)
+        {
+            glVertexArrayElementBuffer(vao, element_buffer);
+        }
+    }
+
+    VertexFormatCache::~VertexFormatCache()
+    {
+        clear();
+    }
+
+    GLuint VertexFormatCache::get(std::span<VertexAttribute const> attributes)
+    {
+        auto it = std::find_if(m_formats.begin(),
+                               m_formats.end(),
+                               [attributes](Format const& format) {
+                                   return std::equal(format.attributes.begin(),
+                                                     format.attributes.end(),
+                                                     attributes.begin(),
+                                                     attributes.end());
+                               });
+        if (it != m_formats.end())
+        {
+            return it->vao;
+        }
+
+        auto vao = create_vertex_array(attributes);
+        m_formats.push_back({{attributes.begin(), attributes.end()}, vao});
+        return vao;
+    }
+
+    std::size_t VertexFormatCache::size() const
+    {
+        return m_formats.size();
+    }
+
+    void VertexFormatCache::clear()
+    {
+        for (auto& format : m_formats)
+        {
+            glDeleteVertexArrays(1, &format.vao);
+        }
+        m_formats.clear();
+    }
+} // namespace atlas::glx
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <GL/gl3w.h>
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace atlas::glx
+{
+    // How the shader sees an attribute: as floats, as integers normalised to
+    // [0, 1] or [-1, 1], or as integers.
+    enum class AttributeKind
+    {
+        floating,
+        normalised,
+        integer
+    };
+
+    // Number of components and OpenGL type of a vertex attribute of type T.
+    // Arrays, scalars and any vector type with a value_type and a static
+    // length(), such as glm's, are covered; other vector types can
+    // specialise this.
+    template<typename T, typename = void>
+    struct AttributeTraits;
+
+    template<typename T, GLenum Type>
+    struct ScalarAttributeTraits
+    {
+        using component_type              = T;
+        static constexpr GLint components = 1;
+        static constexpr GLenum type      = Type;
+        static constexpr AttributeKind kind =
+            std::is_floating_point_v<T> ? AttributeKind::floating
+                                        : AttributeKind::integer;
+    };
+
+    template<>
+    struct AttributeTraits<GLfloat> : ScalarAttributeTraits<GLfloat, GL_FLOAT>
+    {};
+
+    template<>
+    struct AttributeTraits<GLbyte> : ScalarAttributeTraits<GLbyte, GL_BYTE>
+    {};
+
+    template<>
+    struct AttributeTraits<GLubyte> : ScalarAttributeTraits<GLubyte, GL_UNSIGNED_BYTE>
+    {};
+
+    template<>
+    struct AttributeTraits<GLshort> : ScalarAttributeTraits<GLshort, GL_SHORT>
+    {};
+
+    template<>
+    struct AttributeTraits<GLushort> : ScalarAttributeTraits<GLushort, GL_UNSIGNED_SHORT>
+    {};
+
+    template<>
+    struct AttributeTraits<GLint> : ScalarAttributeTraits<GLint, GL_INT>
+    {};
+
+    template<>
+    struct AttributeTraits<GLuint> : ScalarAttributeTraits<GLuint, GL_UNSIGNED_INT>
+    {};
+
+    template<typename T, GLint N>
+    struct VectorAttributeTraits
+    {
+        static_assert(N >= 1 && N <= 4, "attributes have between 1 and 4 components");
+
+        using component_type                = typename AttributeTraits<T>::component_type;
+        static constexpr GLint components   = N;
+        static constexpr GLenum type        = AttributeTraits<T>::type;
+        static constexpr AttributeKind kind = AttributeTraits<T>::kind;
+    };
+
+    template<typename T, std::size_t N>
+    struct AttributeTraits<std::array<T, N>>
+        : VectorAttributeTraits<T, static_cast<GLint>(N)>
+    {};
+
+    template<typename T>
+    struct AttributeTraits<T,
+                           std::void_t<typename T::value_type, decltype(T::length())>>
+        : VectorAttributeTraits<typename T::value_type, static_cast<GLint>(T::length())>
+    {};
+
+    struct VertexAttribute
+    {
+        GLuint location{0};
+        GLint components{0};
+        GLenum type{GL_FLOAT};
+        AttributeKind kind{AttributeKind::floating};
+
+        // Offset from the start of the vertex and size, in bytes.
+        GLuint offset{0};
+        GLuint size{0};
+
+        constexpr bool operator==(VertexAttribute const&) const = default;
+    };
+
+    // Describes an attribute of type T at the given offset, usually given as
+    // offsetof(Vertex, member) with T as decltype(Vertex::member). The kind
+    // defaults to floating for floats and integer for integers.
+    template<typename T>
+    constexpr VertexAttribute
+    vertex_attribute(GLuint location,
+                     std::size_t offset,
+                     AttributeKind kind = AttributeTraits<T>::kind)
+    {
+        using Traits    = AttributeTraits<T>;
+        using Component = typename Traits::component_type;
+        static_assert(sizeof(T) == Traits::components * sizeof(Component),
+                      "attribute components must be tightly packed");
+
+        return {location,
+                Traits::components,
+                Traits::type,
+                kind,
+                static_cast<GLuint>(offset),
+                static_cast<GLuint>(sizeof(T))};
+    }
+
+    // Interleaved attributes read from a single buffer binding. The stride is
+    // the size of the vertex.
+    template<std::size_t N>
+    struct VertexLayout
+    {
+        std::array<VertexAttribute, N> attributes;
+        GLsizei stride{0};
+
+        // Every attribute must fit in the vertex, within the smallest
+        // relative offset OpenGL guarantees, and locations must be unique.
+        constexpr bool is_valid() const
+        {
+            for (std::size_t i{0}; i < N; ++i)
+            {
+                auto const& attribute = attributes[i];
+                if (attribute.components < 1 || attribute.components > 4 ||
+                    attribute.offset > 2047 ||
+                    attribute.offset + attribute.size > static_cast<GLuint>(stride))
+                {
+                    return false;
+                }
+
+                for (std::size_t j{0}; j < i; ++j)
+                {
+                    if (attributes[j].location == attribute.location)
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            return stride > 0;
+        }
+    };
+
+    template<typename Vertex, typename... Attributes>
+    constexpr VertexLayout<sizeof...(Attributes)>
+    make_vertex_layout(Attributes const&... attributes)
+    {
+        static_assert(std::is_standard_layout_v<Vertex>,
+                      "offsetof is only defined for standard layout vertices");
+        return {{attributes...}, static_cast<GLsizei>(sizeof(Vertex))};
+    }
+
+    // Creates a vertex array with the format of the attributes, all of them
+    // enabled and reading from the given buffer binding. Buffers are bound
+    // separately, so the same vertex array can draw any number of meshes.
+    GLuint create_vertex_array(std::span<VertexAttribute const> attributes,
+                               GLuint binding = 0);
+
+    template<std::size_t N>
+    GLuint create_vertex_array(VertexLayout<N> const& layout, GLuint binding = 0)
+    {
+        return create_vertex_array(std::span<VertexAttribute const>{layout.attributes},
+                                   binding);
+    }
+
+    // Points the vertex array at the buffers of a mesh. An element buffer of 0
+    // leaves the current one bound.
+    void bind_vertex_buffers(GLuint vao,
+                             GLuint vertex_buffer,
+                             GLsizei stride,
+                             GLuint element_buffer = 0,
+                             GLintptr offset       = 0,
+                             GLuint binding        = 0);
+
+    template<std::size_t N>
+    void bind_vertex_buffers(GLuint vao,
+                             VertexLayout<N> const& layout,
+                             GLuint vertex_buffer,
+                             GLuint element_buffer = 0,
+                             GLintptr offset       = 0,
+                             GLuint binding        = 0)
+    {
+        bind_vertex_buffers(
+            vao, vertex_buffer, layout.stride, element_buffer, offset, binding);
+    }
+
+    // Vertex arrays shared between all the layouts with the same attributes.
+    // The stride is not part of the format, so vertices of different sizes
+    // with the same attributes share one too. Switching between meshes with
+    // the same format then only needs bind_vertex_buffers.
+    //
+    // Must be used and destroyed on the thread that owns the OpenGL context.
+    class VertexFormatCache
+    {
+    public:
+        VertexFormatCache() = default;
+        ~VertexFormatCache();
+
+        VertexFormatCache(VertexFormatCache const&)            = delete;
+        VertexFormatCache& operator=(VertexFormatCache const&) = delete;
+
+        // Returns the vertex array for the attributes, creating it the first
+        // time they are seen.
+        GLuint get(std::span<VertexAttribute const> attributes);
+
+        template<std::size_t N>
+        GLuint get(VertexLayout<N> const& layout)
+        {
+            return get(std::span<VertexAttribute const>{layout.attributes});
+        }
+
+        std::size_t size() const;
+        void clear();
+
+    private:
+        struct Format
+        {
+            std::vector<VertexAttribute> attributes;
+            GLuint vao;
+        };
+
+        // Programs use a handful of formats, so a linear search is enough.
+        std::vector<Format> m_formats;
+    };
+} // namespace atlas::glx
@@ -2,6 +2,7 @@
 
 #include <atlas/glx/buffer.hpp>
 #include <atlas/glx/glsl.hpp>
+#include <atlas/glx/vertex_layout.hpp>
 #include <zeus/platform.hpp>
 
 #include <fmt/printf.h>
@@ -22,9 +23,33 @@
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
+
+namespace atlas::glx
+{
+    template<>
+    struct AttributeTraits<ImVec2> : VectorAttributeTraits<float, 2>
+    {};
+} // namespace atlas::glx
 
 namespace atlas::gui
 {
+    namespace
+    {
+        using Position = decltype(ImDrawVert::pos);
+        using UV       = decltype(ImDrawVert::uv);
+
+        // The colour is packed into an ImU32, so it is read as four bytes.
+        using Colour = std::array<GLubyte, 4>;
+
+        constexpr auto ui_vertex_layout = glx::make_vertex_layout<ImDrawVert>(
+            glx::vertex_attribute<Position>(0, offsetof(ImDrawVert, pos)),
+            glx::vertex_attribute<UV>(1, offsetof(ImDrawVert, uv)),
+            glx::vertex_attribute<Colour>(
+                2, offsetof(ImDrawVert, col), glx::AttributeKind::normalised));
+        static_assert(ui_vertex_layout.is_valid());
+    } // namespace
+
     void render_draw_data(UIRenderData const& data, ImDrawData* drawData);
     bool create_fonts_texture(UIRenderData& data);
     void destroy_fonts_texture(UIRenderData& data);
@@ -236,8 +261,7 @@ namespace atlas::gui
     static void setupRenderState(UIRenderData const& render_data,
                                  ImDrawData* draw_data,
                                  int fb_width,
-                                 int fb_height,
-                                 GLuint vao)
+                                 int fb_height)
     {
         glEnable(GL_BLEND);
         glBlendEquation(GL_FUNC_ADD);
@@ -270,31 +294,7 @@ namespace atlas::gui
                            &ortho_projection[0][0]);
         glBindSampler(0, 0);
 
-        glBindVertexArray(vao);
-
-        glBindBuffer(GL_ARRAY_BUFFER, render_data.vbo_handle);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, render_data.elements_handle);
-        glEnableVertexAttribArray(render_data.vtx_pos_attrib_location);
-        glEnableVertexAttribArray(render_data.vts_uv_attrib_location);
-        glEnableVertexAttribArray(render_data.vtx_colour_attrib_location);
-        glVertexAttribPointer(render_data.vtx_pos_attrib_location,
-                              2,
-                              GL_FLOAT,
-                              GL_FALSE,
-                              sizeof(ImDrawVert),
-                              reinterpret_cast<GLvoid*>(IM_OFFSETOF(ImDrawVert, pos)));
-        glVertexAttribPointer(render_data.vts_uv_attrib_location,
-                              2,
-                              GL_FLOAT,
-                              GL_FALSE,
-                              sizeof(ImDrawVert),
-                              reinterpret_cast<GLvoid*>(IM_OFFSETOF(ImDrawVert, uv)));
-        glVertexAttribPointer(render_data.vtx_colour_attrib_location,
-                              4,
-                              GL_UNSIGNED_BYTE,
-                              GL_TRUE,
-                              sizeof(ImDrawVert),
-                              reinterpret_cast<GLvoid*>(IM_OFFSETOF(ImDrawVert, col)));
+        glBindVertexArray(render_data.vao_handle);
     }
 
     void render_draw_data(UIRenderData const& render_data, ImDrawData* draw_data)
@@ -319,7 +319,7 @@ namespace atlas::gui
         GLint last_sampler;
         glGetIntegerv(GL_SAMPLER_BINDING, &last_sampler);
         GLint last_array_buffer;
-        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_array_buffer);
+        glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
         GLint last_vertex_array_object;
         glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_vertex_array_object);
 
@@ -352,9 +352,7 @@ namespace atlas::gui
         glGetIntegerv(GL_CLIP_ORIGIN, &last_clip_origin);
         bool is_clip_origin_lower_left = (last_clip_origin != GL_UPPER_LEFT);
 
-        GLuint vao{0};
-        glGenVertexArrays(1, &vao);
-        setupRenderState(render_data, draw_data, fb_width, fb_height, vao);
+        setupRenderState(render_data, draw_data, fb_width, fb_height);
 
         ImVec2 clip_off   = draw_data->DisplayPos;
         ImVec2 clip_scale = draw_data->FramebufferScale;
@@ -363,14 +361,14 @@ namespace atlas::gui
         {
             const ImDrawList* cmd_list = draw_data->CmdLists[n];
 
-            glBufferData(GL_ARRAY_BUFFER,
-                         glx::size<ImDrawVert>(cmd_list->VtxBuffer.Size),
-                         static_cast<const GLvoid*>(cmd_list->VtxBuffer.Data),
-                         GL_STREAM_DRAW);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                         glx::size<ImDrawIdx>(cmd_list->IdxBuffer.Size),
-                         static_cast<const GLvoid*>(cmd_list->IdxBuffer.Data),
-                         GL_STREAM_DRAW);
+            glNamedBufferData(render_data.vbo_handle,
+                              glx::size<ImDrawVert>(cmd_list->VtxBuffer.Size),
+                              static_cast<const GLvoid*>(cmd_list->VtxBuffer.Data),
+                              GL_STREAM_DRAW);
+            glNamedBufferData(render_data.elements_handle,
+                              glx::size<ImDrawIdx>(cmd_list->IdxBuffer.Size),
+                              static_cast<const GLvoid*>(cmd_list->IdxBuffer.Data),
+                              GL_STREAM_DRAW);
 
             for (int cmdI{0}; cmdI < cmd_list->CmdBuffer.Size; ++cmdI)
             {
@@ -379,11 +377,7 @@ namespace atlas::gui
                 {
                     if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
                     {
-                        setupRenderState(render_data,
-                                         draw_data,
-                                         fb_width,
-                                         fb_height,
-                                         vao);
+                        setupRenderState(render_data, draw_data, fb_width, fb_height);
                     }
                     else
                     {
@@ -429,8 +423,6 @@ namespace atlas::gui
             }
         }
 
-        glDeleteVertexArrays(1, &vao);
-
         glUseProgram(last_program);
         glBindTexture(GL_TEXTURE_2D, last_texture);
         glBindSampler(0, last_sampler);
@@ -597,15 +589,18 @@ namespace atlas::gui
             return false;
         }
 
-        auto& handle                    = data.shader_handle;
-        data.tex_attrib_location        = glGetUniformLocation(handle, "Texture");
-        data.proj_mtx_attrib_location   = glGetUniformLocation(handle, "ProjMtx");
-        data.vtx_pos_attrib_location    = glGetAttribLocation(handle, "Position");
-        data.vts_uv_attrib_location     = glGetAttribLocation(handle, "UV");
-        data.vtx_colour_attrib_location = glGetAttribLocation(handle, "Color");
+        // The attribute locations are fixed by the shader and ui_vertex_layout.
+        auto& handle                  = data.shader_handle;
+        data.tex_attrib_location      = glGetUniformLocation(handle, "Texture");
+        data.proj_mtx_attrib_location = glGetUniformLocation(handle, "ProjMtx");
 
-        glGenBuffers(1, &data.vbo_handle);
-        glGenBuffers(1, &data.elements_handle);
+        // The buffers never change, so they are bound to the vertex array
+        // once and only their contents are replaced every frame.
+        glCreateBuffers(1, &data.vbo_handle);
+        glCreateBuffers(1, &data.elements_handle);
+        data.vao_handle = glx::create_vertex_array(ui_vertex_layout);
+        glx::bind_vertex_buffers(
+            data.vao_handle, ui_vertex_layout, data.vbo_handle, data.elements_handle);
 
         create_fonts_texture(data);
 
@@ -618,6 +613,12 @@ namespace atlas::gui
 
     void destroy_device_objects(UIRenderData& data)
     {
+        if (data.vao_handle != 0u)
+        {
+            glDeleteVertexArrays(1, &data.vao_handle);
+            data.vao_handle = 0;
+        }
+
         if (data.vbo_handle != 0u)
         {
             glDeleteBuffers(1, &data.vbo_handle);
@@ -19,12 +19,9 @@ namespace atlas::gui
         int tex_attrib_location{};
         int proj_mtx_attrib_location{};
 
-        int vtx_pos_attrib_location{};
-        int vts_uv_attrib_location{};
-        int vtx_colour_attrib_location{};
-
         GLuint vbo_handle{};
         GLuint elements_handle{};
+        GLuint vao_handle{};
     };
 
     struct UIWindowData
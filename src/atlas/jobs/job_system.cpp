@@ -0,0 +1,478 @@
+#include "job_system.hpp"
+
+#include <cassert>
+#include <exception>
+#include <limits>
+
+namespace atlas::jobs
+{
+    namespace detail
+    {
+        struct Job
+        {
+            std::function<void()> fn;
+            Job* parent{nullptr};
+            bool main{false};
+
+            // Owners of the job: every handle plus the scheduler, which lets
+            // go once the job has finished.
+            std::atomic<std::uint32_t> refs{1};
+
+            // The job itself plus every child that has not finished yet.
+            std::atomic<std::uint32_t> unfinished{1};
+
+            // Dependencies that have not finished yet plus one while the job
+            // is being set up.
+            std::atomic<std::uint32_t> blockers{1};
+
+            std::atomic<bool> done{false};
+
+            std::mutex mutex;
+            bool finished{false};
+            std::vector<Job*> continuations;
+            std::exception_ptr error;
+        };
+    } // namespace detail
+
+    namespace
+    {
+        constexpr auto no_worker = std::numeric_limits<std::size_t>::max();
+
+        thread_local JobSystem const* current_system{nullptr};
+        thread_local std::size_t current_worker{no_worker};
+
+        void retain(detail::Job* job)
+        {
+            job->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void release(detail::Job* job)
+        {
+            if (job->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                delete job;
+            }
+        }
+    } // namespace
+
+    JobHandle::JobHandle(detail::Job* job) :
+        m_job{job}
+    {
+        retain(m_job);
+    }
+
+    JobHandle::JobHandle(JobHandle const& other) :
+        m_job{other.m_job}
+    {
+        if (m_job != nullptr)
+        {
+            retain(m_job);
+        }
+    }
+
+    JobHandle::JobHandle(JobHandle&& other) noexcept :
+        m_job{other.m_job}
+    {
+        other.m_job = nullptr;
+    }
+
+    JobHandle::~JobHandle()
+    {
+        if (m_job != nullptr)
+        {
+            release(m_job);
+        }
+    }
+
+    JobHandle& JobHandle::operator=(JobHandle const& other)
+    {
+        JobHandle copy{other};
+        std::swap(m_job, copy.m_job);
+        return *this;
+    }
+
+    JobHandle& JobHandle::operator=(JobHandle&& other) noexcept
+    {
+        std::swap(m_job, other.m_job);
+        return *this;
+    }
+
+    bool JobHandle::done() const
+    {
+        return m_job != nullptr && m_job->done.load(std::memory_order_acquire);
+    }
+
+    JobSystem::JobSystem(std::size_t thread_count) :
+        m_main_thread{std::this_thread::get_id()}
+    {
+        if (thread_count == 0)
+        {
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // Create every deque before starting any thread, since workers steal
+        // from each other as soon as they start.
+        for (std::size_t i{0}; i + 1 < thread_count; ++i)
+        {
+            m_workers.push_back(std::make_unique<Worker>());
+        }
+
+        for (std::size_t i{0}; i < m_workers.size(); ++i)
+        {
+            m_workers[i]->thread = std::thread{[this, i]() {
+                worker_main(i);
+            }};
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        // Any other thread would wait forever on pending main-thread jobs,
+        // and a worker would end up joining itself.
+        assert(std::this_thread::get_id() == m_main_thread);
+
+        while (m_live.load(std::memory_order_acquire) != 0)
+        {
+            if (run_main_one())
+            {
+                continue;
+            }
+
+            if (!run_one(no_worker))
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        {
+            std::scoped_lock lock{m_wake_mutex};
+            m_stop = true;
+        }
+        m_wake.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            worker->thread.join();
+        }
+    }
+
+    JobHandle JobSystem::submit(std::function<void()> fn,
+                                std::span<JobHandle const> dependencies)
+    {
+        auto job = create(std::move(fn), nullptr, false);
+        for (auto const& dependency : dependencies)
+        {
+            add_dependency(job, dependency);
+        }
+        schedule(job);
+        return job;
+    }
+
+    JobHandle JobSystem::then(JobHandle const& job, std::function<void()> fn)
+    {
+        return submit(std::move(fn), std::span{&job, 1});
+    }
+
+    JobHandle JobSystem::submit_main(std::function<void()> fn,
+                                     std::span<JobHandle const> dependencies)
+    {
+        auto job = create(std::move(fn), nullptr, true);
+        for (auto const& dependency : dependencies)
+        {
+            add_dependency(job, dependency);
+        }
+        schedule(job);
+        return job;
+    }
+
+    std::size_t JobSystem::run_main_thread_jobs()
+    {
+        std::size_t count{0};
+        while (run_main_one())
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    void JobSystem::wait(JobHandle const& handle)
+    {
+        auto job = handle.m_job;
+        if (job == nullptr)
+        {
+            return;
+        }
+
+        bool is_main = std::this_thread::get_id() == m_main_thread;
+        auto self    = (current_system == this) ? current_worker : no_worker;
+        while (!job->done.load(std::memory_order_acquire))
+        {
+            if (is_main && run_main_one())
+            {
+                continue;
+            }
+
+            if (!run_one(self))
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        std::exception_ptr error;
+        {
+            std::scoped_lock lock{job->mutex};
+            error = job->error;
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    JobHandle
+    JobSystem::create(std::function<void()> fn, JobHandle const* parent, bool main)
+    {
+        auto job  = new detail::Job{};
+        job->fn   = std::move(fn);
+        job->main = main;
+        if (parent != nullptr && parent->m_job != nullptr)
+        {
+            job->parent = parent->m_job;
+            job->parent->unfinished.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        m_live.fetch_add(1, std::memory_order_relaxed);
+
+        // The handle takes its own reference, the one the job was created with
+        // belongs to the scheduler.
+        return JobHandle{job};
+    }
+
+    void JobSystem::add_dependency(JobHandle const& job, JobHandle const& dependency)
+    {
+        if (dependency.m_job == nullptr)
+        {
+            return;
+        }
+
+        auto dep = dependency.m_job;
+        std::scoped_lock lock{dep->mutex};
+        if (!dep->finished)
+        {
+            job.m_job->blockers.fetch_add(1, std::memory_order_relaxed);
+            dep->continuations.push_back(job.m_job);
+        }
+    }
+
+    void JobSystem::schedule(JobHandle const& job)
+    {
+        release_blocker(job.m_job);
+    }
+
+    void JobSystem::release_blocker(detail::Job* job)
+    {
+        if (job->blockers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            enqueue(job);
+        }
+    }
+
+    void JobSystem::enqueue(detail::Job* job)
+    {
+        if (job->main)
+        {
+            std::scoped_lock lock{m_main_mutex};
+            m_main.push_back(job);
+            return;
+        }
+
+        // Count the job before it becomes visible so the counter never drops
+        // below the number of queued jobs. This is paired with the increment
+        // of m_sleeping in worker_main: either the worker sees the new job
+        // before sleeping or we see the sleeper.
+        m_pending.fetch_add(1, std::memory_order_seq_cst);
+        if (current_system == this)
+        {
+            m_workers[current_worker]->deque.push(job);
+        }
+        else
+        {
+            std::scoped_lock lock{m_shared_mutex};
+            m_shared.push_back(job);
+        }
+
+        if (m_sleeping.load(std::memory_order_seq_cst) != 0)
+        {
+            {
+                std::scoped_lock lock{m_wake_mutex};
+            }
+            m_wake.notify_one();
+        }
+    }
+
+    void JobSystem::run(detail::Job* job)
+    {
+        if (job->fn)
+        {
+            try
+            {
+                job->fn();
+            }
+            catch (...)
+            {
+                std::scoped_lock lock{job->mutex};
+                if (!job->error)
+                {
+                    job->error = std::current_exception();
+                }
+            }
+
+            // Release whatever the job captured as soon as possible.
+            job->fn = nullptr;
+        }
+
+        finish(job);
+    }
+
+    void JobSystem::finish(detail::Job* job)
+    {
+        if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+
+        std::vector<detail::Job*> continuations;
+        std::exception_ptr error;
+        {
+            std::scoped_lock lock{job->mutex};
+            job->finished = true;
+            std::swap(continuations, job->continuations);
+            error = job->error;
+        }
+
+        auto parent = job->parent;
+        if (parent != nullptr && error)
+        {
+            std::scoped_lock lock{parent->mutex};
+            if (!parent->error)
+            {
+                parent->error = error;
+            }
+        }
+
+        job->done.store(true, std::memory_order_release);
+        for (auto continuation : continuations)
+        {
+            release_blocker(continuation);
+        }
+
+        if (parent != nullptr)
+        {
+            finish(parent);
+        }
+
+        release(job);
+
+        // Must be the last access to the system, since the destructor may
+        // proceed as soon as this reaches zero.
+        m_live.fetch_sub(1, std::memory_order_release);
+    }
+
+    bool JobSystem::run_one(std::size_t self)
+    {
+        std::optional<detail::Job*> job;
+        if (self != no_worker)
+        {
+            job = m_workers[self]->deque.pop();
+        }
+
+        if (!job)
+        {
+            std::scoped_lock lock{m_shared_mutex};
+            if (!m_shared.empty())
+            {
+                job = m_shared.front();
+                m_shared.pop_front();
+            }
+        }
+
+        auto count = m_workers.size();
+        auto start = (self != no_worker) ? self + 1 : 0;
+        for (std::size_t i{0}; !job && i < count; ++i)
+        {
+            auto victim = (start + i) % count;
+            if (victim != self)
+            {
+                job = m_workers[victim]->deque.steal();
+            }
+        }
+
+        if (!job)
+        {
+            return false;
+        }
+
+        m_pending.fetch_sub(1, std::memory_order_relaxed);
+        run(*job);
+        return true;
+    }
+
+    bool JobSystem::run_main_one()
+    {
+        detail::Job* job{nullptr};
+        {
+            std::scoped_lock lock{m_main_mutex};
+            if (m_main.empty())
+            {
+                return false;
+            }
+
+            job = m_main.front();
+            m_main.pop_front();
+        }
+
+        run(job);
+        return true;
+    }
+
+    void JobSystem::worker_main(std::size_t index)
+    {
+        current_system = this;
+        current_worker = index;
+
+        while (true)
+        {
+            if (run_one(index))
+            {
+                continue;
+            }
+
+            // Spin for a little while before going to sleep, new work tends to
+            // arrive in bursts.
+            bool found{false};
+            for (int i{0}; i < 64 && !found; ++i)
+            {
+                std::this_thread::yield();
+                found = run_one(index);
+            }
+
+            if (found)
+            {
+                continue;
+            }
+
+            std::unique_lock lock{m_wake_mutex};
+            m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+            m_wake.wait(lock, [this]() {
+                return m_stop || m_pending.load(std::memory_order_seq_cst) != 0;
+            });
+            m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+
+            if (m_stop)
+            {
+                return;
+            }
+        }
+    }
+} // namespace atlas::jobs
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "work_stealing_deque.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace atlas::jobs
+{
+    namespace detail
+    {
+        struct Job;
+    }
+
+    // Shared reference to a job submitted to a JobSystem. Handles keep the
+    // job's bookkeeping alive, so they can be queried or waited on after the
+    // job has finished.
+    class JobHandle
+    {
+    public:
+        JobHandle() = default;
+        JobHandle(JobHandle const& other);
+        JobHandle(JobHandle&& other) noexcept;
+        ~JobHandle();
+
+        JobHandle& operator=(JobHandle const& other);
+        JobHandle& operator=(JobHandle&& other) noexcept;
+
+        bool valid() const
+        {
+            return m_job != nullptr;
+        }
+
+        // True once the job and all of its children have finished.
+        bool done() const;
+
+    private:
+        friend class JobSystem;
+
+        explicit JobHandle(detail::Job* job);
+
+        detail::Job* m_job{nullptr};
+    };
+
+    // Task scheduler built around per-worker Chase-Lev deques. Workers run
+    // the jobs they spawn themselves in LIFO order and steal the oldest jobs
+    // of other workers when they run out, which keeps related work on the
+    // same core while balancing the load. Jobs submitted from other threads
+    // go through a shared queue.
+    //
+    // Jobs may depend on other jobs, in which case they are only scheduled
+    // once all of their dependencies have finished. A job that throws still
+    // counts as finished; the exception is rethrown by wait.
+    //
+    // Jobs submitted with submit_main never run on a worker. They are run by
+    // the thread that created the system whenever it calls
+    // run_main_thread_jobs or waits, which makes them suitable for anything
+    // that needs the OpenGL context.
+    class JobSystem
+    {
+    public:
+        // A thread_count of 0 uses one thread per hardware thread. The
+        // thread that creates the system counts as one of them, since it
+        // helps run jobs while it waits.
+        explicit JobSystem(std::size_t thread_count = 0);
+
+        // Finishes every outstanding job before joining the workers. Must be
+        // called from the thread that created the system, since it is the
+        // only one that can run the outstanding main-thread jobs.
+        ~JobSystem();
+
+        JobSystem(JobSystem const&)            = delete;
+        JobSystem& operator=(JobSystem const&) = delete;
+
+        std::size_t thread_count() const
+        {
+            return m_workers.size() + 1;
+        }
+
+        JobHandle submit(std::function<void()> fn,
+                         std::span<JobHandle const> dependencies = {});
+
+        // Runs fn once job has finished.
+        JobHandle then(JobHandle const& job, std::function<void()> fn);
+
+        JobHandle submit_main(std::function<void()> fn,
+                              std::span<JobHandle const> dependencies = {});
+
+        // Runs the main-thread jobs that are ready and returns how many ran.
+        // Must be called from the thread that created the system.
+        std::size_t run_main_thread_jobs();
+
+        // Blocks until job has finished, running other jobs in the meantime.
+        // Rethrows the first exception thrown by the job or its children.
+        void wait(JobHandle const& job);
+
+        // Calls fn(begin, end) over consecutive chunks of [0, count) of at
+        // most grain_size elements each and waits for all of them. A
+        // grain_size of 0 splits the range into a few chunks per thread.
+        template<typename Fn>
+        void parallel_for(std::size_t count, std::size_t grain_size, Fn&& fn)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            if (grain_size == 0)
+            {
+                grain_size = std::max<std::size_t>(1, count / (thread_count() * 4));
+            }
+
+            if (grain_size >= count)
+            {
+                fn(std::size_t{0}, count);
+                return;
+            }
+
+            auto root = create({}, nullptr, false);
+            for (std::size_t begin{0}; begin < count; begin += grain_size)
+            {
+                auto end = std::min(begin + grain_size, count);
+                schedule(create(
+                    [&fn, begin, end]() {
+                        fn(begin, end);
+                    },
+                    &root,
+                    false));
+            }
+            schedule(root);
+            wait(root);
+        }
+
+    private:
+        struct Worker
+        {
+            WorkStealingDeque<detail::Job*> deque;
+            std::thread thread;
+        };
+
+        JobHandle create(std::function<void()> fn, JobHandle const* parent, bool main);
+        void add_dependency(JobHandle const& job, JobHandle const& dependency);
+        void schedule(JobHandle const& job);
+
+        void enqueue(detail::Job* job);
+        void release_blocker(detail::Job* job);
+        void run(detail::Job* job);
+        void finish(detail::Job* job);
+
+        bool run_one(std::size_t self);
+        bool run_main_one();
+        void worker_main(std::size_t index);
+
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::thread::id m_main_thread;
+
+        std::mutex m_shared_mutex;
+        std::deque<detail::Job*> m_shared;
+
+        std::mutex m_main_mutex;
+        std::deque<detail::Job*> m_main;
+
+        std::mutex m_wake_mutex;
+        std::condition_variable m_wake;
+        std::atomic<std::size_t> m_pending{0};
+        std::atomic<std::size_t> m_sleeping{0};
+        std::atomic<std::size_t> m_live{0};
+        bool m_stop{false};
+    };
+} // namespace atlas::jobs
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace atlas::jobs
+{
+    // Lock-free Chase-Lev deque. A single owner thread pushes and pops at the
+    // bottom while any number of thieves steal from the top. The memory
+    // orderings follow Lê et al., "Correct and Efficient Work-Stealing for
+    // Weak Memory Models" (PPoPP 2013).
+    //
+    // The buffer grows when full. Old buffers are kept alive until the deque
+    // is destroyed, since a thief may still be reading from them.
+    template<typename T>
+    class WorkStealingDeque
+    {
+    public:
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "deque elements must be trivially copyable");
+
+        explicit WorkStealingDeque(std::size_t capacity = 1024)
+        {
+            std::size_t size{1};
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+
+            m_buffers.push_back(std::make_unique<Buffer>(size));
+            m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+        }
+
+        WorkStealingDeque(WorkStealingDeque const&)            = delete;
+        WorkStealingDeque& operator=(WorkStealingDeque const&) = delete;
+
+        // Owner only.
+        void push(T item)
+        {
+            auto b = m_bottom.load(std::memory_order_relaxed);
+            auto t = m_top.load(std::memory_order_acquire);
+            auto a = m_buffer.load(std::memory_order_relaxed);
+
+            if (b - t > static_cast<std::int64_t>(a->capacity()) - 1)
+            {
+                a = grow(a, t, b);
+            }
+
+            a->put(b, item);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        // Owner only.
+        std::optional<T> pop()
+        {
+            auto b = m_bottom.load(std::memory_order_relaxed) - 1;
+            auto a = m_buffer.load(std::memory_order_relaxed);
+            m_bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto t = m_top.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                // Empty.
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                return {};
+            }
+
+            T item = a->get(b);
+            if (t == b)
+            {
+                // Last item, race against thieves for it.
+                bool won = m_top.compare_exchange_strong(
+                    t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                if (!won)
+                {
+                    return {};
+                }
+            }
+
+            return item;
+        }
+
+        // Any thread. Also returns nothing when it loses a race with another
+        // thief or the owner, so an empty result does not mean the deque is
+        // empty.
+        std::optional<T> steal()
+        {
+            auto t = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto b = m_bottom.load(std::memory_order_acquire);
+
+            if (t >= b)
+            {
+                return {};
+            }
+
+            auto a = m_buffer.load(std::memory_order_acquire);
+            T item = a->get(t);
+            if (!m_top.compare_exchange_strong(
+                    t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return {};
+            }
+
+            return item;
+        }
+
+        // Approximate when called concurrently with other operations.
+        std::size_t size() const
+        {
+            auto b = m_bottom.load(std::memory_order_relaxed);
+            auto t = m_top.load(std::memory_order_relaxed);
+            return (b > t) ? static_cast<std::size_t>(b - t) : 0;
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        std::size_t capacity() const
+        {
+            return m_buffer.load(std::memory_order_relaxed)->capacity();
+        }
+
+    private:
+        class Buffer
+        {
+        public:
+            explicit Buffer(std::size_t capacity) :
+                m_mask{capacity - 1},
+                m_data{std::make_unique<std::atomic<T>[]>(capacity)}
+            {}
+
+            std::size_t capacity() const
+            {
+                return m_mask + 1;
+            }
+
+            T get(std::int64_t i) const
+            {
+                return m_data[static_cast<std::size_t>(i) & m_mask].load(
+                    std::memory_order_relaxed);
+            }
+
+            void put(std::int64_t i, T item)
+            {
+                m_data[static_cast<std::size_t>(i) & m_mask].store(
+                    item, std::memory_order_relaxed);
+            }
+
+        private:
+            std::size_t m_mask;
+            std::unique_ptr<std::atomic<T>[]> m_data;
+        };
+
+        Buffer* grow(Buffer* old, std::int64_t top, std::int64_t bottom)
+        {
+            m_buffers.push_back(std::make_unique<Buffer>(old->capacity() * 2));
+            auto a = m_buffers.back().get();
+            for (auto i = top; i < bottom; ++i)
+            {
+                a->put(i, old->get(i));
+            }
+
+            m_buffer.store(a, std::memory_order_release);
+            return a;
+        }
+
+        // Keep the two ends on separate cache lines so the owner and the
+        // thieves don't invalidate each other on every operation.
+        alignas(64) std::atomic<std::int64_t> m_top{0};
+        alignas(64) std::atomic<std::int64_t> m_bottom{0};
+        alignas(64) std::atomic<Buffer*> m_buffer{nullptr};
+
+        // Owner only.
+        std::vector<std::unique_ptr<Buffer>> m_buffers;
+    };
+} // namespace atlas::jobs
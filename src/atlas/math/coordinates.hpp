@@ -1,18 +1,27 @@
 #pragma once
 
 #include "glm.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <span>
 
 namespace atlas::math
 {
-    glm::vec3 cartesian_to_spherical(glm::vec3 const& p)
+    inline glm::vec3 cartesian_to_spherical(glm::vec3 const& p)
     {
+        // The polar angle is acos(z / r), but near the poles acos amplifies
+        // the rounding error of z / r. atan2 is well conditioned everywhere.
         float r     = glm::length(p);
-        float theta = glm::atan(p.y / p.x);
-        float phi   = glm::acos(p.z / r);
+        float theta = glm::atan(p.y, p.x);
+        float phi   = glm::atan(glm::length(glm::vec2{p}), p.z);
         return {r, theta, phi};
     }
 
-    glm::vec3 spherical_to_cartesian(glm::vec3 const& p)
+    inline glm::vec3 spherical_to_cartesian(glm::vec3 const& p)
     {
         float x = p.r * glm::cos(p.y) * glm::sin(p.z);
         float y = p.r * glm::sin(p.y) * glm::sin(p.z);
@@ -20,31 +29,241 @@ namespace atlas::math
         return {x, y, z};
     }
 
-    glm::vec3 cartesian_to_cylindrical(glm::vec3 const& p)
+    inline glm::vec3 cartesian_to_cylindrical(glm::vec3 const& p)
     {
         float r     = glm::length(glm::vec2{p});
-        float theta = glm::atan(p.y / p.x);
+        float theta = glm::atan(p.y, p.x);
         return {r, theta, p.z};
     }
 
-    glm::vec3 cylindrical_to_cartesian(glm::vec3 const& p)
+    inline glm::vec3 cylindrical_to_cartesian(glm::vec3 const& p)
     {
         float x = p.x * glm::cos(p.y);
         float y = p.x * glm::sin(p.y);
         return {x, y, p.z};
     }
 
-    glm::vec2 cartesian_to_polar(glm::vec2 const& p)
+    inline glm::vec2 cartesian_to_polar(glm::vec2 const& p)
     {
         float r     = glm::length(p);
-        float theta = glm::atan(p.y / p.x);
+        float theta = glm::atan(p.y, p.x);
         return {r, theta};
     }
 
-    glm::vec2 polar_to_cartesian(glm::vec2 const& p)
+    inline glm::vec2 polar_to_cartesian(glm::vec2 const& p)
     {
         float x = p.r * glm::cos(p.y);
         float y = p.r * glm::sin(p.y);
         return {x, y};
     }
+
+    // Both modes process W points at a time. Exact does the arithmetic and
+    // square roots in packs but evaluates atan2, sin and cos lane by lane with
+    // the std functions, in the same order as the scalar functions above, so
+    // the results match them exactly (unless the compiler is allowed to fuse
+    // multiply-adds, which it may do differently in the two versions). Fast
+    // uses the polynomial approximations from simd.hpp instead, whose errors
+    // are documented there.
+    enum class Accuracy
+    {
+        exact,
+        fast
+    };
+
+    namespace detail
+    {
+        template<std::size_t W, typename Vec, typename Exact, typename Fast>
+        void convert_batch(std::span<Vec const> in,
+                           std::span<Vec> out,
+                           Accuracy accuracy,
+                           Exact&& exact,
+                           Fast&& fast)
+        {
+            using P          = simd::Pack<float, W>;
+            constexpr auto L = static_cast<std::size_t>(Vec::length());
+
+            assert(out.size() >= in.size());
+
+            // Points are transposed into one pack per component. The last
+            // pack is padded so every point goes through the same code path.
+            for (std::size_t i{0}; i < in.size(); i += W)
+            {
+                auto count = std::min(W, in.size() - i);
+
+                alignas(64) std::array<std::array<float, W>, L> lanes{};
+                for (std::size_t lane{0}; lane < count; ++lane)
+                {
+                    for (std::size_t k{0}; k < L; ++k)
+                    {
+                        lanes[k][lane] = in[i + lane][static_cast<glm::length_t>(k)];
+                    }
+                }
+
+                std::array<P, L> p;
+                for (std::size_t k{0}; k < L; ++k)
+                {
+                    p[k] = P::load(lanes[k].data());
+                }
+
+                if (accuracy == Accuracy::exact)
+                {
+                    exact(p);
+                }
+                else
+                {
+                    fast(p);
+                }
+
+                for (std::size_t k{0}; k < L; ++k)
+                {
+                    p[k].store(lanes[k].data());
+                }
+
+                for (std::size_t lane{0}; lane < count; ++lane)
+                {
+                    for (std::size_t k{0}; k < L; ++k)
+                    {
+                        out[i + lane][static_cast<glm::length_t>(k)] = lanes[k][lane];
+                    }
+                }
+            }
+        }
+    } // namespace detail
+
+    // Batched conversions over arrays of points. out must hold at least as
+    // many points as in and may be the same array.
+    template<std::size_t W = simd::native_width<float>>
+    void cartesian_to_spherical_batch(std::span<glm::vec3 const> in,
+                                      std::span<glm::vec3> out,
+                                      Accuracy accuracy = Accuracy::exact)
+    {
+        using P = simd::Pack<float, W>;
+        detail::convert_batch<W>(
+            in,
+            out,
+            accuracy,
+            [](std::array<P, 3>& p) {
+                auto xy    = p[0] * p[0] + p[1] * p[1];
+                auto r     = sqrt(xy + p[2] * p[2]);
+                auto theta = simd::atan2(p[1], p[0]);
+                auto phi   = simd::atan2(sqrt(xy), p[2]);
+                p          = {r, theta, phi};
+            },
+            [](std::array<P, 3>& p) {
+                auto xy    = p[0] * p[0] + p[1] * p[1];
+                auto r     = sqrt(xy + p[2] * p[2]);
+                auto theta = simd::fast_atan2(p[1], p[0]);
+                auto phi   = simd::fast_atan2(sqrt(xy), p[2]);
+                p          = {r, theta, phi};
+            });
+    }
+
+    template<std::size_t W = simd::native_width<float>>
+    void spherical_to_cartesian_batch(std::span<glm::vec3 const> in,
+                                      std::span<glm::vec3> out,
+                                      Accuracy accuracy = Accuracy::exact)
+    {
+        using P = simd::Pack<float, W>;
+        detail::convert_batch<W>(
+            in,
+            out,
+            accuracy,
+            [](std::array<P, 3>& p) {
+                auto sin_phi = simd::sin(p[2]);
+                auto x       = p[0] * simd::cos(p[1]) * sin_phi;
+                auto y       = p[0] * simd::sin(p[1]) * sin_phi;
+                p            = {x, y, p[0] * simd::cos(p[2])};
+            },
+            [](std::array<P, 3>& p) {
+                P sin_theta, cos_theta, sin_phi, cos_phi;
+                simd::fast_sincos(p[1], sin_theta, cos_theta);
+                simd::fast_sincos(p[2], sin_phi, cos_phi);
+                auto rho = p[0] * sin_phi;
+                p        = {rho * cos_theta, rho * sin_theta, p[0] * cos_phi};
+            });
+    }
+
+    template<std::size_t W = simd::native_width<float>>
+    void cartesian_to_cylindrical_batch(std::span<glm::vec3 const> in,
+                                        std::span<glm::vec3> out,
+                                        Accuracy accuracy = Accuracy::exact)
+    {
+        using P = simd::Pack<float, W>;
+        detail::convert_batch<W>(
+            in,
+            out,
+            accuracy,
+            [](std::array<P, 3>& p) {
+                auto r     = sqrt(p[0] * p[0] + p[1] * p[1]);
+                auto theta = simd::atan2(p[1], p[0]);
+                p          = {r, theta, p[2]};
+            },
+            [](std::array<P, 3>& p) {
+                auto r     = sqrt(p[0] * p[0] + p[1] * p[1]);
+                auto theta = simd::fast_atan2(p[1], p[0]);
+                p          = {r, theta, p[2]};
+            });
+    }
+
+    template<std::size_t W = simd::native_width<float>>
+    void cylindrical_to_cartesian_batch(std::span<glm::vec3 const> in,
+                                        std::span<glm::vec3> out,
+                                        Accuracy accuracy = Accuracy::exact)
+    {
+        using P = simd::Pack<float, W>;
+        detail::convert_batch<W>(
+            in,
+            out,
+            accuracy,
+            [](std::array<P, 3>& p) {
+                p = {p[0] * simd::cos(p[1]), p[0] * simd::sin(p[1]), p[2]};
+            },
+            [](std::array<P, 3>& p) {
+                P s, c;
+                simd::fast_sincos(p[1], s, c);
+                p = {p[0] * c, p[0] * s, p[2]};
+            });
+    }
+
+    template<std::size_t W = simd::native_width<float>>
+    void cartesian_to_polar_batch(std::span<glm::vec2 const> in,
+                                  std::span<glm::vec2> out,
+                                  Accuracy accuracy = Accuracy::exact)
+    {
+        using P = simd::Pack<float, W>;
+        detail::convert_batch<W>(
+            in,
+            out,
+            accuracy,
+            [](std::array<P, 2>& p) {
+                auto r     = sqrt(p[0] * p[0] + p[1] * p[1]);
+                auto theta = simd::atan2(p[1], p[0]);
+                p          = {r, theta};
+            },
+            [](std::array<P, 2>& p) {
+                auto r     = sqrt(p[0] * p[0] + p[1] * p[1]);
+                auto theta = simd::fast_atan2(p[1], p[0]);
+                p          = {r, theta};
+            });
+    }
+
+    template<std::size_t W = simd::native_width<float>>
+    void polar_to_cartesian_batch(std::span<glm::vec2 const> in,
+                                  std::span<glm::vec2> out,
+                                  Accuracy accuracy = Accuracy::exact)
+    {
+        using P = simd::Pack<float, W>;
+        detail::convert_batch<W>(
+            in,
+            out,
+            accuracy,
+            [](std::array<P, 2>& p) {
+                p = {p[0] * simd::cos(p[1]), p[0] * simd::sin(p[1])};
+            },
+            [](std::array<P, 2>& p) {
+                P s, c;
+                simd::fast_sincos(p[1], s, c);
+                p = {p[0] * c, p[0] * s};
+            });
+    }
 } // namespace atlas::math
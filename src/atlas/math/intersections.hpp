@@ -0,0 +1,486 @@
+#pragma once
+
+#include "glm.hpp"
+#include "ray.hpp"
+#include "ray_packet.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace atlas::math
+{
+    struct Sphere
+    {
+        glm::vec3 center;
+        float radius;
+    };
+
+    struct Plane
+    {
+        glm::vec3 point;
+        glm::vec3 normal;
+    };
+
+    struct AABB
+    {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    struct Triangle
+    {
+        glm::vec3 v0;
+        glm::vec3 v1;
+        glm::vec3 v2;
+    };
+
+    // t is the ray parameter of the hit, (u, v) are the barycentric weights
+    // of v1 and v2.
+    struct TriangleHit
+    {
+        float t;
+        float u;
+        float v;
+    };
+
+    // The scalar tests below return the closest hit within [t_min, t_max],
+    // if any.
+
+    inline std::optional<float>
+    intersect(Ray<glm::vec3> const& ray, Sphere const& sphere, float t_min, float t_max)
+    {
+        glm::vec3 oc = ray.o - sphere.center;
+        float a      = glm::dot(ray.d, ray.d);
+        float b      = glm::dot(oc, ray.d);
+        float c      = glm::dot(oc, oc) - sphere.radius * sphere.radius;
+        float disc   = b * b - a * c;
+        if (disc < 0.0f)
+        {
+            return {};
+        }
+
+        float e = glm::sqrt(disc);
+        float t = (-b - e) / a;
+        if (t < t_min)
+        {
+            t = (-b + e) / a;
+        }
+
+        if (t < t_min || t > t_max)
+        {
+            return {};
+        }
+
+        return t;
+    }
+
+    inline std::optional<float>
+    intersect(Ray<glm::vec3> const& ray, Plane const& plane, float t_min, float t_max)
+    {
+        float denom = glm::dot(ray.d, plane.normal);
+        float t     = glm::dot(plane.point - ray.o, plane.normal) / denom;
+        if (!(t >= t_min && t <= t_max))
+        {
+            return {};
+        }
+
+        return t;
+    }
+
+    // Slab test. Returns the parametric distance at which the ray enters the
+    // box, clamped to t_min when the origin is inside.
+    inline std::optional<float>
+    intersect(Ray<glm::vec3> const& ray, AABB const& box, float t_min, float t_max)
+    {
+        glm::vec3 inv_d = 1.0f / ray.d;
+        for (int i{0}; i < 3; ++i)
+        {
+            float t0 = (box.min[i] - ray.o[i]) * inv_d[i];
+            float t1 = (box.max[i] - ray.o[i]) * inv_d[i];
+            if (t0 > t1)
+            {
+                std::swap(t0, t1);
+            }
+
+            // Written so that a NaN (from 0 * inf) leaves the interval
+            // untouched.
+            t_min = (t0 > t_min) ? t0 : t_min;
+            t_max = (t1 < t_max) ? t1 : t_max;
+        }
+
+        if (t_min > t_max)
+        {
+            return {};
+        }
+
+        return t_min;
+    }
+
+    // Möller-Trumbore.
+    inline std::optional<TriangleHit>
+    intersect(Ray<glm::vec3> const& ray, Triangle const& tri, float t_min, float t_max)
+    {
+        glm::vec3 e1 = tri.v1 - tri.v0;
+        glm::vec3 e2 = tri.v2 - tri.v0;
+        glm::vec3 p  = glm::cross(ray.d, e2);
+        float det    = glm::dot(e1, p);
+        if (det == 0.0f)
+        {
+            return {};
+        }
+
+        float inv_det = 1.0f / det;
+        glm::vec3 s   = ray.o - tri.v0;
+        float u       = glm::dot(s, p) * inv_det;
+        if (u < 0.0f || u > 1.0f)
+        {
+            return {};
+        }
+
+        glm::vec3 q = glm::cross(s, e1);
+        float v     = glm::dot(ray.d, q) * inv_det;
+        if (v < 0.0f || u + v > 1.0f)
+        {
+            return {};
+        }
+
+        float t = glm::dot(e2, q) * inv_det;
+        if (t < t_min || t > t_max)
+        {
+            return {};
+        }
+
+        return TriangleHit{t, u, v};
+    }
+
+    // Watertight ray/triangle intersection from Woop, Benthin and Wald,
+    // "Watertight Ray/Triangle Intersection", JCGT 2013. Rays that hit a
+    // shared edge or vertex are guaranteed to hit at least one of the
+    // adjacent triangles, which Möller-Trumbore does not guarantee.
+    inline std::optional<TriangleHit> intersect_watertight(Ray<glm::vec3> const& ray,
+                                                           Triangle const& tri,
+                                                           float t_min,
+                                                           float t_max)
+    {
+        // Permute the axes so that the largest direction component is z and
+        // the winding is preserved.
+        glm::vec3 ad = glm::abs(ray.d);
+        int kz       = (ad.x > ad.y) ? ((ad.x > ad.z) ? 0 : 2) : ((ad.y > ad.z) ? 1 : 2);
+        int kx       = (kz + 1) % 3;
+        int ky       = (kx + 1) % 3;
+        if (ray.d[kz] < 0.0f)
+        {
+            std::swap(kx, ky);
+        }
+
+        float sx = ray.d[kx] / ray.d[kz];
+        float sy = ray.d[ky] / ray.d[kz];
+        float sz = 1.0f / ray.d[kz];
+
+        glm::vec3 a = tri.v0 - ray.o;
+        glm::vec3 b = tri.v1 - ray.o;
+        glm::vec3 c = tri.v2 - ray.o;
+
+        float ax = a[kx] - sx * a[kz];
+        float ay = a[ky] - sy * a[kz];
+        float bx = b[kx] - sx * b[kz];
+        float by = b[ky] - sy * b[kz];
+        float cx = c[kx] - sx * c[kz];
+        float cy = c[ky] - sy * c[kz];
+
+        // The edge functions are evaluated in double precision. Products of
+        // two floats are exact in double, so the signs are exact as well and
+        // triangles sharing an edge always agree on which side of it the ray
+        // passes, no matter how the compiler contracts the arithmetic.
+        auto edge = [](double x0, double y0, double x1, double y1) {
+            return static_cast<float>(x0 * y1 - y0 * x1);
+        };
+
+        float u = edge(cx, cy, bx, by);
+        float v = edge(ax, ay, cx, cy);
+        float w = edge(bx, by, ax, ay);
+
+        if ((u < 0.0f || v < 0.0f || w < 0.0f) && (u > 0.0f || v > 0.0f || w > 0.0f))
+        {
+            return {};
+        }
+
+        float det = u + v + w;
+        if (det == 0.0f)
+        {
+            return {};
+        }
+
+        float az = sz * a[kz];
+        float bz = sz * b[kz];
+        float cz = sz * c[kz];
+        float t  = (u * az + v * bz + w * cz) / det;
+        if (t < t_min || t > t_max)
+        {
+            return {};
+        }
+
+        return TriangleHit{t, v / det, w / det};
+    }
+
+    // Packet kernels. Each of these tests all active lanes of the packet at
+    // once and returns the mask of lanes that hit within their [t_min, t_max]
+    // interval, along with the hit distance in t. The values of t in lanes
+    // that missed are unspecified. To keep the closest hit, follow up with
+    //
+    //     packet.t_max = select(hit, t, packet.t_max);
+
+    template<typename T, std::size_t N>
+    typename RayPacket<T, N>::mask_type intersect(RayPacket<T, N> const& ray,
+                                                  Sphere const& sphere,
+                                                  simd::Pack<T, N>& t)
+    {
+        using pack_type = simd::Pack<T, N>;
+
+        Vec3Pack<T, N> oc = ray.o - Vec3Pack<T, N>{sphere.center};
+        pack_type r{static_cast<T>(sphere.radius)};
+        pack_type a    = dot(ray.d, ray.d);
+        pack_type b    = dot(oc, ray.d);
+        pack_type c    = dot(oc, oc) - r * r;
+        pack_type disc = b * b - a * c;
+
+        auto mask   = ray.active & (disc >= pack_type{T{0}});
+        pack_type e = sqrt(max(disc, pack_type{T{0}}));
+        pack_type near_t = (-b - e) / a;
+        pack_type far_t  = (-b + e) / a;
+        t                = select(near_t < ray.t_min, far_t, near_t);
+        return mask & (t >= ray.t_min) & (t <= ray.t_max);
+    }
+
+    template<typename T, std::size_t N>
+    typename RayPacket<T, N>::mask_type intersect(RayPacket<T, N> const& ray,
+                                                  Plane const& plane,
+                                                  simd::Pack<T, N>& t)
+    {
+        Vec3Pack<T, N> n{plane.normal};
+        t = dot(Vec3Pack<T, N>{plane.point} - ray.o, n) / dot(ray.d, n);
+        return ray.active & (t >= ray.t_min) & (t <= ray.t_max);
+    }
+
+    template<typename T, std::size_t N>
+    typename RayPacket<T, N>::mask_type intersect(RayPacket<T, N> const& ray,
+                                                  AABB const& box,
+                                                  simd::Pack<T, N>& t)
+    {
+        using pack_type = simd::Pack<T, N>;
+
+        pack_type t_near = ray.t_min;
+        pack_type t_far  = ray.t_max;
+        auto slab        = [&](pack_type const& lo,
+                        pack_type const& hi,
+                        pack_type const& o,
+                        pack_type const& inv_d) {
+            pack_type t0 = (lo - o) * inv_d;
+            pack_type t1 = (hi - o) * inv_d;
+
+            // min/max return their second operand for NaN, so the running
+            // interval goes last.
+            t_near = max(min(t0, t1), t_near);
+            t_far  = min(max(t0, t1), t_far);
+        };
+
+        slab(static_cast<T>(box.min.x), static_cast<T>(box.max.x), ray.o.x, ray.inv_d.x);
+        slab(static_cast<T>(box.min.y), static_cast<T>(box.max.y), ray.o.y, ray.inv_d.y);
+        slab(static_cast<T>(box.min.z), static_cast<T>(box.max.z), ray.o.z, ray.inv_d.z);
+
+        t = t_near;
+        return ray.active & (t_near <= t_far);
+    }
+
+    // Möller-Trumbore, also returning the barycentrics of the hit.
+    template<typename T, std::size_t N>
+    typename RayPacket<T, N>::mask_type intersect(RayPacket<T, N> const& ray,
+                                                  Triangle const& tri,
+                                                  simd::Pack<T, N>& t,
+                                                  simd::Pack<T, N>& u,
+                                                  simd::Pack<T, N>& v)
+    {
+        using pack_type = simd::Pack<T, N>;
+
+        Vec3Pack<T, N> v0{tri.v0};
+        Vec3Pack<T, N> e1 = Vec3Pack<T, N>{tri.v1} - v0;
+        Vec3Pack<T, N> e2 = Vec3Pack<T, N>{tri.v2} - v0;
+        Vec3Pack<T, N> p  = cross(ray.d, e2);
+        pack_type det     = dot(e1, p);
+
+        pack_type zero{T{0}};
+        pack_type one{T{1}};
+        pack_type inv_det = one / det;
+        Vec3Pack<T, N> s  = ray.o - v0;
+        Vec3Pack<T, N> q  = cross(s, e1);
+        u                 = dot(s, p) * inv_det;
+        v                 = dot(ray.d, q) * inv_det;
+        t                 = dot(e2, q) * inv_det;
+
+        return ray.active & (det != zero) & (u >= zero) & (v >= zero) & (u + v <= one)
+               & (t >= ray.t_min) & (t <= ray.t_max);
+    }
+
+    template<typename T, std::size_t N>
+    typename RayPacket<T, N>::mask_type intersect(RayPacket<T, N> const& ray,
+                                                  Triangle const& tri,
+                                                  simd::Pack<T, N>& t)
+    {
+        simd::Pack<T, N> u;
+        simd::Pack<T, N> v;
+        return intersect(ray, tri, t, u, v);
+    }
+
+    namespace detail
+    {
+        // Lane-wise x0 * y1 - y0 * x1. Rounding is monotonic, so whenever the
+        // two rounded products differ, their order, and with it the sign of
+        // the result, is exact, even if the subtraction is contracted into an
+        // FMA. Only lanes where the products round to the same value can be 0
+        // or have the wrong sign, and those are evaluated again in double,
+        // where the products are exact, as the scalar watertight test does.
+        template<typename T, std::size_t N>
+        simd::Pack<T, N> edge_function(simd::Pack<T, N> const& x0,
+                                       simd::Pack<T, N> const& y0,
+                                       simd::Pack<T, N> const& x1,
+                                       simd::Pack<T, N> const& y1)
+        {
+            simd::Pack<T, N> a = x0 * y1;
+            simd::Pack<T, N> b = y0 * x1;
+            auto tied          = a == b;
+            if (simd::none(tied))
+            {
+                return a - b;
+            }
+
+            alignas(64) std::array<std::array<T, N>, 5> lanes;
+            x0.store(lanes[0].data());
+            y0.store(lanes[1].data());
+            x1.store(lanes[2].data());
+            y1.store(lanes[3].data());
+            (a - b).store(lanes[4].data());
+            for (auto bits = tied.bits(); bits != 0; bits &= bits - 1)
+            {
+                auto i      = static_cast<std::size_t>(std::countr_zero(bits));
+                auto x0_y1  = static_cast<double>(lanes[0][i]) * lanes[3][i];
+                auto y0_x1  = static_cast<double>(lanes[1][i]) * lanes[2][i];
+                lanes[4][i] = static_cast<T>(x0_y1 - y0_x1);
+            }
+
+            return simd::Pack<T, N>::load(lanes[4].data());
+        }
+    } // namespace detail
+
+    // Packet version of the watertight test. The axis permutation differs
+    // per ray, so it is resolved with selects instead of indexing.
+    template<typename T, std::size_t N>
+    typename RayPacket<T, N>::mask_type intersect_watertight(RayPacket<T, N> const& ray,
+                                                             Triangle const& tri,
+                                                             simd::Pack<T, N>& t,
+                                                             simd::Pack<T, N>& u,
+                                                             simd::Pack<T, N>& v)
+    {
+        using pack_type = simd::Pack<T, N>;
+
+        pack_type adx = abs(ray.d.x);
+        pack_type ady = abs(ray.d.y);
+        pack_type adz = abs(ray.d.z);
+        auto kz_x     = (adx > ady) & (adx > adz);
+        auto kz_y     = (!kz_x) & (ady > adz);
+
+        // Maps (x, y, z) onto (kx, ky, kz), swapping kx and ky when the
+        // dominant direction component is negative.
+        auto permute = [&](Vec3Pack<T, N> const& a) {
+            pack_type pz = select(kz_x, a.x, select(kz_y, a.y, a.z));
+            pack_type px = select(kz_x, a.y, select(kz_y, a.z, a.x));
+            pack_type py = select(kz_x, a.z, select(kz_y, a.x, a.y));
+            return Vec3Pack<T, N>{px, py, pz};
+        };
+
+        Vec3Pack<T, N> d = permute(ray.d);
+        auto flip        = d.z < pack_type{T{0}};
+        d                = {select(flip, d.y, d.x), select(flip, d.x, d.y), d.z};
+
+        pack_type one{T{1}};
+        pack_type sz = one / d.z;
+        pack_type sx = d.x * sz;
+        pack_type sy = d.y * sz;
+
+        auto project = [&](glm::vec3 const& vertex) {
+            Vec3Pack<T, N> a = permute(Vec3Pack<T, N>{vertex} - ray.o);
+            pack_type ax     = select(flip, a.y, a.x);
+            pack_type ay     = select(flip, a.x, a.y);
+            return Vec3Pack<T, N>{ax - sx * a.z, ay - sy * a.z, sz * a.z};
+        };
+
+        Vec3Pack<T, N> a = project(tri.v0);
+        Vec3Pack<T, N> b = project(tri.v1);
+        Vec3Pack<T, N> c = project(tri.v2);
+
+        pack_type e0 = detail::edge_function(c.x, c.y, b.x, b.y);
+        pack_type e1 = detail::edge_function(a.x, a.y, c.x, c.y);
+        pack_type e2 = detail::edge_function(b.x, b.y, a.x, a.y);
+
+        pack_type zero{T{0}};
+        auto negative  = (e0 < zero) | (e1 < zero) | (e2 < zero);
+        auto positive  = (e0 > zero) | (e1 > zero) | (e2 > zero);
+        pack_type det  = e0 + e1 + e2;
+        pack_type inv  = one / det;
+        t              = (e0 * a.z + e1 * b.z + e2 * c.z) * inv;
+        u              = e1 * inv;
+        v              = e2 * inv;
+
+        return ray.active & !(negative & positive) & (det != zero) & (t >= ray.t_min)
+               & (t <= ray.t_max);
+    }
+
+    // Intersects a stream of rays against a list of primitives, packet by
+    // packet. For every ray that hits, t_max in the stream is shortened to
+    // the closest hit and the index of the primitive is written to
+    // prim_ids; rays that miss everything keep their previous id. Returns
+    // the number of ray/primitive hits that were found.
+    template<typename T, std::size_t N = simd::native_width<T>, typename Primitive>
+    std::size_t intersect_stream(RayStream<T> const& rays,
+                                 std::span<Primitive const> primitives,
+                                 std::span<std::int32_t> prim_ids)
+    {
+        assert(prim_ids.size() == rays.size());
+
+        std::size_t hits{0};
+        for (std::size_t first{0}; first < rays.size(); first += N)
+        {
+            auto packet = rays.template packet<N>(first);
+            std::size_t count = std::min(N, rays.size() - first);
+            auto ids          = prim_ids.subspan(first, count);
+
+            simd::Pack<T, N> t;
+            for (std::size_t i{0}; i < primitives.size(); ++i)
+            {
+                auto hit = intersect(packet, primitives[i], t);
+                if (simd::none(hit))
+                {
+                    continue;
+                }
+
+                packet.t_max = select(hit, t, packet.t_max);
+                for (auto bits = hit.bits(); bits != 0; bits &= bits - 1)
+                {
+                    ids[std::countr_zero(bits)] = static_cast<std::int32_t>(i);
+                    ++hits;
+                }
+            }
+
+            rays.store_t_max(packet, first);
+        }
+
+        return hits;
+    }
+} // namespace atlas::math
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "glm.hpp"
+#include "ray.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <span>
+
+namespace atlas::math
+{
+    // Structure-of-arrays 3D vector where each component holds one value per
+    // lane.
+    template<typename T, std::size_t N>
+    struct Vec3Pack
+    {
+        using pack_type = simd::Pack<T, N>;
+
+        Vec3Pack() = default;
+
+        Vec3Pack(pack_type const& x_, pack_type const& y_, pack_type const& z_) :
+            x{x_},
+            y{y_},
+            z{z_}
+        {}
+
+        Vec3Pack(glm::vec3 const& v) :
+            x{static_cast<T>(v.x)},
+            y{static_cast<T>(v.y)},
+            z{static_cast<T>(v.z)}
+        {}
+
+        friend Vec3Pack operator+(Vec3Pack const& a, Vec3Pack const& b)
+        {
+            return {a.x + b.x, a.y + b.y, a.z + b.z};
+        }
+
+        friend Vec3Pack operator-(Vec3Pack const& a, Vec3Pack const& b)
+        {
+            return {a.x - b.x, a.y - b.y, a.z - b.z};
+        }
+
+        friend Vec3Pack operator*(pack_type const& s, Vec3Pack const& a)
+        {
+            return {s * a.x, s * a.y, s * a.z};
+        }
+
+        friend pack_type dot(Vec3Pack const& a, Vec3Pack const& b)
+        {
+            return a.x * b.x + a.y * b.y + a.z * b.z;
+        }
+
+        friend Vec3Pack cross(Vec3Pack const& a, Vec3Pack const& b)
+        {
+            return {a.y * b.z - a.z * b.y,
+                    a.z * b.x - a.x * b.z,
+                    a.x * b.y - a.y * b.x};
+        }
+
+        pack_type x;
+        pack_type y;
+        pack_type z;
+    };
+
+    // A packet of N rays stored as structure-of-arrays so that every lane of
+    // a SIMD register holds a different ray. Each lane has its own valid
+    // [t_min, t_max] interval and lanes whose bit in active is clear are
+    // ignored by the intersection kernels.
+    //
+    // inv_d caches 1 / d for the slab test, so call update_inverse_direction
+    // whenever d is modified directly.
+    template<typename T, std::size_t N = simd::native_width<T>>
+    struct RayPacket
+    {
+        using pack_type = simd::Pack<T, N>;
+        using mask_type = typename pack_type::mask_type;
+
+        static constexpr std::size_t width = N;
+
+        // Gathers up to N rays into a packet. Lanes past rays.size() are
+        // marked as inactive.
+        static RayPacket load(std::span<Ray<glm::vec3> const> rays,
+                              T t_min = T{0},
+                              T t_max = std::numeric_limits<T>::max())
+        {
+            assert(rays.size() <= N);
+
+            alignas(64) std::array<std::array<T, N>, 6> lanes;
+            for (std::size_t i{0}; i < N; ++i)
+            {
+                // Padding lanes get a valid direction so they don't produce
+                // spurious NaNs.
+                Ray<glm::vec3> r = (i < rays.size())
+                                       ? rays[i]
+                                       : Ray<glm::vec3>{glm::vec3{0.0f}, glm::vec3{1.0f}};
+                lanes[0][i] = static_cast<T>(r.o.x);
+                lanes[1][i] = static_cast<T>(r.o.y);
+                lanes[2][i] = static_cast<T>(r.o.z);
+                lanes[3][i] = static_cast<T>(r.d.x);
+                lanes[4][i] = static_cast<T>(r.d.y);
+                lanes[5][i] = static_cast<T>(r.d.z);
+            }
+
+            RayPacket packet;
+            packet.o = {pack_type::load(lanes[0].data()),
+                        pack_type::load(lanes[1].data()),
+                        pack_type::load(lanes[2].data())};
+            packet.d = {pack_type::load(lanes[3].data()),
+                        pack_type::load(lanes[4].data()),
+                        pack_type::load(lanes[5].data())};
+            packet.t_min  = t_min;
+            packet.t_max  = t_max;
+            packet.active = simd::first_lanes<T, N>(rays.size());
+            packet.update_inverse_direction();
+            return packet;
+        }
+
+        void update_inverse_direction()
+        {
+            pack_type one{T{1}};
+            inv_d = {one / d.x, one / d.y, one / d.z};
+        }
+
+        Ray<glm::vec3> ray(std::size_t lane) const
+        {
+            return {glm::vec3{o.x[lane], o.y[lane], o.z[lane]},
+                    glm::vec3{d.x[lane], d.y[lane], d.z[lane]}};
+        }
+
+        Vec3Pack<T, N> operator()(pack_type const& t) const
+        {
+            return o + t * d;
+        }
+
+        Vec3Pack<T, N> o;
+        Vec3Pack<T, N> d;
+        Vec3Pack<T, N> inv_d;
+        pack_type t_min;
+        pack_type t_max;
+        mask_type active;
+    };
+
+    // Non-owning view over a structure-of-arrays stream of rays, typically
+    // far larger than a single packet. t_max is updated in place by the
+    // stream kernels as closer hits are found.
+    template<typename T>
+    struct RayStream
+    {
+        std::size_t size() const
+        {
+            return t_max.size();
+        }
+
+        // Loads the rays [first, first + N) into a packet, masking out any
+        // lanes past the end of the stream.
+        template<std::size_t N>
+        RayPacket<T, N> packet(std::size_t first) const
+        {
+            using pack_type = simd::Pack<T, N>;
+
+            std::size_t count = std::min(N, size() - first);
+            auto load         = [first, count](std::span<T const> src, T fill) {
+                if (count == N)
+                {
+                    return pack_type::load(src.data() + first);
+                }
+
+                alignas(64) std::array<T, N> tmp;
+                tmp.fill(fill);
+                std::copy_n(src.data() + first, count, tmp.data());
+                return pack_type::load(tmp.data());
+            };
+
+            RayPacket<T, N> p;
+            p.o      = {load(o[0], T{0}), load(o[1], T{0}), load(o[2], T{0})};
+            p.d      = {load(d[0], T{1}), load(d[1], T{1}), load(d[2], T{1})};
+            p.t_min  = load(t_min, T{0});
+            p.t_max  = load(t_max, T{0});
+            p.active = simd::first_lanes<T, N>(count);
+            p.update_inverse_direction();
+            return p;
+        }
+
+        // Writes the t_max of the packet back into the stream.
+        template<std::size_t N>
+        void store_t_max(RayPacket<T, N> const& p, std::size_t first) const
+        {
+            std::size_t count = std::min(N, size() - first);
+            if (count == N)
+            {
+                p.t_max.store(t_max.data() + first);
+                return;
+            }
+
+            alignas(64) std::array<T, N> tmp;
+            p.t_max.store(tmp.data());
+            std::copy_n(tmp.data(), count, t_max.data() + first);
+        }
+
+        std::array<std::span<T const>, 3> o;
+        std::array<std::span<T const>, 3> d;
+        std::span<T const> t_min;
+        std::span<T> t_max;
+    };
+} // namespace atlas::math
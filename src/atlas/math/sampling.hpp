@@ -0,0 +1,77 @@
+#pragma once
+
+#include "glm.hpp"
+
+namespace atlas::math
+{
+    // All of the mappings below take a sample in [0, 1)^2 (for example one
+    // produced by the generators in sequences.hpp) and warp it onto the
+    // corresponding domain. Hemispheres are oriented around +z.
+
+    inline glm::vec2 square_to_disk(glm::vec2 const& u)
+    {
+        // Shirley-Chiu concentric mapping, which preserves the
+        // stratification of the input samples.
+        glm::vec2 offset = 2.0f * u - glm::vec2{1.0f};
+        if (offset.x == 0.0f && offset.y == 0.0f)
+        {
+            return {0.0f, 0.0f};
+        }
+
+        float r;
+        float theta;
+        if (glm::abs(offset.x) > glm::abs(offset.y))
+        {
+            r     = offset.x;
+            theta = glm::quarter_pi<float>() * (offset.y / offset.x);
+        }
+        else
+        {
+            r     = offset.y;
+            theta = glm::half_pi<float>()
+                    - glm::quarter_pi<float>() * (offset.x / offset.y);
+        }
+
+        return {r * glm::cos(theta), r * glm::sin(theta)};
+    }
+
+    inline glm::vec3 square_to_uniform_sphere(glm::vec2 const& u)
+    {
+        float z   = 1.0f - 2.0f * u.x;
+        float r   = glm::sqrt(glm::max(0.0f, 1.0f - z * z));
+        float phi = glm::two_pi<float>() * u.y;
+        return {r * glm::cos(phi), r * glm::sin(phi), z};
+    }
+
+    inline glm::vec3 square_to_uniform_hemisphere(glm::vec2 const& u)
+    {
+        float z   = u.x;
+        float r   = glm::sqrt(glm::max(0.0f, 1.0f - z * z));
+        float phi = glm::two_pi<float>() * u.y;
+        return {r * glm::cos(phi), r * glm::sin(phi), z};
+    }
+
+    inline glm::vec3 square_to_cosine_hemisphere(glm::vec2 const& u)
+    {
+        // Malley's method: project the concentric disk up onto the
+        // hemisphere.
+        glm::vec2 d = square_to_disk(u);
+        float z     = glm::sqrt(glm::max(0.0f, 1.0f - d.x * d.x - d.y * d.y));
+        return {d.x, d.y, z};
+    }
+
+    inline float uniform_sphere_pdf()
+    {
+        return glm::one_over_pi<float>() / 4.0f;
+    }
+
+    inline float uniform_hemisphere_pdf()
+    {
+        return glm::one_over_two_pi<float>();
+    }
+
+    inline float cosine_hemisphere_pdf(float cos_theta)
+    {
+        return cos_theta * glm::one_over_pi<float>();
+    }
+} // namespace atlas::math
@@ -0,0 +1,362 @@
+#pragma once
+
+#include "glm.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+namespace atlas::math
+{
+    enum class SequenceType
+    {
+        sobol = 0,
+        owen_sobol,
+        halton,
+        r2
+    };
+
+    // Number of dimensions for which Sobol direction numbers are tabulated.
+    // Dimension 0 is the van der Corput sequence, the remaining ones use the
+    // primitive polynomials and initial direction numbers of Joe and Kuo
+    // (new-joe-kuo-6.21201).
+    inline constexpr std::size_t sobol_max_dimensions{16};
+
+    // Number of dimensions supported by the Halton sequence (one per prime).
+    inline constexpr std::size_t halton_max_dimensions{32};
+
+    // The R2 sequence is strictly two-dimensional.
+    inline constexpr std::size_t r2_max_dimensions{2};
+
+    namespace detail
+    {
+        struct SobolPolynomial
+        {
+            std::uint32_t degree;
+            std::uint32_t coefficients;
+            std::array<std::uint32_t, 6> initial;
+        };
+
+        // clang-format off
+        inline constexpr std::array<SobolPolynomial, sobol_max_dimensions - 1>
+            sobol_polynomials{{
+                {1,  0, {1}},
+                {2,  1, {1, 3}},
+                {3,  1, {1, 3, 1}},
+                {3,  2, {1, 1, 1}},
+                {4,  1, {1, 1, 3, 3}},
+                {4,  4, {1, 3, 5, 13}},
+                {5,  2, {1, 1, 5, 5, 17}},
+                {5,  4, {1, 1, 5, 5, 5}},
+                {5,  7, {1, 1, 7, 11, 19}},
+                {5, 11, {1, 1, 5, 1, 1}},
+                {5, 13, {1, 1, 1, 3, 11}},
+                {5, 14, {1, 3, 5, 5, 31}},
+                {6,  1, {1, 3, 3, 9, 7, 49}},
+                {6, 13, {1, 1, 1, 15, 21, 21}},
+                {6, 16, {1, 3, 1, 13, 27, 49}}
+            }};
+        // clang-format on
+
+        using SobolDirections =
+            std::array<std::array<std::uint32_t, 32>, sobol_max_dimensions>;
+
+        constexpr SobolDirections make_sobol_directions()
+        {
+            SobolDirections v{};
+
+            for (std::uint32_t k{0}; k < 32; ++k)
+            {
+                v[0][k] = 1u << (31 - k);
+            }
+
+            for (std::size_t d{1}; d < sobol_max_dimensions; ++d)
+            {
+                auto const& poly = sobol_polynomials[d - 1];
+                auto s           = poly.degree;
+
+                for (std::uint32_t k{0}; k < s; ++k)
+                {
+                    v[d][k] = poly.initial[k] << (31 - k);
+                }
+
+                for (std::uint32_t k{s}; k < 32; ++k)
+                {
+                    v[d][k] = v[d][k - s] ^ (v[d][k - s] >> s);
+                    for (std::uint32_t l{1}; l < s; ++l)
+                    {
+                        if ((poly.coefficients >> (s - 1 - l)) & 1u)
+                        {
+                            v[d][k] ^= v[d][k - l];
+                        }
+                    }
+                }
+            }
+
+            return v;
+        }
+
+        inline constexpr SobolDirections sobol_directions = make_sobol_directions();
+
+        // clang-format off
+        inline constexpr std::array<std::uint32_t, halton_max_dimensions> primes{
+            2,   3,   5,   7,   11,  13,  17,  19,  23,  29,  31,
+            37,  41,  43,  47,  53,  59,  61,  67,  71,  73,  79,
+            83,  89,  97,  101, 103, 107, 109, 113, 127, 131};
+        // clang-format on
+
+        // The R2 increments 1/g and 1/g^2 (where g is the plastic number) in
+        // 0.64 fixed point. Working in fixed point keeps the sequence exact
+        // for every 32-bit index instead of drifting with floating point
+        // accumulation.
+        inline constexpr std::array<std::uint64_t, r2_max_dimensions> r2_alpha{
+            0xc13fa9a902a6328full,
+            0x91e10da5c79e7b1dull};
+
+        constexpr std::uint32_t reverse_bits(std::uint32_t x)
+        {
+            x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+            x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+            x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+            x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+            return (x >> 16) | (x << 16);
+        }
+
+        constexpr std::uint32_t hash(std::uint32_t x)
+        {
+            x ^= x >> 16;
+            x *= 0x7feb352du;
+            x ^= x >> 15;
+            x *= 0x846ca68bu;
+            x ^= x >> 16;
+            return x;
+        }
+
+        constexpr std::uint32_t hash_combine(std::uint32_t seed, std::uint32_t v)
+        {
+            return seed ^ (v + (seed << 6) + (seed >> 2));
+        }
+
+        // Laine-Karras style permutation followed by bit reversal gives a
+        // nested uniform (Owen) scramble. See Burley, "Practical Hash-based
+        // Owen Scrambling", JCGT 2020.
+        constexpr std::uint32_t nested_uniform_scramble(std::uint32_t x,
+                                                        std::uint32_t seed)
+        {
+            x = reverse_bits(x);
+            x += seed;
+            x ^= x * 0x6c50b47cu;
+            x ^= x * 0xb82f1e52u;
+            x ^= x * 0xc7afe638u;
+            x ^= x * 0x8d22f6e6u;
+            return reverse_bits(x);
+        }
+
+        template<typename T>
+        constexpr T to_unit_interval(std::uint32_t bits)
+        {
+            if constexpr (std::is_same_v<T, float>)
+            {
+                // Only keep the 24 bits a float can represent so the result
+                // never rounds up to 1.
+                return static_cast<float>(bits >> 8) * 0x1p-24f;
+            }
+            else
+            {
+                return static_cast<T>(bits) * static_cast<T>(0x1p-32);
+            }
+        }
+    } // namespace detail
+
+    constexpr std::uint32_t sobol_sample_bits(std::uint32_t index, std::size_t dimension)
+    {
+        assert(dimension < sobol_max_dimensions);
+
+        auto const& v = detail::sobol_directions[dimension];
+        std::uint32_t result{0};
+        for (std::size_t bit{0}; index != 0; index >>= 1, ++bit)
+        {
+            if (index & 1u)
+            {
+                result ^= v[bit];
+            }
+        }
+
+        return result;
+    }
+
+    constexpr std::uint32_t owen_sobol_sample_bits(std::uint32_t index,
+                                                   std::size_t dimension,
+                                                   std::uint32_t seed)
+    {
+        // Shuffle the index with the same seed in every dimension so all
+        // dimensions of a sample stay paired, then scramble each dimension
+        // independently.
+        auto shuffled = detail::nested_uniform_scramble(index, detail::hash(seed));
+        auto bits     = sobol_sample_bits(shuffled, dimension);
+        auto dim_seed = detail::hash(
+            detail::hash_combine(seed, static_cast<std::uint32_t>(dimension)));
+        return detail::nested_uniform_scramble(bits, dim_seed);
+    }
+
+    template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
+    constexpr T sobol_sample(std::uint32_t index, std::size_t dimension)
+    {
+        return detail::to_unit_interval<T>(sobol_sample_bits(index, dimension));
+    }
+
+    template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
+    constexpr T
+    owen_sobol_sample(std::uint32_t index, std::size_t dimension, std::uint32_t seed)
+    {
+        return detail::to_unit_interval<T>(
+            owen_sobol_sample_bits(index, dimension, seed));
+    }
+
+    template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
+    constexpr T halton_sample(std::uint32_t index, std::size_t dimension)
+    {
+        assert(dimension < halton_max_dimensions);
+
+        if (dimension == 0)
+        {
+            // Base 2 is just the bit-reversed index.
+            return detail::to_unit_interval<T>(detail::reverse_bits(index));
+        }
+
+        // Radical inverse in the given base. The digits are reversed into an
+        // integer and scaled once at the end to avoid accumulating rounding
+        // errors.
+        std::uint64_t const base = detail::primes[dimension];
+        std::uint64_t reversed{0};
+        std::uint64_t scale{1};
+        std::uint64_t i{index};
+        while (i != 0)
+        {
+            std::uint64_t next  = i / base;
+            std::uint64_t digit = i - next * base;
+            reversed            = reversed * base + digit;
+            scale *= base;
+            i = next;
+        }
+
+        double result = static_cast<double>(reversed) / static_cast<double>(scale);
+        constexpr T one_minus_epsilon = T{1} - std::numeric_limits<T>::epsilon() / T{2};
+        auto value                    = static_cast<T>(result);
+        return value < one_minus_epsilon ? value : one_minus_epsilon;
+    }
+
+    template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
+    constexpr T r2_sample(std::uint32_t index, std::size_t dimension)
+    {
+        assert(dimension < r2_max_dimensions);
+
+        // x_n = frac(0.5 + n * alpha), evaluated modulo 2^64.
+        std::uint64_t x = 0x8000000000000000ull + index * detail::r2_alpha[dimension];
+        return detail::to_unit_interval<T>(static_cast<std::uint32_t>(x >> 32));
+    }
+
+    constexpr std::size_t max_dimensions(SequenceType type)
+    {
+        switch (type)
+        {
+        case SequenceType::sobol:
+        case SequenceType::owen_sobol:
+            return sobol_max_dimensions;
+
+        case SequenceType::halton:
+            return halton_max_dimensions;
+
+        case SequenceType::r2:
+            return r2_max_dimensions;
+        }
+
+        return 0;
+    }
+
+    template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
+    constexpr T sample_sequence(SequenceType type,
+                                std::uint32_t index,
+                                std::size_t dimension,
+                                std::uint32_t seed = 0)
+    {
+        switch (type)
+        {
+        case SequenceType::sobol:
+            return sobol_sample<T>(index, dimension);
+
+        case SequenceType::owen_sobol:
+            return owen_sobol_sample<T>(index, dimension, seed);
+
+        case SequenceType::halton:
+            return halton_sample<T>(index, dimension);
+
+        case SequenceType::r2:
+            return r2_sample<T>(index, dimension);
+        }
+
+        return T{0};
+    }
+
+    template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
+    void generate_samples(SequenceType type,
+                          std::span<T> samples,
+                          std::size_t dimension,
+                          std::uint32_t first_index = 0,
+                          std::uint32_t seed        = 0)
+    {
+        // Dispatch once outside of the loop so each of the inner loops is
+        // branch-free.
+        auto fill = [&](auto&& fn) {
+            for (std::size_t i{0}; i < samples.size(); ++i)
+            {
+                samples[i] = fn(first_index + static_cast<std::uint32_t>(i));
+            }
+        };
+
+        switch (type)
+        {
+        case SequenceType::sobol:
+            fill([dimension](std::uint32_t i) {
+                return sobol_sample<T>(i, dimension);
+            });
+            break;
+
+        case SequenceType::owen_sobol:
+            fill([dimension, seed](std::uint32_t i) {
+                return owen_sobol_sample<T>(i, dimension, seed);
+            });
+            break;
+
+        case SequenceType::halton:
+            fill([dimension](std::uint32_t i) {
+                return halton_sample<T>(i, dimension);
+            });
+            break;
+
+        case SequenceType::r2:
+            fill([dimension](std::uint32_t i) {
+                return r2_sample<T>(i, dimension);
+            });
+            break;
+        }
+    }
+
+    inline void generate_samples(SequenceType type,
+                                 std::span<glm::vec2> samples,
+                                 std::size_t first_dimension,
+                                 std::uint32_t first_index = 0,
+                                 std::uint32_t seed        = 0)
+    {
+        for (std::size_t i{0}; i < samples.size(); ++i)
+        {
+            auto index = first_index + static_cast<std::uint32_t>(i);
+            samples[i] = {sample_sequence<float>(type, index, first_dimension, seed),
+                          sample_sequence<float>(type, index, first_dimension + 1, seed)};
+        }
+    }
+} // namespace atlas::math
@@ -1,24 +1,180 @@
 #pragma once
 
+#include "simd.hpp"
+
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <type_traits>
 #include <vector>
 #include <zeus/float.hpp>
 
 namespace atlas::math
 {
-    template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
-    std::size_t solve_quadratic(std::vector<T> const& coeffs, std::vector<T>& roots)
+    namespace detail
     {
-        using zeus::is_zero;
+        // The functions below forward to the standard library at run time,
+        // so results are bit-identical to the std versions. When evaluated
+        // in a constant expression they fall back to iterative
+        // approximations accurate to within a few ulps.
+        template<typename T>
+        constexpr T abs(T x)
+        {
+            return (x < T{0}) ? -x : x;
+        }
 
-        assert(coeffs.size() >= 3);
+        template<typename T>
+        constexpr bool is_zero(T x)
+        {
+            if (std::is_constant_evaluated())
+            {
+                return abs(x) < std::numeric_limits<T>::epsilon();
+            }
 
-        if (roots.empty())
+            return zeus::is_zero<T>(x);
+        }
+
+        template<typename T>
+        constexpr T sqrt(T x)
         {
-            roots.resize(2);
+            if (std::is_constant_evaluated())
+            {
+                if (x <= T{0})
+                {
+                    return T{0};
+                }
+
+                T y = (x > T{1}) ? x : T{1};
+                for (int i{0}; i < 128; ++i)
+                {
+                    T next = T{1} / T{2} * (y + x / y);
+                    if (next == y)
+                    {
+                        break;
+                    }
+                    y = next;
+                }
+                return y;
+            }
+
+            return std::sqrt(x);
+        }
+
+        template<typename T>
+        constexpr T cbrt(T x)
+        {
+            if (std::is_constant_evaluated())
+            {
+                if (x == T{0})
+                {
+                    return T{0};
+                }
+
+                T a = abs(x);
+                T y = (a > T{1}) ? a : T{1};
+                for (int i{0}; i < 256; ++i)
+                {
+                    T next = (T{2} * y + a / (y * y)) / T{3};
+                    if (abs(next - y) <= std::numeric_limits<T>::epsilon() * y)
+                    {
+                        y = next;
+                        break;
+                    }
+                    y = next;
+                }
+                return (x < T{0}) ? -y : y;
+            }
+
+            return std::cbrt(x);
         }
 
+        template<typename T>
+        constexpr T cos(T x)
+        {
+            if (std::is_constant_evaluated())
+            {
+                // Reduce to [-pi, pi] and sum the Taylor series.
+                constexpr T pi     = std::numbers::pi_v<T>;
+                constexpr T two_pi = T{2} * pi;
+                auto k             = static_cast<long long>(x / two_pi);
+                x -= static_cast<T>(k) * two_pi;
+                x = (x > pi) ? x - two_pi : x;
+                x = (x < -pi) ? x + two_pi : x;
+
+                T term = T{1};
+                T sum  = T{1};
+                for (int n{1}; n < 40; ++n)
+                {
+                    term *= -x * x / static_cast<T>((2 * n - 1) * (2 * n));
+                    sum += term;
+                }
+                return sum;
+            }
+
+            return std::cos(x);
+        }
+
+        template<typename T>
+        constexpr T atan(T x)
+        {
+            // Only used for constant evaluation. Reduce the argument twice
+            // with atan(x) = 2 atan(x / (1 + sqrt(1 + x^2))) so the series
+            // converges quickly.
+            if (abs(x) > T{1})
+            {
+                T r = std::numbers::pi_v<T> / T{2} - atan(T{1} / abs(x));
+                return (x < T{0}) ? -r : r;
+            }
+
+            x = x / (T{1} + sqrt(T{1} + x * x));
+            x = x / (T{1} + sqrt(T{1} + x * x));
+
+            T term = x;
+            T sum  = x;
+            for (int n{1}; n < 40; ++n)
+            {
+                term *= -x * x;
+                sum += term / static_cast<T>(2 * n + 1);
+            }
+            return T{4} * sum;
+        }
+
+        template<typename T>
+        constexpr T acos(T x)
+        {
+            if (std::is_constant_evaluated())
+            {
+                if (x >= T{1})
+                {
+                    return T{0};
+                }
+
+                if (x <= -T{1})
+                {
+                    return std::numbers::pi_v<T>;
+                }
+
+                T s = sqrt(T{1} - x * x);
+                if (x == T{0})
+                {
+                    return std::numbers::pi_v<T> / T{2};
+                }
+
+                T r = atan(s / x);
+                return (x < T{0}) ? r + std::numbers::pi_v<T> : r;
+            }
+
+            return std::acos(x);
+        }
+    } // namespace detail
+
+    template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
+    constexpr std::size_t solve_quadratic(std::span<T const, 3> coeffs,
+                                          std::span<T, 2> roots)
+    {
         // Quadratic: x^2 + px + q = 0
         T p, q, D;
         p = coeffs[1] / (T{2} * coeffs[2]);
@@ -26,14 +182,14 @@ namespace atlas::math
 
         D = p * p - q;
 
-        if (is_zero<T>(D))
+        if (detail::is_zero<T>(D))
         {
             roots[0] = -p;
             return 1;
         }
         else if (D > T{0})
         {
-            T sqrtD  = std::sqrt(D);
+            T sqrtD  = detail::sqrt(D);
             roots[0] = sqrtD - p;
             roots[1] = -sqrtD - p;
             return 2;
@@ -43,18 +199,10 @@ namespace atlas::math
     }
 
     template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
-    std::size_t solve_cubic(std::vector<T> const& coeffs, std::vector<T>& roots)
+    constexpr std::size_t solve_cubic(std::span<T const, 4> coeffs,
+                                      std::span<T, 3> roots)
     {
-        using zeus::is_zero;
-
-        assert(coeffs.size() >= 4);
-
-        if (roots.empty())
-        {
-            roots.resize(3);
-        }
-
-        const T pi = 4 * std::atan(T{1});
+        constexpr T pi = std::numbers::pi_v<T>;
 
         // Cubic: x^3 + Ax^2 + Bx + C = 0
         T A = coeffs[2] / coeffs[3];
@@ -72,9 +220,9 @@ namespace atlas::math
         T D   = q * q + cbP;
 
         std::size_t num{0};
-        if (is_zero<T>(D))
+        if (detail::is_zero<T>(D))
         {
-            if (is_zero<T>(q))
+            if (detail::is_zero<T>(q))
             {
                 // Multiplicity 3.
                 roots[0] = 0;
@@ -83,7 +231,7 @@ namespace atlas::math
             else
             {
                 // Multiplicity 2 and 1.
-                T u      = std::cbrt(-q);
+                T u      = detail::cbrt(-q);
                 roots[0] = 2 * u;
                 roots[1] = -u;
                 num      = 2;
@@ -92,21 +240,21 @@ namespace atlas::math
         else if (D < 0)
         {
             // Multiplicity 1 all.
-            T phi = T{1} / T{3} * std::acos(-q / std::sqrt(-cbP));
-            T t   = T{2} * std::sqrt(-p);
+            T phi = T{1} / T{3} * detail::acos(-q / detail::sqrt(-cbP));
+            T t   = T{2} * detail::sqrt(-p);
 
             const auto piBy3 = pi / static_cast<T>(3);
-            roots[0]         = t * std::cos(phi);
-            roots[1]         = -t * std::cos(phi + piBy3);
-            roots[2]         = -t * std::cos(phi - piBy3);
+            roots[0]         = t * detail::cos(phi);
+            roots[1]         = -t * detail::cos(phi + piBy3);
+            roots[2]         = -t * detail::cos(phi - piBy3);
             num              = 3;
         }
         else
         {
             // One real solution.
-            T sqrtD = std::sqrt(D);
-            T u     = std::cbrt(sqrtD - q);
-            T v     = -std::cbrt(sqrtD + q);
+            T sqrtD = detail::sqrt(D);
+            T u     = detail::cbrt(sqrtD - q);
+            T v     = -detail::cbrt(sqrtD + q);
 
             roots[0] = u + v;
             num      = 1;
@@ -124,23 +272,15 @@ namespace atlas::math
     }
 
     template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
-    std::size_t solve_quartic(std::vector<T> const& coeffs, std::vector<T>& roots)
+    constexpr std::size_t solve_quartic(std::span<T const, 5> coeffs,
+                                        std::span<T, 4> roots)
     {
-        using zeus::is_zero;
-
-        assert(coeffs.size() == 5);
-
         auto weak_is_zero = [](T x) {
             return x > -std::numeric_limits<T>::epsilon()
                    && x < std::numeric_limits<T>::epsilon();
         };
 
-        if (roots.empty())
-        {
-            roots.resize(4);
-        }
-
-        std::vector<T> c(4);
+        std::array<T, 4> c{};
 
         // Quartic: x^4 + Ax^3 + Bx^2 + Cx + D = 0.
         T A = coeffs[3] / coeffs[4];
@@ -158,7 +298,7 @@ namespace atlas::math
             -T{3} / T{256} * sqA * sqA + T{1} / T{16} * sqA * B - T{1} / T{4} * A * C + D;
 
         std::size_t num{0};
-        if (is_zero<T>(r) || weak_is_zero(r))
+        if (detail::is_zero<T>(r) || weak_is_zero(r))
         {
             // No absolute term: y(y^3 + py + q) = 0.
             c[0] = q;
@@ -166,7 +306,7 @@ namespace atlas::math
             c[2] = 0;
             c[3] = 1;
 
-            num          = solve_cubic<T>(c, roots);
+            num = solve_cubic<T>(std::span<T const, 4>{c}, roots.template first<3>());
             roots[num++] = 0;
         }
         else
@@ -177,7 +317,7 @@ namespace atlas::math
             c[2] = -T{1} / T{2} * p;
             c[3] = 1;
 
-            solve_cubic<T>(c, roots);
+            solve_cubic<T>(std::span<T const, 4>{c}, roots.template first<3>());
 
             // And take the one real solution
             T z = roots[0];
@@ -186,26 +326,26 @@ namespace atlas::math
             T u = z * z - r;
             T v = 2 * z - p;
 
-            if (is_zero<T>(u) || weak_is_zero(u))
+            if (detail::is_zero<T>(u) || weak_is_zero(u))
             {
                 u = 0;
             }
             else if (u > 0)
             {
-                u = std::sqrt(u);
+                u = detail::sqrt(u);
             }
             else
             {
                 return 0;
             }
 
-            if (is_zero<T>(v) || weak_is_zero(v))
+            if (detail::is_zero<T>(v) || weak_is_zero(v))
             {
                 v = 0;
             }
             else if (v > 0)
             {
-                v = std::sqrt(v);
+                v = detail::sqrt(v);
             }
             else
             {
@@ -216,15 +356,17 @@ namespace atlas::math
             c[1] = (q < 0) ? -v : v;
             c[2] = 1;
 
-            num = solve_quadratic<T>(c, roots);
+            num = solve_quadratic<T>(std::span<T const, 4>{c}.template first<3>(),
+                                     roots.template first<2>());
 
             c[0] = z + u;
             c[1] = (q < 0) ? v : -v;
             c[2] = 1;
 
-            std::vector<T> s(2, T{0});
+            std::array<T, 2> s{};
             std::size_t tmp = num;
-            num += solve_quadratic<T>(c, s);
+            num += solve_quadratic<T>(std::span<T const, 4>{c}.template first<3>(),
+                                      std::span<T, 2>{s});
             roots[tmp]     = s[0];
             roots[tmp + 1] = s[1];
         }
@@ -239,4 +381,444 @@ namespace atlas::math
 
         return num;
     }
+
+    template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
+    constexpr std::size_t solve_quadratic(std::array<T, 3> const& coeffs,
+                                          std::array<T, 2>& roots)
+    {
+        return solve_quadratic<T>(std::span<T const, 3>{coeffs}, std::span<T, 2>{roots});
+    }
+
+    template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
+    constexpr std::size_t solve_cubic(std::array<T, 4> const& coeffs,
+                                      std::array<T, 3>& roots)
+    {
+        return solve_cubic<T>(std::span<T const, 4>{coeffs}, std::span<T, 3>{roots});
+    }
+
+    template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
+    constexpr std::size_t solve_quartic(std::array<T, 5> const& coeffs,
+                                        std::array<T, 4>& roots)
+    {
+        return solve_quartic<T>(std::span<T const, 5>{coeffs}, std::span<T, 4>{roots});
+    }
+
+    // Solves a polynomial whose degree is given by the size of the arrays.
+    // Coefficients are stored from the constant term upwards.
+    template<typename T,
+             std::size_t N,
+             typename = std::enable_if<std::is_floating_point<T>::value>>
+    constexpr std::size_t solve_polynomial(std::array<T, N> const& coeffs,
+                                           std::array<T, N - 1>& roots)
+    {
+        static_assert(N >= 3 && N <= 5, "only degrees 2 to 4 are supported");
+
+        if constexpr (N == 3)
+        {
+            return solve_quadratic<T>(coeffs, roots);
+        }
+        else if constexpr (N == 4)
+        {
+            return solve_cubic<T>(coeffs, roots);
+        }
+        else
+        {
+            return solve_quartic<T>(coeffs, roots);
+        }
+    }
+
+    template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
+    std::size_t solve_quadratic(std::vector<T> const& coeffs, std::vector<T>& roots)
+    {
+        assert(coeffs.size() >= 3);
+
+        if (roots.empty())
+        {
+            roots.resize(2);
+        }
+
+        assert(roots.size() >= 2);
+        return solve_quadratic<T>(std::span<T const, 3>{coeffs.data(), 3},
+                                  std::span<T, 2>{roots.data(), 2});
+    }
+
+    template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
+    std::size_t solve_cubic(std::vector<T> const& coeffs, std::vector<T>& roots)
+    {
+        assert(coeffs.size() >= 4);
+
+        if (roots.empty())
+        {
+            roots.resize(3);
+        }
+
+        assert(roots.size() >= 3);
+        return solve_cubic<T>(std::span<T const, 4>{coeffs.data(), 4},
+                              std::span<T, 3>{roots.data(), 3});
+    }
+
+    template<typename T, typename = std::enable_if<std::is_floating_point<T>::value>>
+    std::size_t solve_quartic(std::vector<T> const& coeffs, std::vector<T>& roots)
+    {
+        assert(coeffs.size() == 5);
+
+        if (roots.empty())
+        {
+            roots.resize(4);
+        }
+
+        assert(roots.size() >= 4);
+        return solve_quartic<T>(std::span<T const, 5>{coeffs.data(), 5},
+                                std::span<T, 4>{roots.data(), 4});
+    }
+
+    namespace detail
+    {
+        // Lane-wise equivalent of zeus::is_zero: the epsilon is scaled by
+        // the magnitude of x once it is above one, as zeus::are_equal does.
+        template<typename P>
+        typename P::mask_type pack_is_zero(P const& x)
+        {
+            using T        = typename P::value_type;
+            auto magnitude = abs(x);
+            return magnitude <=
+                   P{std::numeric_limits<T>::epsilon()} * max(P{T{1}}, magnitude);
+        }
+
+        template<typename P>
+        void
+        quadratic_kernel(P const& c0, P const& c1, P const& c2, P* roots, P& num)
+        {
+            using T = typename P::value_type;
+
+            P p = c1 / (T{2} * c2);
+            P q = c0 / c2;
+            P D = p * p - q;
+
+            auto zero     = pack_is_zero(D);
+            auto positive = (D > P{T{0}}) & !zero;
+
+            P sqrtD  = sqrt(max(D, P{T{0}}));
+            roots[0] = select(zero, -p, sqrtD - p);
+            roots[1] = -sqrtD - p;
+            num      = select(zero, P{T{1}}, select(positive, P{T{2}}, P{T{0}}));
+        }
+
+        template<typename P>
+        void cubic_kernel(P const& c0,
+                          P const& c1,
+                          P const& c2,
+                          P const& c3,
+                          P* roots,
+                          P& num)
+        {
+            using T        = typename P::value_type;
+            constexpr T pi = std::numbers::pi_v<T>;
+
+            P A = c2 / c3;
+            P B = c1 / c3;
+            P C = c0 / c3;
+
+            P sqA = A * A;
+            P p   = T{1} / T{3} * (-T{1} / T{3} * sqA + B);
+            P q   = T{1} / T{2} * (T{2} / T{27} * A * sqA - T{1} / T{3} * A * B + C);
+
+            P cbP = p * p * p;
+            P D   = q * q + cbP;
+
+            auto zero_D   = pack_is_zero(D);
+            auto zero_q   = pack_is_zero(q);
+            auto negative = (D < P{T{0}}) & !zero_D;
+            auto positive = !(zero_D | negative);
+
+            // Every branch of the scalar solver is evaluated for all lanes
+            // and the results are blended with the masks. The expensive
+            // transcendental branches are skipped when no lane needs them.
+            P double_root{T{0}};
+            if (any(zero_D & !zero_q))
+            {
+                double_root = cbrt(-q);
+            }
+
+            P trig0{T{0}};
+            P trig1{T{0}};
+            P trig2{T{0}};
+            if (any(negative))
+            {
+                P phi = T{1} / T{3} * acos(-q / sqrt(max(-cbP, P{T{0}})));
+                P t   = T{2} * sqrt(max(-p, P{T{0}}));
+
+                const auto piBy3 = pi / static_cast<T>(3);
+                trig0            = t * cos(phi);
+                trig1            = -t * cos(phi + piBy3);
+                trig2            = -t * cos(phi - piBy3);
+            }
+
+            P single{T{0}};
+            if (any(positive))
+            {
+                P sqrtD = sqrt(max(D, P{T{0}}));
+                P u     = cbrt(sqrtD - q);
+                P v     = -cbrt(sqrtD + q);
+                single  = u + v;
+            }
+
+            P sub = T{1} / T{3} * A;
+
+            roots[0] = select(zero_D,
+                              select(zero_q, P{T{0}}, T{2} * double_root),
+                              select(negative, trig0, single))
+                       - sub;
+            roots[1] = select(zero_D, -double_root, trig1) - sub;
+            roots[2] = trig2 - sub;
+
+            num = select(zero_D,
+                         select(zero_q, P{T{1}}, P{T{2}}),
+                         select(negative, P{T{3}}, P{T{1}}));
+        }
+
+        template<typename P>
+        void quartic_kernel(P const& c0,
+                            P const& c1,
+                            P const& c2,
+                            P const& c3,
+                            P const& c4,
+                            P* roots,
+                            P& num)
+        {
+            using T = typename P::value_type;
+
+            P A = c3 / c4;
+            P B = c2 / c4;
+            P C = c1 / c4;
+            P D = c0 / c4;
+
+            P sqA = A * A;
+            P p   = -T{3} / T{8} * sqA + B;
+            P q   = T{1} / T{8} * sqA * A - T{1} / T{2} * A * B + C;
+            P r   = -T{3} / T{256} * sqA * sqA + T{1} / T{16} * sqA * B
+                  - T{1} / T{4} * A * C + D;
+
+            P zero{T{0}};
+            P one{T{1}};
+            P two{T{2}};
+
+            auto zero_r = pack_is_zero(r);
+
+            // No absolute term: y(y^3 + py + q) = 0.
+            std::array<P, 4> depressed{};
+            P num_depressed{T{0}};
+            if (any(zero_r))
+            {
+                P cubic_num;
+                cubic_kernel(q, p, zero, one, depressed.data(), cubic_num);
+
+                // The extra root at zero goes right after the cubic roots.
+                depressed[3] = zero;
+                for (std::size_t i{0}; i < 3; ++i)
+                {
+                    depressed[i] =
+                        select(cubic_num == P{static_cast<T>(i)}, zero, depressed[i]);
+                }
+                num_depressed = cubic_num + one;
+            }
+
+            // Otherwise solve the resolvent cubic and split into two
+            // quadratics.
+            std::array<P, 4> split{};
+            P num_split{T{0}};
+            if (!all(zero_r))
+            {
+                std::array<P, 3> cubic_roots;
+                P cubic_num;
+                cubic_kernel(T{1} / T{2} * r * p - T{1} / T{8} * q * q,
+                             -r,
+                             -T{1} / T{2} * p,
+                             one,
+                             cubic_roots.data(),
+                             cubic_num);
+
+                P z = cubic_roots[0];
+                P u = z * z - r;
+                P v = T{2} * z - p;
+
+                auto zero_u = pack_is_zero(u);
+                auto zero_v = pack_is_zero(v);
+                auto valid  = (zero_u | (u > zero)) & (zero_v | (v > zero));
+
+                u = select(zero_u, zero, sqrt(max(u, zero)));
+                v = select(zero_v, zero, sqrt(max(v, zero)));
+
+                auto q_negative = q < zero;
+
+                std::array<P, 2> first;
+                P num_first;
+                quadratic_kernel(z - u,
+                                 select(q_negative, -v, v),
+                                 one,
+                                 first.data(),
+                                 num_first);
+
+                std::array<P, 2> second;
+                P num_second;
+                quadratic_kernel(z + u,
+                                 select(q_negative, v, -v),
+                                 one,
+                                 second.data(),
+                                 num_second);
+
+                // The roots of the second quadratic are packed right after
+                // those of the first one.
+                auto first_two = num_first == two;
+                auto first_one = num_first == one;
+
+                split[0] = select(num_first >= one, first[0], second[0]);
+                split[1] =
+                    select(first_two, first[1], select(first_one, second[0], second[1]));
+                split[2] = select(first_two, second[0], second[1]);
+                split[3] = second[1];
+
+                num_split = select(valid, num_first + num_second, zero);
+            }
+
+            P sub = T{1} / T{4} * A;
+            for (std::size_t i{0}; i < 4; ++i)
+            {
+                roots[i] = select(zero_r, depressed[i], split[i]) - sub;
+            }
+            num = select(zero_r, num_depressed, num_split);
+        }
+
+        template<typename T,
+                 std::size_t W,
+                 std::size_t Degree,
+                 typename Kernel,
+                 typename Scalar>
+        void solve_batch(std::array<std::span<T const>, Degree + 1> const& coeffs,
+                         std::array<std::span<T>, Degree> const& roots,
+                         std::span<std::size_t> num_roots,
+                         Kernel&& kernel,
+                         Scalar&& scalar)
+        {
+            using P = simd::Pack<T, W>;
+
+            std::size_t count = num_roots.size();
+            for (auto const& c : coeffs)
+            {
+                assert(c.size() >= count);
+            }
+            for (auto const& r : roots)
+            {
+                assert(r.size() >= count);
+            }
+
+            std::size_t i{0};
+            for (; i + W <= count; i += W)
+            {
+                std::array<P, Degree + 1> c;
+                for (std::size_t k{0}; k <= Degree; ++k)
+                {
+                    c[k] = P::load(coeffs[k].data() + i);
+                }
+
+                std::array<P, Degree> r;
+                P num;
+                kernel(c, r.data(), num);
+
+                for (std::size_t k{0}; k < Degree; ++k)
+                {
+                    r[k].store(roots[k].data() + i);
+                }
+
+                alignas(64) std::array<T, W> n;
+                num.store(n.data());
+                for (std::size_t lane{0}; lane < W; ++lane)
+                {
+                    num_roots[i + lane] = static_cast<std::size_t>(n[lane]);
+                }
+            }
+
+            // Scalar tail for whatever does not fill a whole pack.
+            for (; i < count; ++i)
+            {
+                std::array<T, Degree + 1> c;
+                for (std::size_t k{0}; k <= Degree; ++k)
+                {
+                    c[k] = coeffs[k][i];
+                }
+
+                std::array<T, Degree> r{};
+                num_roots[i] = scalar(c, r);
+                for (std::size_t k{0}; k < Degree; ++k)
+                {
+                    roots[k][i] = r[k];
+                }
+            }
+        }
+    } // namespace detail
+
+    // Batched solvers operating on structure-of-arrays input: coeffs[k][i]
+    // is the coefficient of x^k for equation i and roots[k][i] receives its
+    // k-th root. Equations are processed W at a time using the widest SIMD
+    // registers available, with a scalar tail for the remainder. Only the
+    // first num_roots[i] roots of each equation are meaningful.
+    template<typename T,
+             std::size_t W = simd::native_width<T>,
+             typename      = std::enable_if<std::is_floating_point<T>::value>>
+    void solve_quadratic_batch(std::array<std::span<T const>, 3> const& coeffs,
+                               std::array<std::span<T>, 2> const& roots,
+                               std::span<std::size_t> num_roots)
+    {
+        using P = simd::Pack<T, W>;
+        detail::solve_batch<T, W, 2>(
+            coeffs,
+            roots,
+            num_roots,
+            [](std::array<P, 3> const& c, P* r, P& num) {
+                detail::quadratic_kernel(c[0], c[1], c[2], r, num);
+            },
+            [](std::array<T, 3> const& c, std::array<T, 2>& r) {
+                return solve_quadratic<T>(c, r);
+            });
+    }
+
+    template<typename T,
+             std::size_t W = simd::native_width<T>,
+             typename      = std::enable_if<std::is_floating_point<T>::value>>
+    void solve_cubic_batch(std::array<std::span<T const>, 4> const& coeffs,
+                           std::array<std::span<T>, 3> const& roots,
+                           std::span<std::size_t> num_roots)
+    {
+        using P = simd::Pack<T, W>;
+        detail::solve_batch<T, W, 3>(
+            coeffs,
+            roots,
+            num_roots,
+            [](std::array<P, 4> const& c, P* r, P& num) {
+                detail::cubic_kernel(c[0], c[1], c[2], c[3], r, num);
+            },
+            [](std::array<T, 4> const& c, std::array<T, 3>& r) {
+                return solve_cubic<T>(c, r);
+            });
+    }
+
+    template<typename T,
+             std::size_t W = simd::native_width<T>,
+             typename      = std::enable_if<std::is_floating_point<T>::value>>
+    void solve_quartic_batch(std::array<std::span<T const>, 5> const& coeffs,
+                             std::array<std::span<T>, 4> const& roots,
+                             std::span<std::size_t> num_roots)
+    {
+        using P = simd::Pack<T, W>;
+        detail::solve_batch<T, W, 4>(
+            coeffs,
+            roots,
+            num_roots,
+            [](std::array<P, 5> const& c, P* r, P& num) {
+                detail::quartic_kernel(c[0], c[1], c[2], c[3], c[4], r, num);
+            },
+            [](std::array<T, 5> const& c, std::array<T, 4>& r) {
+                return solve_quartic<T>(c, r);
+            });
+    }
 } // namespace atlas::math
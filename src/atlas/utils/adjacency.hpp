@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+namespace atlas::utils::detail
+{
+    // Items grouped by key in compressed sparse rows: the items of key k are
+    // items[offsets[k]] to items[offsets[k + 1]], in the order they appear in
+    // keys. Item i is stored as i / group_size, so the index buffer of a mesh
+    // with a group size of 3 gives the triangles around each vertex, and with
+    // a group size of 1 the corners around each vertex.
+    struct Adjacency
+    {
+        Adjacency(std::vector<std::size_t> const& keys,
+                  std::size_t key_count,
+                  std::size_t group_size = 1) :
+            offsets(key_count + 1, 0),
+            items(keys.size())
+        {
+            for (auto key : keys)
+            {
+                ++offsets[key + 1];
+            }
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            auto next = offsets;
+            for (std::size_t i{0}; i < keys.size(); ++i)
+            {
+                items[next[keys[i]]++] = i / group_size;
+            }
+        }
+
+        std::size_t begin(std::size_t key) const
+        {
+            return offsets[key];
+        }
+
+        std::size_t end(std::size_t key) const
+        {
+            return offsets[key + 1];
+        }
+
+        std::size_t count(std::size_t key) const
+        {
+            return offsets[key + 1] - offsets[key];
+        }
+
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> items;
+    };
+} // namespace atlas::utils::detail
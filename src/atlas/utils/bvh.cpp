@@ -0,0 +1,681 @@
+#include "bvh.hpp"
+
+#include <atlas/math/simd.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+
+namespace atlas::utils
+{
+    namespace
+    {
+        // Limits the depth of the binary tree, which in turn bounds the size
+        // of the traversal stack.
+        constexpr std::size_t max_depth{64};
+        constexpr std::size_t max_bins{64};
+
+        math::AABB empty_box()
+        {
+            return {glm::vec3{std::numeric_limits<float>::infinity()},
+                    glm::vec3{-std::numeric_limits<float>::infinity()}};
+        }
+
+        void grow(math::AABB& box, glm::vec3 const& p)
+        {
+            box.min = glm::min(box.min, p);
+            box.max = glm::max(box.max, p);
+        }
+
+        void grow(math::AABB& box, math::AABB const& other)
+        {
+            box.min = glm::min(box.min, other.min);
+            box.max = glm::max(box.max, other.max);
+        }
+
+        float surface_area(math::AABB const& box)
+        {
+            glm::vec3 d = box.max - box.min;
+            if (d.x < 0.0f)
+            {
+                return 0.0f;
+            }
+
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+
+        struct BuildNode
+        {
+            math::AABB bounds;
+            std::unique_ptr<BuildNode> left;
+            std::unique_ptr<BuildNode> right;
+            std::uint32_t first{0};
+            std::uint32_t count{0};
+
+            bool is_leaf() const
+            {
+                return !left;
+            }
+        };
+
+        struct Bin
+        {
+            math::AABB bounds{empty_box()};
+            std::uint32_t count{0};
+        };
+
+        // Bins for all three axes, stored as [axis * bin_count + bin].
+        using Bins = std::vector<Bin>;
+
+        struct RangeInfo
+        {
+            math::AABB bounds{empty_box()};
+            math::AABB centroid_bounds{empty_box()};
+        };
+
+        class Builder
+        {
+        public:
+            Builder(std::vector<math::AABB> const& boxes,
+                    std::vector<glm::vec3> const& centroids,
+                    jobs::JobSystem& system,
+                    BvhSettings const& settings) :
+                m_boxes{boxes},
+                m_centroids{centroids},
+                m_system{&system},
+                m_settings{settings},
+                m_bin_count{std::clamp<std::size_t>(settings.bin_count, 2, max_bins)},
+                m_thread_count{static_cast<std::uint32_t>(system.thread_count())}
+            {
+                m_order.resize(boxes.size());
+                for (std::uint32_t i{0}; i < m_order.size(); ++i)
+                {
+                    m_order[i] = i;
+                }
+
+                // Only fork while there are idle threads left to pick up the
+                // work; deeper levels run on the thread that reached them.
+                m_spawn_depth =
+                    static_cast<std::size_t>(std::bit_width(m_thread_count)) + 1;
+            }
+
+            std::unique_ptr<BuildNode> build()
+            {
+                auto count = static_cast<std::uint32_t>(m_order.size());
+                return build(0, count, range_info(0, count), 0);
+            }
+
+            std::vector<std::uint32_t> const& order() const
+            {
+                return m_order;
+            }
+
+        private:
+            // Runs fn over [first, first + count) in chunks, in parallel if
+            // the range is large enough, and merges the partial results.
+            template<typename Result, typename Fn, typename Merge>
+            Result reduce(std::uint32_t first,
+                          std::uint32_t count,
+                          Result const& identity,
+                          Fn&& fn,
+                          Merge&& merge)
+            {
+                std::uint32_t chunks = std::min<std::uint32_t>(
+                    m_thread_count,
+                    count / static_cast<std::uint32_t>(m_settings.parallel_threshold));
+                if (chunks <= 1)
+                {
+                    Result result{identity};
+                    fn(result, first, first + count);
+                    return result;
+                }
+
+                std::vector<Result> partials(chunks, identity);
+                std::uint32_t step = count / chunks;
+                auto run_chunks = [&](std::size_t begin, std::size_t end) {
+                    for (auto c = static_cast<std::uint32_t>(begin); c < end; ++c)
+                    {
+                        std::uint32_t chunk_begin = first + c * step;
+                        std::uint32_t chunk_end =
+                            (c + 1 == chunks) ? first + count : chunk_begin + step;
+                        fn(partials[c], chunk_begin, chunk_end);
+                    }
+                };
+                m_system->parallel_for(chunks, 1, run_chunks);
+
+                Result result = std::move(partials[0]);
+                for (std::size_t c{1}; c < partials.size(); ++c)
+                {
+                    merge(result, partials[c]);
+                }
+                return result;
+            }
+
+            RangeInfo range_info(std::uint32_t first, std::uint32_t count)
+            {
+                return reduce<RangeInfo>(
+                    first,
+                    count,
+                    RangeInfo{},
+                    [this](RangeInfo& info, std::uint32_t begin, std::uint32_t end) {
+                        for (std::uint32_t i{begin}; i < end; ++i)
+                        {
+                            grow(info.bounds, m_boxes[m_order[i]]);
+                            grow(info.centroid_bounds, m_centroids[m_order[i]]);
+                        }
+                    },
+                    [](RangeInfo& a, RangeInfo const& b) {
+                        grow(a.bounds, b.bounds);
+                        grow(a.centroid_bounds, b.centroid_bounds);
+                    });
+            }
+
+            std::size_t bin_index(glm::vec3 const& c,
+                                  std::size_t axis,
+                                  math::AABB const& centroid_bounds) const
+            {
+                auto a       = static_cast<int>(axis);
+                float extent = centroid_bounds.max[a] - centroid_bounds.min[a];
+                float offset = (c[a] - centroid_bounds.min[a]) / extent;
+                auto bin =
+                    static_cast<std::size_t>(offset * static_cast<float>(m_bin_count));
+                return std::min(bin, m_bin_count - 1);
+            }
+
+            Bins compute_bins(std::uint32_t first,
+                              std::uint32_t count,
+                              math::AABB const& centroid_bounds)
+            {
+                return reduce<Bins>(
+                    first,
+                    count,
+                    Bins(3 * m_bin_count),
+                    [&](Bins& bins, std::uint32_t begin, std::uint32_t end) {
+                        for (std::uint32_t i{begin}; i < end; ++i)
+                        {
+                            auto prim = m_order[i];
+                            for (std::size_t axis{0}; axis < 3; ++axis)
+                            {
+                                auto a = static_cast<int>(axis);
+                                if (centroid_bounds.max[a] <= centroid_bounds.min[a])
+                                {
+                                    continue;
+                                }
+
+                                auto& bin = bins[axis * m_bin_count
+                                                 + bin_index(m_centroids[prim],
+                                                             axis,
+                                                             centroid_bounds)];
+                                grow(bin.bounds, m_boxes[prim]);
+                                ++bin.count;
+                            }
+                        }
+                    },
+                    [this](Bins& a, Bins const& b) {
+                        for (std::size_t i{0}; i < a.size(); ++i)
+                        {
+                            grow(a[i].bounds, b[i].bounds);
+                            a[i].count += b[i].count;
+                        }
+                    });
+            }
+
+            // info holds the bounds of the range, which the parent already
+            // knows from its split so they don't have to be recomputed.
+            std::unique_ptr<BuildNode> build(std::uint32_t first,
+                                             std::uint32_t count,
+                                             RangeInfo const& info,
+                                             std::size_t depth)
+            {
+                auto node    = std::make_unique<BuildNode>();
+                node->bounds = info.bounds;
+                node->first  = first;
+                node->count  = count;
+
+                if (count <= 1 || depth >= max_depth)
+                {
+                    return node;
+                }
+
+                // Find the cheapest split over all axes by sweeping the bins
+                // from both ends.
+                auto bins       = compute_bins(first, count, info.centroid_bounds);
+                float best_cost = std::numeric_limits<float>::max();
+                std::size_t best_axis{0};
+                std::size_t best_split{0};
+                RangeInfo left_info;
+                RangeInfo right_info;
+                for (std::size_t axis{0}; axis < 3; ++axis)
+                {
+                    if (info.centroid_bounds.max[axis] <= info.centroid_bounds.min[axis])
+                    {
+                        continue;
+                    }
+
+                    Bin const* axis_bins = bins.data() + axis * m_bin_count;
+                    std::array<float, max_bins> right_cost;
+                    std::array<math::AABB, max_bins> right_boxes;
+                    math::AABB right_box = empty_box();
+                    std::uint32_t right_count{0};
+                    for (std::size_t i{m_bin_count - 1}; i > 0; --i)
+                    {
+                        grow(right_box, axis_bins[i].bounds);
+                        right_count += axis_bins[i].count;
+                        right_cost[i]  = surface_area(right_box) * right_count;
+                        right_boxes[i] = right_box;
+                    }
+
+                    math::AABB left_box = empty_box();
+                    std::uint32_t left_count{0};
+                    for (std::size_t i{1}; i < m_bin_count; ++i)
+                    {
+                        grow(left_box, axis_bins[i - 1].bounds);
+                        left_count += axis_bins[i - 1].count;
+                        float cost = surface_area(left_box) * left_count + right_cost[i];
+                        if (left_count != 0 && left_count != count && cost < best_cost)
+                        {
+                            best_cost         = cost;
+                            best_axis         = axis;
+                            best_split        = i;
+                            left_info.bounds  = left_box;
+                            right_info.bounds = right_boxes[i];
+                        }
+                    }
+                }
+
+                std::uint32_t mid;
+                if (best_split != 0)
+                {
+                    float leaf_cost  = m_settings.intersection_cost * count;
+                    float split_cost = m_settings.traversal_cost
+                                       + m_settings.intersection_cost * best_cost
+                                             / surface_area(info.bounds);
+                    if (count <= m_settings.max_leaf_size && leaf_cost <= split_cost)
+                    {
+                        return node;
+                    }
+
+                    // Partition in place, gathering the centroid bounds of
+                    // both sides along the way.
+                    std::uint32_t i{first};
+                    std::uint32_t j{first + count};
+                    while (i < j)
+                    {
+                        auto const& c = m_centroids[m_order[i]];
+                        if (bin_index(c, best_axis, info.centroid_bounds) < best_split)
+                        {
+                            grow(left_info.centroid_bounds, c);
+                            ++i;
+                        }
+                        else
+                        {
+                            grow(right_info.centroid_bounds, c);
+                            std::swap(m_order[i], m_order[--j]);
+                        }
+                    }
+                    mid = i;
+                }
+                else
+                {
+                    // All the centroids coincide, so the SAH cannot tell the
+                    // triangles apart. Split down the middle if the leaf
+                    // would be too big.
+                    if (count <= m_settings.max_leaf_size)
+                    {
+                        return node;
+                    }
+
+                    mid        = first + count / 2;
+                    left_info  = range_info(first, mid - first);
+                    right_info = range_info(mid, first + count - mid);
+                }
+
+                std::uint32_t left_count  = mid - first;
+                std::uint32_t right_count = count - left_count;
+                if (depth < m_spawn_depth && count >= m_settings.parallel_threshold)
+                {
+                    // The left half runs as a job while this thread builds
+                    // the right one, then helps with other jobs until the
+                    // left half is done.
+                    auto left = m_system->submit([&, this]() {
+                        node->left = build(first, left_count, left_info, depth + 1);
+                    });
+                    node->right = build(mid, right_count, right_info, depth + 1);
+                    m_system->wait(left);
+                }
+                else
+                {
+                    node->left  = build(first, left_count, left_info, depth + 1);
+                    node->right = build(mid, right_count, right_info, depth + 1);
+                }
+
+                return node;
+            }
+
+            std::vector<math::AABB> const& m_boxes;
+            std::vector<glm::vec3> const& m_centroids;
+            jobs::JobSystem* m_system;
+            BvhSettings const& m_settings;
+            std::size_t m_bin_count;
+            std::uint32_t m_thread_count;
+            std::size_t m_spawn_depth;
+            std::vector<std::uint32_t> m_order;
+        };
+
+        // Per-ray data shared by every node test.
+        struct TraversalRay
+        {
+            explicit TraversalRay(math::Ray<glm::vec3> const& r) :
+                ray{r},
+                inv_d{1.0f / r.d}
+            {
+                for (int axis{0}; axis < 3; ++axis)
+                {
+                    negative[axis] = inv_d[axis] < 0.0f;
+                }
+            }
+
+            math::Ray<glm::vec3> ray;
+            glm::vec3 inv_d;
+            std::array<bool, 3> negative;
+        };
+
+        // Slab test of a ray against all children of a node. Picking the
+        // near and far planes by the sign of the direction (rather than
+        // taking the min/max of both) makes the empty boxes of unused
+        // slots miss.
+        template<std::size_t Width>
+        std::uint64_t intersect_children(typename Bvh<Width>::Node const& node,
+                                         TraversalRay const& r,
+                                         float t_min,
+                                         float t_max,
+                                         std::array<float, Width>& t_near)
+        {
+            using pack_type = math::simd::Pack<float, Width>;
+
+            pack_type near_t{t_min};
+            pack_type far_t{t_max};
+            for (std::size_t axis{0}; axis < 3; ++axis)
+            {
+                bool negative          = r.negative[axis];
+                auto const& near_plane = negative ? node.max[axis] : node.min[axis];
+                auto const& far_plane  = negative ? node.min[axis] : node.max[axis];
+
+                pack_type o{r.ray.o[static_cast<int>(axis)]};
+                pack_type inv_d{r.inv_d[static_cast<int>(axis)]};
+                pack_type t0 = (pack_type::load(near_plane.data()) - o) * inv_d;
+                pack_type t1 = (pack_type::load(far_plane.data()) - o) * inv_d;
+
+                // min/max return their second operand for NaN (0 * inf), so
+                // the running interval goes last.
+                near_t = max(t0, near_t);
+                far_t  = min(t1, far_t);
+            }
+
+            near_t.store(t_near.data());
+            return (near_t <= far_t).bits();
+        }
+
+        struct StackEntry
+        {
+            std::uint32_t node;
+            float t_near;
+        };
+    } // namespace
+
+    template<std::size_t Width>
+    Bvh<Width>::Bvh(ObjMesh const& mesh,
+                    jobs::JobSystem& system,
+                    BvhSettings const& settings)
+    {
+        std::vector<math::Triangle> triangles;
+        std::vector<TriangleRef> refs;
+        for (std::size_t s{0}; s < mesh.shapes.size(); ++s)
+        {
+            auto const& shape = mesh.shapes[s];
+            for (std::size_t f{0}; f + 2 < shape.indices.size(); f += 3)
+            {
+                triangles.push_back({shape.vertices[shape.indices[f + 0]].position,
+                                     shape.vertices[shape.indices[f + 1]].position,
+                                     shape.vertices[shape.indices[f + 2]].position});
+                refs.push_back(
+                    {static_cast<std::uint32_t>(s), static_cast<std::uint32_t>(f / 3)});
+            }
+        }
+
+        if (triangles.empty())
+        {
+            return;
+        }
+
+        std::vector<math::AABB> boxes(triangles.size());
+        std::vector<glm::vec3> centroids(triangles.size());
+        for (std::size_t i{0}; i < triangles.size(); ++i)
+        {
+            auto const& tri = triangles[i];
+            boxes[i]        = {glm::min(tri.v0, glm::min(tri.v1, tri.v2)),
+                        glm::max(tri.v0, glm::max(tri.v1, tri.v2))};
+            centroids[i]    = 0.5f * (boxes[i].min + boxes[i].max);
+        }
+
+        Builder builder{boxes, centroids, system, settings};
+        auto root = builder.build();
+        m_bounds  = root->bounds;
+
+        // Collapse the binary tree. Each wide node repeatedly opens its
+        // largest inner child until it has Width children, and the
+        // triangles are stored in leaf order so every leaf is a contiguous
+        // range.
+        auto const& order = builder.order();
+        m_triangles.reserve(triangles.size());
+        m_refs.reserve(triangles.size());
+
+        auto flatten = [&](auto&& self, BuildNode const& binary) -> std::uint32_t {
+            std::array<BuildNode const*, Width> children{};
+            std::size_t child_count{0};
+            if (binary.is_leaf())
+            {
+                children[child_count++] = &binary;
+            }
+            else
+            {
+                children[child_count++] = binary.left.get();
+                children[child_count++] = binary.right.get();
+            }
+
+            while (child_count < Width)
+            {
+                std::size_t best{Width};
+                float best_area{-1.0f};
+                for (std::size_t i{0}; i < child_count; ++i)
+                {
+                    float area = surface_area(children[i]->bounds);
+                    if (!children[i]->is_leaf() && area > best_area)
+                    {
+                        best      = i;
+                        best_area = area;
+                    }
+                }
+
+                if (best == Width)
+                {
+                    break;
+                }
+
+                BuildNode const* opened   = children[best];
+                children[best]            = opened->left.get();
+                children[child_count++]   = opened->right.get();
+            }
+
+            auto index = static_cast<std::uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+
+            Node node;
+            auto empty = empty_box();
+            for (std::size_t i{0}; i < Width; ++i)
+            {
+                math::AABB box = (i < child_count) ? children[i]->bounds : empty;
+                for (int axis{0}; axis < 3; ++axis)
+                {
+                    node.min[axis][i] = box.min[axis];
+                    node.max[axis][i] = box.max[axis];
+                }
+                node.child[i] = std::numeric_limits<std::uint32_t>::max();
+                node.count[i] = 0;
+            }
+
+            for (std::size_t i{0}; i < child_count; ++i)
+            {
+                auto const& child = *children[i];
+                if (child.is_leaf())
+                {
+                    node.child[i] = static_cast<std::uint32_t>(m_triangles.size());
+                    node.count[i] = child.count;
+                    for (std::uint32_t p{child.first}; p < child.first + child.count; ++p)
+                    {
+                        m_triangles.push_back(triangles[order[p]]);
+                        m_refs.push_back(refs[order[p]]);
+                    }
+                }
+                else
+                {
+                    node.child[i] = self(self, child);
+                }
+            }
+
+            m_nodes[index] = node;
+            return index;
+        };
+
+        flatten(flatten, *root);
+        m_nodes.shrink_to_fit();
+    }
+
+    template<std::size_t Width>
+    std::optional<BvhHit> Bvh<Width>::closest_hit(math::Ray<glm::vec3> const& ray,
+                                                  float t_min,
+                                                  float t_max) const
+    {
+        if (m_nodes.empty())
+        {
+            return {};
+        }
+
+        TraversalRay r{ray};
+        std::optional<BvhHit> result;
+
+        std::array<StackEntry, max_depth * Width> stack;
+        std::size_t top{0};
+        stack[top++] = {0, t_min};
+
+        std::array<float, Width> t_near;
+        while (top != 0)
+        {
+            auto entry = stack[--top];
+            if (entry.t_near > t_max)
+            {
+                continue;
+            }
+
+            auto const& node = m_nodes[entry.node];
+            auto hits = intersect_children<Width>(node, r, t_min, t_max, t_near);
+
+            // Visit the hit children front to back: leaves are intersected
+            // right away and inner nodes are pushed so that the nearest one
+            // is popped first.
+            std::array<std::uint32_t, Width> sorted;
+            std::size_t hit_count{0};
+            for (; hits != 0; hits &= hits - 1)
+            {
+                auto i = static_cast<std::uint32_t>(std::countr_zero(hits));
+                std::size_t j{hit_count++};
+                for (; j > 0 && t_near[sorted[j - 1]] > t_near[i]; --j)
+                {
+                    sorted[j] = sorted[j - 1];
+                }
+                sorted[j] = i;
+            }
+
+            for (std::size_t k{0}; k < hit_count; ++k)
+            {
+                auto i = sorted[k];
+                if (node.count[i] == 0 || t_near[i] > t_max)
+                {
+                    continue;
+                }
+
+                std::uint32_t end = node.child[i] + node.count[i];
+                for (std::uint32_t p{node.child[i]}; p < end; ++p)
+                {
+                    if (auto hit = math::intersect(ray, m_triangles[p], t_min, t_max))
+                    {
+                        t_max  = hit->t;
+                        result = BvhHit{hit->t,
+                                        hit->u,
+                                        hit->v,
+                                        m_refs[p].shape_id,
+                                        m_refs[p].face_id};
+                    }
+                }
+            }
+
+            for (std::size_t k{hit_count}; k > 0; --k)
+            {
+                auto i = sorted[k - 1];
+                if (node.count[i] == 0 && t_near[i] <= t_max)
+                {
+                    stack[top++] = {node.child[i], t_near[i]};
+                }
+            }
+        }
+
+        return result;
+    }
+
+    template<std::size_t Width>
+    bool Bvh<Width>::any_hit(math::Ray<glm::vec3> const& ray,
+                             float t_min,
+                             float t_max) const
+    {
+        if (m_nodes.empty())
+        {
+            return false;
+        }
+
+        TraversalRay r{ray};
+
+        std::array<std::uint32_t, max_depth * Width> stack;
+        std::size_t top{0};
+        stack[top++] = 0;
+
+        std::array<float, Width> t_near;
+        while (top != 0)
+        {
+            auto const& node = m_nodes[stack[--top]];
+            auto hits = intersect_children<Width>(node, r, t_min, t_max, t_near);
+            for (; hits != 0; hits &= hits - 1)
+            {
+                auto i = static_cast<std::size_t>(std::countr_zero(hits));
+                if (node.count[i] == 0)
+                {
+                    stack[top++] = node.child[i];
+                    continue;
+                }
+
+                std::uint32_t end = node.child[i] + node.count[i];
+                for (std::uint32_t p{node.child[i]}; p < end; ++p)
+                {
+                    if (math::intersect(ray, m_triangles[p], t_min, t_max))
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
+    template class Bvh<4>;
+    template class Bvh<8>;
+} // namespace atlas::utils
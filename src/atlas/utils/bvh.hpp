@@ -0,0 +1,120 @@
+#pragma once
+
+#include "load_obj_file.hpp"
+
+#include <atlas/jobs/job_system.hpp>
+#include <atlas/math/glm.hpp>
+#include <atlas/math/intersections.hpp>
+#include <atlas/math/ray.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace atlas::utils
+{
+    struct BvhSettings
+    {
+        // Number of bins used to evaluate the SAH along each axis (at most
+        // 64).
+        std::size_t bin_count{16};
+
+        // Nodes with more triangles than this are always split.
+        std::size_t max_leaf_size{8};
+
+        // Relative costs used by the SAH.
+        float traversal_cost{1.0f};
+        float intersection_cost{1.0f};
+
+        // Ranges with fewer triangles than this are built by a single job.
+        std::size_t parallel_threshold{16384};
+    };
+
+    struct BvhHit
+    {
+        float t;
+        float u;
+        float v;
+        std::uint32_t shape_id;
+        std::uint32_t face_id;
+    };
+
+    // Bounding volume hierarchy over all the triangles of an ObjMesh. The
+    // tree is first built as a binary tree using binned SAH and then
+    // collapsed into nodes with Width children each, which are tested
+    // against a ray all at once.
+    template<std::size_t Width>
+    class Bvh
+    {
+    public:
+        static_assert(Width == 4 || Width == 8, "only BVH4 and BVH8 are supported");
+
+        struct Node
+        {
+            // Bounds of each child, stored per axis so the slab test runs
+            // across all children at once. Unused slots hold an empty box.
+            std::array<std::array<float, Width>, 3> min;
+            std::array<std::array<float, Width>, 3> max;
+
+            // For inner children the index of the child node, for leaves the
+            // index of the first triangle.
+            std::array<std::uint32_t, Width> child;
+
+            // Number of triangles in a leaf, 0 for inner nodes and unused
+            // slots.
+            std::array<std::uint32_t, Width> count;
+        };
+
+        Bvh() = default;
+
+        // Large ranges are split and binned in parallel on the system.
+        Bvh(ObjMesh const& mesh,
+            jobs::JobSystem& system,
+            BvhSettings const& settings = {});
+
+        std::optional<BvhHit>
+        closest_hit(math::Ray<glm::vec3> const& ray,
+                    float t_min = 0.0f,
+                    float t_max = std::numeric_limits<float>::max()) const;
+
+        bool any_hit(math::Ray<glm::vec3> const& ray,
+                     float t_min = 0.0f,
+                     float t_max = std::numeric_limits<float>::max()) const;
+
+        math::AABB bounds() const
+        {
+            return m_bounds;
+        }
+
+        std::vector<Node> const& nodes() const
+        {
+            return m_nodes;
+        }
+
+        std::size_t triangle_count() const
+        {
+            return m_triangles.size();
+        }
+
+    private:
+        struct TriangleRef
+        {
+            std::uint32_t shape_id;
+            std::uint32_t face_id;
+        };
+
+        std::vector<Node> m_nodes;
+        std::vector<math::Triangle> m_triangles;
+        std::vector<TriangleRef> m_refs;
+        math::AABB m_bounds{glm::vec3{0.0f}, glm::vec3{0.0f}};
+    };
+
+    using Bvh4 = Bvh<4>;
+    using Bvh8 = Bvh<8>;
+
+    extern template class Bvh<4>;
+    extern template class Bvh<8>;
+} // namespace atlas::utils
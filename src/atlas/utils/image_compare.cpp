@@ -0,0 +1,250 @@
+#include "image_compare.hpp"
+
+#include <atlas/math/simd.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fmt/printf.h>
+
+namespace atlas::utils
+{
+    namespace
+    {
+        namespace simd = math::simd;
+
+        constexpr std::size_t lanes{std::min<std::size_t>(simd::native_width<float>, 16)};
+        using Floats = simd::Pack<float, lanes>;
+
+        // Pixels are converted to floats in chunks small enough to stay in
+        // the L1 cache. Must be a multiple of the number of lanes.
+        constexpr std::size_t chunk_size{64};
+
+        // YIQ difference between black and white.
+        constexpr float max_delta{35215.0f};
+
+        struct Channels
+        {
+            std::array<float, chunk_size> r;
+            std::array<float, chunk_size> g;
+            std::array<float, chunk_size> b;
+            std::array<float, chunk_size> a;
+        };
+
+        // De-interleaves count pixels with N channels each into out.
+        template<std::size_t N>
+        void split_channels(unsigned char const* pixel, std::size_t count, Channels& out)
+        {
+            for (std::size_t i{0}; i < count; ++i, pixel += N)
+            {
+                if constexpr (N >= 3)
+                {
+                    out.r[i] = pixel[0];
+                    out.g[i] = pixel[1];
+                    out.b[i] = pixel[2];
+                }
+                else
+                {
+                    out.r[i] = out.g[i] = out.b[i] = pixel[0];
+                }
+
+                out.a[i] = (N % 2 == 0) ? pixel[N - 1] : 255.0f;
+            }
+        }
+
+        // Splits the pixels into one array per channel. Grey images are
+        // expanded to RGB, and the tail of the last chunk is opaque black so
+        // that it never differs.
+        void load_chunk(ImageData const& image,
+                        std::size_t first,
+                        std::size_t count,
+                        Channels& out)
+        {
+            auto const channels = static_cast<std::size_t>(image.channels);
+            auto pixel          = image.pixels.data() + first * channels;
+            switch (channels)
+            {
+            case 1:
+                split_channels<1>(pixel, count, out);
+                break;
+
+            case 2:
+                split_channels<2>(pixel, count, out);
+                break;
+
+            case 3:
+                split_channels<3>(pixel, count, out);
+                break;
+
+            default:
+                split_channels<4>(pixel, count, out);
+                break;
+            }
+
+            for (std::size_t i{count}; i < chunk_size; ++i)
+            {
+                out.r[i] = out.g[i] = out.b[i] = 0.0f;
+                out.a[i]                       = 255.0f;
+            }
+        }
+
+        bool is_valid(ImageData const& image)
+        {
+            auto size = static_cast<std::size_t>(image.width) * image.height *
+                        image.channels;
+            return !image.is_float && image.width > 0 && image.height > 0 &&
+                   image.channels >= 1 && image.channels <= 4 &&
+                   image.pixels.size() == size;
+        }
+    } // namespace
+
+    std::optional<ImageDiff> compare_images(ImageData const& reference,
+                                            ImageData const& image,
+                                            float threshold)
+    {
+        if (!is_valid(reference) || !is_valid(image))
+        {
+            fmt::print(stderr, "error: only 8-bit images can be compared\n");
+            return {};
+        }
+
+        if (reference.width != image.width || reference.height != image.height ||
+            reference.channels != image.channels)
+        {
+            fmt::print(stderr,
+                       "error: cannot compare a {}x{}x{} image against a {}x{}x{} one\n",
+                       image.width,
+                       image.height,
+                       image.channels,
+                       reference.width,
+                       reference.height,
+                       reference.channels);
+            return {};
+        }
+
+        auto const count     = static_cast<std::size_t>(image.width) * image.height;
+        bool const has_rgb   = image.channels >= 3;
+        bool const has_alpha = image.channels % 2 == 0;
+
+        ImageDiff diff;
+        diff.image.width           = image.width;
+        diff.image.height          = image.height;
+        diff.image.channels        = 3;
+        diff.image.flip_vertically = reference.flip_vertically;
+        diff.image.pixels.resize(count * 3);
+
+        Floats const white{255.0f};
+        Floats const inverse_alpha{1.0f / 255.0f};
+        Floats const limit{max_delta * threshold * threshold};
+
+        Channels before;
+        Channels after;
+        std::array<float, chunk_size> luma;
+        std::array<float, chunk_size> differs;
+
+        double sum_squares{0.0};
+        Floats largest{0.0f};
+        for (std::size_t first{0}; first < count; first += chunk_size)
+        {
+            auto const size = std::min(chunk_size, count - first);
+            load_chunk(reference, first, size, before);
+            load_chunk(image, first, size, after);
+
+            Floats squares{0.0f};
+            for (std::size_t i{0}; i < chunk_size; i += lanes)
+            {
+                auto r0 = Floats::load(before.r.data() + i);
+                auto g0 = Floats::load(before.g.data() + i);
+                auto b0 = Floats::load(before.b.data() + i);
+                auto a0 = Floats::load(before.a.data() + i);
+                auto r1 = Floats::load(after.r.data() + i);
+                auto g1 = Floats::load(after.g.data() + i);
+                auto b1 = Floats::load(after.b.data() + i);
+                auto a1 = Floats::load(after.a.data() + i);
+
+                // Differences of the stored channels. Grey images repeat
+                // the same difference in all three colour channels, so only
+                // red counts.
+                auto dr = r1 - r0;
+                squares = squares + dr * dr;
+                largest = max(largest, abs(dr));
+                if (has_rgb)
+                {
+                    auto dg = g1 - g0;
+                    auto db = b1 - b0;
+                    squares = squares + dg * dg + db * db;
+                    largest = max(largest, max(abs(dg), abs(db)));
+                }
+                if (has_alpha)
+                {
+                    auto da = a1 - a0;
+                    squares = squares + da * da;
+                    largest = max(largest, abs(da));
+                }
+
+                // Perceptual difference of the colours over white. The YIQ
+                // transform is linear, so it can be applied to the
+                // difference directly.
+                auto alpha0 = a0 * inverse_alpha;
+                auto alpha1 = a1 * inverse_alpha;
+                r0          = white + (r0 - white) * alpha0;
+                g0          = white + (g0 - white) * alpha0;
+                b0          = white + (b0 - white) * alpha0;
+                auto cr     = white + (r1 - white) * alpha1 - r0;
+                auto cg     = white + (g1 - white) * alpha1 - g0;
+                auto cb     = white + (b1 - white) * alpha1 - b0;
+
+                auto y = Floats{0.29889531f} * cr + Floats{0.58662247f} * cg +
+                         Floats{0.11448223f} * cb;
+                auto in = Floats{0.59597799f} * cr - Floats{0.27417610f} * cg -
+                          Floats{0.32180189f} * cb;
+                auto q = Floats{0.21147017f} * cr - Floats{0.52261711f} * cg +
+                         Floats{0.31114694f} * cb;
+                auto delta = Floats{0.5053f} * y * y + Floats{0.299f} * in * in +
+                             Floats{0.1957f} * q * q;
+
+                auto reference_luma = Floats{0.29889531f} * r0 +
+                                      Floats{0.58662247f} * g0 +
+                                      Floats{0.11448223f} * b0;
+                reference_luma.store(luma.data() + i);
+                auto differing = select(delta > limit, Floats{1.0f}, Floats{0.0f});
+                differing.store(differs.data() + i);
+            }
+
+            std::array<float, lanes> partial;
+            squares.store(partial.data());
+            for (auto value : partial)
+            {
+                sum_squares += value;
+            }
+
+            auto out = diff.image.pixels.data() + first * 3;
+            for (std::size_t i{0}; i < size; ++i, out += 3)
+            {
+                if (differs[i] != 0.0f)
+                {
+                    ++diff.differing_pixels;
+                    out[0] = 255;
+                    out[1] = 0;
+                    out[2] = 0;
+                }
+                else
+                {
+                    auto grey = static_cast<unsigned char>(
+                        255.0f - (255.0f - std::clamp(luma[i], 0.0f, 255.0f)) * 0.1f);
+                    out[0] = out[1] = out[2] = grey;
+                }
+            }
+        }
+
+        std::array<float, lanes> maxima;
+        largest.store(maxima.data());
+
+        auto samples   = count * static_cast<std::size_t>(has_rgb ? 3 : 1) +
+                       (has_alpha ? count : 0);
+        diff.rmse      = std::sqrt(sum_squares / static_cast<double>(samples));
+        diff.max_error =
+            static_cast<int>(*std::max_element(maxima.begin(), maxima.end()));
+        return diff;
+    }
+} // namespace atlas::utils
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "image_writer.hpp"
+
+#include <cstddef>
+#include <optional>
+
+namespace atlas::utils
+{
+    struct ImageDiff
+    {
+        // Over every channel, in 8-bit units.
+        double rmse{0.0};
+        int max_error{0};
+
+        // Pixels whose perceptual difference is above the threshold.
+        std::size_t differing_pixels{0};
+
+        // Differing pixels in red over a faded copy of the reference, in RGB.
+        ImageData image;
+    };
+
+    // Compares two 8-bit images of the same size and number of channels.
+    // The perceptual difference of a pixel is the distance between the two
+    // colours in YIQ space, weighted as in pixelmatch and blended over white
+    // if there is alpha, scaled so that black against white is 1. The
+    // threshold is on the same scale.
+    std::optional<ImageDiff> compare_images(ImageData const& reference,
+                                            ImageData const& image,
+                                            float threshold = 0.1f);
+} // namespace atlas::utils
@@ -0,0 +1,225 @@
+#include "image_writer.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fmt/printf.h>
+#include <stb_image_write.h>
+
+namespace atlas::utils
+{
+    namespace
+    {
+        std::vector<unsigned char> flip_rows(ImageData const& image, std::size_t row)
+        {
+            std::vector<unsigned char> pixels(image.pixels.size());
+            auto height = static_cast<std::size_t>(image.height);
+            for (std::size_t y{0}; y < height; ++y)
+            {
+                std::memcpy(pixels.data() + y * row,
+                            image.pixels.data() + (height - 1 - y) * row,
+                            row);
+            }
+            return pixels;
+        }
+    } // namespace
+
+    bool write_image(std::string const& filename, ImageData const& image)
+    {
+        auto extension = std::filesystem::path{filename}.extension().string();
+        std::transform(
+            extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+                return static_cast<char>(std::tolower(c));
+            });
+
+        auto const width    = image.width;
+        auto const height   = image.height;
+        auto const channels = image.channels;
+        auto const row      = static_cast<std::size_t>(width) * channels *
+                         (image.is_float ? sizeof(float) : 1);
+        if (width <= 0 || height <= 0 || channels < 1 || channels > 4 ||
+            image.pixels.size() != row * height)
+        {
+            fmt::print(stderr, "error: invalid image: {}\n", filename);
+            return false;
+        }
+
+        bool const is_hdr = (extension == ".hdr");
+        if (is_hdr != image.is_float)
+        {
+            fmt::print(stderr,
+                       "error: {} requires {} pixels\n",
+                       filename,
+                       is_hdr ? "float" : "8-bit");
+            return false;
+        }
+
+        std::vector<unsigned char> flipped;
+        auto data = image.pixels.data();
+        if (image.flip_vertically)
+        {
+            flipped = flip_rows(image, row);
+            data    = flipped.data();
+        }
+
+        int ret{0};
+        if (is_hdr)
+        {
+            // The pixels are not guaranteed to be aligned for floats.
+            std::vector<float> floats(image.pixels.size() / sizeof(float));
+            std::memcpy(floats.data(), data, image.pixels.size());
+            ret = stbi_write_hdr(
+                filename.c_str(), width, height, channels, floats.data());
+        }
+        else if (extension == ".png")
+        {
+            ret = stbi_write_png(filename.c_str(),
+                                 width,
+                                 height,
+                                 channels,
+                                 data,
+                                 static_cast<int>(row));
+        }
+        else if (extension == ".jpg" || extension == ".jpeg")
+        {
+            ret = stbi_write_jpg(filename.c_str(), width, height, channels, data, 90);
+        }
+        else if (extension == ".bmp")
+        {
+            ret = stbi_write_bmp(filename.c_str(), width, height, channels, data);
+        }
+        else if (extension == ".tga")
+        {
+            ret = stbi_write_tga(filename.c_str(), width, height, channels, data);
+        }
+        else
+        {
+            fmt::print(stderr, "error: unsupported image format: {}\n", filename);
+            return false;
+        }
+
+        if (ret == 0)
+        {
+            fmt::print(stderr, "error: could not write image: {}\n", filename);
+            return false;
+        }
+
+        return true;
+    }
+
+    ImageWriter::ImageWriter(jobs::JobSystem& system, std::size_t max_pending) :
+        m_max_pending{std::max<std::size_t>(max_pending, 1)},
+        m_system{&system}
+    {}
+
+    ImageWriter::~ImageWriter()
+    {
+        wait();
+    }
+
+    bool ImageWriter::write(std::string filename, ImageData image)
+    {
+        {
+            std::scoped_lock lock{m_mutex};
+            if (m_pending == m_max_pending)
+            {
+                ++m_dropped;
+                return false;
+            }
+            ++m_pending;
+        }
+
+        auto job = m_system->submit([this,
+                                     filename = std::move(filename),
+                                     image    = std::move(image)]() {
+            auto result = write_image(filename, image);
+
+            std::scoped_lock lock{m_mutex};
+            ++(result ? m_written : m_failed);
+            --m_pending;
+        });
+
+        std::scoped_lock lock{m_mutex};
+        std::erase_if(m_jobs, [](jobs::JobHandle const& handle) {
+            return handle.done();
+        });
+        m_jobs.push_back(std::move(job));
+        return true;
+    }
+
+    void ImageWriter::wait()
+    {
+        // Waiting on the jobs, rather than on a condition, lets this thread
+        // encode too.
+        while (true)
+        {
+            std::vector<jobs::JobHandle> outstanding;
+            {
+                std::scoped_lock lock{m_mutex};
+                outstanding.swap(m_jobs);
+            }
+
+            if (outstanding.empty())
+            {
+                return;
+            }
+
+            for (auto const& job : outstanding)
+            {
+                m_system->wait(job);
+            }
+        }
+    }
+
+    std::size_t ImageWriter::pending() const
+    {
+        std::scoped_lock lock{m_mutex};
+        return m_pending;
+    }
+
+    std::size_t ImageWriter::written() const
+    {
+        std::scoped_lock lock{m_mutex};
+        return m_written;
+    }
+
+    std::size_t ImageWriter::failed() const
+    {
+        std::scoped_lock lock{m_mutex};
+        return m_failed;
+    }
+
+    std::size_t ImageWriter::dropped() const
+    {
+        std::scoped_lock lock{m_mutex};
+        return m_dropped;
+    }
+
+    ImageSequence::ImageSequence(ImageWriter& writer,
+                                 std::string const& directory,
+                                 std::string prefix,
+                                 std::string extension) :
+        m_writer{&writer},
+        m_directory{directory},
+        m_prefix{std::move(prefix)},
+        m_extension{std::move(extension)}
+    {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+    }
+
+    bool ImageSequence::add(ImageData image)
+    {
+        auto name = fmt::format("{}_{:06}{}", m_prefix, m_frame_count, m_extension);
+        auto path = (std::filesystem::path{m_directory} / name).string();
+        if (!m_writer->write(std::move(path), std::move(image)))
+        {
+            ++m_dropped;
+            return false;
+        }
+
+        ++m_frame_count;
+        return true;
+    }
+} // namespace atlas::utils
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atlas/jobs/job_system.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace atlas::utils
+{
+    struct ImageData
+    {
+        int width{0};
+        int height{0};
+        int channels{0};
+
+        // Pixels are 8-bit unless is_float is set, in which case they hold
+        // 32-bit floats.
+        bool is_float{false};
+
+        // Rows are stored bottom to top, which is how OpenGL reads them back.
+        bool flip_vertically{false};
+
+        std::vector<unsigned char> pixels;
+    };
+
+    // Writes an image to disk. The format is chosen from the extension:
+    // .png, .jpg, .bmp and .tga take 8-bit pixels and .hdr takes floats.
+    bool write_image(std::string const& filename, ImageData const& image);
+
+    // Encodes and writes images on worker threads so that saving a
+    // screenshot or a recording never stalls the render loop. The number of
+    // images waiting to be written is bounded: once max_pending are queued,
+    // further images are dropped rather than blocking the caller or piling
+    // up in memory. Destroying the writer waits for the queued images.
+    //
+    // The job system must outlive the writer. Images are only encoded in the
+    // background on its workers, so it needs more than one thread unless the
+    // owner waits on it.
+    class ImageWriter
+    {
+    public:
+        explicit ImageWriter(jobs::JobSystem& system, std::size_t max_pending = 8);
+        ~ImageWriter();
+
+        ImageWriter(ImageWriter const&)            = delete;
+        ImageWriter& operator=(ImageWriter const&) = delete;
+
+        // Queues an image to be written. Returns false if it was dropped
+        // because the queue is full.
+        bool write(std::string filename, ImageData image);
+
+        // Blocks until every queued image has been written.
+        void wait();
+
+        std::size_t pending() const;
+
+        // Number of images written, of images that could not be written and
+        // of images dropped because the queue was full.
+        std::size_t written() const;
+        std::size_t failed() const;
+        std::size_t dropped() const;
+
+    private:
+        std::size_t m_max_pending;
+
+        mutable std::mutex m_mutex;
+        std::size_t m_pending{0};
+        std::size_t m_written{0};
+        std::size_t m_failed{0};
+        std::size_t m_dropped{0};
+
+        // Jobs that may still be running, waited on by wait.
+        std::vector<jobs::JobHandle> m_jobs;
+        jobs::JobSystem* m_system;
+    };
+
+    // Continuous capture into a numbered sequence of images, named
+    // directory/prefix_000000.ext and so on, which is what tools such as
+    // ffmpeg expect. Frames dropped by the writer do not use up a number, so
+    // the sequence never has gaps.
+    class ImageSequence
+    {
+    public:
+        ImageSequence(ImageWriter& writer,
+                      std::string const& directory,
+                      std::string prefix    = "frame",
+                      std::string extension = ".png");
+
+        // Queues the next frame. Returns false if it was dropped.
+        bool add(ImageData image);
+
+        std::size_t frame_count() const
+        {
+            return m_frame_count;
+        }
+
+        std::size_t dropped() const
+        {
+            return m_dropped;
+        }
+
+    private:
+        ImageWriter* m_writer;
+        std::string m_directory;
+        std::string m_prefix;
+        std::string m_extension;
+        std::size_t m_frame_count{0};
+        std::size_t m_dropped{0};
+    };
+} // namespace atlas::utils
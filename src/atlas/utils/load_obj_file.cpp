@@ -1,97 +1,197 @@
 #include "load_obj_file.hpp"
+#include "obj_parser.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <fmt/printf.h>
-#include <functional>
-#include <glm/gtx/hash.hpp>
-#include <unordered_map>
+#include <fstream>
+#include <limits>
 #include <zeus/filesystem.hpp>
 
 namespace atlas::utils
 {
-    bool operator==(Vertex const& rhs, Vertex const& lhs)
+    namespace
     {
-        return rhs.position == lhs.position;
-    }
+        constexpr auto no_index = std::numeric_limits<std::size_t>::max();
 
-    struct VertexHash
-    {
-        std::size_t operator()(Vertex const& vertex) const
+        // Open-addressing hash table with linear probing that maps keys to
+        // indices into an array held by the caller. Only the index and the
+        // full hash are stored, so a lookup touches a single cache line in
+        // the common case and there is no allocation per entry.
+        class IndexTable
         {
-            auto posHash    = std::hash<glm::vec3>()(vertex.position);
-            auto normalHash = std::hash<glm::vec3>()(vertex.normal);
-            auto texHash    = std::hash<glm::vec2>()(vertex.tex_coord);
-            return ((posHash ^ (normalHash << 1)) >> 1) ^ (texHash << 1);
-        }
-    };
+        public:
+            explicit IndexTable(std::size_t expected_size)
+            {
+                auto capacity = std::bit_ceil(std::max<std::size_t>(
+                    16, expected_size + expected_size / 2));
+                m_slots.resize(capacity);
+            }
 
-    std::optional<ObjMesh> load_obj_mesh(std::string const& filename,
-                                         std::string const& material_path)
-    {
-        tinyobj::ObjReader reader;
-        tinyobj::ObjReaderConfig config;
-        config.triangulate  = true;
-        config.vertex_color = false;
+            // Returns the index of an entry with the given hash for which
+            // equal returns true, or no_index if there is none.
+            template<typename Equal>
+            std::size_t find(std::uint64_t hash, Equal&& equal) const
+            {
+                auto mask = m_slots.size() - 1;
+                for (auto i = hash & mask;; i = (i + 1) & mask)
+                {
+                    auto const& slot = m_slots[i];
+                    if (slot.index == no_index)
+                    {
+                        return no_index;
+                    }
+
+                    if (slot.hash == hash && equal(slot.index))
+                    {
+                        return slot.index;
+                    }
+                }
+            }
 
-        // Check if the material path is empty. If it is, then use the root
-        // directory of the file itself. Otherwise, use the provided path.
-        std::string root_dir   = zeus::get_file_directory(filename);
-        config.mtl_search_path = (material_path.empty()) ? root_dir : material_path;
+            // Same as find, but stores the given index if there is no match
+            // and returns it.
+            template<typename Equal>
+            std::size_t
+            find_or_insert(std::uint64_t hash, std::size_t index, Equal&& equal)
+            {
+                if (10 * (m_size + 1) > 7 * m_slots.size())
+                {
+                    grow();
+                }
 
-        bool ret = reader.ParseFromFile(filename, config);
-        if (!ret || !reader.Valid())
-        {
-            return {};
-        }
+                auto mask = m_slots.size() - 1;
+                for (auto i = hash & mask;; i = (i + 1) & mask)
+                {
+                    auto& slot = m_slots[i];
+                    if (slot.index == no_index)
+                    {
+                        slot = {hash, index};
+                        ++m_size;
+                        return index;
+                    }
 
-        if (!reader.Warning().empty())
+                    if (slot.hash == hash && equal(slot.index))
+                    {
+                        return slot.index;
+                    }
+                }
+            }
+
+        private:
+            struct Slot
+            {
+                std::uint64_t hash{0};
+                std::size_t index{no_index};
+            };
+
+            void grow()
+            {
+                std::vector<Slot> slots(m_slots.size() * 2);
+                auto mask = slots.size() - 1;
+                for (auto const& slot : m_slots)
+                {
+                    if (slot.index == no_index)
+                    {
+                        continue;
+                    }
+
+                    auto i = slot.hash & mask;
+                    while (slots[i].index != no_index)
+                    {
+                        i = (i + 1) & mask;
+                    }
+                    slots[i] = slot;
+                }
+                m_slots = std::move(slots);
+            }
+
+            std::vector<Slot> m_slots;
+            std::size_t m_size{0};
+        };
+
+        std::uint64_t mix(std::uint64_t hash)
         {
-            fmt::print("warning: in function loadObjMesh: {}\n", reader.Warning());
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdull;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ull;
+            hash ^= hash >> 33;
+            return hash;
         }
 
-        if (!reader.Error().empty())
+        std::uint64_t hash_vertex(Vertex const& vertex)
         {
-            fmt::print("error: in function loadObjMesh: {}\n", reader.Error());
-        }
+            std::array<float, 8> values{vertex.position.x,
+                                        vertex.position.y,
+                                        vertex.position.z,
+                                        vertex.normal.x,
+                                        vertex.normal.y,
+                                        vertex.normal.z,
+                                        vertex.tex_coord.x,
+                                        vertex.tex_coord.y};
 
-        auto attrib    = reader.GetAttrib();
-        auto shapes    = reader.GetShapes();
-        auto materials = reader.GetMaterials();
+            std::uint64_t hash{0};
+            for (auto value : values)
+            {
+                // Adding zero turns -0 into +0, so values that compare equal
+                // also hash the same.
+                value += 0.0f;
+                std::uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                hash = mix(hash ^ bits);
+            }
+            return hash;
+        }
 
-        if (materials.empty())
+        bool same_attributes(Vertex const& lhs, Vertex const& rhs)
         {
-            materials.push_back(tinyobj::material_t{});
+            return lhs.position == rhs.position && lhs.normal == rhs.normal &&
+                   lhs.tex_coord == rhs.tex_coord;
         }
 
-        ObjMesh result_mesh;
-        for (std::size_t s{0}; s < shapes.size(); ++s)
+        Shape convert_shape(tinyobj::attrib_t const& attrib,
+                            tinyobj::mesh_t& mesh,
+                            float weld_tolerance)
         {
-            Shape shape{};
-            std::unordered_map<Vertex, std::size_t, VertexHash> vertex_map{};
-            std::vector<Vertex> unique_vertices{};
-            std::size_t index_offset{0};
+            Shape shape;
 
-            for (std::size_t face{0}; face < shapes[s].mesh.num_face_vertices.size();
-                 ++face)
+            // Every face corner is either a new vertex or a repeat, so the
+            // number of corners bounds the indices. Vertices usually number
+            // about as many as positions, and a triangle mesh has around six
+            // times as many corners, so the vertices and the table start from
+            // the positions and grow if normals or texture coordinates split
+            // them further.
+            auto corner_count = mesh.indices.size();
+            shape.indices.reserve(corner_count);
+            auto position_count = attrib.vertices.size() / 3;
+            shape.vertices.reserve(std::min(corner_count, position_count));
+
+            IndexTable vertex_table{std::min(corner_count, position_count)};
+
+            std::size_t index_offset{0};
+            for (std::size_t face{0}; face < mesh.num_face_vertices.size(); ++face)
             {
-                int num_face_vertices = shapes[s].mesh.num_face_vertices[face];
+                int num_face_vertices = mesh.num_face_vertices[face];
                 for (int v{0}; v < num_face_vertices; ++v)
                 {
-                    glm::vec3 p{};
-                    glm::vec3 n{};
-                    glm::vec2 tex{};
-
-                    tinyobj::index_t idx = shapes[s].mesh.indices[index_offset + v];
+                    Vertex vertex{};
+                    tinyobj::index_t idx = mesh.indices[index_offset + v];
 
-                    p.x = attrib.vertices[3 * idx.vertex_index + 0];
-                    p.y = attrib.vertices[3 * idx.vertex_index + 1];
-                    p.z = attrib.vertices[3 * idx.vertex_index + 2];
+                    vertex.position.x = attrib.vertices[3 * idx.vertex_index + 0];
+                    vertex.position.y = attrib.vertices[3 * idx.vertex_index + 1];
+                    vertex.position.z = attrib.vertices[3 * idx.vertex_index + 2];
 
                     if (idx.normal_index != -1 && shape.has_normals)
                     {
-                        n.x = attrib.normals[3 * idx.normal_index + 0];
-                        n.y = attrib.normals[3 * idx.normal_index + 1];
-                        n.z = attrib.normals[3 * idx.normal_index + 2];
+                        vertex.normal.x = attrib.normals[3 * idx.normal_index + 0];
+                        vertex.normal.y = attrib.normals[3 * idx.normal_index + 1];
+                        vertex.normal.z = attrib.normals[3 * idx.normal_index + 2];
                     }
                     else
                     {
@@ -100,40 +200,443 @@ namespace atlas::utils
 
                     if (idx.texcoord_index != -1 && shape.has_texture_coords)
                     {
-                        tex.x = attrib.texcoords[2 * idx.texcoord_index + 0];
-                        tex.y = attrib.texcoords[2 * idx.texcoord_index + 1];
+                        auto t             = 2 * idx.texcoord_index;
+                        vertex.tex_coord.x = attrib.texcoords[t + 0];
+                        vertex.tex_coord.y = attrib.texcoords[t + 1];
                     }
                     else
                     {
                         shape.has_texture_coords = false;
                     }
 
-                    Vertex vertex{};
-                    vertex.position  = p;
-                    vertex.normal    = n;
-                    vertex.tex_coord = tex;
+                    // Look the vertex up and insert it in one go.
+                    vertex.index = shape.vertices.size();
+                    auto index   = vertex_table.find_or_insert(
+                        hash_vertex(vertex), vertex.index, [&](std::size_t i) {
+                            return same_attributes(shape.vertices[i], vertex);
+                        });
 
-                    if (vertex_map.count(vertex) == 0)
+                    if (index == vertex.index)
                     {
-                        vertex.index       = vertex_map.size();
-                        vertex.face_id     = face;
-                        vertex_map[vertex] = vertex.index;
-                        unique_vertices.push_back(vertex);
+                        vertex.face_id = face;
+                        shape.vertices.push_back(vertex);
                     }
 
-                    shape.indices.push_back(vertex_map[vertex]);
+                    shape.indices.push_back(index);
                 }
                 index_offset += num_face_vertices;
             }
 
-            shape.vertices            = unique_vertices;
-            shape.material_ids        = shapes[s].mesh.material_ids;
-            shape.smoothing_group_ids = shapes[s].mesh.smoothing_group_ids;
+            if (weld_tolerance > 0.0f)
+            {
+                weld_vertices(shape, weld_tolerance);
+            }
+
+            shape.material_ids        = std::move(mesh.material_ids);
+            shape.smoothing_group_ids = std::move(mesh.smoothing_group_ids);
+            return shape;
+        }
+
+        ObjMesh convert_obj(tinyobj::attrib_t const& attrib,
+                            std::vector<tinyobj::shape_t>& shapes,
+                            std::vector<tinyobj::material_t>& materials,
+                            float weld_tolerance)
+        {
+            if (materials.empty())
+            {
+                materials.push_back(tinyobj::material_t{});
+            }
+
+            ObjMesh result_mesh;
+            result_mesh.shapes.reserve(shapes.size());
+            for (auto& source : shapes)
+            {
+                result_mesh.shapes.push_back(
+                    convert_shape(attrib, source.mesh, weld_tolerance));
+
+                // The parsed shape is no longer needed, so give its memory back
+                // before converting the next one.
+                source = {};
+            }
+
+            result_mesh.materials = std::move(materials);
+            return result_mesh;
+        }
+
+        std::string get_material_path(std::string const& filename,
+                                      std::string const& material_path)
+        {
+            // Check if the material path is empty. If it is, then use the root
+            // directory of the file itself. Otherwise, use the provided path.
+            return (material_path.empty()) ? zeus::get_file_directory(filename)
+                                           : material_path;
+        }
+
+        void print_messages(std::string const& warning, std::string const& error)
+        {
+            if (!warning.empty())
+            {
+                fmt::print("warning: in function loadObjMesh: {}\n", warning);
+            }
+
+            if (!error.empty())
+            {
+                fmt::print("error: in function loadObjMesh: {}\n", error);
+            }
+        }
+    } // namespace
 
-            result_mesh.shapes.push_back(shape);
+    void weld_vertices(Shape& shape, float tolerance)
+    {
+        if (tolerance <= 0.0f)
+        {
+            return;
         }
 
-        result_mesh.materials = materials;
-        return {result_mesh};
+        using Cell = std::array<std::int64_t, 3>;
+
+        auto cell_of = [tolerance](glm::vec3 const& p) {
+            Cell cell;
+            for (int k{0}; k < 3; ++k)
+            {
+                auto c  = std::floor(static_cast<double>(p[k]) / tolerance);
+                cell[k] = static_cast<std::int64_t>(std::clamp(c, -0x1p62, 0x1p62));
+            }
+            return cell;
+        };
+
+        auto hash_cell = [](Cell const& cell) {
+            std::uint64_t hash{0};
+            for (auto c : cell)
+            {
+                hash = mix(hash ^ static_cast<std::uint64_t>(c));
+            }
+            return hash;
+        };
+
+        // The tolerance is a distance in model space, which says nothing
+        // about unit normals or texture coordinates, so those must match
+        // exactly.
+        auto close = [tolerance](Vertex const& lhs, Vertex const& rhs) {
+            return glm::distance(lhs.position, rhs.position) <= tolerance &&
+                   lhs.normal == rhs.normal && lhs.tex_coord == rhs.tex_coord;
+        };
+
+        // The grid holds the vertices that are kept, bucketed by cells as
+        // wide as the tolerance, so any match is in one of the 27 cells
+        // around a vertex. Vertices that share a cell are chained through
+        // next.
+        std::vector<Vertex> welded;
+        std::vector<std::size_t> next;
+        std::vector<std::size_t> remap(shape.vertices.size());
+        IndexTable grid{shape.vertices.size()};
+        welded.reserve(shape.vertices.size());
+
+        for (std::size_t i{0}; i < shape.vertices.size(); ++i)
+        {
+            auto const& vertex = shape.vertices[i];
+            auto cell          = cell_of(vertex.position);
+            auto match         = no_index;
+            for (int n{0}; n < 27 && match == no_index; ++n)
+            {
+                Cell neighbour{
+                    cell[0] + n % 3 - 1, cell[1] + n / 3 % 3 - 1, cell[2] + n / 9 - 1};
+                auto head = grid.find(hash_cell(neighbour), [&](std::size_t j) {
+                    return cell_of(welded[j].position) == neighbour;
+                });
+
+                for (auto j = head; j != no_index && match == no_index; j = next[j])
+                {
+                    match = close(welded[j], vertex) ? j : no_index;
+                }
+            }
+
+            if (match == no_index)
+            {
+                match = welded.size();
+                welded.push_back(vertex);
+                welded.back().index = match;
+                next.push_back(no_index);
+
+                auto same_cell = [&](std::size_t j) {
+                    return cell_of(welded[j].position) == cell;
+                };
+
+                auto head = grid.find_or_insert(hash_cell(cell), match, same_cell);
+                if (head != match)
+                {
+                    next[match] = next[head];
+                    next[head]  = match;
+                }
+            }
+
+            remap[i] = match;
+        }
+
+        for (auto& index : shape.indices)
+        {
+            index = remap[index];
+        }
+        shape.vertices = std::move(welded);
+    }
+
+    void merge_vertices(Shape& shape)
+    {
+        std::vector<Vertex> merged;
+        std::vector<std::size_t> remap(shape.vertices.size());
+        IndexTable table{shape.vertices.size()};
+        merged.reserve(shape.vertices.size());
+
+        for (std::size_t i{0}; i < shape.vertices.size(); ++i)
+        {
+            auto const& vertex = shape.vertices[i];
+            auto index         = table.find_or_insert(
+                hash_vertex(vertex), merged.size(), [&](std::size_t j) {
+                    return same_attributes(merged[j], vertex);
+                });
+
+            if (index == merged.size())
+            {
+                merged.push_back(vertex);
+                merged.back().index = index;
+            }
+            remap[i] = index;
+        }
+
+        for (auto& index : shape.indices)
+        {
+            index = remap[index];
+        }
+        shape.vertices = std::move(merged);
+    }
+
+    std::optional<ObjMesh> load_obj_mesh(std::string const& filename,
+                                         std::string const& material_path,
+                                         float weld_tolerance)
+    {
+        std::string mtl_path = get_material_path(filename, material_path);
+
+        // Parse into arrays we own rather than going through ObjReader, which
+        // only hands out const references. That way everything below can be
+        // moved instead of copied.
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string warning;
+        std::string error;
+
+        bool ret = tinyobj::LoadObj(&attrib,
+                                    &shapes,
+                                    &materials,
+                                    &warning,
+                                    &error,
+                                    filename.c_str(),
+                                    mtl_path.c_str(),
+                                    true,
+                                    false);
+
+        print_messages(warning, error);
+        if (!ret)
+        {
+            return {};
+        }
+
+        return convert_obj(attrib, shapes, materials, weld_tolerance);
+    }
+
+    std::optional<ObjMesh> load_obj_mesh_parallel(std::string const& filename,
+                                                  jobs::JobSystem& system,
+                                                  std::string const& material_path,
+                                                  float weld_tolerance)
+    {
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string warning;
+        std::string error;
+
+        bool ret = parse_obj_file(filename,
+                                  get_material_path(filename, material_path),
+                                  system,
+                                  attrib,
+                                  shapes,
+                                  materials,
+                                  warning,
+                                  error);
+
+        print_messages(warning, error);
+        if (!ret)
+        {
+            return {};
+        }
+
+        return convert_obj(attrib, shapes, materials, weld_tolerance);
+    }
+
+    ObjStreamStatus stream_obj_mesh(std::string const& filename,
+                                    ObjStreamCallbacks const& callbacks,
+                                    jobs::JobSystem& system,
+                                    ObjStreamSettings const& settings,
+                                    std::stop_token stop_token)
+    {
+        std::ifstream stream{filename, std::ios::binary};
+        if (!stream)
+        {
+            print_messages({}, fmt::format("Cannot open file [{}]\n", filename));
+            return ObjStreamStatus::failed;
+        }
+
+        std::error_code code;
+        auto file_size   = std::filesystem::file_size(filename, code);
+        auto total_bytes = code ? std::size_t{0} : static_cast<std::size_t>(file_size);
+        auto block_size  = std::max<std::size_t>(settings.block_size, 1);
+
+        ObjStreamParser parser{get_material_path(filename, settings.material_path),
+                               system,
+                               settings.max_shape_faces};
+
+        auto on_shape = [&](tinyobj::mesh_t& mesh) {
+            auto shape = convert_shape(parser.attrib(), mesh, settings.weld_tolerance);
+            if (callbacks.shape_callback)
+            {
+                callbacks.shape_callback(std::move(shape));
+            }
+        };
+
+        // Text after the last line break of a block is kept for the next
+        // one.
+        std::string buffer;
+        std::size_t bytes{0};
+        std::size_t material_count{0};
+        bool last_block{false};
+        while (!last_block)
+        {
+            if (stop_token.stop_requested())
+            {
+                return ObjStreamStatus::cancelled;
+            }
+
+            auto kept = buffer.size();
+            buffer.resize(kept + block_size);
+            stream.read(buffer.data() + kept, static_cast<std::streamsize>(block_size));
+            buffer.resize(kept + static_cast<std::size_t>(stream.gcount()));
+            last_block = !stream;
+
+            auto end = buffer.size();
+            if (!last_block)
+            {
+                auto line_end = buffer.rfind('\n');
+                if (line_end == std::string::npos)
+                {
+                    continue;
+                }
+                end = line_end + 1;
+            }
+
+            parser.parse({buffer.data(), end}, on_shape);
+            buffer.erase(0, end);
+            bytes += end;
+
+            if (parser.materials().size() != material_count &&
+                callbacks.materials_callback)
+            {
+                material_count = parser.materials().size();
+                callbacks.materials_callback(parser.materials());
+            }
+
+            if (callbacks.progress_callback)
+            {
+                callbacks.progress_callback(bytes, std::max(bytes, total_bytes));
+            }
+        }
+
+        parser.finish(on_shape);
+        print_messages(parser.warning(), parser.error());
+
+        // Same as load_obj_mesh, there is always at least one material.
+        if (material_count == 0 && callbacks.materials_callback)
+        {
+            callbacks.materials_callback({tinyobj::material_t{}});
+        }
+
+        return ObjStreamStatus::finished;
+    }
+
+    ObjStream::ObjStream(std::string filename,
+                         jobs::JobSystem& system,
+                         ObjStreamSettings settings)
+    {
+        // The thread is started last, once every member it uses exists.
+        m_thread = std::jthread{[this,
+                                 &system,
+                                 filename = std::move(filename),
+                                 settings = std::move(settings)](std::stop_token stop) {
+            ObjStreamCallbacks callbacks;
+            callbacks.shape_callback = [&](Shape&& shape) {
+                auto capacity = std::max<std::size_t>(settings.max_queued_shapes, 1);
+                std::unique_lock<std::mutex> lock{m_mutex};
+                if (!m_space.wait(
+                        lock, stop, [&] { return m_shapes.size() < capacity; }))
+                {
+                    return;
+                }
+                m_shapes.push_back(std::move(shape));
+                ++m_progress.shape_count;
+            };
+
+            callbacks.materials_callback = [&](auto const& materials) {
+                std::lock_guard<std::mutex> lock{m_mutex};
+                m_materials = materials;
+            };
+
+            callbacks.progress_callback = [&](std::size_t bytes, std::size_t total) {
+                std::lock_guard<std::mutex> lock{m_mutex};
+                m_progress.bytes       = bytes;
+                m_progress.total_bytes = total;
+            };
+
+            auto status = stream_obj_mesh(filename, callbacks, system, settings, stop);
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_status = status;
+        }};
+    }
+
+    ObjStream::~ObjStream()
+    {
+        cancel();
+    }
+
+    std::vector<Shape> ObjStream::take_shapes()
+    {
+        std::vector<Shape> shapes;
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            shapes.swap(m_shapes);
+        }
+        m_space.notify_one();
+        return shapes;
+    }
+
+    std::vector<tinyobj::material_t> ObjStream::materials() const
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_materials;
+    }
+
+    ObjStreamProgress ObjStream::progress() const
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_progress;
+    }
+
+    ObjStreamStatus ObjStream::status() const
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_status;
+    }
+
+    void ObjStream::cancel()
+    {
+        m_thread.request_stop();
     }
 } // namespace atlas::utils
@@ -1,8 +1,15 @@
 #pragma once
 
+#include <atlas/jobs/job_system.hpp>
 #include <atlas/math/glm.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
 #include <optional>
+#include <stop_token>
 #include <string>
+#include <thread>
 #include <tiny_obj_loader.h>
 #include <vector>
 
@@ -33,6 +40,127 @@ namespace atlas::utils
         std::vector<tinyobj::material_t> materials;
     };
 
+    // Merges vertices whose positions are within the given distance of
+    // another vertex with exactly the same normal and texture coordinates,
+    // and updates the indices to match. Vertices are visited in order and
+    // each one is merged into the first kept vertex close enough to it.
+    void weld_vertices(Shape& shape, float tolerance);
+
+    // Merges vertices whose positions, normals and texture coordinates are
+    // exactly the same, keeping the first of each, and updates the indices to
+    // match.
+    void merge_vertices(Shape& shape);
+
+    // Corners of the faces that share position, normal and texture
+    // coordinates become a single vertex. If a weld tolerance is given, the
+    // vertices are then welded with weld_vertices.
     std::optional<ObjMesh> load_obj_mesh(std::string const& filename,
-                                         std::string const& material_path = {});
+                                         std::string const& material_path = {},
+                                         float weld_tolerance = 0.0f);
+
+    // Same as load_obj_mesh, but the file is parsed by our own parser, which
+    // memory maps it and parses chunks of it in parallel on the job system.
+    // This is much faster for large files and produces the same mesh.
+    std::optional<ObjMesh>
+    load_obj_mesh_parallel(std::string const& filename,
+                           jobs::JobSystem& system,
+                           std::string const& material_path = {},
+                           float weld_tolerance = 0.0f);
+
+    struct ObjStreamSettings
+    {
+        std::string material_path{};
+        float weld_tolerance{0.0f};
+
+        // The file is read this many bytes at a time, and progress is
+        // reported after each block.
+        std::size_t block_size{std::size_t{1} << 22};
+
+        // Shapes with more faces than this are handed out in pieces, so a
+        // file made of a single huge group still shows up progressively.
+        std::size_t max_shape_faces{std::size_t{1} << 20};
+
+        // How many finished shapes ObjStream holds before the loader waits
+        // for them to be taken.
+        std::size_t max_queued_shapes{16};
+    };
+
+    struct ObjStreamCallbacks
+    {
+        // Called with each shape as soon as all of its faces have been read.
+        std::function<void(Shape&& shape)> shape_callback{};
+
+        // Called whenever a material library has been read, with every
+        // material read so far. Material ids of shapes refer to these.
+        std::function<void(std::vector<tinyobj::material_t> const& materials)>
+            materials_callback{};
+
+        // Called after each block with the number of bytes processed so far
+        // and the size of the file.
+        std::function<void(std::size_t bytes, std::size_t total_bytes)>
+            progress_callback{};
+    };
+
+    enum class ObjStreamStatus
+    {
+        loading,
+        finished,
+        cancelled,
+        failed
+    };
+
+    // Streaming version of load_obj_mesh_parallel. Instead of building the
+    // whole mesh, each shape is converted and handed to the callbacks as
+    // soon as it is complete. Only the attributes, one block of the file and
+    // the faces of the current shape are held at any time, so memory stays
+    // bounded by the size of the attributes rather than the whole mesh. The
+    // stop token is checked after every block.
+    ObjStreamStatus stream_obj_mesh(std::string const& filename,
+                                    ObjStreamCallbacks const& callbacks,
+                                    jobs::JobSystem& system,
+                                    ObjStreamSettings const& settings = {},
+                                    std::stop_token stop_token = {});
+
+    struct ObjStreamProgress
+    {
+        std::size_t bytes{0};
+        std::size_t total_bytes{0};
+        std::size_t shape_count{0};
+    };
+
+    // Runs stream_obj_mesh on a background thread and queues the shapes it
+    // produces, so a render loop can pick up whatever is ready once per frame
+    // without ever blocking on the file. Destroying the stream cancels the
+    // load. The job system must outlive the stream.
+    class ObjStream
+    {
+    public:
+        ObjStream(std::string filename,
+                  jobs::JobSystem& system,
+                  ObjStreamSettings settings = {});
+        ~ObjStream();
+
+        ObjStream(ObjStream const&)            = delete;
+        ObjStream& operator=(ObjStream const&) = delete;
+
+        // Moves out the shapes finished since the last call. Never blocks on
+        // the loader.
+        std::vector<Shape> take_shapes();
+
+        std::vector<tinyobj::material_t> materials() const;
+        ObjStreamProgress progress() const;
+        ObjStreamStatus status() const;
+
+        // Asks the loader to stop. Shapes already queued can still be taken.
+        void cancel();
+
+    private:
+        mutable std::mutex m_mutex;
+        std::condition_variable_any m_space;
+        std::vector<Shape> m_shapes;
+        std::vector<tinyobj::material_t> m_materials;
+        ObjStreamProgress m_progress;
+        ObjStreamStatus m_status{ObjStreamStatus::loading};
+        std::jthread m_thread;
+    };
 } // namespace atlas::utils
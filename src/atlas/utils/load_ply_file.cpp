@@ -0,0 +1,794 @@
+#include "load_ply_file.hpp"
+#include "mapped_file.hpp"
+#include "parse_float.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fmt/printf.h>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace atlas::utils
+{
+    namespace
+    {
+        constexpr auto no_property = std::numeric_limits<std::size_t>::max();
+
+        enum class Format
+        {
+            ascii,
+            binary_little_endian,
+            binary_big_endian
+        };
+
+        enum class Type
+        {
+            int8,
+            uint8,
+            int16,
+            uint16,
+            int32,
+            uint32,
+            float32,
+            float64
+        };
+
+        struct Property
+        {
+            std::string name;
+            Type type{Type::float32};
+
+            // Lists store their length as count_type, followed by that many
+            // values of type.
+            bool is_list{false};
+            Type count_type{Type::uint8};
+
+            // Offset in bytes from the start of a binary record. Only valid
+            // if the element has a stride.
+            std::size_t offset{0};
+        };
+
+        struct Element
+        {
+            std::string name;
+            std::size_t count{0};
+            std::vector<Property> properties;
+
+            // Size in bytes of a binary record, or 0 if the element has lists
+            // and its records vary in size.
+            std::size_t stride{0};
+
+            std::size_t find(std::string_view property) const
+            {
+                for (std::size_t i{0}; i < properties.size(); ++i)
+                {
+                    if (properties[i].name == property)
+                    {
+                        return i;
+                    }
+                }
+                return no_property;
+            }
+        };
+
+        struct Header
+        {
+            Format format{Format::ascii};
+            std::vector<Element> elements;
+            std::size_t size{0};
+        };
+
+        std::size_t type_size(Type type)
+        {
+            switch (type)
+            {
+            case Type::int8:
+            case Type::uint8:
+                return 1;
+            case Type::int16:
+            case Type::uint16:
+                return 2;
+            case Type::int32:
+            case Type::uint32:
+            case Type::float32:
+                return 4;
+            case Type::float64:
+                return 8;
+            }
+            return 0;
+        }
+
+        std::optional<Type> parse_type(std::string_view name)
+        {
+            // Both the original names and the sized ones are in use.
+            constexpr std::array<std::pair<std::string_view, Type>, 16> names{
+                {{"char", Type::int8},
+                 {"int8", Type::int8},
+                 {"uchar", Type::uint8},
+                 {"uint8", Type::uint8},
+                 {"short", Type::int16},
+                 {"int16", Type::int16},
+                 {"ushort", Type::uint16},
+                 {"uint16", Type::uint16},
+                 {"int", Type::int32},
+                 {"int32", Type::int32},
+                 {"uint", Type::uint32},
+                 {"uint32", Type::uint32},
+                 {"float", Type::float32},
+                 {"float32", Type::float32},
+                 {"double", Type::float64},
+                 {"float64", Type::float64}}};
+
+            for (auto const& [type_name, type] : names)
+            {
+                if (name == type_name)
+                {
+                    return type;
+                }
+            }
+            return {};
+        }
+
+        std::vector<std::string_view> split_words(std::string_view line)
+        {
+            std::vector<std::string_view> words;
+            while (!line.empty())
+            {
+                auto start = line.find_first_not_of(" \t\r");
+                if (start == std::string_view::npos)
+                {
+                    break;
+                }
+
+                line     = line.substr(start);
+                auto end = std::min(line.find_first_of(" \t\r"), line.size());
+                words.push_back(line.substr(0, end));
+                line = line.substr(end);
+            }
+            return words;
+        }
+
+        std::optional<Header> parse_header(std::string_view data, std::string& error)
+        {
+            Header header;
+            bool has_format{false};
+            std::size_t position{0};
+            std::size_t line_number{0};
+            while (true)
+            {
+                auto line_end = data.find('\n', position);
+                if (line_end == std::string_view::npos)
+                {
+                    error = "missing end_header";
+                    return {};
+                }
+
+                auto words = split_words(data.substr(position, line_end - position));
+                position   = line_end + 1;
+                if (line_number++ == 0)
+                {
+                    if (words.size() != 1 || words[0] != "ply")
+                    {
+                        error = "not a PLY file";
+                        return {};
+                    }
+                    continue;
+                }
+
+                if (words.empty() || words[0] == "comment" || words[0] == "obj_info")
+                {
+                    continue;
+                }
+
+                if (words[0] == "end_header")
+                {
+                    break;
+                }
+
+                if (words[0] == "format" && words.size() == 3)
+                {
+                    has_format = true;
+                    if (words[1] == "ascii")
+                    {
+                        header.format = Format::ascii;
+                    }
+                    else if (words[1] == "binary_little_endian")
+                    {
+                        header.format = Format::binary_little_endian;
+                    }
+                    else if (words[1] == "binary_big_endian")
+                    {
+                        header.format = Format::binary_big_endian;
+                    }
+                    else
+                    {
+                        error = fmt::format("unknown format {}", words[1]);
+                        return {};
+                    }
+                }
+                else if (words[0] == "element" && words.size() == 3)
+                {
+                    auto& element = header.elements.emplace_back();
+                    element.name  = words[1];
+
+                    auto count     = words[2];
+                    auto [ptr, ec] = std::from_chars(
+                        count.data(), count.data() + count.size(), element.count);
+                    if (ec != std::errc{})
+                    {
+                        error = fmt::format("invalid element count {}", count);
+                        return {};
+                    }
+                }
+                else if (words[0] == "property" && !header.elements.empty())
+                {
+                    Property property;
+                    std::optional<Type> type;
+                    std::optional<Type> count_type{Type::uint8};
+                    if (words.size() == 5 && words[1] == "list")
+                    {
+                        property.is_list = true;
+                        count_type       = parse_type(words[2]);
+                        type             = parse_type(words[3]);
+                        property.name    = words[4];
+                    }
+                    else if (words.size() == 3)
+                    {
+                        type          = parse_type(words[1]);
+                        property.name = words[2];
+                    }
+
+                    if (!type || !count_type)
+                    {
+                        error = fmt::format("invalid property {}", property.name);
+                        return {};
+                    }
+                    property.type       = *type;
+                    property.count_type = *count_type;
+                    header.elements.back().properties.push_back(property);
+                }
+                else
+                {
+                    error = fmt::format("unknown header line {}", words[0]);
+                    return {};
+                }
+            }
+
+            if (!has_format)
+            {
+                error = "missing format";
+                return {};
+            }
+
+            for (auto& element : header.elements)
+            {
+                std::size_t offset{0};
+                bool fixed{true};
+                for (auto& property : element.properties)
+                {
+                    property.offset = offset;
+                    offset += type_size(property.type);
+                    fixed = fixed && !property.is_list;
+                }
+                element.stride = fixed ? offset : 0;
+            }
+
+            header.size = position;
+            return header;
+        }
+
+        template<typename T>
+        T load(char const* data, bool swap)
+        {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+            if (swap)
+            {
+                auto bytes = reinterpret_cast<unsigned char*>(&value);
+                std::reverse(bytes, bytes + sizeof(T));
+            }
+            return value;
+        }
+
+        template<typename T>
+        T load_as(char const* data, Type type, bool swap)
+        {
+            switch (type)
+            {
+            case Type::int8:
+                return static_cast<T>(load<std::int8_t>(data, swap));
+            case Type::uint8:
+                return static_cast<T>(load<std::uint8_t>(data, swap));
+            case Type::int16:
+                return static_cast<T>(load<std::int16_t>(data, swap));
+            case Type::uint16:
+                return static_cast<T>(load<std::uint16_t>(data, swap));
+            case Type::int32:
+                return static_cast<T>(load<std::int32_t>(data, swap));
+            case Type::uint32:
+                return static_cast<T>(load<std::uint32_t>(data, swap));
+            case Type::float32:
+                return static_cast<T>(load<float>(data, swap));
+            case Type::float64:
+                return static_cast<T>(load<double>(data, swap));
+            }
+            return T{};
+        }
+
+        // Reads values one at a time, from either binary data or text.
+        class Cursor
+        {
+        public:
+            Cursor(std::string_view data, Format format) :
+                m_data{data.data()},
+                m_end{data.data() + data.size()},
+                m_ascii{format == Format::ascii},
+                m_swap{(format == Format::binary_big_endian) !=
+                       (std::endian::native == std::endian::big)}
+            {}
+
+            template<typename T>
+            bool read(Type type, T& value)
+            {
+                if (m_ascii)
+                {
+                    while (m_data < m_end &&
+                           std::isspace(static_cast<unsigned char>(*m_data)))
+                    {
+                        ++m_data;
+                    }
+
+                    // Integers are read exactly, unless they were written with a
+                    // fraction or an exponent.
+                    long long integer{0};
+                    auto [end, ec]  = std::from_chars(m_data, m_end, integer);
+                    bool is_integer = ec == std::errc{} &&
+                                      (end == m_end ||
+                                       (*end != '.' && *end != 'e' && *end != 'E'));
+                    if (type != Type::float32 && type != Type::float64 && is_integer)
+                    {
+                        m_data = end;
+                        value  = static_cast<T>(integer);
+                        return true;
+                    }
+
+                    float number{0.0f};
+                    auto ptr = detail::parse_float(m_data, m_end, number);
+                    if (ptr == m_data)
+                    {
+                        return false;
+                    }
+                    m_data = ptr;
+                    value  = static_cast<T>(number);
+                    return true;
+                }
+
+                auto size = type_size(type);
+                if (static_cast<std::size_t>(m_end - m_data) < size)
+                {
+                    return false;
+                }
+                value = load_as<T>(m_data, type, m_swap);
+                m_data += size;
+                return true;
+            }
+
+            bool skip(Property const& property)
+            {
+                double value{0.0};
+                if (!property.is_list)
+                {
+                    return read(property.type, value);
+                }
+
+                std::size_t count{0};
+                if (!read(property.count_type, count))
+                {
+                    return false;
+                }
+
+                if (!m_ascii)
+                {
+                    return skip_bytes(count * type_size(property.type));
+                }
+
+                for (std::size_t i{0}; i < count; ++i)
+                {
+                    if (!read(property.type, value))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            bool skip_bytes(std::size_t size)
+            {
+                if (static_cast<std::size_t>(m_end - m_data) < size)
+                {
+                    return false;
+                }
+                m_data += size;
+                return true;
+            }
+
+            bool is_ascii() const
+            {
+                return m_ascii;
+            }
+
+            bool swap() const
+            {
+                return m_swap;
+            }
+
+            char const* data() const
+            {
+                return m_data;
+            }
+
+            std::size_t remaining() const
+            {
+                return static_cast<std::size_t>(m_end - m_data);
+            }
+
+            // Most values of the given type that could still be read, used to
+            // check list lengths before allocating for them. In ASCII every
+            // value but the last needs a digit and a separator.
+            std::size_t max_values(Type type) const
+            {
+                return m_ascii ? (remaining() + 1) / 2 : remaining() / type_size(type);
+            }
+
+        private:
+            char const* m_data;
+            char const* m_end;
+            bool m_ascii;
+            bool m_swap;
+        };
+
+        // Fewest bytes a record of the element can take: its stride, the
+        // size of its scalars and list lengths, or a digit and a separator
+        // per property in ASCII.
+        std::size_t min_record_size(Element const& element, bool ascii)
+        {
+            if (ascii)
+            {
+                return 2 * element.properties.size();
+            }
+
+            if (element.stride != 0)
+            {
+                return element.stride;
+            }
+
+            std::size_t size{0};
+            for (auto const& property : element.properties)
+            {
+                size += type_size(property.is_list ? property.count_type : property.type);
+            }
+            return size;
+        }
+
+        bool read_vertices(Cursor& cursor, Element const& element, Shape& shape)
+        {
+            // Properties that end up in the vertex, in the order of the
+            // values below.
+            std::array<std::size_t, 8> slots{element.find("x"),
+                                             element.find("y"),
+                                             element.find("z"),
+                                             element.find("nx"),
+                                             element.find("ny"),
+                                             element.find("nz"),
+                                             element.find("u"),
+                                             element.find("v")};
+            if (slots[6] == no_property || slots[7] == no_property)
+            {
+                slots[6] = element.find("s");
+                slots[7] = element.find("t");
+            }
+
+            if (slots[0] == no_property || slots[1] == no_property ||
+                slots[2] == no_property)
+            {
+                return false;
+            }
+
+            shape.has_normals = slots[3] != no_property && slots[4] != no_property &&
+                                slots[5] != no_property;
+            shape.has_texture_coords = slots[6] != no_property && slots[7] != no_property;
+
+            std::array<float, 8> values{};
+            auto store = [&](std::size_t i) {
+                auto& vertex    = shape.vertices[i];
+                vertex.position = glm::vec3{values[0], values[1], values[2]};
+                if (shape.has_normals)
+                {
+                    vertex.normal = glm::vec3{values[3], values[4], values[5]};
+                }
+                if (shape.has_texture_coords)
+                {
+                    vertex.tex_coord = glm::vec2{values[6], values[7]};
+                }
+                vertex.index = i;
+            };
+
+            // The count comes from the header, so check that the file can
+            // hold that many vertices before allocating them.
+            auto record_size = min_record_size(element, cursor.is_ascii());
+            if (cursor.remaining() / record_size < element.count)
+            {
+                return false;
+            }
+
+            shape.vertices.resize(element.count);
+
+            // Binary records of a fixed size are read straight from their
+            // offsets.
+            if (!cursor.is_ascii() && element.stride != 0)
+            {
+                auto record = cursor.data();
+                for (std::size_t i{0}; i < element.count; ++i, record += element.stride)
+                {
+                    for (std::size_t k{0}; k < values.size(); ++k)
+                    {
+                        if (slots[k] != no_property)
+                        {
+                            auto const& property = element.properties[slots[k]];
+                            values[k]            = load_as<float>(
+                                record + property.offset, property.type, cursor.swap());
+                        }
+                    }
+                    store(i);
+                }
+                return cursor.skip_bytes(element.count * element.stride);
+            }
+
+            for (std::size_t i{0}; i < element.count; ++i)
+            {
+                for (std::size_t p{0}; p < element.properties.size(); ++p)
+                {
+                    auto const& property = element.properties[p];
+                    auto slot = std::find(slots.begin(), slots.end(), p) - slots.begin();
+                    auto ok   = (slot == 8 || property.is_list)
+                                    ? cursor.skip(property)
+                                    : cursor.read(property.type, values[slot]);
+                    if (!ok)
+                    {
+                        return false;
+                    }
+                }
+                store(i);
+            }
+            return true;
+        }
+
+        bool read_faces(Cursor& cursor,
+                        Element const& element,
+                        Shape& shape,
+                        std::string& error)
+        {
+            auto list = element.find("vertex_indices");
+            if (list == no_property)
+            {
+                list = element.find("vertex_index");
+            }
+
+            if (list == no_property || !element.properties[list].is_list)
+            {
+                error = "faces have no vertex_indices list";
+                return false;
+            }
+
+            auto const vertex_count = shape.vertices.size();
+            std::vector<bool> used(vertex_count, false);
+            std::vector<std::int64_t> polygon;
+
+            auto add_polygon = [&]() {
+                for (auto index : polygon)
+                {
+                    if (index < 0 || static_cast<std::size_t>(index) >= vertex_count)
+                    {
+                        error = "vertex indices out of bounds";
+                        return false;
+                    }
+                }
+
+                for (std::size_t k{1}; k + 1 < polygon.size(); ++k)
+                {
+                    auto face = shape.indices.size() / 3;
+                    for (auto corner : {polygon[0], polygon[k], polygon[k + 1]})
+                    {
+                        auto index = static_cast<std::size_t>(corner);
+                        if (!used[index])
+                        {
+                            used[index]                  = true;
+                            shape.vertices[index].face_id = face;
+                        }
+                        shape.indices.push_back(index);
+                    }
+                }
+                return true;
+            };
+
+            // Faces with nothing but the index list, which is what most
+            // exporters write, are read without going through every
+            // property.
+            auto const& indices = element.properties[list];
+            auto index_size     = type_size(indices.type);
+            if (!cursor.is_ascii() && element.properties.size() == 1)
+            {
+                for (std::size_t f{0}; f < element.count; ++f)
+                {
+                    std::size_t count{0};
+                    if (!cursor.read(indices.count_type, count) ||
+                        cursor.max_values(indices.type) < count)
+                    {
+                        error = "unexpected end of file";
+                        return false;
+                    }
+
+                    auto data = cursor.data();
+                    polygon.resize(count);
+                    for (std::size_t k{0}; k < count; ++k)
+                    {
+                        polygon[k] = load_as<std::int64_t>(
+                            data + k * index_size, indices.type, cursor.swap());
+                    }
+                    cursor.skip_bytes(count * index_size);
+
+                    if (!add_polygon())
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            for (std::size_t f{0}; f < element.count; ++f)
+            {
+                for (std::size_t p{0}; p < element.properties.size(); ++p)
+                {
+                    auto const& property = element.properties[p];
+                    if (p != list)
+                    {
+                        if (!cursor.skip(property))
+                        {
+                            error = "unexpected end of file";
+                            return false;
+                        }
+                        continue;
+                    }
+
+                    // The count comes from the file, so check that it can
+                    // hold that many indices before allocating them.
+                    std::size_t count{0};
+                    if (!cursor.read(property.count_type, count) ||
+                        cursor.max_values(property.type) < count)
+                    {
+                        error = "unexpected end of file";
+                        return false;
+                    }
+
+                    polygon.resize(count);
+                    for (auto& index : polygon)
+                    {
+                        if (!cursor.read(property.type, index))
+                        {
+                            error = "unexpected end of file";
+                            return false;
+                        }
+                    }
+                }
+
+                if (!add_polygon())
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool skip_element(Cursor& cursor, Element const& element)
+        {
+            // Elements without properties take no space, whatever their count.
+            if (element.properties.empty())
+            {
+                return true;
+            }
+
+            // Check the count against the file before looping over it, as
+            // for the vertices.
+            auto record_size = min_record_size(element, cursor.is_ascii());
+            if (cursor.remaining() / record_size < element.count)
+            {
+                return false;
+            }
+
+            if (!cursor.is_ascii() && element.stride != 0)
+            {
+                return cursor.skip_bytes(element.count * element.stride);
+            }
+
+            for (std::size_t i{0}; i < element.count; ++i)
+            {
+                for (auto const& property : element.properties)
+                {
+                    if (!cursor.skip(property))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+    } // namespace
+
+    std::optional<ObjMesh> load_ply_mesh(std::string const& filename,
+                                         float weld_tolerance)
+    {
+        MappedFile file{filename};
+        if (!file.is_open())
+        {
+            fmt::print(stderr, "error: could not open file {}\n", filename);
+            return {};
+        }
+
+        std::string error;
+        auto header = parse_header(file.view(), error);
+        if (!header)
+        {
+            fmt::print(stderr, "error: in {}: {}\n", filename, error);
+            return {};
+        }
+
+        Shape shape;
+        bool has_vertices{false};
+        Cursor cursor{file.view().substr(header->size), header->format};
+        auto read_element = [&](Element const& element) {
+            if (element.name == "vertex")
+            {
+                has_vertices = true;
+                error        = "invalid vertex element";
+                return read_vertices(cursor, element, shape);
+            }
+
+            if (element.name == "face")
+            {
+                error = "faces before vertices";
+                return has_vertices && read_faces(cursor, element, shape, error);
+            }
+
+            error = "unexpected end of file";
+            return skip_element(cursor, element);
+        };
+
+        for (auto const& element : header->elements)
+        {
+            if (!read_element(element))
+            {
+                fmt::print(stderr, "error: in {}: {}\n", filename, error);
+                return {};
+            }
+        }
+
+        auto face_count = shape.indices.size() / 3;
+        shape.material_ids.assign(face_count, -1);
+        shape.smoothing_group_ids.assign(face_count, 0);
+        if (weld_tolerance > 0.0f)
+        {
+            weld_vertices(shape, weld_tolerance);
+        }
+
+        ObjMesh mesh;
+        mesh.shapes.push_back(std::move(shape));
+        mesh.materials.push_back(tinyobj::material_t{});
+        return mesh;
+    }
+} // namespace atlas::utils
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "load_obj_file.hpp"
+
+#include <optional>
+#include <string>
+
+namespace atlas::utils
+{
+    // Loads an ASCII or binary PLY file, in either byte order, into the same
+    // structures as load_obj_mesh. Binary files are memory mapped and read
+    // with a fixed offset per property, so no text is parsed past the
+    // header.
+    //
+    // Vertices are read from the x, y and z properties of the vertex
+    // element, along with nx, ny and nz and u and v (or s and t) if present.
+    // Properties can be of any type. Faces come from the vertex_indices list
+    // of the face element, and polygons are split as fans. Other properties
+    // and elements are skipped. The vertices are used as they are in the
+    // file, since PLY already shares them between faces, so the mesh has a
+    // single shape with the default material. If a weld tolerance is given,
+    // the vertices are then welded with weld_vertices.
+    std::optional<ObjMesh> load_ply_mesh(std::string const& filename,
+                                         float weld_tolerance = 0.0f);
+} // namespace atlas::utils
@@ -0,0 +1,283 @@
+#include "load_stl_file.hpp"
+#include "mapped_file.hpp"
+#include "parse_float.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fmt/printf.h>
+#include <string_view>
+#include <vector>
+
+namespace atlas::utils
+{
+    namespace
+    {
+        constexpr std::size_t header_size{84};
+        constexpr std::size_t triangle_size{50};
+
+        // Binary STL is always little endian.
+        template<typename T>
+        T read_little_endian(char const* data)
+        {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+            if constexpr (std::endian::native == std::endian::big)
+            {
+                auto bytes = reinterpret_cast<unsigned char*>(&value);
+                std::reverse(bytes, bytes + sizeof(T));
+            }
+            return value;
+        }
+
+        void add_triangle(Shape& shape, glm::vec3 normal, glm::vec3 const* corners)
+        {
+            if (normal == glm::vec3{0.0f})
+            {
+                auto e1     = corners[1] - corners[0];
+                auto e2     = corners[2] - corners[0];
+                auto n      = glm::cross(e1, e2);
+                auto length = glm::length(n);
+                normal      = (length > 0.0f) ? n / length : glm::vec3{0.0f};
+            }
+
+            auto face = shape.indices.size() / 3;
+            for (std::size_t k{0}; k < 3; ++k)
+            {
+                Vertex vertex;
+                vertex.position = corners[k];
+                vertex.normal   = normal;
+                vertex.index    = shape.vertices.size();
+                vertex.face_id  = face;
+                shape.indices.push_back(vertex.index);
+                shape.vertices.push_back(vertex);
+            }
+        }
+
+        Shape make_shape()
+        {
+            Shape shape;
+            shape.has_texture_coords = false;
+            return shape;
+        }
+
+        void finish_shape(Shape& shape, float weld_tolerance)
+        {
+            auto face_count = shape.indices.size() / 3;
+            shape.material_ids.assign(face_count, -1);
+            shape.smoothing_group_ids.assign(face_count, 0);
+
+            merge_vertices(shape);
+            if (weld_tolerance > 0.0f)
+            {
+                weld_vertices(shape, weld_tolerance);
+            }
+        }
+
+        bool is_binary(std::string_view data)
+        {
+            if (data.size() < header_size)
+            {
+                return false;
+            }
+
+            // Some exporters start binary files with "solid" as well, so the
+            // size is what tells them apart.
+            auto count = read_little_endian<std::uint32_t>(data.data() + 80);
+            return data.size() == header_size + triangle_size * std::size_t{count};
+        }
+
+        std::vector<Shape> read_binary(std::string_view data)
+        {
+            auto count = read_little_endian<std::uint32_t>(data.data() + 80);
+
+            auto shape = make_shape();
+            shape.vertices.reserve(3 * std::size_t{count});
+            shape.indices.reserve(3 * std::size_t{count});
+
+            auto record = data.data() + header_size;
+            for (std::uint32_t i{0}; i < count; ++i, record += triangle_size)
+            {
+                // The normal and corners, skipping the attribute count.
+                float values[12];
+                if constexpr (std::endian::native == std::endian::little)
+                {
+                    std::memcpy(values, record, sizeof(values));
+                }
+                else
+                {
+                    for (std::size_t k{0}; k < 12; ++k)
+                    {
+                        values[k] = read_little_endian<float>(record + 4 * k);
+                    }
+                }
+
+                glm::vec3 corners[3]{{values[3], values[4], values[5]},
+                                     {values[6], values[7], values[8]},
+                                     {values[9], values[10], values[11]}};
+                add_triangle(shape, {values[0], values[1], values[2]}, corners);
+            }
+
+            std::vector<Shape> shapes;
+            shapes.push_back(std::move(shape));
+            return shapes;
+        }
+
+        std::string_view next_token(char const*& p, char const* end)
+        {
+            while (p < end && std::isspace(static_cast<unsigned char>(*p)))
+            {
+                ++p;
+            }
+
+            auto start = p;
+            while (p < end && !std::isspace(static_cast<unsigned char>(*p)))
+            {
+                ++p;
+            }
+            return {start, static_cast<std::size_t>(p - start)};
+        }
+
+        bool read_vector(char const*& p, char const* end, glm::vec3& out)
+        {
+            for (int k{0}; k < 3; ++k)
+            {
+                auto token = next_token(p, end);
+                if (!token.empty() && token.front() == '+')
+                {
+                    token.remove_prefix(1);
+                }
+
+                auto first = token.data();
+                auto last  = first + token.size();
+                if (first == last || detail::parse_float(first, last, out[k]) != last)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::optional<std::vector<Shape>> read_ascii(std::string_view data,
+                                                     std::string const& filename)
+        {
+            std::vector<Shape> shapes;
+            auto shape = make_shape();
+
+            glm::vec3 normal{0.0f};
+            glm::vec3 corners[3];
+            std::size_t corner_count{0};
+            std::size_t facet_corners{0};
+
+            auto p   = data.data();
+            auto end = p + data.size();
+            while (p < end)
+            {
+                auto keyword = next_token(p, end);
+                if (keyword == "solid")
+                {
+                    // The rest of the line is the name.
+                    p = std::find(p, end, '\n');
+                }
+                else if (keyword == "facet")
+                {
+                    normal        = glm::vec3{0.0f};
+                    corner_count  = 0;
+                    facet_corners = 0;
+                    if (next_token(p, end) != "normal" || !read_vector(p, end, normal))
+                    {
+                        fmt::print(stderr, "error: invalid facet in {}\n", filename);
+                        return {};
+                    }
+                }
+                else if (keyword == "vertex")
+                {
+                    glm::vec3 position;
+                    if (!read_vector(p, end, position))
+                    {
+                        fmt::print(stderr, "error: invalid vertex in {}\n", filename);
+                        return {};
+                    }
+
+                    // Facets with more than three corners are split as fans.
+                    if (corner_count == 3)
+                    {
+                        corners[1]   = corners[2];
+                        corner_count = 2;
+                    }
+                    corners[corner_count++] = position;
+                    if (corner_count == 3)
+                    {
+                        add_triangle(shape, normal, corners);
+                    }
+                    ++facet_corners;
+                }
+                else if (keyword == "endfacet" && facet_corners < 3)
+                {
+                    fmt::print(
+                        stderr, "error: facet with too few corners in {}\n", filename);
+                    return {};
+                }
+                else if (keyword == "endsolid")
+                {
+                    p = std::find(p, end, '\n');
+                    if (!shape.indices.empty())
+                    {
+                        shapes.push_back(std::move(shape));
+                        shape = make_shape();
+                    }
+                }
+            }
+
+            if (!shape.indices.empty())
+            {
+                shapes.push_back(std::move(shape));
+            }
+            return shapes;
+        }
+    } // namespace
+
+    std::optional<ObjMesh> load_stl_mesh(std::string const& filename,
+                                         float weld_tolerance)
+    {
+        MappedFile file{filename};
+        if (!file.is_open())
+        {
+            fmt::print(stderr, "error: could not open file {}\n", filename);
+            return {};
+        }
+
+        auto data = file.view();
+        std::optional<std::vector<Shape>> shapes;
+        if (is_binary(data))
+        {
+            shapes = read_binary(data);
+        }
+        else if (auto start = data.find_first_not_of(" \t\r\n");
+                 start != std::string_view::npos && data.substr(start, 5) == "solid")
+        {
+            shapes = read_ascii(data, filename);
+        }
+        else
+        {
+            fmt::print(stderr, "error: {} is not a valid STL file\n", filename);
+            return {};
+        }
+
+        if (!shapes)
+        {
+            return {};
+        }
+
+        ObjMesh mesh;
+        mesh.shapes = std::move(*shapes);
+        for (auto& shape : mesh.shapes)
+        {
+            finish_shape(shape, weld_tolerance);
+        }
+        mesh.materials.push_back(tinyobj::material_t{});
+        return mesh;
+    }
+} // namespace atlas::utils
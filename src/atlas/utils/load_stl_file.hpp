@@ -0,0 +1,23 @@
+#pragma once
+
+#include "load_obj_file.hpp"
+
+#include <optional>
+#include <string>
+
+namespace atlas::utils
+{
+    // Loads a binary or ASCII STL file into the same structures as
+    // load_obj_mesh. Binary files are memory mapped and each triangle is
+    // copied out as a block of 12 floats. Each solid of an ASCII file
+    // becomes a shape, while binary files always have a single one.
+    //
+    // STL stores every triangle with its own three corners and a facet
+    // normal, so corners with the same position and normal are merged into
+    // one vertex. Facets whose normal is missing get one from their winding.
+    // There are no texture coordinates and only the default material. If a
+    // weld tolerance is given, the vertices are then welded with
+    // weld_vertices.
+    std::optional<ObjMesh> load_stl_mesh(std::string const& filename,
+                                         float weld_tolerance = 0.0f);
+} // namespace atlas::utils
@@ -0,0 +1,163 @@
+#include "mapped_file.hpp"
+
+#include <utility>
+
+#if defined(_WIN32)
+#    define NOMINMAX
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace atlas::utils
+{
+#if defined(_WIN32)
+    MappedFile::MappedFile(std::string const& filename)
+    {
+        auto file = CreateFileA(filename.c_str(),
+                                GENERIC_READ,
+                                FILE_SHARE_READ,
+                                nullptr,
+                                OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                                nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size))
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        m_file = file;
+        m_open = true;
+        m_size = static_cast<std::size_t>(size.QuadPart);
+
+        // Empty files cannot be mapped, but they are still valid files.
+        if (m_size == 0)
+        {
+            return;
+        }
+
+        m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping != nullptr)
+        {
+            m_data = static_cast<char const*>(
+                MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+
+        if (m_data == nullptr)
+        {
+            close();
+        }
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+        }
+
+        if (m_mapping != nullptr)
+        {
+            CloseHandle(m_mapping);
+        }
+
+        if (m_file != nullptr)
+        {
+            CloseHandle(m_file);
+        }
+
+        m_open    = false;
+        m_data    = nullptr;
+        m_size    = 0;
+        m_file    = nullptr;
+        m_mapping = nullptr;
+    }
+#else
+    MappedFile::MappedFile(std::string const& filename)
+    {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            return;
+        }
+
+        struct stat info
+        {};
+        if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+        {
+            ::close(fd);
+            return;
+        }
+
+        m_open = true;
+        m_size = static_cast<std::size_t>(info.st_size);
+
+        // Empty files cannot be mapped, but they are still valid files.
+        if (m_size != 0)
+        {
+            auto data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                m_open = false;
+                m_size = 0;
+            }
+            else
+            {
+                m_data = static_cast<char const*>(data);
+                ::madvise(data, m_size, MADV_SEQUENTIAL);
+            }
+        }
+
+        // The mapping keeps the file alive on its own.
+        ::close(fd);
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data != nullptr)
+        {
+            ::munmap(const_cast<char*>(m_data), m_size);
+        }
+
+        m_open = false;
+        m_data = nullptr;
+        m_size = 0;
+    }
+#endif
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            std::swap(m_open, other.m_open);
+            std::swap(m_data, other.m_data);
+            std::swap(m_size, other.m_size);
+#if defined(_WIN32)
+            std::swap(m_file, other.m_file);
+            std::swap(m_mapping, other.m_mapping);
+#endif
+        }
+        return *this;
+    }
+} // namespace atlas::utils
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace atlas::utils
+{
+    // Read-only memory mapping of a whole file. Pages are loaded by the OS
+    // as they are touched, so opening a file costs the same no matter how
+    // large it is.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        explicit MappedFile(std::string const& filename);
+
+        MappedFile(MappedFile const&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        MappedFile& operator=(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        bool is_open() const
+        {
+            return m_open;
+        }
+
+        char const* data() const
+        {
+            return m_data;
+        }
+
+        std::size_t size() const
+        {
+            return m_size;
+        }
+
+        std::string_view view() const
+        {
+            return {m_data, m_size};
+        }
+
+    private:
+        void close();
+
+        bool m_open{false};
+        char const* m_data{nullptr};
+        std::size_t m_size{0};
+
+#if defined(_WIN32)
+        void* m_file{nullptr};
+        void* m_mapping{nullptr};
+#endif
+    };
+} // namespace atlas::utils
@@ -0,0 +1,535 @@
+#include "mesh_cache.hpp"
+#include "mapped_file.hpp"
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fmt/printf.h>
+#include <fstream>
+#include <map>
+#include <type_traits>
+#include <zeus/filesystem.hpp>
+
+namespace fs = std::filesystem;
+
+namespace atlas::utils
+{
+    namespace
+    {
+        constexpr std::array<char, 8> magic{'A', 'T', 'L', 'M', 'E', 'S', 'H', '\0'};
+        constexpr std::uint32_t version{1};
+        constexpr std::uint32_t byte_order{0x01020304};
+        constexpr std::uint64_t alignment{64};
+
+        static_assert(std::is_trivially_copyable_v<Vertex>);
+
+        struct Block
+        {
+            std::uint64_t offset{0};
+            std::uint64_t count{0};
+        };
+
+        struct Header
+        {
+            std::array<char, 8> magic;
+            std::uint32_t version;
+            std::uint32_t byte_order;
+            std::uint32_t vertex_size;
+            std::uint32_t index_size;
+            Block shapes;
+            Block materials;
+            std::uint64_t material_count;
+            Block source_path;
+            std::uint64_t source_size;
+            std::int64_t source_last_write;
+        };
+
+        struct ShapeRecord
+        {
+            std::uint32_t has_normals;
+            std::uint32_t has_texture_coords;
+            Block vertices;
+            Block indices;
+            Block material_ids;
+            Block smoothing_group_ids;
+        };
+
+        std::uint64_t align(std::uint64_t offset)
+        {
+            return (offset + alignment - 1) & ~(alignment - 1);
+        }
+
+        template<typename T>
+        Block place(std::uint64_t& offset, std::size_t count)
+        {
+            Block block{align(offset), count};
+            offset = block.offset + count * sizeof(T);
+            return block;
+        }
+
+        // Visits every serialised field of a material. Texture options are
+        // not stored.
+        template<typename Material, typename Fn>
+        void for_each_field(Material& m, Fn& fn)
+        {
+            fn(m.name);
+            fn(m.ambient);
+            fn(m.diffuse);
+            fn(m.specular);
+            fn(m.transmittance);
+            fn(m.emission);
+            fn(m.shininess);
+            fn(m.ior);
+            fn(m.dissolve);
+            fn(m.illum);
+            fn(m.ambient_texname);
+            fn(m.diffuse_texname);
+            fn(m.specular_texname);
+            fn(m.specular_highlight_texname);
+            fn(m.bump_texname);
+            fn(m.displacement_texname);
+            fn(m.alpha_texname);
+            fn(m.reflection_texname);
+            fn(m.roughness);
+            fn(m.metallic);
+            fn(m.sheen);
+            fn(m.clearcoat_thickness);
+            fn(m.clearcoat_roughness);
+            fn(m.anisotropy);
+            fn(m.anisotropy_rotation);
+            fn(m.roughness_texname);
+            fn(m.metallic_texname);
+            fn(m.sheen_texname);
+            fn(m.emissive_texname);
+            fn(m.normal_texname);
+            fn(m.unknown_parameter);
+        }
+
+        class MaterialWriter
+        {
+        public:
+            template<typename T>
+            void operator()(T const& value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                auto bytes = reinterpret_cast<char const*>(&value);
+                data.append(bytes, sizeof(T));
+            }
+
+            void operator()(std::string const& value)
+            {
+                (*this)(static_cast<std::uint32_t>(value.size()));
+                data.append(value);
+            }
+
+            void operator()(std::map<std::string, std::string> const& values)
+            {
+                (*this)(static_cast<std::uint32_t>(values.size()));
+                for (auto const& [key, value] : values)
+                {
+                    (*this)(key);
+                    (*this)(value);
+                }
+            }
+
+            std::string data;
+        };
+
+        class MaterialReader
+        {
+        public:
+            template<typename T>
+            void operator()(T& value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                if (data.size() < sizeof(T))
+                {
+                    valid = false;
+                    return;
+                }
+
+                std::memcpy(&value, data.data(), sizeof(T));
+                data.remove_prefix(sizeof(T));
+            }
+
+            void operator()(std::string& value)
+            {
+                std::uint32_t size{0};
+                (*this)(size);
+                if (!valid || data.size() < size)
+                {
+                    valid = false;
+                    return;
+                }
+
+                value.assign(data.substr(0, size));
+                data.remove_prefix(size);
+            }
+
+            void operator()(std::map<std::string, std::string>& values)
+            {
+                std::uint32_t count{0};
+                (*this)(count);
+                for (std::uint32_t i{0}; i < count && valid; ++i)
+                {
+                    std::string key;
+                    std::string value;
+                    (*this)(key);
+                    (*this)(value);
+                    values.emplace(std::move(key), std::move(value));
+                }
+            }
+
+            std::string_view data;
+            bool valid{true};
+        };
+
+        void write_at(std::ofstream& stream,
+                      std::uint64_t& position,
+                      std::uint64_t offset,
+                      void const* data,
+                      std::size_t size)
+        {
+            static constexpr std::array<char, alignment> zeros{};
+            while (position < offset)
+            {
+                auto count = std::min<std::uint64_t>(offset - position, zeros.size());
+                stream.write(zeros.data(), static_cast<std::streamsize>(count));
+                position += count;
+            }
+
+            auto bytes = static_cast<char const*>(data);
+            stream.write(bytes, static_cast<std::streamsize>(size));
+            position += size;
+        }
+
+        template<typename T>
+        std::optional<std::span<T const>> get_block(MappedFile const& file, Block block)
+        {
+            if (block.offset > file.size() || block.offset % alignof(T) != 0 ||
+                block.count > (file.size() - block.offset) / sizeof(T))
+            {
+                return {};
+            }
+
+            if (block.count == 0)
+            {
+                return std::span<T const>{};
+            }
+
+            auto data = reinterpret_cast<T const*>(file.data() + block.offset);
+            return std::span<T const>{data, static_cast<std::size_t>(block.count)};
+        }
+
+        std::string get_cache_filename(std::string const& filename,
+                                       std::string const& cache_directory)
+        {
+            if (cache_directory.empty())
+            {
+                return filename + ".amesh";
+            }
+
+            // Files with the same name in different directories must not
+            // share a cache entry, so the name includes a hash of the path.
+            auto path = fs::absolute(filename).string();
+            std::uint64_t hash{14695981039346656037ull};
+            for (auto c : path)
+            {
+                hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+            }
+
+            auto stem = fs::path{filename}.stem().string();
+            auto name = fmt::format("{}_{:016x}.amesh", stem, hash);
+            return (fs::path{cache_directory} / name).string();
+        }
+    } // namespace
+
+    BinaryMesh::BinaryMesh()                                 = default;
+    BinaryMesh::BinaryMesh(BinaryMesh&&) noexcept            = default;
+    BinaryMesh::~BinaryMesh()                                = default;
+    BinaryMesh& BinaryMesh::operator=(BinaryMesh&&) noexcept = default;
+
+    ObjMesh BinaryMesh::to_obj_mesh() const
+    {
+        ObjMesh mesh;
+        mesh.shapes.reserve(m_shapes.size());
+        for (auto const& source : m_shapes)
+        {
+            auto& shape               = mesh.shapes.emplace_back();
+            shape.has_normals         = source.has_normals;
+            shape.has_texture_coords  = source.has_texture_coords;
+            shape.vertices            = {source.vertices.begin(), source.vertices.end()};
+            shape.indices             = {source.indices.begin(), source.indices.end()};
+            shape.material_ids        = {source.material_ids.begin(),
+                                         source.material_ids.end()};
+            shape.smoothing_group_ids = {source.smoothing_group_ids.begin(),
+                                         source.smoothing_group_ids.end()};
+        }
+
+        mesh.materials = m_materials;
+        return mesh;
+    }
+
+    bool save_binary_mesh(ObjMesh const& mesh,
+                          std::string const& filename,
+                          MeshSource const& source)
+    {
+        MaterialWriter writer;
+        for (auto const& material : mesh.materials)
+        {
+            for_each_field(material, writer);
+        }
+
+        // Lay out the whole file first so the streams can be written straight
+        // from the mesh.
+        Header header{};
+        header.magic       = magic;
+        header.version     = version;
+        header.byte_order  = byte_order;
+        header.vertex_size = sizeof(Vertex);
+        header.index_size  = sizeof(std::size_t);
+
+        std::uint64_t offset{sizeof(Header)};
+        header.shapes = place<ShapeRecord>(offset, mesh.shapes.size());
+
+        std::vector<ShapeRecord> records(mesh.shapes.size());
+        for (std::size_t i{0}; i < mesh.shapes.size(); ++i)
+        {
+            auto const& shape         = mesh.shapes[i];
+            auto& record              = records[i];
+            record.has_normals        = shape.has_normals;
+            record.has_texture_coords = shape.has_texture_coords;
+            record.vertices     = place<Vertex>(offset, shape.vertices.size());
+            record.indices      = place<std::size_t>(offset, shape.indices.size());
+            record.material_ids = place<int>(offset, shape.material_ids.size());
+            record.smoothing_group_ids =
+                place<unsigned int>(offset, shape.smoothing_group_ids.size());
+        }
+
+        header.materials         = place<char>(offset, writer.data.size());
+        header.material_count    = mesh.materials.size();
+        header.source_path       = place<char>(offset, source.path.size());
+        header.source_size       = source.size;
+        header.source_last_write = source.last_write;
+
+        std::ofstream stream{filename, std::ios::binary};
+        if (!stream)
+        {
+            fmt::print(stderr, "error: could not open file {} for writing\n", filename);
+            return false;
+        }
+
+        std::uint64_t position{0};
+        write_at(stream, position, 0, &header, sizeof(Header));
+        write_at(stream,
+                 position,
+                 header.shapes.offset,
+                 records.data(),
+                 records.size() * sizeof(ShapeRecord));
+
+        for (std::size_t i{0}; i < mesh.shapes.size(); ++i)
+        {
+            auto const& shape  = mesh.shapes[i];
+            auto const& record = records[i];
+            write_at(stream,
+                     position,
+                     record.vertices.offset,
+                     shape.vertices.data(),
+                     shape.vertices.size() * sizeof(Vertex));
+            write_at(stream,
+                     position,
+                     record.indices.offset,
+                     shape.indices.data(),
+                     shape.indices.size() * sizeof(std::size_t));
+            write_at(stream,
+                     position,
+                     record.material_ids.offset,
+                     shape.material_ids.data(),
+                     shape.material_ids.size() * sizeof(int));
+            write_at(stream,
+                     position,
+                     record.smoothing_group_ids.offset,
+                     shape.smoothing_group_ids.data(),
+                     shape.smoothing_group_ids.size() * sizeof(unsigned int));
+        }
+
+        write_at(stream,
+                 position,
+                 header.materials.offset,
+                 writer.data.data(),
+                 writer.data.size());
+        write_at(stream,
+                 position,
+                 header.source_path.offset,
+                 source.path.data(),
+                 source.path.size());
+
+        if (!stream)
+        {
+            fmt::print(stderr, "error: could not write file {}\n", filename);
+            return false;
+        }
+
+        return true;
+    }
+
+    namespace detail
+    {
+        std::optional<BinaryMesh> map_binary_mesh(std::string const& filename)
+        {
+            MappedFile file{filename};
+            if (!file.is_open() || file.size() < sizeof(Header))
+            {
+                return {};
+            }
+
+            Header header;
+            std::memcpy(&header, file.data(), sizeof(Header));
+            if (header.magic != magic || header.version != version ||
+                header.byte_order != byte_order || header.vertex_size != sizeof(Vertex) ||
+                header.index_size != sizeof(std::size_t))
+            {
+                return {};
+            }
+
+            auto records = get_block<ShapeRecord>(file, header.shapes);
+            auto bytes   = get_block<char>(file, header.materials);
+            auto path    = get_block<char>(file, header.source_path);
+            // Every material takes up more than one byte, which bounds the
+            // count of a corrupt file.
+            if (!records || !path || !bytes || header.material_count > bytes->size())
+            {
+                return {};
+            }
+
+            BinaryMesh mesh;
+            for (auto const& record : *records)
+            {
+                auto vertices  = get_block<Vertex>(file, record.vertices);
+                auto indices   = get_block<std::size_t>(file, record.indices);
+                auto materials = get_block<int>(file, record.material_ids);
+                auto groups =
+                    get_block<unsigned int>(file, record.smoothing_group_ids);
+                if (!vertices || !indices || !materials || !groups)
+                {
+                    return {};
+                }
+
+                mesh.m_shapes.push_back({record.has_normals != 0,
+                                         record.has_texture_coords != 0,
+                                         *vertices,
+                                         *indices,
+                                         *materials,
+                                         *groups});
+            }
+
+            MaterialReader reader{{bytes->data(), bytes->size()}};
+            mesh.m_materials.resize(header.material_count);
+            for (auto& material : mesh.m_materials)
+            {
+                for_each_field(material, reader);
+            }
+
+            if (!reader.valid)
+            {
+                return {};
+            }
+
+            mesh.m_source.path       = {path->begin(), path->end()};
+            mesh.m_source.size       = header.source_size;
+            mesh.m_source.last_write = header.source_last_write;
+
+            // Moving the mapping keeps its address, so the spans stay valid.
+            mesh.m_file = std::make_unique<MappedFile>(std::move(file));
+            return mesh;
+        }
+
+        BinaryMesh wrap_obj_mesh(ObjMesh&& mesh, MeshSource const& source)
+        {
+            // As with the mapping, moving the vectors keeps their storage.
+            BinaryMesh result;
+            result.m_mesh   = std::move(mesh);
+            result.m_source = source;
+            for (auto const& shape : result.m_mesh.shapes)
+            {
+                result.m_shapes.push_back({shape.has_normals,
+                                           shape.has_texture_coords,
+                                           shape.vertices,
+                                           shape.indices,
+                                           shape.material_ids,
+                                           shape.smoothing_group_ids});
+            }
+            result.m_materials = std::move(result.m_mesh.materials);
+            return result;
+        }
+    } // namespace detail
+
+    std::optional<BinaryMesh> load_binary_mesh(std::string const& filename)
+    {
+        auto mesh = detail::map_binary_mesh(filename);
+        if (!mesh)
+        {
+            fmt::print(stderr, "error: {} is not a valid binary mesh\n", filename);
+        }
+        return mesh;
+    }
+
+    std::optional<BinaryMesh> load_obj_mesh_cached(std::string const& filename,
+                                                   jobs::JobSystem& system,
+                                                   std::string const& cache_directory,
+                                                   std::string const& material_path)
+    {
+        std::error_code code;
+        auto size = fs::file_size(filename, code);
+        if (code)
+        {
+            fmt::print(stderr, "error: could not open file {}\n", filename);
+            return {};
+        }
+
+        MeshSource source{fs::absolute(filename).string(),
+                          size,
+                          static_cast<std::int64_t>(zeus::get_file_last_write(filename))};
+
+        auto cache_filename = get_cache_filename(filename, cache_directory);
+        if (fs::exists(cache_filename, code))
+        {
+            auto mesh = detail::map_binary_mesh(cache_filename);
+            if (mesh && mesh->source() == source)
+            {
+                return mesh;
+            }
+        }
+
+        auto mesh = load_obj_mesh_parallel(filename, system, material_path);
+        if (!mesh)
+        {
+            return {};
+        }
+
+        if (!cache_directory.empty())
+        {
+            fs::create_directories(cache_directory, code);
+        }
+
+        // Write under a temporary name first, so nobody can map a cache file
+        // that is only partially written. Failing to cache the mesh does not
+        // fail the load.
+        auto temp_filename = cache_filename + ".tmp";
+        if (save_binary_mesh(*mesh, temp_filename, source))
+        {
+            fs::rename(temp_filename, cache_filename, code);
+            if (!code)
+            {
+                if (auto cached = detail::map_binary_mesh(cache_filename); cached)
+                {
+                    return cached;
+                }
+            }
+            fmt::print(stderr, "error: could not write file {}\n", cache_filename);
+        }
+
+        fs::remove(temp_filename, code);
+        return detail::wrap_obj_mesh(std::move(*mesh), source);
+    }
+} // namespace atlas::utils
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "load_obj_file.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace atlas::utils
+{
+    // Identifies the file a binary mesh was made from. A cached mesh is only
+    // used if all three still match the file.
+    struct MeshSource
+    {
+        std::string path;
+        std::uint64_t size{0};
+        std::int64_t last_write{0};
+
+        bool operator==(MeshSource const&) const = default;
+    };
+
+    // Shape whose streams point into a memory-mapped binary mesh.
+    struct BinaryShape
+    {
+        bool has_normals{true};
+        bool has_texture_coords{true};
+        std::span<Vertex const> vertices;
+        std::span<std::size_t const> indices;
+        std::span<int const> material_ids;
+        std::span<unsigned int const> smoothing_group_ids;
+    };
+
+    class BinaryMesh;
+    class MappedFile;
+
+    namespace detail
+    {
+        // Same as load_binary_mesh, but fails silently.
+        std::optional<BinaryMesh> map_binary_mesh(std::string const& filename);
+
+        // Views a mesh held in memory, for when it could not be cached.
+        BinaryMesh wrap_obj_mesh(ObjMesh&& mesh, MeshSource const& source);
+    } // namespace detail
+
+    // Mesh loaded from the binary format written by save_binary_mesh. The
+    // file is memory mapped and the vertex and index streams are used in
+    // place, so loading does not depend on the size of the mesh. Every stream
+    // starts on a 64-byte boundary. The vertices can be uploaded as is, but
+    // the indices are std::size_t like those of Shape, so they have to be
+    // narrowed before they can be used as a GPU index buffer.
+    //
+    // The format stores the in-memory layout of the streams, so it is meant
+    // as a cache on the machine that wrote it rather than for distribution.
+    class BinaryMesh
+    {
+    public:
+        BinaryMesh();
+        BinaryMesh(BinaryMesh&&) noexcept;
+        ~BinaryMesh();
+
+        BinaryMesh& operator=(BinaryMesh&&) noexcept;
+
+        std::vector<BinaryShape> const& shapes() const
+        {
+            return m_shapes;
+        }
+
+        std::vector<tinyobj::material_t> const& materials() const
+        {
+            return m_materials;
+        }
+
+        MeshSource const& source() const
+        {
+            return m_source;
+        }
+
+        // Copies the streams out of the file.
+        ObjMesh to_obj_mesh() const;
+
+    private:
+        friend std::optional<BinaryMesh>
+        detail::map_binary_mesh(std::string const& filename);
+        friend BinaryMesh detail::wrap_obj_mesh(ObjMesh&& mesh,
+                                                MeshSource const& source);
+
+        std::unique_ptr<MappedFile> m_file;
+        ObjMesh m_mesh;
+        std::vector<BinaryShape> m_shapes;
+        std::vector<tinyobj::material_t> m_materials;
+        MeshSource m_source;
+    };
+
+    bool save_binary_mesh(ObjMesh const& mesh,
+                          std::string const& filename,
+                          MeshSource const& source = {});
+
+    std::optional<BinaryMesh> load_binary_mesh(std::string const& filename);
+
+    // Loads an OBJ file through a binary cache. The cache lives next to the
+    // OBJ file unless a cache directory is given, and is rebuilt whenever the
+    // path, size or modification time of the OBJ file changes, in which case
+    // it is parsed again on the job system. Changes to material libraries are
+    // not tracked. Failing to write the cache does not fail the load: the
+    // parsed mesh is returned from memory instead.
+    std::optional<BinaryMesh>
+    load_obj_mesh_cached(std::string const& filename,
+                         jobs::JobSystem& system,
+                         std::string const& cache_directory = {},
+                         std::string const& material_path = {});
+} // namespace atlas::utils
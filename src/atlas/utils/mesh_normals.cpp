@@ -0,0 +1,546 @@
+#include "mesh_normals.hpp"
+#include "adjacency.hpp"
+
+#include <algorithm>
+#include <fmt/printf.h>
+#include <limits>
+#include <numeric>
+#include <tuple>
+
+namespace atlas::utils
+{
+    namespace
+    {
+        // Numbers the vertices so that those with the same key get the same
+        // number, and returns the number of each corner along with how many
+        // there are.
+        template<typename Key>
+        std::vector<std::size_t>
+        weld_corners(Shape const& shape, Key const& key, std::size_t& count)
+        {
+            auto const& vertices = shape.vertices;
+            std::vector<std::size_t> order(vertices.size());
+            std::iota(order.begin(), order.end(), std::size_t{0});
+            std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+                return key(vertices[a]) < key(vertices[b]);
+            });
+
+            std::vector<std::size_t> group(vertices.size());
+            count = 0;
+            for (std::size_t i{0}; i < order.size(); ++i)
+            {
+                if (i != 0 && key(vertices[order[i]]) != key(vertices[order[i - 1]]))
+                {
+                    ++count;
+                }
+                group[order[i]] = count;
+            }
+            count += vertices.empty() ? 0 : 1;
+
+            std::vector<std::size_t> corners(shape.indices.size());
+            for (std::size_t c{0}; c < corners.size(); ++c)
+            {
+                corners[c] = group[shape.indices[c]];
+            }
+            return corners;
+        }
+
+        // Smoothing works across texture seams, so normals only look at
+        // positions.
+        auto position_key(Vertex const& v)
+        {
+            return std::tie(v.position.x, v.position.y, v.position.z);
+        }
+
+        // MikkTSpace treats vertices as the same when all of their
+        // attributes are.
+        auto tangent_key(Vertex const& v)
+        {
+            return std::tie(v.position.x,
+                            v.position.y,
+                            v.position.z,
+                            v.normal.x,
+                            v.normal.y,
+                            v.normal.z,
+                            v.tex_coord.x,
+                            v.tex_coord.y);
+        }
+
+        // Angle of the face at each of its corners.
+        std::vector<float> corner_angles(Shape const& shape, jobs::JobSystem& system)
+        {
+            std::vector<float> angles(shape.indices.size());
+            system.parallel_for(
+                shape.indices.size() / 3, 0, [&](std::size_t begin, std::size_t end) {
+                    for (auto f = begin; f < end; ++f)
+                    {
+                        for (std::size_t k{0}; k < 3; ++k)
+                        {
+                            auto const& p = shape.vertices[shape.indices[3 * f + k]];
+                            auto const& a =
+                                shape.vertices[shape.indices[3 * f + (k + 1) % 3]];
+                            auto const& b =
+                                shape.vertices[shape.indices[3 * f + (k + 2) % 3]];
+
+                            auto u = a.position - p.position;
+                            auto v = b.position - p.position;
+                            auto d = glm::length(u) * glm::length(v);
+                            auto c = (d > 0.0f) ? glm::dot(u, v) / d : 1.0f;
+                            angles[3 * f + k] = glm::acos(glm::clamp(c, -1.0f, 1.0f));
+                        }
+                    }
+                });
+            return angles;
+        }
+
+        glm::vec3 any_perpendicular(glm::vec3 const& n)
+        {
+            auto axis = (glm::abs(n.x) < 0.9f) ? glm::vec3{1.0f, 0.0f, 0.0f}
+                                                : glm::vec3{0.0f, 1.0f, 0.0f};
+            return glm::normalize(glm::cross(n, axis));
+        }
+
+        constexpr auto no_face = std::numeric_limits<std::size_t>::max();
+
+        // What MikkTSpace keeps for each face.
+        struct FaceFrame
+        {
+            // Direction of increasing u, flipped when the texture coordinates
+            // are mirrored.
+            glm::vec3 tangent{0.0f};
+            float sign{1.0f};
+
+            // The texture coordinates are degenerate, so the face takes the
+            // orientation of the first group that reaches it.
+            bool free{true};
+
+            // Two of the corners are the same vertex.
+            bool degenerate{false};
+        };
+
+        // Face across each edge, where edge k of a face goes from its corner k
+        // to corner k + 1. Faces are only neighbours if they are wound the
+        // same way, and each edge is paired at most once.
+        std::vector<std::size_t> face_neighbours(std::vector<std::size_t> const& corners,
+                                                 std::vector<FaceFrame> const& frames)
+        {
+            struct Edge
+            {
+                std::size_t from;
+                std::size_t to;
+                std::size_t corner;
+            };
+
+            std::vector<Edge> edges;
+            edges.reserve(corners.size());
+            for (std::size_t f{0}; f < frames.size(); ++f)
+            {
+                if (frames[f].degenerate)
+                {
+                    continue;
+                }
+
+                for (std::size_t k{0}; k < 3; ++k)
+                {
+                    edges.push_back(
+                        {corners[3 * f + k], corners[3 * f + (k + 1) % 3], 3 * f + k});
+                }
+            }
+
+            auto less = [](Edge const& a, Edge const& b) {
+                return std::tie(a.from, a.to, a.corner) <
+                       std::tie(b.from, b.to, b.corner);
+            };
+            std::sort(edges.begin(), edges.end(), less);
+
+            std::vector<std::size_t> neighbours(corners.size(), no_face);
+            for (auto const& edge : edges)
+            {
+                if (neighbours[edge.corner] != no_face)
+                {
+                    continue;
+                }
+
+                Edge const twin{edge.to, edge.from, 0};
+                for (auto it = std::lower_bound(edges.begin(), edges.end(), twin, less);
+                     it != edges.end() && it->from == twin.from && it->to == twin.to;
+                     ++it)
+                {
+                    if (neighbours[it->corner] == no_face)
+                    {
+                        neighbours[edge.corner] = it->corner / 3;
+                        neighbours[it->corner]  = edge.corner / 3;
+                        break;
+                    }
+                }
+            }
+            return neighbours;
+        }
+
+        // Gives each corner a vertex with its own value, splitting the
+        // vertices whose corners have different values. Returns the value of
+        // each vertex afterwards. Vertices no corner uses are kept.
+        template<typename T>
+        std::vector<T> split_vertices(Shape& shape,
+                                      std::vector<T> const& values,
+                                      jobs::JobSystem& system)
+        {
+            auto const vertex_count = shape.vertices.size();
+            detail::Adjacency corners{shape.indices, vertex_count};
+
+            // Number the distinct values of each vertex in the order they
+            // first appear.
+            std::vector<std::size_t> variant(shape.indices.size());
+            std::vector<std::size_t> offsets(vertex_count + 1, 0);
+            system.parallel_for(vertex_count, 0, [&](std::size_t begin, std::size_t end) {
+                for (auto v = begin; v < end; ++v)
+                {
+                    std::size_t count{0};
+                    for (auto i = corners.begin(v); i < corners.end(v); ++i)
+                    {
+                        auto c     = corners.items[i];
+                        variant[c] = count;
+                        for (auto j = corners.begin(v); j < i; ++j)
+                        {
+                            if (values[corners.items[j]] == values[c])
+                            {
+                                variant[c] = variant[corners.items[j]];
+                                break;
+                            }
+                        }
+
+                        count += (variant[c] == count) ? 1 : 0;
+                    }
+                    offsets[v + 1] = std::max<std::size_t>(count, 1);
+                }
+            });
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            std::vector<Vertex> vertices(offsets.back());
+            std::vector<T> result(offsets.back());
+            system.parallel_for(vertex_count, 0, [&](std::size_t begin, std::size_t end) {
+                for (auto v = begin; v < end; ++v)
+                {
+                    vertices[offsets[v]]       = shape.vertices[v];
+                    vertices[offsets[v]].index = offsets[v];
+
+                    // Corners are sorted by face, so the first corner of each
+                    // value is on the first face that uses the new vertex.
+                    std::size_t filled{0};
+                    for (auto i = corners.begin(v); i < corners.end(v); ++i)
+                    {
+                        auto c     = corners.items[i];
+                        auto index = offsets[v] + variant[c];
+                        if (variant[c] == filled)
+                        {
+                            vertices[index]         = shape.vertices[v];
+                            vertices[index].index   = index;
+                            vertices[index].face_id = c / 3;
+                            result[index]           = values[c];
+                            ++filled;
+                        }
+                        shape.indices[c] = index;
+                    }
+                }
+            });
+
+            shape.vertices = std::move(vertices);
+            return result;
+        }
+    } // namespace
+
+    void generate_normals(Shape& shape,
+                          jobs::JobSystem& system,
+                          NormalSettings const& settings)
+    {
+        auto const face_count = shape.indices.size() / 3;
+        if (face_count == 0)
+        {
+            return;
+        }
+
+        std::vector<glm::vec3> face_normals(face_count);
+        system.parallel_for(face_count, 0, [&](std::size_t begin, std::size_t end) {
+            for (auto f = begin; f < end; ++f)
+            {
+                auto const& a = shape.vertices[shape.indices[3 * f + 0]].position;
+                auto const& b = shape.vertices[shape.indices[3 * f + 1]].position;
+                auto const& c = shape.vertices[shape.indices[3 * f + 2]].position;
+                auto n        = glm::cross(b - a, c - a);
+                auto length   = glm::length(n);
+                face_normals[f] = (length > 0.0f) ? n / length : glm::vec3{0.0f};
+            }
+        });
+
+        auto angles = corner_angles(shape, system);
+
+        std::size_t position_count{0};
+        auto positions = weld_corners(shape, position_key, position_count);
+        detail::Adjacency around{positions, position_count};
+
+        auto const& groups    = shape.smoothing_group_ids;
+        auto const use_groups = settings.use_smoothing_groups;
+        auto const has_groups = groups.size() == face_count;
+        auto const min_dot    = glm::cos(settings.angle_threshold);
+
+        auto smoothed = [&](std::size_t f, std::size_t g) {
+            if (f == g)
+            {
+                return true;
+            }
+
+            if (use_groups)
+            {
+                auto group = has_groups ? groups[f] : 0u;
+                if (group == 0 || groups[g] != group)
+                {
+                    return false;
+                }
+            }
+
+            return glm::dot(face_normals[f], face_normals[g]) >= min_dot;
+        };
+
+        std::vector<glm::vec3> normals(shape.indices.size());
+        system.parallel_for(face_count, 0, [&](std::size_t begin, std::size_t end) {
+            for (auto f = begin; f < end; ++f)
+            {
+                for (std::size_t k{0}; k < 3; ++k)
+                {
+                    auto p = positions[3 * f + k];
+
+                    glm::vec3 sum{0.0f};
+                    for (auto i = around.begin(p); i < around.end(p); ++i)
+                    {
+                        auto c = around.items[i];
+                        if (smoothed(f, c / 3))
+                        {
+                            sum += face_normals[c / 3] * angles[c];
+                        }
+                    }
+
+                    auto length = glm::length(sum);
+                    if (length > 0.0f)
+                    {
+                        normals[3 * f + k] = sum / length;
+                    }
+                    else if (face_normals[f] != glm::vec3{0.0f})
+                    {
+                        normals[3 * f + k] = face_normals[f];
+                    }
+                    else
+                    {
+                        normals[3 * f + k] = glm::vec3{0.0f, 0.0f, 1.0f};
+                    }
+                }
+            }
+        });
+
+        auto vertex_normals = split_vertices(shape, normals, system);
+        for (std::size_t v{0}; v < shape.vertices.size(); ++v)
+        {
+            shape.vertices[v].normal = vertex_normals[v];
+        }
+        shape.has_normals = true;
+    }
+
+    std::vector<glm::vec4> generate_tangents(Shape& shape, jobs::JobSystem& system)
+    {
+        if (!shape.has_normals || !shape.has_texture_coords)
+        {
+            fmt::print(stderr,
+                       "error: tangents need both normals and texture coordinates\n");
+            return {};
+        }
+
+        auto const face_count = shape.indices.size() / 3;
+        if (face_count == 0)
+        {
+            return std::vector<glm::vec4>(shape.vertices.size());
+        }
+
+        // Vertices are welded on all of their attributes, so texture seams
+        // and hard edges start new groups.
+        std::size_t vertex_count{0};
+        auto corners = weld_corners(shape, tangent_key, vertex_count);
+
+        std::vector<FaceFrame> frames(face_count);
+        system.parallel_for(face_count, 0, [&](std::size_t begin, std::size_t end) {
+            for (auto f = begin; f < end; ++f)
+            {
+                auto const& a = shape.vertices[shape.indices[3 * f + 0]];
+                auto const& b = shape.vertices[shape.indices[3 * f + 1]];
+                auto const& c = shape.vertices[shape.indices[3 * f + 2]];
+
+                auto e1   = b.position - a.position;
+                auto e2   = c.position - a.position;
+                auto st1  = b.tex_coord - a.tex_coord;
+                auto st2  = c.tex_coord - a.tex_coord;
+                auto area = st1.x * st2.y - st1.y * st2.x;
+                auto s    = e1 * st2.y - e2 * st1.y;
+                auto t    = e2 * st1.x - e1 * st2.x;
+
+                auto& frame      = frames[f];
+                frame.sign       = (area > 0.0f) ? 1.0f : -1.0f;
+                frame.degenerate = corners[3 * f + 0] == corners[3 * f + 1] ||
+                                   corners[3 * f + 0] == corners[3 * f + 2] ||
+                                   corners[3 * f + 1] == corners[3 * f + 2];
+
+                auto const min = std::numeric_limits<float>::min();
+                if (glm::abs(area) > min)
+                {
+                    auto s_length = glm::length(s);
+                    auto t_length = glm::length(t);
+                    if (s_length > min)
+                    {
+                        frame.tangent = s * (frame.sign / s_length);
+                    }
+                    frame.free = s_length / glm::abs(area) <= min ||
+                                 t_length / glm::abs(area) <= min;
+                }
+            }
+        });
+
+        auto neighbours = face_neighbours(corners, frames);
+
+        // Around each vertex, faces that are connected through the edges at
+        // that vertex and have the same orientation form a group. This is
+        // serial and in face order, since the free faces take the orientation
+        // of whichever group reaches them first.
+        std::vector<std::size_t> corner_groups(shape.indices.size(), no_face);
+        std::vector<float> group_signs;
+        std::vector<std::size_t> pending;
+        for (std::size_t f{0}; f < face_count; ++f)
+        {
+            for (std::size_t k{0}; k < 3; ++k)
+            {
+                if (frames[f].degenerate || corner_groups[3 * f + k] != no_face)
+                {
+                    continue;
+                }
+
+                auto const group  = group_signs.size();
+                auto const vertex = corners[3 * f + k];
+                group_signs.push_back(frames[f].sign);
+                pending.push_back(f);
+                while (!pending.empty())
+                {
+                    auto g = pending.back();
+                    pending.pop_back();
+
+                    std::size_t i{0};
+                    while (corners[3 * g + i] != vertex)
+                    {
+                        ++i;
+                    }
+
+                    auto c = 3 * g + i;
+                    if (corner_groups[c] != no_face)
+                    {
+                        continue;
+                    }
+
+                    auto& frame = frames[g];
+                    if (frame.free && corner_groups[3 * g + 0] == no_face &&
+                        corner_groups[3 * g + 1] == no_face &&
+                        corner_groups[3 * g + 2] == no_face)
+                    {
+                        frame.sign = group_signs[group];
+                    }
+
+                    if (frame.sign != group_signs[group])
+                    {
+                        continue;
+                    }
+
+                    corner_groups[c] = group;
+                    for (auto edge : {c, 3 * g + (i + 2) % 3})
+                    {
+                        if (neighbours[edge] != no_face)
+                        {
+                            pending.push_back(neighbours[edge]);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Corners of degenerate faces are keyed past the last group.
+        auto const group_count = group_signs.size();
+        for (auto& group : corner_groups)
+        {
+            group = (group == no_face) ? group_count : group;
+        }
+        detail::Adjacency members{corner_groups, group_count + 1};
+
+        auto unit_normal = [&](std::size_t c) {
+            auto n = shape.vertices[shape.indices[c]].normal;
+            if (auto length = glm::length(n); length > 0.0f)
+            {
+                n /= length;
+            }
+            return n;
+        };
+
+        // Every corner of a group is the same vertex, so they share a normal.
+        // The tangent of each face is projected onto its plane and weighted by
+        // the angle of the face there, also measured in that plane.
+        std::vector<glm::vec4> tangents(shape.indices.size());
+        system.parallel_for(group_count, 0, [&](std::size_t begin, std::size_t end) {
+            for (auto group = begin; group < end; ++group)
+            {
+                auto n       = unit_normal(members.items[members.begin(group)]);
+                auto project = [&](glm::vec3 v) {
+                    v -= n * glm::dot(n, v);
+                    auto length = glm::length(v);
+                    return (length > 0.0f) ? v / length : v;
+                };
+
+                glm::vec3 sum{0.0f};
+                for (auto i = members.begin(group); i < members.end(group); ++i)
+                {
+                    auto c = members.items[i];
+                    auto f = c / 3;
+                    auto k = c % 3;
+
+                    auto const& p    = shape.vertices[shape.indices[c]].position;
+                    auto const& next = shape.vertices[shape.indices[3 * f + (k + 1) % 3]];
+                    auto const& prev = shape.vertices[shape.indices[3 * f + (k + 2) % 3]];
+
+                    auto cosine =
+                        glm::dot(project(prev.position - p), project(next.position - p));
+                    auto angle = glm::acos(glm::clamp(cosine, -1.0f, 1.0f));
+                    sum += project(frames[f].tangent) * angle;
+                }
+
+                auto length = glm::length(sum);
+                auto t      = (length > 0.0f) ? sum / length : any_perpendicular(n);
+                for (auto i = members.begin(group); i < members.end(group); ++i)
+                {
+                    tangents[members.items[i]] = glm::vec4{t, group_signs[group]};
+                }
+            }
+        });
+
+        // Degenerate faces copy the first other corner of the same vertex.
+        std::vector<std::size_t> first_corners(vertex_count, no_face);
+        for (std::size_t c{shape.indices.size()}; c-- > 0;)
+        {
+            if (!frames[c / 3].degenerate)
+            {
+                first_corners[corners[c]] = c;
+            }
+        }
+
+        for (auto i = members.begin(group_count); i < members.end(group_count); ++i)
+        {
+            auto c      = members.items[i];
+            auto source = first_corners[corners[c]];
+            tangents[c] = (source != no_face)
+                              ? tangents[source]
+                              : glm::vec4{any_perpendicular(unit_normal(c)), 1.0f};
+        }
+
+        return split_vertices(shape, tangents, system);
+    }
+} // namespace atlas::utils
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "load_obj_file.hpp"
+
+#include <atlas/jobs/job_system.hpp>
+#include <atlas/math/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace atlas::utils
+{
+    struct NormalSettings
+    {
+        // Faces are only smoothed together if the angle between them, in
+        // radians, is at most this.
+        float angle_threshold{glm::pi<float>()};
+
+        // Only smooth faces that are in the same smoothing group. Group 0
+        // (s off, or no s statement at all) is flat shaded, as in the OBJ
+        // format. Otherwise every face is smoothed with its neighbours and
+        // only the angle threshold applies.
+        bool use_smoothing_groups{true};
+    };
+
+    // Replaces the normals of a shape with ones computed from its faces.
+    // Each corner gets the average of the normals of the faces around its
+    // position that are smoothed with its face, weighted by the angle of
+    // each face at that position. Vertices whose corners end up with
+    // different normals are split, so the indices change. Faces are
+    // processed in parallel, and each corner gathers from its neighbours
+    // rather than faces adding to their vertices, so no synchronisation is
+    // needed.
+    void generate_normals(Shape& shape,
+                          jobs::JobSystem& system,
+                          NormalSettings const& settings = {});
+
+    // Computes a tangent per vertex the way MikkTSpace does, with the sign of
+    // the bitangent in w so that bitangent = w * cross(normal, tangent).
+    // Vertices with the same position, normal and texture coordinates count as
+    // one. Around each of them, the faces that are connected through its edges
+    // and have the same orientation in texture space form a group, and every
+    // corner in the group gets the tangents of its faces projected onto the
+    // plane of the normal and averaged, weighted by the angle of each face
+    // there. Vertices that end up in more than one group, such as those on a
+    // mirrored seam, are split. Shapes only hold triangles, so the special
+    // cases the reference code has for quads never apply. Returns nothing if
+    // the shape has no normals or texture coordinates.
+    std::vector<glm::vec4> generate_tangents(Shape& shape, jobs::JobSystem& system);
+} // namespace atlas::utils
@@ -0,0 +1,434 @@
+#include "mesh_optimiser.hpp"
+#include "adjacency.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace atlas::utils
+{
+    namespace
+    {
+        constexpr auto no_vertex = std::numeric_limits<std::size_t>::max();
+
+        // FIFO post-transform cache. Each vertex remembers when it was
+        // added, so a lookup is a single subtraction.
+        class VertexCache
+        {
+        public:
+            VertexCache(std::size_t vertex_count, std::size_t cache_size) :
+                m_stamps(vertex_count, 0),
+                m_size{cache_size}
+            {}
+
+            // Returns true if the vertex had to be transformed.
+            bool access(std::size_t vertex)
+            {
+                auto& stamp = m_stamps[vertex];
+                if (stamp != 0 && m_time - stamp < m_size)
+                {
+                    return false;
+                }
+
+                stamp = ++m_time;
+                return true;
+            }
+
+            void flush()
+            {
+                // Everything currently in the cache is at least m_size
+                // entries old after this.
+                m_time += m_size;
+            }
+
+        private:
+            std::vector<std::size_t> m_stamps;
+            std::size_t m_time{0};
+            std::size_t m_size;
+        };
+
+        // Moves triangle order[i] to position i.
+        void reorder_triangles(Shape& shape, std::vector<std::size_t> const& order)
+        {
+            std::vector<std::size_t> indices(shape.indices.size());
+            std::vector<std::size_t> remap(order.size());
+            for (std::size_t i{0}; i < order.size(); ++i)
+            {
+                auto first = shape.indices.begin() + 3 * order[i];
+                std::copy_n(first, 3, indices.begin() + 3 * i);
+                remap[order[i]] = i;
+            }
+            shape.indices = std::move(indices);
+
+            auto permute = [&order](auto& ids) {
+                if (ids.size() != order.size())
+                {
+                    return;
+                }
+
+                auto old = ids;
+                for (std::size_t i{0}; i < order.size(); ++i)
+                {
+                    ids[i] = old[order[i]];
+                }
+            };
+
+            permute(shape.material_ids);
+            permute(shape.smoothing_group_ids);
+
+            for (auto& vertex : shape.vertices)
+            {
+                if (vertex.face_id < remap.size())
+                {
+                    vertex.face_id = remap[vertex.face_id];
+                }
+            }
+        }
+
+        glm::vec3 triangle_normal(Shape const& shape, std::size_t triangle)
+        {
+            auto const& a = shape.vertices[shape.indices[3 * triangle + 0]].position;
+            auto const& b = shape.vertices[shape.indices[3 * triangle + 1]].position;
+            auto const& c = shape.vertices[shape.indices[3 * triangle + 2]].position;
+
+            // Twice the area, which weighs the normal by it.
+            return glm::cross(b - a, c - a);
+        }
+
+        glm::vec3 triangle_centroid(Shape const& shape, std::size_t triangle)
+        {
+            auto const& a = shape.vertices[shape.indices[3 * triangle + 0]].position;
+            auto const& b = shape.vertices[shape.indices[3 * triangle + 1]].position;
+            auto const& c = shape.vertices[shape.indices[3 * triangle + 2]].position;
+            return (a + b + c) / 3.0f;
+        }
+    } // namespace
+
+    VertexCacheStatistics analyse_vertex_cache(std::vector<std::size_t> const& indices,
+                                               std::size_t vertex_count,
+                                               std::size_t cache_size)
+    {
+        VertexCacheStatistics statistics;
+        VertexCache cache{vertex_count, cache_size};
+        for (auto index : indices)
+        {
+            statistics.vertices_transformed += cache.access(index) ? 1 : 0;
+        }
+
+        auto transformed = static_cast<float>(statistics.vertices_transformed);
+        if (!indices.empty())
+        {
+            statistics.acmr = transformed / static_cast<float>(indices.size() / 3);
+        }
+
+        if (vertex_count != 0)
+        {
+            statistics.atvr = transformed / static_cast<float>(vertex_count);
+        }
+
+        return statistics;
+    }
+
+    void optimise_vertex_cache(Shape& shape, std::size_t cache_size)
+    {
+        auto const& indices     = shape.indices;
+        auto const vertex_count = shape.vertices.size();
+        auto const face_count   = indices.size() / 3;
+        if (face_count == 0)
+        {
+            return;
+        }
+
+        // Triangles that use each vertex.
+        detail::Adjacency adjacency{indices, vertex_count, 3};
+
+        // Number of triangles left to emit that use each vertex.
+        std::vector<std::size_t> live(vertex_count);
+        for (std::size_t v{0}; v < vertex_count; ++v)
+        {
+            live[v] = adjacency.count(v);
+        }
+
+        std::vector<std::size_t> cache_time(vertex_count, 0);
+        std::vector<bool> emitted(face_count, false);
+        std::vector<std::size_t> dead_end;
+        std::vector<std::size_t> candidates;
+        std::vector<std::size_t> order;
+        order.reserve(face_count);
+
+        auto time   = cache_size + 1;
+        auto cursor = std::size_t{0};
+
+        auto in_cache = [&](std::size_t v) {
+            return time - cache_time[v] <= cache_size;
+        };
+
+        // When the neighbourhood of the fanning vertex is exhausted, go back
+        // to a recently used vertex, or failing that, the next vertex in
+        // input order that still has triangles.
+        auto skip_dead_end = [&]() {
+            while (!dead_end.empty())
+            {
+                auto v = dead_end.back();
+                dead_end.pop_back();
+                if (live[v] > 0)
+                {
+                    return v;
+                }
+            }
+
+            while (cursor < vertex_count)
+            {
+                if (live[cursor++] > 0)
+                {
+                    return cursor - 1;
+                }
+            }
+
+            return no_vertex;
+        };
+
+        // Pick the candidate that will still be in the cache once its
+        // remaining triangles are emitted, preferring the oldest one.
+        auto next_vertex = [&]() {
+            auto best     = no_vertex;
+            auto priority = std::size_t{0};
+            for (auto v : candidates)
+            {
+                if (live[v] == 0)
+                {
+                    continue;
+                }
+
+                auto age = time - cache_time[v];
+                auto p   = (age + 2 * live[v] <= cache_size) ? age + 1 : 1;
+                if (p > priority)
+                {
+                    best     = v;
+                    priority = p;
+                }
+            }
+
+            return (best == no_vertex) ? skip_dead_end() : best;
+        };
+
+        auto fanning = skip_dead_end();
+        while (fanning != no_vertex)
+        {
+            candidates.clear();
+            for (auto t = adjacency.begin(fanning); t < adjacency.end(fanning); ++t)
+            {
+                auto triangle = adjacency.items[t];
+                if (emitted[triangle])
+                {
+                    continue;
+                }
+
+                for (std::size_t k{0}; k < 3; ++k)
+                {
+                    auto v = indices[3 * triangle + k];
+                    dead_end.push_back(v);
+                    candidates.push_back(v);
+                    --live[v];
+                    if (!in_cache(v))
+                    {
+                        cache_time[v] = time++;
+                    }
+                }
+
+                emitted[triangle] = true;
+                order.push_back(triangle);
+            }
+
+            fanning = next_vertex();
+        }
+
+        reorder_triangles(shape, order);
+    }
+
+    void optimise_overdraw(Shape& shape, float threshold, std::size_t cache_size)
+    {
+        auto const face_count = shape.indices.size() / 3;
+        if (face_count == 0)
+        {
+            return;
+        }
+
+        // Hard boundaries are the triangles that miss the cache on all three
+        // vertices, so whatever came before them does not matter to the
+        // cache.
+        std::vector<std::size_t> hard{0};
+        {
+            VertexCache cache{shape.vertices.size(), cache_size};
+            for (std::size_t t{0}; t < face_count; ++t)
+            {
+                std::size_t misses{0};
+                for (std::size_t k{0}; k < 3; ++k)
+                {
+                    misses += cache.access(shape.indices[3 * t + k]) ? 1 : 0;
+                }
+
+                if (misses == 3 && t != 0)
+                {
+                    hard.push_back(t);
+                }
+            }
+        }
+        hard.push_back(face_count);
+
+        // Split each hard cluster further wherever the part before the split
+        // already does as well as threshold times the whole cluster, since
+        // the cache starts out empty for every cluster once they are sorted.
+        std::vector<std::size_t> clusters;
+        VertexCache cache{shape.vertices.size(), cache_size};
+        for (std::size_t c{0}; c + 1 < hard.size(); ++c)
+        {
+            auto first = hard[c];
+            auto last  = hard[c + 1];
+
+            cache.flush();
+            std::size_t misses{0};
+            for (auto t = first; t < last; ++t)
+            {
+                for (std::size_t k{0}; k < 3; ++k)
+                {
+                    misses += cache.access(shape.indices[3 * t + k]) ? 1 : 0;
+                }
+            }
+            auto acmr = static_cast<float>(misses) / static_cast<float>(last - first);
+
+            cache.flush();
+            clusters.push_back(first);
+            misses = 0;
+            for (auto t = first; t < last; ++t)
+            {
+                for (std::size_t k{0}; k < 3; ++k)
+                {
+                    misses += cache.access(shape.indices[3 * t + k]) ? 1 : 0;
+                }
+
+                auto triangles = t + 1 - clusters.back();
+                if (t + 1 < last &&
+                    static_cast<float>(misses) <=
+                        threshold * acmr * static_cast<float>(triangles))
+                {
+                    clusters.push_back(t + 1);
+                    cache.flush();
+                    misses = 0;
+                }
+            }
+        }
+        clusters.push_back(face_count);
+
+        // Sort the clusters by how far their average normal points away
+        // from the centre of the shape.
+        glm::vec3 centre{0.0f};
+        float total_area{0.0f};
+        for (std::size_t t{0}; t < face_count; ++t)
+        {
+            auto area = glm::length(triangle_normal(shape, t));
+            centre += triangle_centroid(shape, t) * area;
+            total_area += area;
+        }
+        centre /= (total_area > 0.0f) ? total_area : 1.0f;
+
+        auto const cluster_count = clusters.size() - 1;
+        std::vector<float> sort_keys(cluster_count);
+        for (std::size_t c{0}; c < cluster_count; ++c)
+        {
+            glm::vec3 normal{0.0f};
+            glm::vec3 centroid{0.0f};
+            float area{0.0f};
+            for (auto t = clusters[c]; t < clusters[c + 1]; ++t)
+            {
+                auto n  = triangle_normal(shape, t);
+                auto a  = glm::length(n);
+                normal += n;
+                centroid += triangle_centroid(shape, t) * a;
+                area += a;
+            }
+
+            if (area == 0.0f || glm::length(normal) == 0.0f)
+            {
+                continue;
+            }
+
+            centroid /= area;
+            sort_keys[c] = glm::dot(centroid - centre, glm::normalize(normal));
+        }
+
+        std::vector<std::size_t> cluster_order(cluster_count);
+        std::iota(cluster_order.begin(), cluster_order.end(), std::size_t{0});
+        std::stable_sort(cluster_order.begin(),
+                         cluster_order.end(),
+                         [&](std::size_t a, std::size_t b) {
+                             return sort_keys[a] > sort_keys[b];
+                         });
+
+        std::vector<std::size_t> order;
+        order.reserve(face_count);
+        for (auto c : cluster_order)
+        {
+            for (auto t = clusters[c]; t < clusters[c + 1]; ++t)
+            {
+                order.push_back(t);
+            }
+        }
+
+        reorder_triangles(shape, order);
+    }
+
+    void optimise_vertex_fetch(Shape& shape)
+    {
+        auto const vertex_count = shape.vertices.size();
+        std::vector<std::size_t> remap(vertex_count, no_vertex);
+        std::vector<Vertex> vertices;
+        vertices.reserve(vertex_count);
+
+        auto add = [&](std::size_t v) {
+            remap[v] = vertices.size();
+            vertices.push_back(shape.vertices[v]);
+            vertices.back().index = remap[v];
+        };
+
+        for (auto& index : shape.indices)
+        {
+            if (remap[index] == no_vertex)
+            {
+                add(index);
+            }
+            index = remap[index];
+        }
+
+        for (std::size_t v{0}; v < vertex_count; ++v)
+        {
+            if (remap[v] == no_vertex)
+            {
+                add(v);
+            }
+        }
+
+        shape.vertices = std::move(vertices);
+    }
+
+    MeshOptimisationReport optimise_mesh(Shape& shape,
+                                         MeshOptimisationSettings const& settings)
+    {
+        auto const cache_size = settings.cache_size;
+
+        MeshOptimisationReport report;
+        report.before =
+            analyse_vertex_cache(shape.indices, shape.vertices.size(), cache_size);
+
+        optimise_vertex_cache(shape, cache_size);
+        if (settings.overdraw_threshold > 0.0f)
+        {
+            optimise_overdraw(shape, settings.overdraw_threshold, cache_size);
+        }
+        optimise_vertex_fetch(shape);
+
+        report.after =
+            analyse_vertex_cache(shape.indices, shape.vertices.size(), cache_size);
+        return report;
+    }
+} // namespace atlas::utils
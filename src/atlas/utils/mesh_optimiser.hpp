@@ -0,0 +1,81 @@
+#pragma once
+
+#include "load_obj_file.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace atlas::utils
+{
+    // Number of entries of the post-transform cache the optimisations aim
+    // for. Recent GPUs do not have a fixed size FIFO cache any more, but
+    // index orders that do well on a FIFO of this size do well on them too.
+    constexpr std::size_t default_vertex_cache_size{16};
+
+    struct VertexCacheStatistics
+    {
+        std::size_t vertices_transformed{0};
+
+        // Average cache miss ratio: vertices transformed per triangle. This
+        // is between 0.5 and 3 for most meshes, and lower is better.
+        float acmr{0.0f};
+
+        // Average transform to vertex ratio: vertices transformed per vertex
+        // in the shape. The best possible value is 1.
+        float atvr{0.0f};
+    };
+
+    struct MeshOptimisationSettings
+    {
+        std::size_t cache_size{default_vertex_cache_size};
+
+        // How much the cache miss ratio may grow to let optimise_overdraw
+        // reorder smaller clusters. Set to 0 to skip overdraw reordering.
+        float overdraw_threshold{1.05f};
+    };
+
+    struct MeshOptimisationReport
+    {
+        VertexCacheStatistics before;
+        VertexCacheStatistics after;
+    };
+
+    // Simulates drawing the indices with a FIFO post-transform cache of the
+    // given size.
+    VertexCacheStatistics
+    analyse_vertex_cache(std::vector<std::size_t> const& indices,
+                         std::size_t vertex_count,
+                         std::size_t cache_size = default_vertex_cache_size);
+
+    // The passes below reorder the triangles or vertices of a shape in place.
+    // Material and smoothing group ids are moved along with their triangles,
+    // and the face and vertex ids stored in the vertices are updated to
+    // match.
+
+    // Reorders triangles for the post-transform cache using Tipsify, from
+    // "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"
+    // (Sander et al., 2007). Runs in linear time.
+    void optimise_vertex_cache(Shape& shape,
+                               std::size_t cache_size = default_vertex_cache_size);
+
+    // Splits the triangles into clusters that are drawn in the same order as
+    // before and sorts the clusters so the ones facing away from the centre
+    // of the shape are drawn first, which lets early depth testing reject
+    // more of the rest. Clusters are split at points where the cache is
+    // flushed anyway, and further wherever that keeps the cache miss ratio of
+    // the cluster within threshold times its original value, so this should
+    // run after optimise_vertex_cache.
+    void optimise_overdraw(Shape& shape,
+                           float threshold = 1.05f,
+                           std::size_t cache_size = default_vertex_cache_size);
+
+    // Sorts the vertices in the order the indices first use them, so vertex
+    // fetches walk through memory in order. Vertices no index refers to are
+    // moved to the end.
+    void optimise_vertex_fetch(Shape& shape);
+
+    // Runs all three passes in order and reports the cache statistics before
+    // and after.
+    MeshOptimisationReport optimise_mesh(Shape& shape,
+                                         MeshOptimisationSettings const& settings = {});
+} // namespace atlas::utils
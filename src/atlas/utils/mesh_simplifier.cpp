@@ -0,0 +1,769 @@
+#include "mesh_simplifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <tuple>
+#include <utility>
+
+namespace atlas::utils
+{
+    namespace
+    {
+        constexpr auto no_index = std::numeric_limits<std::size_t>::max();
+
+        // Weight of the planes that keep unlocked borders in place, relative
+        // to the squared length of the border edge.
+        constexpr double border_weight{10.0};
+
+        // Weighted sum of squared distances to a set of planes, stored as
+        // the upper triangle of the symmetric 4x4 matrix.
+        struct Quadric
+        {
+            void add_plane(glm::dvec3 const& n, double d, double weight)
+            {
+                a00 += weight * n.x * n.x;
+                a01 += weight * n.x * n.y;
+                a02 += weight * n.x * n.z;
+                a11 += weight * n.y * n.y;
+                a12 += weight * n.y * n.z;
+                a22 += weight * n.z * n.z;
+                b0 += weight * n.x * d;
+                b1 += weight * n.y * d;
+                b2 += weight * n.z * d;
+                c += weight * d * d;
+                w += weight;
+            }
+
+            Quadric& operator+=(Quadric const& q)
+            {
+                a00 += q.a00;
+                a01 += q.a01;
+                a02 += q.a02;
+                a11 += q.a11;
+                a12 += q.a12;
+                a22 += q.a22;
+                b0 += q.b0;
+                b1 += q.b1;
+                b2 += q.b2;
+                c += q.c;
+                w += q.w;
+                return *this;
+            }
+
+            // Weighted mean of the squared distances from p to the planes.
+            double error(glm::dvec3 const& p) const
+            {
+                if (w <= 0.0)
+                {
+                    return 0.0;
+                }
+
+                auto e = a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z +
+                         2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z) +
+                         2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+                return std::max(e / w, 0.0);
+            }
+
+            double a00{0.0}, a01{0.0}, a02{0.0}, a11{0.0}, a12{0.0}, a22{0.0};
+            double b0{0.0}, b1{0.0}, b2{0.0};
+            double c{0.0};
+            double w{0.0};
+        };
+
+        struct Collapse
+        {
+            double cost;
+            double error;
+            std::size_t from;
+            std::size_t to;
+
+            // Makes std::priority_queue pop the cheapest collapse first.
+            bool operator<(Collapse const& rhs) const
+            {
+                return cost > rhs.cost;
+            }
+        };
+
+        // Vertices with the same position form a group, and the vertices of
+        // a group are its wedges. Collapses work on groups, and the wedges of
+        // the group that goes away are mapped onto the wedges of the one
+        // that stays.
+        class Simplifier
+        {
+        public:
+            Simplifier(Shape& shape, SimplifySettings const& settings) :
+                m_shape{shape},
+                m_settings{settings},
+                m_removed(shape.indices.size() / 3, false),
+                m_alive{shape.indices.size() / 3}
+            {
+                make_groups();
+                make_quadrics();
+            }
+
+            // Returns the largest squared error of the collapses made.
+            double run(std::size_t target)
+            {
+                for (std::size_t g{0}; g < m_wedges.size(); ++g)
+                {
+                    neighbours(g, m_around);
+                    for (auto n : m_around)
+                    {
+                        if (n > g)
+                        {
+                            push_edge(g, n);
+                        }
+                    }
+                }
+
+                auto const max_error = static_cast<double>(m_settings.max_error);
+                double result{0.0};
+                while (m_alive > target && !m_queue.empty())
+                {
+                    auto top = m_queue.top();
+                    m_queue.pop();
+                    if (m_collapsed[top.from] || m_collapsed[top.to])
+                    {
+                        continue;
+                    }
+
+                    // Collapses around the edge may have changed its cost
+                    // since it was queued, or made this way of collapsing it
+                    // impossible while the other one may still work.
+                    Collapse collapse;
+                    if (!evaluate(top.from, top.to, collapse))
+                    {
+                        if (evaluate(top.to, top.from, collapse))
+                        {
+                            m_queue.push(collapse);
+                        }
+                        continue;
+                    }
+
+                    if (collapse.cost > top.cost * (1.0 + 1e-6) + 1e-30)
+                    {
+                        m_queue.push(collapse);
+                        continue;
+                    }
+
+                    if (std::sqrt(collapse.error) > max_error)
+                    {
+                        continue;
+                    }
+
+                    apply(collapse);
+                    result = std::max(result, collapse.error);
+                    push_edges(collapse.to);
+                }
+
+                compact();
+                return result;
+            }
+
+        private:
+            glm::dvec3 const& position(std::size_t group) const
+            {
+                return m_positions[group];
+            }
+
+            std::size_t corner_group(std::size_t triangle, std::size_t k) const
+            {
+                return m_group[m_shape.indices[3 * triangle + k]];
+            }
+
+            glm::dvec3 triangle_normal(std::size_t triangle) const
+            {
+                auto a = position(corner_group(triangle, 0));
+                auto b = position(corner_group(triangle, 1));
+                auto c = position(corner_group(triangle, 2));
+                return glm::cross(b - a, c - a);
+            }
+
+            void make_groups()
+            {
+                auto const& vertices = m_shape.vertices;
+                std::vector<std::size_t> order(vertices.size());
+                std::iota(order.begin(), order.end(), std::size_t{0});
+
+                auto less = [&](std::size_t a, std::size_t b) {
+                    auto const& p = vertices[a].position;
+                    auto const& q = vertices[b].position;
+                    return std::tie(p.x, p.y, p.z) < std::tie(q.x, q.y, q.z);
+                };
+                std::sort(order.begin(), order.end(), less);
+
+                m_group.resize(vertices.size());
+                for (std::size_t i{0}; i < order.size(); ++i)
+                {
+                    if (i == 0 ||
+                        vertices[order[i]].position != vertices[order[i - 1]].position)
+                    {
+                        m_wedges.emplace_back();
+                        m_positions.emplace_back(vertices[order[i]].position);
+                    }
+
+                    m_group[order[i]] = m_wedges.size() - 1;
+                    m_wedges.back().push_back(order[i]);
+                }
+
+                m_triangles.resize(m_wedges.size());
+                m_collapsed.resize(m_wedges.size(), false);
+                m_locked.resize(m_wedges.size(), false);
+
+                auto const& material_ids = m_shape.material_ids;
+                auto const has_materials = material_ids.size() == m_removed.size();
+                std::vector<std::size_t> first(m_wedges.size(), no_index);
+
+                for (std::size_t t{0}; t < m_removed.size(); ++t)
+                {
+                    auto a = corner_group(t, 0);
+                    auto b = corner_group(t, 1);
+                    auto c = corner_group(t, 2);
+                    if (a == b || b == c || a == c)
+                    {
+                        m_removed[t] = true;
+                        --m_alive;
+                        continue;
+                    }
+
+                    for (auto g : {a, b, c})
+                    {
+                        m_triangles[g].push_back(t);
+                        if (!has_materials)
+                        {
+                            continue;
+                        }
+
+                        if (first[g] == no_index)
+                        {
+                            first[g] = t;
+                        }
+                        else if (material_ids[first[g]] != material_ids[t])
+                        {
+                            m_locked[g] = true;
+                        }
+                    }
+                }
+            }
+
+            void make_quadrics()
+            {
+                m_quadrics.resize(m_wedges.size());
+
+                // Edges between groups, with the triangle they came from,
+                // sorted so the copies of each edge are next to each other.
+                struct Edge
+                {
+                    std::size_t a;
+                    std::size_t b;
+                    std::size_t triangle;
+                };
+                std::vector<Edge> edges;
+                edges.reserve(3 * m_alive);
+
+                glm::dvec3 min{std::numeric_limits<double>::max()};
+                glm::dvec3 max{std::numeric_limits<double>::lowest()};
+                for (std::size_t t{0}; t < m_removed.size(); ++t)
+                {
+                    if (m_removed[t])
+                    {
+                        continue;
+                    }
+
+                    auto n    = triangle_normal(t);
+                    auto area = glm::length(n);
+                    for (std::size_t k{0}; k < 3; ++k)
+                    {
+                        auto a = corner_group(t, k);
+                        auto b = corner_group(t, (k + 1) % 3);
+                        edges.push_back({std::min(a, b), std::max(a, b), t});
+
+                        min = glm::min(min, position(a));
+                        max = glm::max(max, position(a));
+                    }
+
+                    if (area == 0.0)
+                    {
+                        continue;
+                    }
+
+                    n /= area;
+                    auto d = -glm::dot(n, position(corner_group(t, 0)));
+                    for (std::size_t k{0}; k < 3; ++k)
+                    {
+                        m_quadrics[corner_group(t, k)].add_plane(n, d, 0.5 * area);
+                    }
+                }
+
+                if (!edges.empty())
+                {
+                    m_attribute_scale = glm::length2(max - min);
+                }
+
+                auto less = [](Edge const& lhs, Edge const& rhs) {
+                    return std::tie(lhs.a, lhs.b) < std::tie(rhs.a, rhs.b);
+                };
+                std::sort(edges.begin(), edges.end(), less);
+
+                for (std::size_t i{0}; i < edges.size();)
+                {
+                    auto j = i + 1;
+                    while (j < edges.size() && edges[j].a == edges[i].a &&
+                           edges[j].b == edges[i].b)
+                    {
+                        ++j;
+                    }
+
+                    auto const& edge = edges[i];
+                    if (j - i > 2)
+                    {
+                        m_locked[edge.a] = true;
+                        m_locked[edge.b] = true;
+                    }
+                    else if (j - i == 1 && m_settings.lock_borders)
+                    {
+                        m_locked[edge.a] = true;
+                        m_locked[edge.b] = true;
+                    }
+                    else if (j - i == 1)
+                    {
+                        // A plane through the edge, perpendicular to the
+                        // triangle, keeps the border from moving sideways.
+                        auto p = position(edge.a);
+                        auto e = position(edge.b) - p;
+                        auto n = glm::cross(e, triangle_normal(edge.triangle));
+                        if (glm::length(n) > 0.0)
+                        {
+                            n      = glm::normalize(n);
+                            auto d = -glm::dot(n, p);
+                            auto w = border_weight * glm::length2(e);
+                            m_quadrics[edge.a].add_plane(n, d, w);
+                            m_quadrics[edge.b].add_plane(n, d, w);
+                        }
+                    }
+
+                    i = j;
+                }
+            }
+
+            std::vector<std::size_t> const& triangles(std::size_t group)
+            {
+                auto& list = m_triangles[group];
+                std::erase_if(list, [this](std::size_t t) { return m_removed[t]; });
+                return list;
+            }
+
+            void neighbours(std::size_t group, std::vector<std::size_t>& out)
+            {
+                out.clear();
+                for (auto t : triangles(group))
+                {
+                    for (std::size_t k{0}; k < 3; ++k)
+                    {
+                        if (auto g = corner_group(t, k); g != group)
+                        {
+                            out.push_back(g);
+                        }
+                    }
+                }
+
+                std::sort(out.begin(), out.end());
+                out.erase(std::unique(out.begin(), out.end()), out.end());
+            }
+
+            std::size_t wedge_in(std::size_t triangle, std::size_t group) const
+            {
+                for (std::size_t k{0}; k < 3; ++k)
+                {
+                    if (corner_group(triangle, k) == group)
+                    {
+                        return m_shape.indices[3 * triangle + k];
+                    }
+                }
+                return no_index;
+            }
+
+            std::size_t mapped_wedge(std::size_t wedge) const
+            {
+                for (auto const& [from, to] : m_wedge_map)
+                {
+                    if (from == wedge)
+                    {
+                        return to;
+                    }
+                }
+                return no_index;
+            }
+
+            double attribute_distance(std::size_t a, std::size_t b) const
+            {
+                auto const& p = m_shape.vertices[a];
+                auto const& q = m_shape.vertices[b];
+
+                double distance{0.0};
+                if (m_shape.has_normals)
+                {
+                    distance += glm::length2(glm::dvec3{p.normal - q.normal});
+                }
+
+                if (m_shape.has_texture_coords)
+                {
+                    distance += glm::length2(glm::dvec2{p.tex_coord - q.tex_coord});
+                }
+                return distance;
+            }
+
+            // Checks whether moving group u onto group v keeps the surface
+            // valid and fills in the wedge map and the cost if it does.
+            bool evaluate(std::size_t u, std::size_t v, Collapse& collapse)
+            {
+                if (m_locked[u])
+                {
+                    return false;
+                }
+
+                // Every wedge of u must share a triangle with exactly one
+                // wedge of v, which is the one it becomes.
+                m_wedge_map.clear();
+                m_opposite.clear();
+                for (auto t : triangles(u))
+                {
+                    auto wv = wedge_in(t, v);
+                    if (wv == no_index)
+                    {
+                        continue;
+                    }
+
+                    auto wu     = wedge_in(t, u);
+                    auto mapped = mapped_wedge(wu);
+                    if (mapped != no_index && mapped != wv)
+                    {
+                        return false;
+                    }
+                    else if (mapped == no_index)
+                    {
+                        m_wedge_map.emplace_back(wu, wv);
+                    }
+
+                    for (std::size_t k{0}; k < 3; ++k)
+                    {
+                        if (auto g = corner_group(t, k); g != u && g != v)
+                        {
+                            m_opposite.push_back(g);
+                        }
+                    }
+                }
+
+                if (m_wedge_map.empty())
+                {
+                    return false;
+                }
+
+                auto const pv = position(v);
+                double attribute_error{0.0};
+                double area{0.0};
+                for (auto t : triangles(u))
+                {
+                    auto wu = wedge_in(t, u);
+                    if (wedge_in(t, v) != no_index)
+                    {
+                        continue;
+                    }
+
+                    auto wv = mapped_wedge(wu);
+                    if (wv == no_index)
+                    {
+                        return false;
+                    }
+
+                    // The triangle must not flip over.
+                    glm::dvec3 p[3];
+                    for (std::size_t k{0}; k < 3; ++k)
+                    {
+                        auto g = corner_group(t, k);
+                        p[k]   = (g == u) ? pv : position(g);
+                    }
+
+                    auto before = triangle_normal(t);
+                    auto after  = glm::cross(p[1] - p[0], p[2] - p[0]);
+                    if (glm::dot(before, after) <= 0.0)
+                    {
+                        return false;
+                    }
+
+                    auto a = glm::length(before);
+                    attribute_error += a * attribute_distance(wu, wv);
+                    area += a;
+                }
+
+                if (area > 0.0)
+                {
+                    attribute_error /= area;
+                }
+
+                // Link condition: u and v may only share the neighbours on
+                // the other side of the triangles that are removed, or the
+                // collapse would pinch the surface.
+                neighbours(u, m_neighbours_u);
+                neighbours(v, m_neighbours_v);
+                std::sort(m_opposite.begin(), m_opposite.end());
+                m_opposite.erase(std::unique(m_opposite.begin(), m_opposite.end()),
+                                 m_opposite.end());
+
+                std::size_t shared{0};
+                for (auto g : m_neighbours_u)
+                {
+                    shared += std::binary_search(
+                                  m_neighbours_v.begin(), m_neighbours_v.end(), g)
+                                  ? 1
+                                  : 0;
+                }
+
+                if (shared != m_opposite.size())
+                {
+                    return false;
+                }
+
+                auto quadric = m_quadrics[u];
+                quadric += m_quadrics[v];
+
+                collapse.from  = u;
+                collapse.to    = v;
+                collapse.error = quadric.error(pv);
+                collapse.cost  = collapse.error +
+                                static_cast<double>(m_settings.attribute_weight) *
+                                    m_attribute_scale * attribute_error;
+                return true;
+            }
+
+            // Expects evaluate to have just filled in the wedge map.
+            void apply(Collapse const& collapse)
+            {
+                auto u = collapse.from;
+                auto v = collapse.to;
+                for (auto t : triangles(u))
+                {
+                    if (wedge_in(t, v) != no_index)
+                    {
+                        m_removed[t] = true;
+                        --m_alive;
+                        continue;
+                    }
+
+                    for (std::size_t k{0}; k < 3; ++k)
+                    {
+                        auto& index = m_shape.indices[3 * t + k];
+                        if (m_group[index] == u)
+                        {
+                            index = mapped_wedge(index);
+                        }
+                    }
+                    m_triangles[v].push_back(t);
+                }
+
+                m_quadrics[v] += m_quadrics[u];
+                m_triangles[u].clear();
+                m_collapsed[u] = true;
+            }
+
+            // Queues the cheaper of the two ways of collapsing the edge.
+            void push_edge(std::size_t a, std::size_t b)
+            {
+                Collapse forward;
+                Collapse backward;
+                auto has_forward  = evaluate(a, b, forward);
+                auto has_backward = evaluate(b, a, backward);
+                if (has_forward && (!has_backward || forward.cost <= backward.cost))
+                {
+                    m_queue.push(forward);
+                }
+                else if (has_backward)
+                {
+                    m_queue.push(backward);
+                }
+            }
+
+            void push_edges(std::size_t group)
+            {
+                neighbours(group, m_around);
+                for (auto g : m_around)
+                {
+                    push_edge(group, g);
+                }
+            }
+
+            // Drops the removed triangles and the vertices no longer used.
+            void compact()
+            {
+                auto& shape              = m_shape;
+                auto const has_materials = shape.material_ids.size() == m_removed.size();
+
+                auto const has_smoothing_groups =
+                    shape.smoothing_group_ids.size() == m_removed.size();
+
+                std::vector<std::size_t> remap(shape.vertices.size(), no_index);
+                std::vector<std::size_t> indices;
+                std::vector<int> material_ids;
+                std::vector<unsigned int> smoothing_group_ids;
+                indices.reserve(3 * m_alive);
+
+                for (std::size_t t{0}; t < m_removed.size(); ++t)
+                {
+                    if (m_removed[t])
+                    {
+                        continue;
+                    }
+
+                    auto face = indices.size() / 3;
+                    for (std::size_t k{0}; k < 3; ++k)
+                    {
+                        auto index = shape.indices[3 * t + k];
+                        if (remap[index] == no_index)
+                        {
+                            remap[index]                 = face;
+                            shape.vertices[index].face_id = face;
+                        }
+                        indices.push_back(index);
+                    }
+
+                    if (has_materials)
+                    {
+                        material_ids.push_back(shape.material_ids[t]);
+                    }
+
+                    if (has_smoothing_groups)
+                    {
+                        smoothing_group_ids.push_back(shape.smoothing_group_ids[t]);
+                    }
+                }
+
+                // Keep the vertices in their original order.
+                std::vector<Vertex> vertices;
+                for (std::size_t i{0}; i < shape.vertices.size(); ++i)
+                {
+                    if (remap[i] != no_index)
+                    {
+                        remap[i] = vertices.size();
+                        vertices.push_back(shape.vertices[i]);
+                        vertices.back().index = remap[i];
+                    }
+                }
+
+                for (auto& index : indices)
+                {
+                    index = remap[index];
+                }
+
+                shape.vertices = std::move(vertices);
+                shape.indices  = std::move(indices);
+                if (has_materials)
+                {
+                    shape.material_ids = std::move(material_ids);
+                }
+
+                if (has_smoothing_groups)
+                {
+                    shape.smoothing_group_ids = std::move(smoothing_group_ids);
+                }
+            }
+
+            Shape& m_shape;
+            SimplifySettings m_settings;
+
+            std::vector<std::size_t> m_group;
+            std::vector<std::vector<std::size_t>> m_wedges;
+            std::vector<glm::dvec3> m_positions;
+            std::vector<std::vector<std::size_t>> m_triangles;
+            std::vector<Quadric> m_quadrics;
+            std::vector<bool> m_locked;
+            std::vector<bool> m_collapsed;
+            std::vector<bool> m_removed;
+            std::size_t m_alive;
+            double m_attribute_scale{0.0};
+
+            std::priority_queue<Collapse> m_queue;
+
+            // Scratch space.
+            std::vector<std::pair<std::size_t, std::size_t>> m_wedge_map;
+            std::vector<std::size_t> m_opposite;
+            std::vector<std::size_t> m_neighbours_u;
+            std::vector<std::size_t> m_neighbours_v;
+            std::vector<std::size_t> m_around;
+        };
+    } // namespace
+
+    float
+    simplify_shape(Shape& shape, float target_ratio, SimplifySettings const& settings)
+    {
+        auto const triangle_count = shape.indices.size() / 3;
+        auto const target =
+            static_cast<std::size_t>(static_cast<double>(target_ratio) * triangle_count);
+        if (target >= triangle_count)
+        {
+            return 0.0f;
+        }
+
+        Simplifier simplifier{shape, settings};
+        return static_cast<float>(std::sqrt(simplifier.run(target)));
+    }
+
+    std::vector<Lod> generate_lods(Shape const& shape,
+                                   std::vector<float> const& ratios,
+                                   SimplifySettings const& settings)
+    {
+        auto const triangle_count = static_cast<float>(shape.indices.size() / 3);
+
+        std::vector<Lod> lods;
+        lods.reserve(ratios.size() + 1);
+        lods.push_back({shape, 1.0f, 0.0f});
+        for (auto ratio : ratios)
+        {
+            auto const& previous = lods.back();
+            auto current         = static_cast<float>(previous.shape.indices.size() / 3);
+
+            Lod lod{previous.shape, ratio, previous.error};
+            if (current > 0.0f)
+            {
+                auto relative = ratio * triangle_count / current;
+                lod.error += simplify_shape(lod.shape, relative, settings);
+                auto simplified = static_cast<float>(lod.shape.indices.size() / 3);
+                lod.ratio       = simplified / triangle_count;
+            }
+
+            lods.push_back(std::move(lod));
+        }
+
+        return lods;
+    }
+
+    std::vector<std::vector<Lod>> generate_lods(ObjMesh const& mesh,
+                                                std::vector<float> const& ratios,
+                                                jobs::JobSystem& system,
+                                                SimplifySettings const& settings)
+    {
+        std::vector<std::vector<Lod>> lods(mesh.shapes.size());
+        system.parallel_for(lods.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i)
+            {
+                lods[i] = generate_lods(mesh.shapes[i], ratios, settings);
+            }
+        });
+
+        return lods;
+    }
+
+    std::size_t select_lod(std::vector<Lod> const& lods, float distance, float threshold)
+    {
+        for (auto i = lods.size(); i > 1; --i)
+        {
+            if (lods[i - 1].error <= threshold * distance)
+            {
+                return i - 1;
+            }
+        }
+
+        return 0;
+    }
+} // namespace atlas::utils
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "load_obj_file.hpp"
+
+#include <atlas/jobs/job_system.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace atlas::utils
+{
+    struct SimplifySettings
+    {
+        // Simplification stops before the geometric error (see
+        // simplify_shape) goes over this, even if the target was not met.
+        float max_error{std::numeric_limits<float>::max()};
+
+        // Weight of the change in normals and texture coordinates against the
+        // change in position. Attribute errors are scaled by the size of the
+        // shape, so the weight does not depend on its units.
+        float attribute_weight{1.0f};
+
+        // Keep the vertices on open edges where they are. Otherwise they are
+        // only kept close to the border. Vertices shared by triangles with
+        // different materials, or on edges with more than two triangles, are
+        // always kept.
+        bool lock_borders{true};
+    };
+
+    // Simplifies the shape in place until it has at most target_ratio times
+    // its triangles, by collapsing edges in order of their quadric error
+    // ("Surface Simplification Using Quadric Error Metrics", Garland and
+    // Heckbert, 1997). Collapses move one vertex onto the other, so no new
+    // vertices are made. Vertices with the same position but different
+    // normals or texture coordinates (seams) only collapse along the seam.
+    //
+    // Returns the geometric error, in the units of the shape: the largest
+    // root mean square distance, over the collapses made, from a moved vertex
+    // to the original triangles around it, weighted by their area. This is an
+    // average rather than a bound, so parts of the simplified surface can be
+    // further than this from the original.
+    float simplify_shape(Shape& shape,
+                         float target_ratio,
+                         SimplifySettings const& settings = {});
+
+    struct Lod
+    {
+        Shape shape;
+        float ratio{1.0f};
+        float error{0.0f};
+    };
+
+    // Builds a chain of levels of detail with the given triangle ratios,
+    // which should be decreasing. Level 0 is the shape itself, and every
+    // other level is simplified from the one before it, so their errors
+    // add up.
+    std::vector<Lod> generate_lods(Shape const& shape,
+                                   std::vector<float> const& ratios,
+                                   SimplifySettings const& settings = {});
+
+    // Same as above for every shape of a mesh, simplifying shapes in
+    // parallel on the job system.
+    std::vector<std::vector<Lod>> generate_lods(ObjMesh const& mesh,
+                                                std::vector<float> const& ratios,
+                                                jobs::JobSystem& system,
+                                                SimplifySettings const& settings = {});
+
+    // Returns the coarsest level whose error is at most threshold times the
+    // distance to the viewer. The threshold is the largest error allowed per
+    // unit of distance, which for a perspective camera is roughly the angle
+    // covered by a pixel in radians.
+    std::size_t select_lod(std::vector<Lod> const& lods, float distance, float threshold);
+} // namespace atlas::utils
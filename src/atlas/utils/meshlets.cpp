@@ -0,0 +1,330 @@
+#include "meshlets.hpp"
+#include "adjacency.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace atlas::utils
+{
+    namespace
+    {
+        constexpr auto no_local = std::numeric_limits<std::uint32_t>::max();
+
+        // Below this, the triangles of a meshlet spread over more than a
+        // hemisphere, more or less, and the cone would never cull anything.
+        constexpr float min_cone_dot{0.1f};
+
+        // Ritter's bounding sphere: a sphere through the two points that are
+        // far apart, grown to take in any point left outside.
+        glm::vec4 bounding_sphere(std::vector<glm::vec3> const& points)
+        {
+            auto farthest = [&points](glm::vec3 const& from) {
+                return *std::max_element(
+                    points.begin(), points.end(), [&from](auto const& a, auto const& b) {
+                        return glm::distance2(a, from) < glm::distance2(b, from);
+                    });
+            };
+
+            auto a      = farthest(points.front());
+            auto b      = farthest(a);
+            auto centre = (a + b) * 0.5f;
+            auto radius = glm::distance(a, b) * 0.5f;
+            for (auto const& p : points)
+            {
+                auto d = glm::distance(p, centre);
+                if (d > radius)
+                {
+                    auto grow = (d - radius) * 0.5f;
+                    centre += (p - centre) * (grow / d);
+                    radius += grow;
+                }
+            }
+
+            // Cover the rounding in the updates above.
+            return glm::vec4{centre, radius * (1.0f + 1e-5f)};
+        }
+    } // namespace
+
+    Meshlets build_meshlets(Shape const& shape, MeshletSettings const& settings)
+    {
+        auto const& indices     = shape.indices;
+        auto const& vertices    = shape.vertices;
+        auto const face_count   = indices.size() / 3;
+        auto const max_vertices = std::min<std::size_t>(settings.max_vertices, 256);
+        auto const cone_weight  = settings.cone_weight;
+
+        Meshlets meshlets;
+        if (face_count == 0 || max_vertices < 3 || settings.max_triangles == 0)
+        {
+            return meshlets;
+        }
+
+        // Triangles that use each vertex.
+        detail::Adjacency adjacency{indices, vertices.size(), 3};
+
+        std::vector<glm::vec3> normals(face_count);
+        for (std::size_t t{0}; t < face_count; ++t)
+        {
+            auto const& a = vertices[indices[3 * t + 0]].position;
+            auto const& b = vertices[indices[3 * t + 1]].position;
+            auto const& c = vertices[indices[3 * t + 2]].position;
+            auto n        = glm::cross(b - a, c - a);
+            auto length   = glm::length(n);
+            normals[t]    = (length > 0.0f) ? n / length : glm::vec3{0.0f};
+        }
+
+        std::vector<bool> used(face_count, false);
+        std::vector<std::uint32_t> local(vertices.size(), no_local);
+        std::vector<std::size_t> meshlet_vertices;
+        std::vector<std::size_t> meshlet_triangles;
+        std::vector<glm::vec3> points;
+        glm::vec3 normal_sum{0.0f};
+
+        auto extra_vertices = [&](std::size_t t) {
+            std::size_t extra{0};
+            for (std::size_t k{0}; k < 3; ++k)
+            {
+                extra += (local[indices[3 * t + k]] == no_local) ? 1 : 0;
+            }
+            return extra;
+        };
+
+        auto add_triangle = [&](std::size_t t) {
+            for (std::size_t k{0}; k < 3; ++k)
+            {
+                auto& slot = local[indices[3 * t + k]];
+                if (slot == no_local)
+                {
+                    slot = static_cast<std::uint32_t>(meshlet_vertices.size());
+                    meshlet_vertices.push_back(indices[3 * t + k]);
+                }
+            }
+
+            used[t] = true;
+            meshlet_triangles.push_back(t);
+            normal_sum += normals[t];
+        };
+
+        auto finish_meshlet = [&]() {
+            meshlets.vertex_offsets.push_back(
+                static_cast<std::uint32_t>(meshlets.vertices.size()));
+            meshlets.vertex_counts.push_back(
+                static_cast<std::uint32_t>(meshlet_vertices.size()));
+            meshlets.triangle_offsets.push_back(
+                static_cast<std::uint32_t>(meshlets.triangles.size()));
+            meshlets.triangle_counts.push_back(
+                static_cast<std::uint32_t>(meshlet_triangles.size()));
+
+            points.clear();
+            for (auto v : meshlet_vertices)
+            {
+                meshlets.vertices.push_back(static_cast<std::uint32_t>(v));
+                points.push_back(vertices[v].position);
+            }
+
+            for (auto t : meshlet_triangles)
+            {
+                for (std::size_t k{0}; k < 3; ++k)
+                {
+                    auto slot = local[indices[3 * t + k]];
+                    meshlets.triangles.push_back(static_cast<std::uint8_t>(slot));
+                }
+            }
+
+            // Keep every meshlet's triangles aligned to a uint.
+            meshlets.triangles.resize((meshlets.triangles.size() + 3) & ~std::size_t{3});
+
+            auto sphere = bounding_sphere(points);
+            meshlets.spheres.push_back(sphere);
+
+            // The axis is the average normal and the cone is as wide as the
+            // normal furthest from it.
+            glm::vec3 centre{sphere};
+            glm::vec3 axis{0.0f};
+            auto min_dot = -1.0f;
+            if (glm::length(normal_sum) > 0.0f)
+            {
+                axis    = glm::normalize(normal_sum);
+                min_dot = 1.0f;
+                for (auto t : meshlet_triangles)
+                {
+                    if (normals[t] != glm::vec3{0.0f})
+                    {
+                        min_dot = std::min(min_dot, glm::dot(normals[t], axis));
+                    }
+                }
+            }
+
+            if (min_dot <= min_cone_dot)
+            {
+                meshlets.cones.emplace_back(axis, 1.0f);
+                meshlets.cone_apexes.emplace_back(centre, 0.0f);
+            }
+            else
+            {
+                // Move the apex back along the axis until it is behind the
+                // plane of every triangle.
+                auto max_t = 0.0f;
+                for (auto t : meshlet_triangles)
+                {
+                    if (normals[t] == glm::vec3{0.0f})
+                    {
+                        continue;
+                    }
+
+                    auto const& corner = vertices[indices[3 * t]].position;
+                    auto dc            = glm::dot(centre - corner, normals[t]);
+                    auto dn            = glm::dot(axis, normals[t]);
+                    max_t              = std::max(max_t, dc / dn);
+                }
+
+                auto cutoff = glm::sqrt(1.0f - min_dot * min_dot);
+                meshlets.cones.emplace_back(axis, cutoff);
+                meshlets.cone_apexes.emplace_back(centre - axis * max_t, 0.0f);
+            }
+
+            for (auto v : meshlet_vertices)
+            {
+                local[v] = no_local;
+            }
+            meshlet_vertices.clear();
+            meshlet_triangles.clear();
+            normal_sum = glm::vec3{0.0f};
+        };
+
+        std::size_t cursor{0};
+        while (true)
+        {
+            while (cursor < face_count && used[cursor])
+            {
+                ++cursor;
+            }
+
+            if (cursor == face_count)
+            {
+                break;
+            }
+
+            add_triangle(cursor);
+            while (meshlet_triangles.size() < settings.max_triangles)
+            {
+                auto axis = (glm::length(normal_sum) > 0.0f) ? glm::normalize(normal_sum)
+                                                              : glm::vec3{0.0f};
+
+                // Look through the unused triangles around the meshlet for
+                // the one that adds the fewest vertices.
+                auto best       = face_count;
+                auto best_score = std::numeric_limits<float>::max();
+                for (auto v : meshlet_vertices)
+                {
+                    for (auto i = adjacency.begin(v); i < adjacency.end(v); ++i)
+                    {
+                        auto t = adjacency.items[i];
+                        if (used[t])
+                        {
+                            continue;
+                        }
+
+                        auto extra = extra_vertices(t);
+                        if (meshlet_vertices.size() + extra > max_vertices)
+                        {
+                            continue;
+                        }
+
+                        auto spread = 1.0f - glm::dot(normals[t], axis);
+                        auto score  = static_cast<float>(extra) + cone_weight * spread;
+                        if (score < best_score)
+                        {
+                            best       = t;
+                            best_score = score;
+                        }
+                    }
+                }
+
+                if (best == face_count)
+                {
+                    break;
+                }
+                add_triangle(best);
+            }
+
+            finish_meshlet();
+        }
+
+        return meshlets;
+    }
+
+    std::array<glm::vec4, 6> frustum_planes(glm::mat4 const& view_projection)
+    {
+        auto const& m = view_projection;
+        auto row      = [&m](int i) {
+            return glm::vec4{m[0][i], m[1][i], m[2][i], m[3][i]};
+        };
+
+        std::array<glm::vec4, 6> planes{row(3) + row(0),
+                                        row(3) - row(0),
+                                        row(3) + row(1),
+                                        row(3) - row(1),
+                                        row(3) + row(2),
+                                        row(3) - row(2)};
+        for (auto& plane : planes)
+        {
+            plane /= glm::length(glm::vec3{plane});
+        }
+
+        return planes;
+    }
+
+    bool is_meshlet_backfacing(Meshlets const& meshlets,
+                               std::size_t meshlet,
+                               glm::vec3 const& camera)
+    {
+        auto const& cone = meshlets.cones[meshlet];
+        if (cone.w >= 1.0f)
+        {
+            return false;
+        }
+
+        glm::vec3 apex{meshlets.cone_apexes[meshlet]};
+        if (apex == camera)
+        {
+            return false;
+        }
+
+        return glm::dot(glm::normalize(apex - camera), glm::vec3{cone}) >= cone.w;
+    }
+
+    bool is_meshlet_outside(Meshlets const& meshlets,
+                            std::size_t meshlet,
+                            std::array<glm::vec4, 6> const& planes)
+    {
+        auto const& sphere = meshlets.spheres[meshlet];
+        glm::vec3 centre{sphere};
+        for (auto const& plane : planes)
+        {
+            if (glm::dot(glm::vec3{plane}, centre) + plane.w < -sphere.w)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    std::vector<std::uint32_t> cull_meshlets(Meshlets const& meshlets,
+                                             glm::vec3 const& camera,
+                                             std::array<glm::vec4, 6> const& planes)
+    {
+        std::vector<std::uint32_t> visible;
+        for (std::size_t i{0}; i < meshlets.size(); ++i)
+        {
+            if (!is_meshlet_outside(meshlets, i, planes) &&
+                !is_meshlet_backfacing(meshlets, i, camera))
+            {
+                visible.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+
+        return visible;
+    }
+} // namespace atlas::utils
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "load_obj_file.hpp"
+
+#include <atlas/math/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace atlas::utils
+{
+    struct MeshletSettings
+    {
+        // Limits for each meshlet. 64 and 124 fit the output limits of mesh
+        // shaders on most hardware. max_vertices must be at most 256, since
+        // triangles refer to vertices with 8-bit indices.
+        std::size_t max_vertices{64};
+        std::size_t max_triangles{124};
+
+        // How strongly triangles whose normals are close to the rest of the
+        // meshlet are preferred, which gives narrower normal cones. 0 only
+        // looks at how many vertices a triangle adds.
+        float cone_weight{0.5f};
+    };
+
+    // Meshlets of a shape, stored as one array per field so each can be
+    // uploaded as is to a shader storage buffer and read in a compute shader
+    // with the std430 layout:
+    //
+    //     layout(std430) readonly buffer Spheres { vec4 spheres[]; };
+    //     layout(std430) readonly buffer Cones { vec4 cones[]; };
+    //
+    // and likewise for the other arrays. The vec4 members are stored as
+    // glm::vec4 and the rest as uint, so no padding is needed.
+    struct Meshlets
+    {
+        std::size_t size() const
+        {
+            return vertex_offsets.size();
+        }
+
+        // Where the vertices and triangles of each meshlet start in the
+        // arrays below, and how many there are. Triangle offsets are in
+        // bytes and always a multiple of 4.
+        std::vector<std::uint32_t> vertex_offsets;
+        std::vector<std::uint32_t> vertex_counts;
+        std::vector<std::uint32_t> triangle_offsets;
+        std::vector<std::uint32_t> triangle_counts;
+
+        // Bounding sphere of each meshlet, with the radius in w.
+        std::vector<glm::vec4> spheres;
+
+        // Normal cone of each meshlet, with the axis in xyz and the cutoff in
+        // w. A meshlet faces away from a camera at c if
+        //     dot(normalize(apex - c), axis) >= cutoff
+        // where apex is the cone apex below. A cutoff of 1 or more means the
+        // meshlet can never be culled this way.
+        std::vector<glm::vec4> cones;
+        std::vector<glm::vec4> cone_apexes;
+
+        // Indices into the vertices of the shape.
+        std::vector<std::uint32_t> vertices;
+
+        // Three indices into the vertices of the meshlet per triangle. Read
+        // from a shader as a uint array and unpack the bytes.
+        std::vector<std::uint8_t> triangles;
+    };
+
+    // Groups the triangles of a shape into meshlets. Triangles are added to
+    // the current meshlet while they share vertices with it, preferring the
+    // ones that add the fewest vertices, so the index order of the shape
+    // only decides where each meshlet starts.
+    Meshlets build_meshlets(Shape const& shape, MeshletSettings const& settings = {});
+
+    // Planes of the frustum of a view projection matrix, facing inwards,
+    // with the normal in xyz and the distance in w.
+    std::array<glm::vec4, 6> frustum_planes(glm::mat4 const& view_projection);
+
+    // True if none of the triangles of the meshlet can face the camera.
+    bool is_meshlet_backfacing(Meshlets const& meshlets,
+                               std::size_t meshlet,
+                               glm::vec3 const& camera);
+
+    // True if the bounding sphere of the meshlet is outside one of the
+    // planes.
+    bool is_meshlet_outside(Meshlets const& meshlets,
+                            std::size_t meshlet,
+                            std::array<glm::vec4, 6> const& planes);
+
+    // Returns the meshlets that pass both tests.
+    std::vector<std::uint32_t> cull_meshlets(Meshlets const& meshlets,
+                                             glm::vec3 const& camera,
+                                             std::array<glm::vec4, 6> const& planes);
+} // namespace atlas::utils
@@ -0,0 +1,996 @@
+#include "obj_parser.hpp"
+#include "mapped_file.hpp"
+#include "parse_float.hpp"
+
+#include <atlas/jobs/job_system.hpp>
+#include <atlas/math/glm.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <fmt/printf.h>
+#include <fstream>
+#include <map>
+#include <string_view>
+#include <utility>
+
+namespace atlas::utils
+{
+    namespace
+    {
+        constexpr std::size_t min_chunk_size{1 << 20};
+
+        // Components of a corner that were given relative to the end of the
+        // attribute arrays, which only becomes known once every chunk before
+        // it has been parsed.
+        enum RelativeMask : std::uint8_t
+        {
+            relative_vertex   = 1,
+            relative_texcoord = 2,
+            relative_normal   = 4
+        };
+
+        struct Fixup
+        {
+            std::size_t corner;
+            std::uint8_t mask;
+        };
+
+        // Polygon with more than three corners, stored as a fan of
+        // count - 2 triangles starting at face.
+        struct Polygon
+        {
+            std::size_t face;
+            std::size_t count;
+        };
+
+        template<typename T>
+        struct Change
+        {
+            std::size_t face;
+            T value;
+        };
+
+        struct Chunk
+        {
+            std::string_view text;
+
+            std::vector<float> positions;
+            std::vector<float> normals;
+            std::vector<float> texcoords;
+
+            // Three corners per triangle. Absolute indices are already zero
+            // based, relative ones are offsets into this chunk's attributes
+            // until the fixups are applied.
+            std::vector<tinyobj::index_t> indices;
+            std::vector<Fixup> fixups;
+            std::vector<Polygon> polygons;
+
+            // State changes, keyed by the first face they apply to. Faces
+            // before the first change continue the previous chunk.
+            std::vector<Change<std::string>> materials;
+            std::vector<Change<unsigned int>> smoothing_groups;
+            std::vector<std::size_t> groups;
+            std::vector<std::string> libraries;
+
+            std::string warning;
+        };
+
+        bool is_space(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        void skip_space(char const*& p, char const* end)
+        {
+            while (p < end && is_space(*p))
+            {
+                ++p;
+            }
+        }
+
+        std::string_view trim(std::string_view text)
+        {
+            while (!text.empty() && is_space(text.front()))
+            {
+                text.remove_prefix(1);
+            }
+            while (!text.empty() && is_space(text.back()))
+            {
+                text.remove_suffix(1);
+            }
+            return text;
+        }
+
+        // Missing components are left at 0, like tinyobjloader does.
+        template<std::size_t N>
+        void parse_floats(char const* p, char const* end, std::vector<float>& out)
+        {
+            for (std::size_t i{0}; i < N; ++i)
+            {
+                float value{0.0f};
+                skip_space(p, end);
+                if (p < end && *p == '+')
+                {
+                    ++p;
+                }
+
+                p = detail::parse_float(p, end, value);
+                out.push_back(value);
+            }
+        }
+
+        bool parse_index(char const*& p,
+                         char const* end,
+                         std::size_t count,
+                         std::uint8_t bit,
+                         std::uint8_t& mask,
+                         int& out)
+        {
+            long long value{0};
+            auto [ptr, ec] = std::from_chars(p, end, value);
+            if (ec != std::errc{} || value == 0)
+            {
+                return false;
+            }
+
+            p = ptr;
+            if (value > 0)
+            {
+                out = static_cast<int>(value - 1);
+            }
+            else
+            {
+                out = static_cast<int>(static_cast<long long>(count) + value);
+                mask |= bit;
+            }
+            return true;
+        }
+
+        bool parse_face(char const* p,
+                        char const* end,
+                        Chunk& chunk,
+                        std::vector<tinyobj::index_t>& corners,
+                        std::vector<std::uint8_t>& masks)
+        {
+            corners.clear();
+            masks.clear();
+
+            while (true)
+            {
+                skip_space(p, end);
+                if (p == end)
+                {
+                    break;
+                }
+
+                tinyobj::index_t corner{-1, -1, -1};
+                std::uint8_t mask{0};
+                if (!parse_index(p,
+                                 end,
+                                 chunk.positions.size() / 3,
+                                 relative_vertex,
+                                 mask,
+                                 corner.vertex_index))
+                {
+                    return false;
+                }
+
+                if (p < end && *p == '/')
+                {
+                    ++p;
+                    if (p < end && *p != '/' &&
+                        !parse_index(p,
+                                     end,
+                                     chunk.texcoords.size() / 2,
+                                     relative_texcoord,
+                                     mask,
+                                     corner.texcoord_index))
+                    {
+                        return false;
+                    }
+
+                    if (p < end && *p == '/')
+                    {
+                        ++p;
+                        if (!parse_index(p,
+                                         end,
+                                         chunk.normals.size() / 3,
+                                         relative_normal,
+                                         mask,
+                                         corner.normal_index))
+                        {
+                            return false;
+                        }
+                    }
+                }
+
+                if (p < end && !is_space(*p))
+                {
+                    return false;
+                }
+
+                corners.push_back(corner);
+                masks.push_back(mask);
+            }
+
+            if (corners.size() < 3)
+            {
+                return true;
+            }
+
+            // Split into a fan for now. Concave polygons are split again
+            // once all the positions are known.
+            auto face = chunk.indices.size() / 3;
+            if (corners.size() > 3)
+            {
+                chunk.polygons.push_back({face, corners.size()});
+            }
+
+            for (std::size_t i{1}; i + 1 < corners.size(); ++i)
+            {
+                for (auto k : {std::size_t{0}, i, i + 1})
+                {
+                    if (masks[k] != 0)
+                    {
+                        chunk.fixups.push_back({chunk.indices.size(), masks[k]});
+                    }
+                    chunk.indices.push_back(corners[k]);
+                }
+            }
+
+            return true;
+        }
+
+        void parse_chunk(Chunk& chunk)
+        {
+            std::vector<tinyobj::index_t> corners;
+            std::vector<std::uint8_t> masks;
+
+            auto p   = chunk.text.data();
+            auto end = p + chunk.text.size();
+            while (p < end)
+            {
+                auto line_end = std::find(p, end, '\n');
+                auto line     = p;
+                p             = (line_end == end) ? end : line_end + 1;
+
+                skip_space(line, line_end);
+                auto length = static_cast<std::size_t>(line_end - line);
+                if (length < 2)
+                {
+                    continue;
+                }
+
+                auto keyword_end = line;
+                while (keyword_end < line_end && !is_space(*keyword_end))
+                {
+                    ++keyword_end;
+                }
+                auto keyword = std::string_view{line, line_end}.substr(
+                    0, static_cast<std::size_t>(keyword_end - line));
+                auto rest = std::string_view{keyword_end, line_end};
+                auto face = chunk.indices.size() / 3;
+
+                if (keyword == "v")
+                {
+                    parse_floats<3>(keyword_end, line_end, chunk.positions);
+                }
+                else if (keyword == "vn")
+                {
+                    parse_floats<3>(keyword_end, line_end, chunk.normals);
+                }
+                else if (keyword == "vt")
+                {
+                    parse_floats<2>(keyword_end, line_end, chunk.texcoords);
+                }
+                else if (keyword == "f")
+                {
+                    // Like tinyobjloader, a face that cannot be read is
+                    // skipped instead of failing the whole file.
+                    if (!parse_face(keyword_end, line_end, chunk, corners, masks))
+                    {
+                        chunk.warning += fmt::format("Skipping invalid face: {}\n",
+                                                     trim({line, line_end}));
+                    }
+                }
+                else if (keyword == "o" || keyword == "g")
+                {
+                    chunk.groups.push_back(face);
+                }
+                else if (keyword == "usemtl")
+                {
+                    chunk.materials.push_back({face, std::string{trim(rest)}});
+                }
+                else if (keyword == "s")
+                {
+                    unsigned int group{0};
+                    auto text = trim(rest);
+                    if (text != "off")
+                    {
+                        std::from_chars(text.data(), text.data() + text.size(), group);
+                    }
+                    chunk.smoothing_groups.push_back({face, group});
+                }
+                else if (keyword == "mtllib")
+                {
+                    chunk.libraries.emplace_back(trim(rest));
+                }
+            }
+        }
+
+        std::vector<Chunk> split_chunks(std::string_view text, std::size_t thread_count)
+        {
+            auto chunk_size = std::max(min_chunk_size, text.size() / (thread_count * 8));
+
+            std::vector<Chunk> chunks;
+            std::size_t start{0};
+            while (start < text.size())
+            {
+                auto end = std::min(start + chunk_size, text.size());
+                end      = text.find('\n', end);
+                end      = (end == std::string_view::npos) ? text.size() : end + 1;
+
+                chunks.emplace_back().text = text.substr(start, end - start);
+                start                      = end;
+            }
+
+            return chunks;
+        }
+
+        // Loads every material library in the order they appear. Like
+        // tinyobjloader, only the first file that can be opened on each line
+        // is read.
+        void load_materials(std::vector<Chunk> const& chunks,
+                            std::string const& material_path,
+                            std::map<std::string, int>& material_map,
+                            std::vector<tinyobj::material_t>& materials,
+                            std::string& warning,
+                            std::string& error)
+        {
+            for (auto const& chunk : chunks)
+            {
+                for (auto const& library : chunk.libraries)
+                {
+                    bool found{false};
+                    std::string_view names{library};
+                    while (!found && !names.empty())
+                    {
+                        auto name_end = names.find_first_of(" \t");
+                        auto name     = names.substr(0, name_end);
+                        names         = (name_end == std::string_view::npos)
+                                            ? std::string_view{}
+                                            : trim(names.substr(name_end));
+
+                        auto path = std::filesystem::path{material_path} / name;
+                        std::ifstream stream{path};
+                        if (stream)
+                        {
+                            tinyobj::LoadMtl(
+                                &material_map, &materials, &stream, &warning, &error);
+                            found = true;
+                        }
+                    }
+
+                    if (!found)
+                    {
+                        warning +=
+                            fmt::format("Material file [ {} ] not found.\n", library);
+                    }
+                }
+            }
+        }
+
+        // Attribute counts a corner is checked against once the chunks are
+        // merged.
+        struct Counts
+        {
+            int vertex;
+            int normal;
+            int texcoord;
+
+            bool contains(tinyobj::index_t corner) const
+            {
+                return corner.vertex_index >= 0 && corner.vertex_index < vertex &&
+                       corner.normal_index >= -1 && corner.normal_index < normal &&
+                       corner.texcoord_index >= -1 && corner.texcoord_index < texcoord;
+            }
+        };
+
+        // Drops the triangles with a corner outside of the attribute arrays,
+        // which tinyobjloader skips with a warning.
+        void remove_invalid_faces(tinyobj::mesh_t& mesh, Counts const& counts)
+        {
+            std::size_t kept{0};
+            auto face_count = mesh.indices.size() / 3;
+            for (std::size_t face{0}; face < face_count; ++face)
+            {
+                auto first = mesh.indices.data() + 3 * face;
+                if (!std::all_of(first, first + 3, [&](tinyobj::index_t corner) {
+                        return counts.contains(corner);
+                    }))
+                {
+                    continue;
+                }
+
+                if (kept != face)
+                {
+                    std::copy(first, first + 3, mesh.indices.data() + 3 * kept);
+                }
+                mesh.material_ids[kept]        = mesh.material_ids[face];
+                mesh.smoothing_group_ids[kept] = mesh.smoothing_group_ids[face];
+                ++kept;
+            }
+
+            mesh.indices.resize(3 * kept);
+            mesh.num_face_vertices.resize(kept);
+            mesh.material_ids.resize(kept);
+            mesh.smoothing_group_ids.resize(kept);
+        }
+
+        glm::vec3 position(tinyobj::attrib_t const& attrib, tinyobj::index_t corner)
+        {
+            auto i = 3 * static_cast<std::size_t>(corner.vertex_index);
+            return {attrib.vertices[i], attrib.vertices[i + 1], attrib.vertices[i + 2]};
+        }
+
+        // Re-splits a polygon stored as a fan if it turns out to be concave.
+        // This follows the ear clipping in tinyobjloader: the polygon is
+        // projected onto the plane its normal is closest to, and the first
+        // ear found from the current corner is cut off each time.
+        void triangulate_polygon(tinyobj::attrib_t const& attrib,
+                                 tinyobj::index_t* triangles,
+                                 std::size_t count)
+        {
+            std::vector<tinyobj::index_t> corners(count);
+            corners[0] = triangles[0];
+            corners[1] = triangles[1];
+            for (std::size_t i{2}; i < count; ++i)
+            {
+                corners[i] = triangles[3 * (i - 2) + 2];
+            }
+
+            std::vector<glm::vec3> points(count);
+            glm::vec3 normal{0.0f};
+            for (std::size_t i{0}; i < count; ++i)
+            {
+                points[i] = position(attrib, corners[i]);
+            }
+            for (std::size_t i{0}; i < count; ++i)
+            {
+                normal += glm::cross(points[i], points[(i + 1) % count]);
+            }
+
+            auto n    = glm::abs(normal);
+            int axis  = (n.x > n.y) ? ((n.x > n.z) ? 0 : 2) : ((n.y > n.z) ? 1 : 2);
+            auto sign = (normal[axis] < 0.0f) ? -1.0f : 1.0f;
+
+            std::vector<glm::vec2> plane(count);
+            for (std::size_t i{0}; i < count; ++i)
+            {
+                plane[i] = {points[i][(axis + 1) % 3], points[i][(axis + 2) % 3]};
+            }
+
+            auto turn = [&](std::size_t a, std::size_t b, std::size_t c) {
+                auto ab = plane[b] - plane[a];
+                auto bc = plane[c] - plane[b];
+                return sign * (ab.x * bc.y - ab.y * bc.x);
+            };
+
+            bool convex{true};
+            for (std::size_t i{0}; i < count && convex; ++i)
+            {
+                convex = turn(i, (i + 1) % count, (i + 2) % count) >= 0.0f;
+            }
+
+            if (convex)
+            {
+                return;
+            }
+
+            auto inside = [&](auto p, auto a, auto b, auto c) {
+                return turn(a, b, p) > 0.0f && turn(b, c, p) > 0.0f &&
+                       turn(c, a, p) > 0.0f;
+            };
+
+            std::vector<std::size_t> remaining(count);
+            for (std::size_t i{0}; i < count; ++i)
+            {
+                remaining[i] = i;
+            }
+
+            std::size_t written{0};
+            auto emit = [&](std::size_t a, std::size_t b, std::size_t c) {
+                triangles[written++] = corners[a];
+                triangles[written++] = corners[b];
+                triangles[written++] = corners[c];
+            };
+
+            std::size_t guess{0};
+            std::size_t rounds{count};
+            std::size_t previous{count};
+            while (remaining.size() > 3 && rounds > 0)
+            {
+                auto m = remaining.size();
+                guess %= m;
+                if (previous != m)
+                {
+                    previous = m;
+                    rounds   = m;
+                }
+                else
+                {
+                    --rounds;
+                }
+
+                auto a = remaining[guess];
+                auto b = remaining[(guess + 1) % m];
+                auto c = remaining[(guess + 2) % m];
+                if (turn(a, b, c) < 0.0f)
+                {
+                    ++guess;
+                    continue;
+                }
+
+                bool ear{true};
+                for (std::size_t k{3}; k < m && ear; ++k)
+                {
+                    ear = !inside(remaining[(guess + k) % m], a, b, c);
+                }
+
+                if (!ear)
+                {
+                    ++guess;
+                    continue;
+                }
+
+                emit(a, b, c);
+                auto removed = (guess + 1) % m;
+                remaining.erase(remaining.begin() + static_cast<std::ptrdiff_t>(removed));
+                if (removed < guess)
+                {
+                    --guess;
+                }
+            }
+
+            // Whatever is left (a triangle, or a degenerate polygon with no
+            // ears) becomes a fan, so the triangle count never changes.
+            for (std::size_t i{1}; i + 1 < remaining.size(); ++i)
+            {
+                emit(remaining[0], remaining[i], remaining[i + 1]);
+            }
+        }
+    } // namespace
+
+    bool parse_obj_file(std::string const& filename,
+                        std::string const& material_path,
+                        jobs::JobSystem& system,
+                        tinyobj::attrib_t& attrib,
+                        std::vector<tinyobj::shape_t>& shapes,
+                        std::vector<tinyobj::material_t>& materials,
+                        std::string& warning,
+                        std::string& error)
+    {
+        MappedFile file{filename};
+        if (!file.is_open())
+        {
+            error = fmt::format("Cannot open file [{}]\n", filename);
+            return false;
+        }
+
+        auto chunks = split_chunks(file.view(), system.thread_count());
+
+        system.parallel_for(chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i)
+            {
+                parse_chunk(chunks[i]);
+            }
+        });
+
+        for (auto const& chunk : chunks)
+        {
+            warning += chunk.warning;
+        }
+
+        std::map<std::string, int> material_map;
+        load_materials(chunks, material_path, material_map, materials, warning, error);
+
+        // Work out where every chunk goes in the merged arrays, along with the
+        // state it starts with.
+        struct Placement
+        {
+            std::size_t position{0};
+            std::size_t normal{0};
+            std::size_t texcoord{0};
+            std::size_t face{0};
+            int material{-1};
+            unsigned int smoothing_group{0};
+        };
+
+        std::vector<Placement> placements(chunks.size() + 1);
+        std::vector<std::size_t> shape_starts;
+        for (std::size_t i{0}; i < chunks.size(); ++i)
+        {
+            auto const& chunk = chunks[i];
+            auto next         = placements[i];
+            next.position += chunk.positions.size();
+            next.normal += chunk.normals.size();
+            next.texcoord += chunk.texcoords.size();
+            next.face += chunk.indices.size() / 3;
+
+            if (!chunk.materials.empty())
+            {
+                auto const& name = chunk.materials.back().value;
+                auto it          = material_map.find(name);
+                next.material    = (it == material_map.end()) ? -1 : it->second;
+            }
+
+            if (!chunk.smoothing_groups.empty())
+            {
+                next.smoothing_group = chunk.smoothing_groups.back().value;
+            }
+
+            // A new group only starts a new shape if the current one has
+            // faces.
+            for (auto face : chunk.groups)
+            {
+                auto global = placements[i].face + face;
+                if (global != (shape_starts.empty() ? 0 : shape_starts.back()))
+                {
+                    shape_starts.push_back(global);
+                }
+            }
+
+            placements[i + 1] = next;
+        }
+
+        for (auto const& chunk : chunks)
+        {
+            for (auto const& change : chunk.materials)
+            {
+                if (material_map.find(change.value) == material_map.end())
+                {
+                    warning += fmt::format("material [ '{}' ] not found in .mtl\n",
+                                           change.value);
+                }
+            }
+        }
+
+        auto const& totals = placements.back();
+        if (shape_starts.empty() || shape_starts.front() != 0)
+        {
+            shape_starts.insert(shape_starts.begin(), 0);
+        }
+        if (shape_starts.back() == totals.face)
+        {
+            shape_starts.pop_back();
+        }
+        shape_starts.push_back(totals.face);
+
+        shapes.resize(shape_starts.size() - 1);
+        for (std::size_t s{0}; s < shapes.size(); ++s)
+        {
+            auto face_count = shape_starts[s + 1] - shape_starts[s];
+            auto& mesh      = shapes[s].mesh;
+            mesh.indices.resize(face_count * 3);
+            mesh.num_face_vertices.assign(face_count, 3);
+            mesh.material_ids.resize(face_count);
+            mesh.smoothing_group_ids.resize(face_count);
+        }
+
+        attrib.vertices.resize(totals.position);
+        attrib.normals.resize(totals.normal);
+        attrib.texcoords.resize(totals.texcoord);
+
+        auto locate = [&](std::size_t face) {
+            auto it = std::upper_bound(shape_starts.begin(), shape_starts.end(), face);
+            auto s  = static_cast<std::size_t>(it - shape_starts.begin()) - 1;
+            return std::pair{&shapes[s].mesh, face - shape_starts[s]};
+        };
+
+        std::atomic<bool> out_of_range{false};
+        Counts const counts{static_cast<int>(totals.position / 3),
+                            static_cast<int>(totals.normal / 3),
+                            static_cast<int>(totals.texcoord / 2)};
+        auto merge = [&](std::size_t i) {
+            auto& chunk = chunks[i];
+            auto& place = placements[i];
+
+            std::copy(chunk.positions.begin(),
+                      chunk.positions.end(),
+                      attrib.vertices.data() + place.position);
+            std::copy(chunk.normals.begin(),
+                      chunk.normals.end(),
+                      attrib.normals.data() + place.normal);
+            std::copy(chunk.texcoords.begin(),
+                      chunk.texcoords.end(),
+                      attrib.texcoords.data() + place.texcoord);
+
+            for (auto const& fixup : chunk.fixups)
+            {
+                auto& corner = chunk.indices[fixup.corner];
+                if (fixup.mask & relative_vertex)
+                {
+                    corner.vertex_index += static_cast<int>(place.position / 3);
+                }
+                if (fixup.mask & relative_texcoord)
+                {
+                    corner.texcoord_index += static_cast<int>(place.texcoord / 2);
+                }
+                if (fixup.mask & relative_normal)
+                {
+                    corner.normal_index += static_cast<int>(place.normal / 3);
+                }
+            }
+
+            auto material   = place.material;
+            auto smoothing  = place.smoothing_group;
+            auto next_mtl   = chunk.materials.begin();
+            auto next_group = chunk.smoothing_groups.begin();
+            auto face_count = chunk.indices.size() / 3;
+            for (std::size_t face{0}; face < face_count; ++face)
+            {
+                for (; next_mtl != chunk.materials.end() && next_mtl->face == face;
+                     ++next_mtl)
+                {
+                    auto it  = material_map.find(next_mtl->value);
+                    material = (it == material_map.end()) ? -1 : it->second;
+                }
+
+                for (; next_group != chunk.smoothing_groups.end() &&
+                       next_group->face == face;
+                     ++next_group)
+                {
+                    smoothing = next_group->value;
+                }
+
+                auto [mesh, local] = locate(place.face + face);
+                for (std::size_t k{0}; k < 3; ++k)
+                {
+                    auto corner = chunk.indices[3 * face + k];
+                    if (!counts.contains(corner))
+                    {
+                        out_of_range = true;
+                    }
+                    mesh->indices[3 * local + k] = corner;
+                }
+                mesh->material_ids[local]        = material;
+                mesh->smoothing_group_ids[local] = smoothing;
+            }
+
+            // Only the polygon list is needed from here on.
+            auto polygons  = std::move(chunk.polygons);
+            chunk          = {};
+            chunk.polygons = std::move(polygons);
+        };
+
+        system.parallel_for(chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i)
+            {
+                merge(i);
+            }
+        });
+
+        system.parallel_for(chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i)
+            {
+                for (auto const& polygon : chunks[i].polygons)
+                {
+                    auto [mesh, local] = locate(placements[i].face + polygon.face);
+                    auto first         = mesh->indices.data() + 3 * local;
+                    auto last          = first + 3 * (polygon.count - 2);
+
+                    // A polygon with any corner out of range is dropped as a
+                    // whole, so mark every one of its triangles.
+                    if (!std::all_of(first, last, [&](tinyobj::index_t corner) {
+                            return counts.contains(corner);
+                        }))
+                    {
+                        std::for_each(first, last, [](tinyobj::index_t& corner) {
+                            corner.vertex_index = -1;
+                        });
+                        continue;
+                    }
+                    triangulate_polygon(attrib, first, polygon.count);
+                }
+            }
+        });
+
+        if (out_of_range)
+        {
+            warning += "Face with invalid vertex index found.\n";
+            for (auto& shape : shapes)
+            {
+                remove_invalid_faces(shape.mesh, counts);
+            }
+            std::erase_if(shapes, [](tinyobj::shape_t const& shape) {
+                return shape.mesh.indices.empty();
+            });
+        }
+
+        return true;
+    }
+
+    ObjStreamParser::ObjStreamParser(std::string material_path,
+                                     jobs::JobSystem& system,
+                                     std::size_t max_shape_faces) :
+        m_material_path{std::move(material_path)},
+        m_max_shape_faces{std::max<std::size_t>(max_shape_faces, 1)},
+        m_system{&system}
+    {}
+
+    void ObjStreamParser::parse(std::string_view text, ShapeCallback const& on_shape)
+    {
+        auto chunks = split_chunks(text, m_system->thread_count());
+        m_system->parallel_for(chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i)
+            {
+                parse_chunk(chunks[i]);
+            }
+        });
+
+        for (auto const& chunk : chunks)
+        {
+            m_warning += chunk.warning;
+        }
+
+        load_materials(
+            chunks, m_material_path, m_material_map, m_materials, m_warning, m_error);
+
+        auto find_material = [&](std::string const& name) {
+            auto it = m_material_map.find(name);
+            if (it == m_material_map.end())
+            {
+                m_warning += fmt::format("material [ '{}' ] not found in .mtl\n", name);
+                return -1;
+            }
+            return it->second;
+        };
+
+        for (auto& chunk : chunks)
+        {
+            auto position_offset = static_cast<int>(m_attrib.vertices.size() / 3);
+            auto normal_offset   = static_cast<int>(m_attrib.normals.size() / 3);
+            auto texcoord_offset = static_cast<int>(m_attrib.texcoords.size() / 2);
+
+            m_attrib.vertices.insert(
+                m_attrib.vertices.end(), chunk.positions.begin(), chunk.positions.end());
+            m_attrib.normals.insert(
+                m_attrib.normals.end(), chunk.normals.begin(), chunk.normals.end());
+            m_attrib.texcoords.insert(
+                m_attrib.texcoords.end(), chunk.texcoords.begin(), chunk.texcoords.end());
+
+            for (auto const& fixup : chunk.fixups)
+            {
+                auto& corner = chunk.indices[fixup.corner];
+                if (fixup.mask & relative_vertex)
+                {
+                    corner.vertex_index += position_offset;
+                }
+                if (fixup.mask & relative_texcoord)
+                {
+                    corner.texcoord_index += texcoord_offset;
+                }
+                if (fixup.mask & relative_normal)
+                {
+                    corner.normal_index += normal_offset;
+                }
+            }
+
+            // Faces can only refer to attributes that have been read, since
+            // the ones after them are not known yet.
+            Counts const counts{static_cast<int>(m_attrib.vertices.size() / 3),
+                                static_cast<int>(m_attrib.normals.size() / 3),
+                                static_cast<int>(m_attrib.texcoords.size() / 2)};
+
+            auto next_mtl     = chunk.materials.begin();
+            auto next_group   = chunk.smoothing_groups.begin();
+            auto next_shape   = chunk.groups.begin();
+            auto next_polygon = chunk.polygons.begin();
+            auto face_count   = chunk.indices.size() / 3;
+            for (std::size_t face{0}; face < face_count;)
+            {
+                for (; next_mtl != chunk.materials.end() && next_mtl->face <= face;
+                     ++next_mtl)
+                {
+                    m_material = find_material(next_mtl->value);
+                }
+
+                for (; next_group != chunk.smoothing_groups.end() &&
+                       next_group->face <= face;
+                     ++next_group)
+                {
+                    m_smoothing_group = next_group->value;
+                }
+
+                // A new group only starts a new shape if the current one has
+                // faces.
+                for (; next_shape != chunk.groups.end() && *next_shape <= face;
+                     ++next_shape)
+                {
+                    emit(on_shape);
+                }
+
+                // Polygons are moved as a whole, so they never end up split
+                // between two shapes.
+                std::size_t count{1};
+                if (next_polygon != chunk.polygons.end() && next_polygon->face == face)
+                {
+                    count = next_polygon->count - 2;
+                    ++next_polygon;
+                }
+
+                // Like tinyobjloader, faces that refer to missing attributes
+                // are skipped.
+                auto corners = chunk.indices.data() + 3 * face;
+                if (!std::all_of(corners,
+                                 corners + 3 * count,
+                                 [&](tinyobj::index_t corner) {
+                                     return counts.contains(corner);
+                                 }))
+                {
+                    m_warning += "Face with invalid vertex index found.\n";
+                    face += count;
+                    continue;
+                }
+
+                if (m_mesh.num_face_vertices.size() >= m_max_shape_faces)
+                {
+                    emit(on_shape);
+                }
+
+                auto first = m_mesh.indices.size();
+                m_mesh.indices.insert(m_mesh.indices.end(), corners, corners + 3 * count);
+
+                if (count > 1)
+                {
+                    triangulate_polygon(m_attrib, &m_mesh.indices[first], count + 2);
+                }
+
+                m_mesh.num_face_vertices.insert(m_mesh.num_face_vertices.end(), count, 3);
+                m_mesh.material_ids.insert(m_mesh.material_ids.end(), count, m_material);
+                m_mesh.smoothing_group_ids.insert(
+                    m_mesh.smoothing_group_ids.end(), count, m_smoothing_group);
+                face += count;
+            }
+
+            // State changes after the last face still apply to the next
+            // chunk.
+            for (; next_mtl != chunk.materials.end(); ++next_mtl)
+            {
+                m_material = find_material(next_mtl->value);
+            }
+            if (next_group != chunk.smoothing_groups.end())
+            {
+                m_smoothing_group = chunk.smoothing_groups.back().value;
+            }
+            if (next_shape != chunk.groups.end())
+            {
+                emit(on_shape);
+            }
+
+            chunk = {};
+        }
+    }
+
+    void ObjStreamParser::finish(ShapeCallback const& on_shape)
+    {
+        emit(on_shape);
+    }
+
+    void ObjStreamParser::emit(ShapeCallback const& on_shape)
+    {
+        if (m_mesh.num_face_vertices.empty())
+        {
+            return;
+        }
+
+        if (on_shape)
+        {
+            on_shape(m_mesh);
+        }
+        m_mesh = {};
+    }
+} // namespace atlas::utils
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atlas/jobs/job_system.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <tiny_obj_loader.h>
+#include <vector>
+
+namespace atlas::utils
+{
+    // Drop-in replacement for tinyobj::LoadObj with triangulation enabled.
+    // The file is memory mapped and split into line-aligned chunks that are
+    // parsed in parallel, after which the per-chunk streams are merged into
+    // the same arrays tinyobjloader produces. Polygons are split the same way
+    // as well: convex ones as a fan, concave ones by ear clipping.
+    //
+    // Only geometry, materials and smoothing groups are read. Lines, points,
+    // vertex colours and shape names are skipped. As in tinyobjloader, faces
+    // that cannot be read or that refer to missing attributes are dropped
+    // with a warning rather than failing the file.
+    bool parse_obj_file(std::string const& filename,
+                        std::string const& material_path,
+                        jobs::JobSystem& system,
+                        tinyobj::attrib_t& attrib,
+                        std::vector<tinyobj::shape_t>& shapes,
+                        std::vector<tinyobj::material_t>& materials,
+                        std::string& warning,
+                        std::string& error);
+
+    // Incremental version of parse_obj_file, for files that are read a block
+    // at a time. Each block is split into chunks that are parsed in parallel
+    // as above, and then merged onto what has been read so far. Faces can
+    // refer to any earlier attribute, so those are kept for the whole file,
+    // but the faces of a shape are handed out and dropped as soon as a new
+    // group starts, or once there are max_shape_faces of them. The job
+    // system must outlive the parser.
+    class ObjStreamParser
+    {
+    public:
+        using ShapeCallback = std::function<void(tinyobj::mesh_t& mesh)>;
+
+        ObjStreamParser(std::string material_path,
+                        jobs::JobSystem& system,
+                        std::size_t max_shape_faces);
+
+        // Parses a block of text, which must end at a line break unless it
+        // is the last one. Every shape completed by it is passed to
+        // on_shape.
+        void parse(std::string_view text, ShapeCallback const& on_shape);
+
+        // Hands out the faces that are left, if any.
+        void finish(ShapeCallback const& on_shape);
+
+        tinyobj::attrib_t const& attrib() const
+        {
+            return m_attrib;
+        }
+
+        std::vector<tinyobj::material_t> const& materials() const
+        {
+            return m_materials;
+        }
+
+        std::string const& warning() const
+        {
+            return m_warning;
+        }
+
+        std::string const& error() const
+        {
+            return m_error;
+        }
+
+    private:
+        void emit(ShapeCallback const& on_shape);
+
+        std::string m_material_path;
+        std::size_t m_max_shape_faces;
+        jobs::JobSystem* m_system;
+
+        tinyobj::attrib_t m_attrib;
+        tinyobj::mesh_t m_mesh;
+        std::vector<tinyobj::material_t> m_materials;
+        std::map<std::string, int> m_material_map;
+        int m_material{-1};
+        unsigned int m_smoothing_group{0};
+
+        std::string m_warning;
+        std::string m_error;
+    };
+} // namespace atlas::utils
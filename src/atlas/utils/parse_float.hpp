@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+namespace atlas::utils::detail
+{
+    // Parses a float at the start of [first, last) with the syntax that
+    // std::from_chars accepts in general format: no leading whitespace or
+    // '+'. The float overloads of std::from_chars need GCC 11, so this is
+    // used instead. Returns the end of the number, or first if there is none
+    // or it is out of range, in which case value is left unchanged.
+    //
+    // Decimals with at most 7 significant digits and a small exponent are
+    // converted exactly in float arithmetic, which covers most mesh files.
+    // Anything else is handed to std::strtof, which assumes the "C" locale.
+    inline char const* parse_float(char const* first, char const* last, float& value)
+    {
+        auto is_digit = [](char c) {
+            return c >= '0' && c <= '9';
+        };
+
+        auto p        = first;
+        bool negative = p < last && *p == '-';
+        if (negative)
+        {
+            ++p;
+        }
+
+        // Only the first 19 significant digits fit in the mantissa, the rest
+        // send the number to strtof.
+        std::uint64_t mantissa{0};
+        int digits{0};
+        int exponent{0};
+        bool seen_digit{false};
+        bool truncated{false};
+        auto add_digit = [&](char c, int scale) {
+            seen_digit = true;
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(c - '0');
+                digits += (mantissa != 0) ? 1 : 0;
+                exponent -= scale;
+            }
+            else
+            {
+                truncated = truncated || c != '0';
+                exponent += 1 - scale;
+            }
+        };
+
+        for (; p < last && is_digit(*p); ++p)
+        {
+            add_digit(*p, 0);
+        }
+        if (p < last && *p == '.')
+        {
+            for (++p; p < last && is_digit(*p); ++p)
+            {
+                add_digit(*p, 1);
+            }
+        }
+
+        if (!seen_digit)
+        {
+            // Only inf, infinity and nan(...) are left, and strtof finds
+            // where they end.
+            auto q = negative ? first + 1 : first;
+            if (q == last || (*q != 'i' && *q != 'I' && *q != 'n' && *q != 'N'))
+            {
+                return first;
+            }
+            p = (last - first > 64) ? first + 64 : last;
+        }
+        else if (p < last && (*p == 'e' || *p == 'E'))
+        {
+            // An exponent without digits is not part of the number.
+            auto q = p + 1;
+            bool negative_exponent{false};
+            if (q < last && (*q == '+' || *q == '-'))
+            {
+                negative_exponent = *q == '-';
+                ++q;
+            }
+
+            if (q < last && is_digit(*q))
+            {
+                int e{0};
+                for (; q < last && is_digit(*q); ++q)
+                {
+                    e = (e < 10000) ? e * 10 + (*q - '0') : e;
+                }
+                exponent += negative_exponent ? -e : e;
+                p = q;
+            }
+        }
+
+        if (seen_digit && !truncated && mantissa <= (1u << 24) && exponent >= -10 &&
+            exponent <= 10)
+        {
+            // Both the mantissa and the power of 10 are exact in a float, so
+            // a single multiplication or division rounds correctly.
+            constexpr float powers[]{
+                1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+            auto result = static_cast<float>(mantissa);
+            result      = (exponent < 0) ? result / powers[-exponent]
+                                         : result * powers[exponent];
+            value       = negative ? -result : result;
+            return p;
+        }
+
+        std::string text{first, p};
+        char* end{nullptr};
+        errno       = 0;
+        auto result = std::strtof(text.c_str(), &end);
+        if (end == text.c_str() || errno == ERANGE)
+        {
+            return first;
+        }
+
+        value = result;
+        return first + (end - text.c_str());
+    }
+} // namespace atlas::utils::detail
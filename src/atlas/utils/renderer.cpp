@@ -0,0 +1,284 @@
+#include "renderer.hpp"
+#include "image_writer.hpp"
+
+#include <atlas/math/sampling.hpp>
+#include <atlas/math/sequences.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+
+namespace atlas::utils
+{
+    namespace
+    {
+        constexpr std::uint32_t hash(std::uint32_t x)
+        {
+            x ^= x >> 16;
+            x *= 0x7feb352dU;
+            x ^= x >> 15;
+            x *= 0x846ca68bU;
+            x ^= x >> 16;
+            return x;
+        }
+
+        // Orthonormal basis around n (Duff et al. 2017).
+        void make_basis(glm::vec3 const& n, glm::vec3& s, glm::vec3& t)
+        {
+            float sign = std::copysign(1.0f, n.z);
+            float a    = -1.0f / (sign + n.z);
+            float b    = n.x * n.y * a;
+            s          = {1.0f + sign * n.x * n.x * a, sign * b, -sign * n.x};
+            t          = {b, sign + n.y * n.y * a, -n.y};
+        }
+
+        glm::vec3 offset_origin(glm::vec3 const& p, glm::vec3 const& n)
+        {
+            float scale = std::max({1.0f, std::abs(p.x), std::abs(p.y), std::abs(p.z)});
+            return p + n * (1e-4f * scale);
+        }
+
+        std::uint8_t to_srgb8(float linear)
+        {
+            float c = std::clamp(linear, 0.0f, 1.0f);
+            c       = (c <= 0.0031308f) ? 12.92f * c
+                                        : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+            return static_cast<std::uint8_t>(c * 255.0f + 0.5f);
+        }
+    } // namespace
+
+    MeshScene::MeshScene(ObjMesh const& mesh,
+                         jobs::JobSystem& system,
+                         BvhSettings const& settings) :
+        m_mesh{&mesh},
+        m_bvh{mesh, system, settings}
+    {}
+
+    std::optional<SurfaceHit> MeshScene::intersect(math::Ray<glm::vec3> const& ray,
+                                                   float t_min,
+                                                   float t_max) const
+    {
+        auto bvh_hit = m_bvh.closest_hit(ray, t_min, t_max);
+        if (!bvh_hit)
+        {
+            return {};
+        }
+
+        auto const& shape = m_mesh->shapes[bvh_hit->shape_id];
+        auto const face   = bvh_hit->face_id;
+        auto const& v0    = shape.vertices[shape.indices[face * 3 + 0]];
+        auto const& v1    = shape.vertices[shape.indices[face * 3 + 1]];
+        auto const& v2    = shape.vertices[shape.indices[face * 3 + 2]];
+
+        SurfaceHit hit{};
+        hit.t      = bvh_hit->t;
+        hit.normal = glm::cross(v1.position - v0.position, v2.position - v0.position);
+        if (shape.has_normals)
+        {
+            auto w      = 1.0f - bvh_hit->u - bvh_hit->v;
+            auto shaded = w * v0.normal + bvh_hit->u * v1.normal + bvh_hit->v * v2.normal;
+            if (glm::dot(shaded, shaded) > 0.0f)
+            {
+                hit.normal = shaded;
+            }
+        }
+        hit.normal = glm::normalize(hit.normal);
+
+        // Only materials that came from an MTL file carry a name; the
+        // placeholder added by load_obj_mesh leaves the surface white.
+        if (face < shape.material_ids.size())
+        {
+            auto id = shape.material_ids[face];
+            if (id >= 0 && static_cast<std::size_t>(id) < m_mesh->materials.size())
+            {
+                auto const& material = m_mesh->materials[id];
+                if (!material.name.empty())
+                {
+                    hit.albedo = {
+                        material.diffuse[0], material.diffuse[1], material.diffuse[2]};
+                }
+            }
+        }
+
+        return hit;
+    }
+
+    bool MeshScene::occluded(math::Ray<glm::vec3> const& ray,
+                             float t_min,
+                             float t_max) const
+    {
+        return m_bvh.any_hit(ray, t_min, t_max);
+    }
+
+    glm::vec3 shade_ambient_occlusion(Scene const& scene,
+                                      math::Ray<glm::vec3> const& ray,
+                                      SurfaceHit const& hit,
+                                      glm::vec2 const& sample)
+    {
+        auto n = (glm::dot(hit.normal, ray.d) > 0.0f) ? -hit.normal : hit.normal;
+
+        glm::vec3 s, t;
+        make_basis(n, s, t);
+        auto local = math::square_to_cosine_hemisphere(sample);
+        auto dir   = local.x * s + local.y * t + local.z * n;
+
+        math::Ray<glm::vec3> shadow{offset_origin(ray(hit.t), n), dir};
+        if (scene.occluded(shadow, 0.0f, std::numeric_limits<float>::max()))
+        {
+            return glm::vec3{0.0f};
+        }
+
+        return hit.albedo;
+    }
+
+    Renderer::Renderer(jobs::JobSystem& system, RenderSettings const& settings) :
+        m_settings{settings},
+        m_system{&system},
+        m_shade{shade_ambient_occlusion},
+        m_accumulator(settings.width * settings.height, glm::vec3{0.0f})
+    {
+        m_settings.tile_size = std::max<std::size_t>(m_settings.tile_size, 1);
+    }
+
+    void Renderer::set_shade_function(ShadeFunction const& shade)
+    {
+        m_shade = shade;
+        reset();
+    }
+
+    void Renderer::reset()
+    {
+        std::fill(m_accumulator.begin(), m_accumulator.end(), glm::vec3{0.0f});
+        m_sample_count = 0;
+    }
+
+    void Renderer::render(Scene const& scene, Camera const& camera, std::size_t samples)
+    {
+        auto view = camera.compute_view_matrix();
+        if (m_view && *m_view != view)
+        {
+            reset();
+        }
+        m_view = view;
+
+        // The camera looks down -z in view space, so rays are built there and
+        // moved into the world with the inverse of the view matrix.
+        auto const inv_view = glm::inverse(view);
+        auto const origin   = glm::vec3{inv_view * glm::vec4{0.0f, 0.0f, 0.0f, 1.0f}};
+
+        auto const width     = m_settings.width;
+        auto const height    = m_settings.height;
+        auto const tile_size = m_settings.tile_size;
+        auto const tan_half  = std::tan(glm::radians(m_settings.fov) * 0.5f);
+        auto const aspect    = static_cast<float>(width) / static_cast<float>(height);
+
+        auto const tiles_x = (width + tile_size - 1) / tile_size;
+        auto const tiles_y = (height + tile_size - 1) / tile_size;
+        auto const first   = static_cast<std::uint32_t>(m_sample_count);
+
+        auto render_tile = [&](std::size_t tile) {
+            auto const x0 = (tile % tiles_x) * tile_size;
+            auto const y0 = (tile / tiles_x) * tile_size;
+            auto const x1 = std::min(x0 + tile_size, width);
+            auto const y1 = std::min(y0 + tile_size, height);
+
+            for (std::size_t y{y0}; y < y1; ++y)
+            {
+                for (std::size_t x{x0}; x < x1; ++x)
+                {
+                    auto const pixel = y * width + x;
+                    auto const seed =
+                        hash(static_cast<std::uint32_t>(pixel) ^ hash(m_settings.seed));
+
+                    glm::vec3 sum{0.0f};
+                    for (std::uint32_t i{0}; i < samples; ++i)
+                    {
+                        auto index = first + i;
+                        auto jx    = math::owen_sobol_sample<float>(index, 0, seed);
+                        auto jy    = math::owen_sobol_sample<float>(index, 1, seed);
+                        glm::vec2 shade_sample{
+                            math::owen_sobol_sample<float>(index, 2, seed),
+                            math::owen_sobol_sample<float>(index, 3, seed)};
+
+                        auto px = (2.0f * (x + jx) / width - 1.0f) * tan_half * aspect;
+                        auto py = (1.0f - 2.0f * (y + jy) / height) * tan_half;
+                        auto d  = glm::vec3{inv_view * glm::vec4{px, py, -1.0f, 0.0f}};
+
+                        math::Ray<glm::vec3> ray{origin, glm::normalize(d)};
+                        auto hit = scene.intersect(
+                            ray, 0.0f, std::numeric_limits<float>::max());
+                        sum += hit ? m_shade(scene, ray, *hit, shade_sample)
+                                   : m_settings.background;
+                    }
+
+                    m_accumulator[pixel] += sum;
+                }
+            }
+        };
+
+        auto const tile_count = tiles_x * tiles_y;
+        m_system->parallel_for(tile_count, 1, [&](std::size_t begin, std::size_t end) {
+            for (auto tile = begin; tile < end; ++tile)
+            {
+                render_tile(tile);
+            }
+        });
+
+        m_sample_count += samples;
+    }
+
+    std::vector<glm::vec3> Renderer::image() const
+    {
+        std::vector<glm::vec3> result(m_accumulator.size(), glm::vec3{0.0f});
+        if (m_sample_count == 0)
+        {
+            return result;
+        }
+
+        auto const scale = 1.0f / static_cast<float>(m_sample_count);
+        std::transform(m_accumulator.begin(),
+                       m_accumulator.end(),
+                       result.begin(),
+                       [scale](glm::vec3 const& sum) {
+                           return sum * scale;
+                       });
+        return result;
+    }
+
+    bool Renderer::save_image(std::string const& filename) const
+    {
+        auto const pixels = image();
+
+        // Lowercase the extension the same way write_image does, so both agree
+        // on whether the file is HDR.
+        auto extension = std::filesystem::path{filename}.extension().string();
+        std::transform(
+            extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+                return static_cast<char>(std::tolower(c));
+            });
+
+        ImageData data;
+        data.width    = static_cast<int>(m_settings.width);
+        data.height   = static_cast<int>(m_settings.height);
+        data.channels = 3;
+        data.is_float = (extension == ".hdr");
+        if (data.is_float)
+        {
+            data.pixels.resize(pixels.size() * sizeof(glm::vec3));
+            std::memcpy(data.pixels.data(), pixels.data(), data.pixels.size());
+        }
+        else
+        {
+            data.pixels.resize(pixels.size() * 3);
+            for (std::size_t i{0}; i < pixels.size(); ++i)
+            {
+                data.pixels[i * 3 + 0] = to_srgb8(pixels[i].r);
+                data.pixels[i * 3 + 1] = to_srgb8(pixels[i].g);
+                data.pixels[i * 3 + 2] = to_srgb8(pixels[i].b);
+            }
+        }
+
+        return write_image(filename, data);
+    }
+} // namespace atlas::utils
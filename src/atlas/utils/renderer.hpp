@@ -0,0 +1,147 @@
+#pragma once
+
+#include "bvh.hpp"
+#include "cameras.hpp"
+#include "load_obj_file.hpp"
+
+#include <atlas/jobs/job_system.hpp>
+#include <atlas/math/glm.hpp>
+#include <atlas/math/ray.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace atlas::utils
+{
+    struct SurfaceHit
+    {
+        float t;
+        glm::vec3 normal;
+        glm::vec3 albedo{1.0f};
+    };
+
+    // Geometry the renderer traces rays against. Implementations must be
+    // safe to query from several threads at once.
+    class Scene
+    {
+    public:
+        virtual ~Scene() = default;
+
+        virtual std::optional<SurfaceHit>
+        intersect(math::Ray<glm::vec3> const& ray, float t_min, float t_max) const = 0;
+
+        virtual bool
+        occluded(math::Ray<glm::vec3> const& ray, float t_min, float t_max) const
+        {
+            return intersect(ray, t_min, t_max).has_value();
+        }
+    };
+
+    // Scene made up of the triangles of an ObjMesh. The mesh is referenced,
+    // not copied, so it has to outlive the scene.
+    class MeshScene : public Scene
+    {
+    public:
+        // The BVH is built on the system, which is not used afterwards.
+        MeshScene(ObjMesh const& mesh,
+                  jobs::JobSystem& system,
+                  BvhSettings const& settings = {});
+
+        std::optional<SurfaceHit> intersect(math::Ray<glm::vec3> const& ray,
+                                            float t_min,
+                                            float t_max) const override;
+
+        bool occluded(math::Ray<glm::vec3> const& ray,
+                      float t_min,
+                      float t_max) const override;
+
+    private:
+        ObjMesh const* m_mesh;
+        Bvh8 m_bvh;
+    };
+
+    struct RenderSettings
+    {
+        std::size_t width{640};
+        std::size_t height{480};
+
+        // Side of the square tiles the image is split into. Each tile is one
+        // job.
+        std::size_t tile_size{16};
+
+        // Vertical field of view in degrees.
+        float fov{45.0f};
+
+        // Seed for the per-pixel sample scrambling.
+        std::uint32_t seed{0};
+
+        glm::vec3 background{0.0f};
+    };
+
+    // Computes the radiance along a primary ray that hit the scene. The
+    // sample is a fresh point in [0, 1)^2 for every pixel and frame.
+    using ShadeFunction = std::function<glm::vec3(Scene const& scene,
+                                                  math::Ray<glm::vec3> const& ray,
+                                                  SurfaceHit const& hit,
+                                                  glm::vec2 const& sample)>;
+
+    // Progressive renderer: every call to render adds samples to each pixel
+    // and image returns the running average. The image is split into tiles
+    // that are rendered in parallel, and samples are derived from the pixel
+    // and sample index only, so the result does not depend on the number of
+    // threads. The job system must outlive the renderer.
+    class Renderer
+    {
+    public:
+        explicit Renderer(jobs::JobSystem& system, RenderSettings const& settings = {});
+
+        void set_shade_function(ShadeFunction const& shade);
+
+        // Renders the given number of samples per pixel and adds them to the
+        // accumulated image. Accumulation restarts whenever the camera has
+        // moved since the last call.
+        void render(Scene const& scene, Camera const& camera, std::size_t samples = 1);
+
+        void reset();
+
+        std::size_t sample_count() const
+        {
+            return m_sample_count;
+        }
+
+        RenderSettings const& settings() const
+        {
+            return m_settings;
+        }
+
+        // Average of all samples so far, in linear colour, stored row by row
+        // starting at the top of the image.
+        std::vector<glm::vec3> image() const;
+
+        // Writes the image to disk. The format is chosen from the extension:
+        // .png, .jpg, .bmp and .tga are written as 8-bit sRGB, .hdr as
+        // linear floats.
+        bool save_image(std::string const& filename) const;
+
+    private:
+        RenderSettings m_settings;
+        jobs::JobSystem* m_system;
+        ShadeFunction m_shade;
+
+        std::vector<glm::vec3> m_accumulator;
+        std::size_t m_sample_count{0};
+        std::optional<glm::mat4> m_view;
+    };
+
+    // Default shading: white ambient occlusion lit by a constant sky, with
+    // one cosine-weighted occlusion ray per sample.
+    glm::vec3 shade_ambient_occlusion(Scene const& scene,
+                                      math::Ray<glm::vec3> const& ray,
+                                      SurfaceHit const& hit,
+                                      glm::vec2 const& sample);
+} // namespace atlas::utils
@@ -0,0 +1,854 @@
+#include "texture_compression.hpp"
+#include "mapped_file.hpp"
+
+#include <atlas/math/simd.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fmt/printf.h>
+#include <fstream>
+#include <limits>
+
+namespace fs = std::filesystem;
+
+namespace atlas::utils
+{
+    namespace
+    {
+        namespace simd = math::simd;
+
+        // Every block has 16 pixels, so a pack never straddles two blocks.
+        constexpr std::size_t lanes{std::min<std::size_t>(simd::native_width<float>, 16)};
+        using Floats  = simd::Pack<float, lanes>;
+        using Channel = std::array<float, 16>;
+
+        constexpr std::array<char, 8> magic{'A', 'T', 'L', 'T', 'E', 'X', '\0', '\0'};
+        constexpr std::uint32_t version{1};
+        constexpr std::uint32_t byte_order{0x01020304};
+
+        struct Header
+        {
+            std::array<char, 8> magic;
+            std::uint32_t version;
+            std::uint32_t byte_order;
+            std::uint32_t format;
+            std::uint32_t is_srgb;
+            std::uint64_t key;
+            std::uint64_t level_count;
+        };
+
+        struct LevelRecord
+        {
+            std::uint32_t width;
+            std::uint32_t height;
+            std::uint64_t offset;
+            std::uint64_t size;
+        };
+
+        struct Colours
+        {
+            alignas(64) Channel r;
+            alignas(64) Channel g;
+            alignas(64) Channel b;
+        };
+
+        Colours load_colours(unsigned char const* rgba)
+        {
+            Colours colours;
+            for (std::size_t i{0}; i < 16; ++i)
+            {
+                colours.r[i] = rgba[4 * i + 0];
+                colours.g[i] = rgba[4 * i + 1];
+                colours.b[i] = rgba[4 * i + 2];
+            }
+            return colours;
+        }
+
+        Channel load_channel(unsigned char const* rgba, std::size_t channel)
+        {
+            Channel values;
+            for (std::size_t i{0}; i < 16; ++i)
+            {
+                values[i] = rgba[4 * i + channel];
+            }
+            return values;
+        }
+
+        std::uint16_t pack_565(glm::vec3 const& colour)
+        {
+            auto quantise = [](float value, float levels) {
+                auto scaled = std::clamp(value, 0.0f, 255.0f) * levels / 255.0f;
+                return static_cast<std::uint16_t>(scaled + 0.5f);
+            };
+
+            return static_cast<std::uint16_t>((quantise(colour.r, 31.0f) << 11) |
+                                              (quantise(colour.g, 63.0f) << 5) |
+                                              quantise(colour.b, 31.0f));
+        }
+
+        std::array<int, 3> unpack_565(std::uint16_t colour)
+        {
+            int r = (colour >> 11) & 31;
+            int g = (colour >> 5) & 63;
+            int b = colour & 31;
+            return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+        }
+
+        // Palette of a BC1 block in four colour mode.
+        std::array<glm::vec3, 4> colour_palette(std::uint16_t c0, std::uint16_t c1)
+        {
+            auto a = unpack_565(c0);
+            auto b = unpack_565(c1);
+            glm::vec3 p0{a[0], a[1], a[2]};
+            glm::vec3 p1{b[0], b[1], b[2]};
+            return {p0, p1, (2.0f * p0 + p1) / 3.0f, (p0 + 2.0f * p1) / 3.0f};
+        }
+
+        // Picks the closest palette entry for every pixel and returns the
+        // total squared error.
+        float choose_colour_indices(Colours const& colours,
+                                    std::uint16_t c0,
+                                    std::uint16_t c1,
+                                    std::array<std::uint8_t, 16>& indices)
+        {
+            auto palette = colour_palette(c0, c1);
+
+            alignas(64) std::array<float, 16> best_index;
+            alignas(64) std::array<float, 16> best_error;
+            for (std::size_t i{0}; i < 16; i += lanes)
+            {
+                auto r = Floats::load(colours.r.data() + i);
+                auto g = Floats::load(colours.g.data() + i);
+                auto b = Floats::load(colours.b.data() + i);
+
+                Floats best{std::numeric_limits<float>::max()};
+                Floats index{0.0f};
+                for (std::size_t k{0}; k < 4; ++k)
+                {
+                    auto dr     = r - Floats{palette[k].r};
+                    auto dg     = g - Floats{palette[k].g};
+                    auto db     = b - Floats{palette[k].b};
+                    auto error  = dr * dr + dg * dg + db * db;
+                    auto closer = error < best;
+                    best        = select(closer, error, best);
+                    index       = select(closer, Floats{static_cast<float>(k)}, index);
+                }
+
+                index.store(best_index.data() + i);
+                best.store(best_error.data() + i);
+            }
+
+            float total{0.0f};
+            for (std::size_t i{0}; i < 16; ++i)
+            {
+                indices[i] = static_cast<std::uint8_t>(best_index[i]);
+                total += best_error[i];
+            }
+            return total;
+        }
+
+        // Principal axis of the colours, found by power iteration on their
+        // covariance.
+        glm::vec3 principal_axis(Colours const& colours, glm::vec3 const& mean)
+        {
+            float xx{0}, xy{0}, xz{0}, yy{0}, yz{0}, zz{0};
+            for (std::size_t i{0}; i < 16; ++i)
+            {
+                auto r = colours.r[i] - mean.r;
+                auto g = colours.g[i] - mean.g;
+                auto b = colours.b[i] - mean.b;
+                xx += r * r;
+                xy += r * g;
+                xz += r * b;
+                yy += g * g;
+                yz += g * b;
+                zz += b * b;
+            }
+
+            // Starting from the longest row of the matrix keeps the start
+            // from being orthogonal to the axis.
+            std::array<glm::vec3, 3> rows{
+                glm::vec3{xx, xy, xz}, glm::vec3{xy, yy, yz}, glm::vec3{xz, yz, zz}};
+            auto axis = *std::max_element(
+                rows.begin(), rows.end(), [](glm::vec3 const& a, glm::vec3 const& b) {
+                    return glm::dot(a, a) < glm::dot(b, b);
+                });
+
+            for (int i{0}; i < 8; ++i)
+            {
+                auto length = glm::length(axis);
+                if (length <= 0.0f)
+                {
+                    return glm::normalize(glm::vec3{1.0f});
+                }
+
+                axis /= length;
+                axis = rows[0] * axis.x + rows[1] * axis.y + rows[2] * axis.z;
+            }
+
+            auto length = glm::length(axis);
+            return (length > 0.0f) ? axis / length : glm::normalize(glm::vec3{1.0f});
+        }
+
+        // Solves for the endpoints that best fit the chosen indices in the
+        // least squares sense.
+        bool refine_endpoints(Colours const& colours,
+                              std::array<std::uint8_t, 16> const& indices,
+                              glm::vec3& e0,
+                              glm::vec3& e1)
+        {
+            constexpr std::array<float, 4> weights{1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+
+            float aa{0}, ab{0}, bb{0};
+            glm::vec3 ax{0.0f};
+            glm::vec3 bx{0.0f};
+            for (std::size_t i{0}; i < 16; ++i)
+            {
+                auto t = weights[indices[i]];
+                auto s = 1.0f - t;
+                glm::vec3 x{colours.r[i], colours.g[i], colours.b[i]};
+                aa += t * t;
+                ab += t * s;
+                bb += s * s;
+                ax += t * x;
+                bx += s * x;
+            }
+
+            auto det = aa * bb - ab * ab;
+            if (std::abs(det) < 1e-6f)
+            {
+                return false;
+            }
+
+            e0 = (bb * ax - ab * bx) / det;
+            e1 = (aa * bx - ab * ax) / det;
+            return true;
+        }
+
+        void write_colour_block(std::uint16_t c0,
+                                std::uint16_t c1,
+                                std::array<std::uint8_t, 16> indices,
+                                unsigned char* block)
+        {
+            // Four colour mode needs c0 > c1. Swapping the endpoints swaps
+            // indices 0 and 1 and indices 2 and 3.
+            if (c0 < c1)
+            {
+                std::swap(c0, c1);
+                for (auto& index : indices)
+                {
+                    index ^= 1;
+                }
+            }
+            else if (c0 == c1)
+            {
+                indices.fill(0);
+            }
+
+            std::uint32_t bits{0};
+            for (std::size_t i{0}; i < 16; ++i)
+            {
+                bits |= std::uint32_t{indices[i]} << (2 * i);
+            }
+
+            block[0] = static_cast<unsigned char>(c0 & 0xFF);
+            block[1] = static_cast<unsigned char>(c0 >> 8);
+            block[2] = static_cast<unsigned char>(c1 & 0xFF);
+            block[3] = static_cast<unsigned char>(c1 >> 8);
+            for (std::size_t i{0}; i < 4; ++i)
+            {
+                block[4 + i] = static_cast<unsigned char>(bits >> (8 * i));
+            }
+        }
+
+        void encode_colour(Colours const& colours, unsigned char* block)
+        {
+            glm::vec3 mean{0.0f};
+            for (std::size_t i{0}; i < 16; ++i)
+            {
+                mean += glm::vec3{colours.r[i], colours.g[i], colours.b[i]};
+            }
+            mean /= 16.0f;
+
+            auto axis = principal_axis(colours, mean);
+
+            // Extent of the colours along the axis.
+            alignas(64) Channel projection;
+            for (std::size_t i{0}; i < 16; i += lanes)
+            {
+                auto t = (Floats::load(colours.r.data() + i) - Floats{mean.r}) *
+                             Floats{axis.r} +
+                         (Floats::load(colours.g.data() + i) - Floats{mean.g}) *
+                             Floats{axis.g} +
+                         (Floats::load(colours.b.data() + i) - Floats{mean.b}) *
+                             Floats{axis.b};
+                t.store(projection.data() + i);
+            }
+            auto [lo, hi] = std::minmax_element(projection.begin(), projection.end());
+
+            // Pulling the endpoints in slightly lowers the error of the
+            // interpolated colours, which cover most pixels.
+            auto e0    = mean + axis * *hi;
+            auto e1    = mean + axis * *lo;
+            auto inset = (e0 - e1) / 16.0f;
+            e0 -= inset;
+            e1 += inset;
+
+            auto c0 = pack_565(e0);
+            auto c1 = pack_565(e1);
+            std::array<std::uint8_t, 16> indices;
+            auto error = choose_colour_indices(colours, c0, c1, indices);
+
+            if (refine_endpoints(colours, indices, e0, e1))
+            {
+                auto r0 = pack_565(e0);
+                auto r1 = pack_565(e1);
+                std::array<std::uint8_t, 16> refined;
+                if (choose_colour_indices(colours, r0, r1, refined) < error)
+                {
+                    c0      = r0;
+                    c1      = r1;
+                    indices = refined;
+                }
+            }
+
+            write_colour_block(c0, c1, indices, block);
+        }
+
+        void encode_channel(Channel const& values, unsigned char* block)
+        {
+            auto [lo, hi] = std::minmax_element(values.begin(), values.end());
+            auto a0       = static_cast<unsigned char>(*hi);
+            auto a1       = static_cast<unsigned char>(*lo);
+            block[0]      = a0;
+            block[1]      = a1;
+
+            // With a0 > a1 the palette is a0, a1 and six evenly spaced values
+            // in between, so the closest entry comes from rounding the
+            // position on the ramp from a1 to a0.
+            alignas(64) Channel ramp;
+            auto scale = (a0 == a1) ? 0.0f : 7.0f / static_cast<float>(a0 - a1);
+            for (std::size_t i{0}; i < 16; i += lanes)
+            {
+                auto value = Floats::load(values.data() + i);
+                auto t     = (value - Floats{static_cast<float>(a1)}) * Floats{scale};
+                (t + Floats{0.5f}).store(ramp.data() + i);
+            }
+
+            constexpr std::array<std::uint64_t, 8> ramp_to_index{1, 7, 6, 5, 4, 3, 2, 0};
+            std::uint64_t bits{0};
+            for (std::size_t i{0}; i < 16; ++i)
+            {
+                auto position = std::min(static_cast<int>(ramp[i]), 7);
+                auto index    = (a0 == a1) ? 0 : ramp_to_index[position];
+                bits |= index << (3 * i);
+            }
+
+            for (std::size_t i{0}; i < 6; ++i)
+            {
+                block[2 + i] = static_cast<unsigned char>(bits >> (8 * i));
+            }
+        }
+
+        void decode_colour(unsigned char const* block,
+                           bool always_opaque,
+                           unsigned char* rgba)
+        {
+            auto c0 = static_cast<std::uint16_t>(block[0] | (block[1] << 8));
+            auto c1 = static_cast<std::uint16_t>(block[2] | (block[3] << 8));
+            auto a  = unpack_565(c0);
+            auto b  = unpack_565(c1);
+
+            std::array<std::array<int, 4>, 4> palette;
+            palette[0] = {a[0], a[1], a[2], 255};
+            palette[1] = {b[0], b[1], b[2], 255};
+            if (c0 > c1 || always_opaque)
+            {
+                for (std::size_t c{0}; c < 3; ++c)
+                {
+                    palette[2][c] = (2 * a[c] + b[c]) / 3;
+                    palette[3][c] = (a[c] + 2 * b[c]) / 3;
+                }
+                palette[2][3] = 255;
+                palette[3][3] = 255;
+            }
+            else
+            {
+                for (std::size_t c{0}; c < 3; ++c)
+                {
+                    palette[2][c] = (a[c] + b[c]) / 2;
+                }
+                palette[2][3] = 255;
+                palette[3]    = {0, 0, 0, 0};
+            }
+
+            std::uint32_t bits{0};
+            for (std::size_t i{0}; i < 4; ++i)
+            {
+                bits |= std::uint32_t{block[4 + i]} << (8 * i);
+            }
+
+            for (std::size_t i{0}; i < 16; ++i)
+            {
+                auto const& colour = palette[(bits >> (2 * i)) & 3];
+                for (std::size_t c{0}; c < 4; ++c)
+                {
+                    rgba[4 * i + c] = static_cast<unsigned char>(colour[c]);
+                }
+            }
+        }
+
+        void decode_channel(unsigned char const* block,
+                            unsigned char* rgba,
+                            std::size_t channel)
+        {
+            int a0 = block[0];
+            int a1 = block[1];
+
+            std::array<int, 8> palette{a0, a1};
+            if (a0 > a1)
+            {
+                for (int k{2}; k < 8; ++k)
+                {
+                    palette[k] = ((8 - k) * a0 + (k - 1) * a1 + 3) / 7;
+                }
+            }
+            else
+            {
+                for (int k{2}; k < 6; ++k)
+                {
+                    palette[k] = ((6 - k) * a0 + (k - 1) * a1 + 2) / 5;
+                }
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+
+            std::uint64_t bits{0};
+            for (std::size_t i{0}; i < 6; ++i)
+            {
+                bits |= std::uint64_t{block[2 + i]} << (8 * i);
+            }
+
+            for (std::size_t i{0}; i < 16; ++i)
+            {
+                rgba[4 * i + channel] =
+                    static_cast<unsigned char>(palette[(bits >> (3 * i)) & 7]);
+            }
+        }
+
+        // Copies a 4x4 block out of the level as RGBA, repeating the last row
+        // and column past the edges.
+        void fetch_block(TextureLevel const& level,
+                         int channels,
+                         int block_x,
+                         int block_y,
+                         unsigned char* rgba)
+        {
+            for (int y{0}; y < 4; ++y)
+            {
+                auto row = std::min(block_y * 4 + y, level.height - 1);
+                for (int x{0}; x < 4; ++x)
+                {
+                    auto column = std::min(block_x * 4 + x, level.width - 1);
+                    auto source = level.pixels.data() +
+                                  (static_cast<std::size_t>(row) * level.width + column) *
+                                      channels;
+                    auto pixel = rgba + 4 * (y * 4 + x);
+                    switch (channels)
+                    {
+                    case 1:
+                        pixel[0] = pixel[1] = pixel[2] = source[0];
+                        pixel[3]                       = 255;
+                        break;
+
+                    case 2:
+                        pixel[0] = source[0];
+                        pixel[1] = source[1];
+                        pixel[2] = 0;
+                        pixel[3] = 255;
+                        break;
+
+                    case 3:
+                        std::memcpy(pixel, source, 3);
+                        pixel[3] = 255;
+                        break;
+
+                    default:
+                        std::memcpy(pixel, source, 4);
+                        break;
+                    }
+                }
+            }
+        }
+
+        std::uint64_t hash_bytes(std::string_view bytes, std::uint64_t hash)
+        {
+            constexpr std::uint64_t prime{1099511628211ull};
+
+            // FNV-1a over whole words, which is plenty to tell images apart
+            // and several times faster than going byte by byte.
+            std::size_t i{0};
+            for (; i + 8 <= bytes.size(); i += 8)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, bytes.data() + i, 8);
+                hash = (hash ^ word) * prime;
+                hash ^= hash >> 29;
+            }
+
+            for (; i < bytes.size(); ++i)
+            {
+                hash = (hash ^ static_cast<unsigned char>(bytes[i])) * prime;
+            }
+            return hash;
+        }
+
+        std::optional<CompressedTexture>
+        read_compressed_texture(std::string const& filename,
+                                std::optional<std::uint64_t> key)
+        {
+            MappedFile file{filename};
+            if (!file.is_open() || file.size() < sizeof(Header))
+            {
+                return {};
+            }
+
+            Header header;
+            std::memcpy(&header, file.data(), sizeof(Header));
+            auto format = static_cast<BlockFormat>(header.format);
+            if (header.magic != magic || header.version != version ||
+                header.byte_order != byte_order ||
+                (format != BlockFormat::bc1 && format != BlockFormat::bc3 &&
+                 format != BlockFormat::bc4 && format != BlockFormat::bc5) ||
+                (key && header.key != *key) ||
+                header.level_count > (file.size() - sizeof(Header)) / sizeof(LevelRecord))
+            {
+                return {};
+            }
+
+            CompressedTexture texture;
+            texture.format  = format;
+            texture.is_srgb = header.is_srgb != 0;
+            texture.levels.resize(header.level_count);
+
+            for (std::size_t i{0}; i < texture.levels.size(); ++i)
+            {
+                LevelRecord record;
+                std::memcpy(&record,
+                            file.data() + sizeof(Header) + i * sizeof(LevelRecord),
+                            sizeof(LevelRecord));
+
+                auto blocks = std::size_t{(record.width + 3) / 4} *
+                              std::size_t{(record.height + 3) / 4};
+                if (record.width == 0 || record.height == 0 ||
+                    record.size != blocks * block_bytes(format) ||
+                    record.offset > file.size() ||
+                    record.size > file.size() - record.offset)
+                {
+                    return {};
+                }
+
+                auto& level  = texture.levels[i];
+                level.width  = static_cast<int>(record.width);
+                level.height = static_cast<int>(record.height);
+                level.blocks.assign(file.data() + record.offset,
+                                    file.data() + record.offset + record.size);
+            }
+
+            return texture;
+        }
+    } // namespace
+
+    std::size_t block_bytes(BlockFormat format)
+    {
+        return (format == BlockFormat::bc1 || format == BlockFormat::bc4) ? 8 : 16;
+    }
+
+    std::size_t CompressedTexture::size() const
+    {
+        std::size_t total{0};
+        for (auto const& level : levels)
+        {
+            total += level.blocks.size();
+        }
+        return total;
+    }
+
+    void encode_bc1_block(unsigned char const* rgba, unsigned char* block)
+    {
+        encode_colour(load_colours(rgba), block);
+    }
+
+    void encode_bc3_block(unsigned char const* rgba, unsigned char* block)
+    {
+        encode_channel(load_channel(rgba, 3), block);
+        encode_colour(load_colours(rgba), block + 8);
+    }
+
+    void encode_bc4_block(unsigned char const* rgba, unsigned char* block)
+    {
+        encode_channel(load_channel(rgba, 0), block);
+    }
+
+    void encode_bc5_block(unsigned char const* rgba, unsigned char* block)
+    {
+        encode_channel(load_channel(rgba, 0), block);
+        encode_channel(load_channel(rgba, 1), block + 8);
+    }
+
+    void decode_block(BlockFormat format, unsigned char const* block, unsigned char* rgba)
+    {
+        switch (format)
+        {
+        case BlockFormat::bc1:
+            decode_colour(block, false, rgba);
+            break;
+
+        case BlockFormat::bc3:
+            decode_colour(block + 8, true, rgba);
+            decode_channel(block, rgba, 3);
+            break;
+
+        case BlockFormat::bc4:
+        case BlockFormat::bc5:
+            for (std::size_t i{0}; i < 16; ++i)
+            {
+                rgba[4 * i + 1] = 0;
+                rgba[4 * i + 2] = 0;
+                rgba[4 * i + 3] = 255;
+            }
+
+            decode_channel(block, rgba, 0);
+            if (format == BlockFormat::bc5)
+            {
+                decode_channel(block + 8, rgba, 1);
+            }
+            break;
+        }
+    }
+
+    CompressedLevel compress_level(TextureLevel const& level,
+                                   int channels,
+                                   BlockFormat format,
+                                   jobs::JobSystem& system)
+    {
+        auto blocks_x = (level.width + 3) / 4;
+        auto blocks_y = (level.height + 3) / 4;
+        auto bytes    = block_bytes(format);
+
+        CompressedLevel compressed;
+        compressed.width  = level.width;
+        compressed.height = level.height;
+        compressed.blocks.resize(static_cast<std::size_t>(blocks_x) * blocks_y * bytes);
+
+        auto encode = [format]() {
+            switch (format)
+            {
+            case BlockFormat::bc1:
+                return &encode_bc1_block;
+            case BlockFormat::bc3:
+                return &encode_bc3_block;
+            case BlockFormat::bc4:
+                return &encode_bc4_block;
+            default:
+                return &encode_bc5_block;
+            }
+        }();
+
+        auto encode_rows = [&](std::size_t begin, std::size_t end) {
+            std::array<unsigned char, 64> rgba;
+            for (auto y = begin; y < end; ++y)
+            {
+                auto out = compressed.blocks.data() + y * blocks_x * bytes;
+                for (int x{0}; x < blocks_x; ++x, out += bytes)
+                {
+                    fetch_block(level, channels, x, static_cast<int>(y), rgba.data());
+                    encode(rgba.data(), out);
+                }
+            }
+        };
+        system.parallel_for(static_cast<std::size_t>(blocks_y), 0, encode_rows);
+
+        return compressed;
+    }
+
+    CompressedTexture compress_texture(TextureData const& texture,
+                                       BlockFormat format,
+                                       jobs::JobSystem& system)
+    {
+        CompressedTexture compressed;
+        compressed.format = format;
+        compressed.is_srgb =
+            texture.is_srgb && (format == BlockFormat::bc1 || format == BlockFormat::bc3);
+        compressed.levels.reserve(texture.levels.size());
+        for (auto const& level : texture.levels)
+        {
+            compressed.levels.push_back(
+                compress_level(level, texture.channels, format, system));
+        }
+        return compressed;
+    }
+
+    std::vector<unsigned char> decompress_level(CompressedLevel const& level,
+                                                BlockFormat format)
+    {
+        auto blocks_x = (level.width + 3) / 4;
+        auto blocks_y = (level.height + 3) / 4;
+        auto bytes    = block_bytes(format);
+
+        std::vector<unsigned char> pixels(static_cast<std::size_t>(level.width) *
+                                          level.height * 4);
+        std::array<unsigned char, 64> rgba;
+        for (int by{0}; by < blocks_y; ++by)
+        {
+            for (int bx{0}; bx < blocks_x; ++bx)
+            {
+                auto block = level.blocks.data() +
+                             (static_cast<std::size_t>(by) * blocks_x + bx) * bytes;
+                decode_block(format, block, rgba.data());
+
+                for (int y{0}; y < 4 && by * 4 + y < level.height; ++y)
+                {
+                    auto count = std::min(4, level.width - bx * 4);
+                    auto row   = static_cast<std::size_t>(by * 4 + y) * level.width;
+                    std::memcpy(pixels.data() + (row + bx * 4) * 4,
+                                rgba.data() + y * 16,
+                                static_cast<std::size_t>(count) * 4);
+                }
+            }
+        }
+
+        return pixels;
+    }
+
+    bool save_compressed_texture(CompressedTexture const& texture,
+                                 std::string const& filename,
+                                 std::uint64_t key)
+    {
+        Header header{};
+        header.magic       = magic;
+        header.version     = version;
+        header.byte_order  = byte_order;
+        header.format      = static_cast<std::uint32_t>(texture.format);
+        header.is_srgb     = texture.is_srgb ? 1 : 0;
+        header.key         = key;
+        header.level_count = texture.levels.size();
+
+        std::vector<LevelRecord> records;
+        std::uint64_t offset{sizeof(Header) +
+                             texture.levels.size() * sizeof(LevelRecord)};
+        for (auto const& level : texture.levels)
+        {
+            records.push_back({static_cast<std::uint32_t>(level.width),
+                               static_cast<std::uint32_t>(level.height),
+                               offset,
+                               level.blocks.size()});
+            offset += level.blocks.size();
+        }
+
+        std::ofstream stream{filename, std::ios::binary};
+        if (!stream)
+        {
+            fmt::print(stderr, "error: could not open file {} for writing\n", filename);
+            return false;
+        }
+
+        stream.write(reinterpret_cast<char const*>(&header), sizeof(Header));
+        stream.write(reinterpret_cast<char const*>(records.data()),
+                     static_cast<std::streamsize>(records.size() * sizeof(LevelRecord)));
+        for (auto const& level : texture.levels)
+        {
+            stream.write(reinterpret_cast<char const*>(level.blocks.data()),
+                         static_cast<std::streamsize>(level.blocks.size()));
+        }
+
+        if (!stream)
+        {
+            fmt::print(stderr, "error: could not write file {}\n", filename);
+            return false;
+        }
+
+        return true;
+    }
+
+    std::optional<CompressedTexture>
+    load_compressed_texture(std::string const& filename, std::optional<std::uint64_t> key)
+    {
+        auto texture = read_compressed_texture(filename, key);
+        if (!texture)
+        {
+            fmt::print(stderr, "error: {} is not a valid compressed texture\n", filename);
+        }
+        return texture;
+    }
+
+    std::optional<CompressedTexture>
+    load_texture_cached(std::string const& filename,
+                        BlockFormat format,
+                        jobs::JobSystem& system,
+                        std::string const& cache_directory,
+                        TextureSettings const& settings)
+    {
+        MappedFile file{filename};
+        if (!file.is_open())
+        {
+            fmt::print(stderr, "error: could not open file {}\n", filename);
+            return {};
+        }
+
+        // Anything that changes the compressed texture is part of the key.
+        auto key = hash_bytes(file.view(), 14695981039346656037ull);
+        std::array<std::uint32_t, 5> options{
+            static_cast<std::uint32_t>(format),
+            static_cast<std::uint32_t>(settings.channels),
+            settings.is_srgb,
+            settings.generate_mips,
+            settings.flip_vertically};
+        key = hash_bytes({reinterpret_cast<char const*>(options.data()), sizeof(options)},
+                         key);
+
+        auto directory = cache_directory.empty() ? fs::path{filename}.parent_path()
+                                                 : fs::path{cache_directory};
+        auto stem  = fs::path{filename}.stem().string();
+        auto cache = (directory / fmt::format("{}_{:016x}.atex", stem, key)).string();
+
+        std::error_code code;
+        if (fs::exists(cache, code))
+        {
+            if (auto texture = read_compressed_texture(cache, key); texture)
+            {
+                return texture;
+            }
+        }
+
+        auto data = load_texture(filename, system, settings);
+        if (!data)
+        {
+            return {};
+        }
+
+        auto texture = compress_texture(*data, format, system);
+        if (!cache_directory.empty())
+        {
+            fs::create_directories(cache_directory, code);
+        }
+
+        // Write under a temporary name first, so nobody can read an entry
+        // that is only partially written. Failing to cache the texture does
+        // not fail the load.
+        auto temp = cache + ".tmp";
+        if (save_compressed_texture(texture, temp, key))
+        {
+            fs::rename(temp, cache, code);
+            if (code)
+            {
+                fmt::print(stderr, "error: could not write file {}\n", cache);
+                fs::remove(temp, code);
+            }
+        }
+        return texture;
+    }
+} // namespace atlas::utils
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "texture_loader.hpp"
+
+#include <atlas/jobs/job_system.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace atlas::utils
+{
+    // Block compressed formats, numbered after their BCn name. BC1 and BC3
+    // hold colour, with BC1 ignoring alpha, and BC4 and BC5 hold one and two
+    // linear channels, which suits roughness and normal maps.
+    enum class BlockFormat
+    {
+        bc1 = 1,
+        bc3 = 3,
+        bc4 = 4,
+        bc5 = 5
+    };
+
+    // Bytes per 4x4 block.
+    std::size_t block_bytes(BlockFormat format);
+
+    struct CompressedLevel
+    {
+        int width{0};
+        int height{0};
+        std::vector<unsigned char> blocks;
+    };
+
+    struct CompressedTexture
+    {
+        BlockFormat format{BlockFormat::bc1};
+        bool is_srgb{true};
+        std::vector<CompressedLevel> levels;
+
+        std::size_t size() const;
+    };
+
+    // Encoders for a single block of 4x4 RGBA pixels, given row by row. BC4
+    // encodes the red channel and BC5 the red and green channels.
+    void encode_bc1_block(unsigned char const* rgba, unsigned char* block);
+    void encode_bc3_block(unsigned char const* rgba, unsigned char* block);
+    void encode_bc4_block(unsigned char const* rgba, unsigned char* block);
+    void encode_bc5_block(unsigned char const* rgba, unsigned char* block);
+
+    // Decodes a block to 4x4 RGBA pixels the way the GPU samples it. Missing
+    // channels are 0, or 255 for alpha.
+    void
+    decode_block(BlockFormat format, unsigned char const* block, unsigned char* rgba);
+
+    // Encodes a level with any number of channels. Rows of blocks are split
+    // across the job system, and the edge blocks of levels that are not a
+    // multiple of 4 repeat their last row and column.
+    CompressedLevel compress_level(TextureLevel const& level,
+                                   int channels,
+                                   BlockFormat format,
+                                   jobs::JobSystem& system);
+
+    CompressedTexture compress_texture(TextureData const& texture,
+                                       BlockFormat format,
+                                       jobs::JobSystem& system);
+
+    // Decodes a level back to RGBA pixels.
+    std::vector<unsigned char> decompress_level(CompressedLevel const& level,
+                                                BlockFormat format);
+
+    // Saves and loads the mip chain of a compressed texture, tagged with the
+    // key of its source.
+    bool save_compressed_texture(CompressedTexture const& texture,
+                                 std::string const& filename,
+                                 std::uint64_t key = 0);
+
+    std::optional<CompressedTexture>
+    load_compressed_texture(std::string const& filename,
+                            std::optional<std::uint64_t> key = {});
+
+    // Loads an image through a cache of compressed textures. Entries are
+    // keyed by a hash of the contents of the image and the settings, so a
+    // changed image is compressed again no matter its modification time.
+    // The cache lives next to the image unless a cache directory is given,
+    // which is created if needed. Stale entries are not removed.
+    std::optional<CompressedTexture>
+    load_texture_cached(std::string const& filename,
+                        BlockFormat format,
+                        jobs::JobSystem& system,
+                        std::string const& cache_directory = {},
+                        TextureSettings const& settings    = {});
+} // namespace atlas::utils
@@ -0,0 +1,313 @@
+#include "texture_loader.hpp"
+
+#include <stb_image.h>
+#include <stb_image_resize.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fmt/printf.h>
+#include <utility>
+
+namespace atlas::utils
+{
+    namespace
+    {
+        std::string normalise_path(std::string const& path)
+        {
+            return std::filesystem::path{path}.lexically_normal().generic_string();
+        }
+
+        void flip_rows(TextureLevel& level, int channels)
+        {
+            auto row = static_cast<std::size_t>(level.width) * channels;
+            std::vector<unsigned char> scratch(row);
+            for (int y{0}; y < level.height / 2; ++y)
+            {
+                auto top    = level.pixels.data() + y * row;
+                auto bottom = level.pixels.data() + (level.height - 1 - y) * row;
+                std::memcpy(scratch.data(), top, row);
+                std::memcpy(top, bottom, row);
+                std::memcpy(bottom, scratch.data(), row);
+            }
+        }
+
+        // Resizes rows [begin, end) of next from previous. Shifting the
+        // output by the first row keeps every row identical to a resize of
+        // the whole level.
+        void resize_rows(TextureLevel const& previous,
+                         TextureLevel& next,
+                         int channels,
+                         bool is_srgb,
+                         std::size_t begin,
+                         std::size_t end)
+        {
+            auto row        = static_cast<std::size_t>(next.width) * channels;
+            auto x_scale    = static_cast<float>(next.width) / previous.width;
+            auto y_scale    = static_cast<float>(next.height) / previous.height;
+            auto alpha      = (channels == 4) ? 3 : STBIR_ALPHA_CHANNEL_NONE;
+            auto colorspace = is_srgb ? STBIR_COLORSPACE_SRGB : STBIR_COLORSPACE_LINEAR;
+
+            stbir_resize_subpixel(previous.pixels.data(),
+                                  previous.width,
+                                  previous.height,
+                                  0,
+                                  next.pixels.data() + begin * row,
+                                  next.width,
+                                  static_cast<int>(end - begin),
+                                  0,
+                                  STBIR_TYPE_UINT8,
+                                  channels,
+                                  alpha,
+                                  0,
+                                  STBIR_EDGE_CLAMP,
+                                  STBIR_EDGE_CLAMP,
+                                  STBIR_FILTER_DEFAULT,
+                                  STBIR_FILTER_DEFAULT,
+                                  colorspace,
+                                  nullptr,
+                                  x_scale,
+                                  y_scale,
+                                  0.0f,
+                                  static_cast<float>(begin));
+        }
+
+        std::optional<TextureData> decode_texture(std::string const& filename,
+                                                  TextureSettings const& settings,
+                                                  jobs::JobSystem& system)
+        {
+            int width{0};
+            int height{0};
+            int file_channels{0};
+            auto pixels = stbi_load(
+                filename.c_str(), &width, &height, &file_channels, settings.channels);
+            if (pixels == nullptr)
+            {
+                fmt::print(stderr, "error: could not load texture {}\n", filename);
+                return {};
+            }
+
+            TextureData data;
+            data.path     = filename;
+            data.channels = (settings.channels == 0) ? file_channels : settings.channels;
+            data.is_srgb  = settings.is_srgb;
+
+            TextureLevel base;
+            base.width  = width;
+            base.height = height;
+            base.pixels.assign(pixels,
+                               pixels + static_cast<std::size_t>(width) * height *
+                                            data.channels);
+            stbi_image_free(pixels);
+
+            if (settings.flip_vertically)
+            {
+                flip_rows(base, data.channels);
+            }
+
+            if (settings.generate_mips)
+            {
+                data.levels = generate_mips(
+                    base, data.channels, data.is_srgb, system, settings.mip_rows_per_job);
+            }
+            else
+            {
+                data.levels.push_back(std::move(base));
+            }
+
+            return data;
+        }
+    } // namespace
+
+    std::size_t mip_count(int width, int height)
+    {
+        std::size_t count{1};
+        while (width > 1 || height > 1)
+        {
+            width  = std::max(1, width / 2);
+            height = std::max(1, height / 2);
+            ++count;
+        }
+        return count;
+    }
+
+    std::vector<TextureLevel> generate_mips(TextureLevel const& base,
+                                            int channels,
+                                            bool is_srgb,
+                                            jobs::JobSystem& system,
+                                            std::size_t rows_per_job)
+    {
+        std::vector<TextureLevel> levels;
+        levels.reserve(mip_count(base.width, base.height));
+        levels.push_back(base);
+
+        // Every level depends on the one above it, so the parallelism is
+        // within each level.
+        while (levels.back().width > 1 || levels.back().height > 1)
+        {
+            auto const& previous = levels.back();
+
+            TextureLevel next;
+            next.width  = std::max(1, previous.width / 2);
+            next.height = std::max(1, previous.height / 2);
+            next.pixels.resize(static_cast<std::size_t>(next.width) * next.height *
+                               channels);
+
+            system.parallel_for(static_cast<std::size_t>(next.height),
+                                std::max<std::size_t>(rows_per_job, 1),
+                                [&](std::size_t begin, std::size_t end) {
+                                    resize_rows(
+                                        previous, next, channels, is_srgb, begin, end);
+                                });
+            levels.push_back(std::move(next));
+        }
+
+        return levels;
+    }
+
+    std::optional<TextureData> load_texture(std::string const& filename,
+                                            jobs::JobSystem& system,
+                                            TextureSettings const& settings)
+    {
+        return decode_texture(filename, settings, system);
+    }
+
+    TextureLoader::TextureLoader(jobs::JobSystem& system, TextureSettings settings) :
+        m_settings{settings},
+        m_system{&system}
+    {}
+
+    TextureLoader::~TextureLoader()
+    {
+        std::vector<jobs::JobHandle> outstanding;
+        {
+            std::scoped_lock lock{m_mutex};
+            outstanding.swap(m_jobs);
+        }
+
+        for (auto const& job : outstanding)
+        {
+            m_system->wait(job);
+        }
+    }
+
+    TextureHandle TextureLoader::request(std::string const& path)
+    {
+        return request(path, m_settings.is_srgb);
+    }
+
+    TextureHandle TextureLoader::request(std::string const& path, bool is_srgb)
+    {
+        auto key = normalise_path(path);
+
+        TextureHandle handle;
+        {
+            std::scoped_lock lock{m_mutex};
+            auto& paths = is_srgb ? m_srgb_paths : m_linear_paths;
+            if (auto it = paths.find(key); it != paths.end())
+            {
+                return it->second;
+            }
+
+            handle = m_entries.size();
+            m_entries.emplace_back();
+            paths.emplace(key, handle);
+            ++m_pending;
+        }
+
+        auto settings    = m_settings;
+        settings.is_srgb = is_srgb;
+        auto job = m_system->submit([this, handle, key, settings]() {
+            auto data = decode_texture(key, settings, *m_system);
+
+            std::scoped_lock lock{m_mutex};
+            auto& entry = m_entries[handle];
+            if (data)
+            {
+                entry.status = TextureStatus::ready;
+                entry.data   = std::make_shared<TextureData const>(std::move(*data));
+            }
+            else
+            {
+                entry.status = TextureStatus::failed;
+            }
+            m_ready.push_back(handle);
+            --m_pending;
+        });
+
+        {
+            std::scoped_lock lock{m_mutex};
+            std::erase_if(m_jobs, [](jobs::JobHandle const& running) {
+                return running.done();
+            });
+            m_jobs.push_back(std::move(job));
+        }
+
+        return handle;
+    }
+
+    std::vector<MaterialTextures>
+    TextureLoader::request_materials(std::vector<tinyobj::material_t> const& materials,
+                                     std::string const& texture_path)
+    {
+        auto load = [this, &texture_path](std::string const& name,
+                                          bool is_srgb) -> std::optional<TextureHandle> {
+            if (name.empty())
+            {
+                return {};
+            }
+
+            auto path = std::filesystem::path{texture_path} / name;
+            return request(path.string(), is_srgb);
+        };
+
+        std::vector<MaterialTextures> textures;
+        textures.reserve(materials.size());
+        for (auto const& material : materials)
+        {
+            auto const& normal = material.normal_texname.empty()
+                                     ? material.bump_texname
+                                     : material.normal_texname;
+
+            MaterialTextures entry;
+            entry.diffuse  = load(material.diffuse_texname, true);
+            entry.specular = load(material.specular_texname, true);
+            entry.emissive = load(material.emissive_texname, true);
+            entry.normal   = load(normal, false);
+            entry.alpha    = load(material.alpha_texname, false);
+            textures.push_back(entry);
+        }
+
+        return textures;
+    }
+
+    std::vector<TextureHandle> TextureLoader::take_ready()
+    {
+        std::scoped_lock lock{m_mutex};
+        return std::exchange(m_ready, {});
+    }
+
+    TextureStatus TextureLoader::status(TextureHandle handle) const
+    {
+        std::scoped_lock lock{m_mutex};
+        return m_entries[handle].status;
+    }
+
+    std::shared_ptr<TextureData const> TextureLoader::data(TextureHandle handle) const
+    {
+        std::scoped_lock lock{m_mutex};
+        return m_entries[handle].data;
+    }
+
+    void TextureLoader::release(TextureHandle handle)
+    {
+        std::scoped_lock lock{m_mutex};
+        m_entries[handle].data.reset();
+    }
+
+    std::size_t TextureLoader::pending() const
+    {
+        std::scoped_lock lock{m_mutex};
+        return m_pending;
+    }
+} // namespace atlas::utils
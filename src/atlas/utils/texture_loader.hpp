@@ -0,0 +1,156 @@
+#pragma once
+
+#include "load_obj_file.hpp"
+
+#include <atlas/jobs/job_system.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace atlas::utils
+{
+    struct TextureLevel
+    {
+        int width{0};
+        int height{0};
+        std::vector<unsigned char> pixels;
+    };
+
+    // Decoded 8-bit image with its mip chain. Level 0 is the full image and
+    // every level is tightly packed, with channels bytes per pixel.
+    struct TextureData
+    {
+        std::string path;
+        int channels{0};
+        bool is_srgb{true};
+        std::vector<TextureLevel> levels;
+    };
+
+    struct TextureSettings
+    {
+        // Number of channels to convert every image to, or 0 to keep the
+        // channels of the file.
+        int channels{4};
+
+        // Colour textures should be filtered in sRGB space. Turn this off for
+        // normal maps and other data textures.
+        bool is_srgb{true};
+        bool generate_mips{true};
+
+        // OpenGL expects the first row to be the bottom of the image.
+        bool flip_vertically{true};
+
+        // Rows per job when resizing a single mip level.
+        std::size_t mip_rows_per_job{64};
+    };
+
+    // Number of levels in a full mip chain, down to 1x1.
+    std::size_t mip_count(int width, int height);
+
+    // Resizes base down to every level of its mip chain, each from the one
+    // above it. The rows of every level are split across the job system, and
+    // the result is the same as resizing each level in one call.
+    std::vector<TextureLevel> generate_mips(TextureLevel const& base,
+                                            int channels,
+                                            bool is_srgb,
+                                            jobs::JobSystem& system,
+                                            std::size_t rows_per_job = 64);
+
+    // Decodes an image and builds its mip chain on the job system.
+    std::optional<TextureData> load_texture(std::string const& filename,
+                                            jobs::JobSystem& system,
+                                            TextureSettings const& settings = {});
+
+    enum class TextureStatus
+    {
+        loading,
+        ready,
+        failed
+    };
+
+    using TextureHandle = std::size_t;
+
+    struct MaterialTextures
+    {
+        std::optional<TextureHandle> diffuse;
+        std::optional<TextureHandle> specular;
+        std::optional<TextureHandle> emissive;
+        std::optional<TextureHandle> normal;
+        std::optional<TextureHandle> alpha;
+    };
+
+    // Loads textures on worker threads so the render loop never waits on a
+    // decode. Each request is decoded and has its mips built by the job
+    // system, and finished textures are collected with take_ready once per
+    // frame, ready to be handed to glx::TextureUploader.
+    //
+    // Requests are deduplicated by path, so a texture shared by several
+    // materials is only decoded once and every request for it gets the same
+    // handle. Destroying the loader waits for the textures still decoding.
+    //
+    // The job system must outlive the loader. Textures only decode in the
+    // background on its workers, so it needs more than one thread unless
+    // the owner waits on it.
+    class TextureLoader
+    {
+    public:
+        explicit TextureLoader(jobs::JobSystem& system, TextureSettings settings = {});
+        ~TextureLoader();
+
+        TextureLoader(TextureLoader const&)            = delete;
+        TextureLoader& operator=(TextureLoader const&) = delete;
+
+        // Requests a texture in the colour space of the settings. Asking for
+        // the same file in both colour spaces loads it twice.
+        TextureHandle request(std::string const& path);
+        TextureHandle request(std::string const& path, bool is_srgb);
+
+        // Requests the textures referenced by each material, relative to
+        // texture_path. Colour maps are loaded as sRGB and normal (or bump)
+        // and alpha maps as linear.
+        std::vector<MaterialTextures>
+        request_materials(std::vector<tinyobj::material_t> const& materials,
+                          std::string const& texture_path = {});
+
+        // Moves out the handles that finished loading since the last call,
+        // including the ones that failed. Never blocks on the workers.
+        std::vector<TextureHandle> take_ready();
+
+        TextureStatus status(TextureHandle handle) const;
+
+        // Decoded image of a ready texture, or null otherwise.
+        std::shared_ptr<TextureData const> data(TextureHandle handle) const;
+
+        // Drops the pixels of a ready texture once they have been uploaded.
+        // Its status is unchanged.
+        void release(TextureHandle handle);
+
+        // Number of requests that are still decoding.
+        std::size_t pending() const;
+
+    private:
+        struct Entry
+        {
+            TextureStatus status{TextureStatus::loading};
+            std::shared_ptr<TextureData const> data;
+        };
+
+        TextureSettings m_settings;
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, TextureHandle> m_srgb_paths;
+        std::unordered_map<std::string, TextureHandle> m_linear_paths;
+        std::vector<Entry> m_entries;
+        std::vector<TextureHandle> m_ready;
+        std::size_t m_pending{0};
+
+        // Jobs that may still be running, waited on by the destructor.
+        std::vector<jobs::JobHandle> m_jobs;
+        jobs::JobSystem* m_system;
+    };
+} // namespace atlas::utils
@@ -0,0 +1,238 @@
+#include "vertex_streams.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+namespace atlas::utils
+{
+    namespace
+    {
+        glm::vec2 sign_not_zero(glm::vec2 const& v)
+        {
+            return {(v.x >= 0.0f) ? 1.0f : -1.0f, (v.y >= 0.0f) ? 1.0f : -1.0f};
+        }
+
+        template<typename T>
+        void write(std::byte* data, T const& value)
+        {
+            std::memcpy(data, &value, sizeof(T));
+        }
+
+        ComponentType normal_type(NormalEncoding encoding)
+        {
+            switch (encoding)
+            {
+            case NormalEncoding::octahedral:
+                return ComponentType::snorm16;
+
+            case NormalEncoding::snorm_2_10_10_10:
+                return ComponentType::snorm_2_10_10_10;
+
+            default:
+                return ComponentType::float32;
+            }
+        }
+
+        std::uint32_t normal_components(NormalEncoding encoding)
+        {
+            switch (encoding)
+            {
+            case NormalEncoding::octahedral:
+                return 2;
+
+            case NormalEncoding::snorm_2_10_10_10:
+                return 4;
+
+            default:
+                return 3;
+            }
+        }
+    } // namespace
+
+    std::uint32_t attribute_size(ComponentType type, std::uint32_t components)
+    {
+        switch (type)
+        {
+        case ComponentType::float16:
+        case ComponentType::snorm16:
+            return 2 * components;
+
+        case ComponentType::snorm_2_10_10_10:
+            return 4;
+
+        default:
+            return 4 * components;
+        }
+    }
+
+    std::uint32_t encode_octahedral(glm::vec3 const& normal)
+    {
+        // A zero normal has no direction and would divide into NaN, so it
+        // is stored as +z. The comparison also catches NaN components.
+        auto length = glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z);
+        if (!(length > 0.0f))
+        {
+            return glm::packSnorm2x16(glm::vec2{0.0f});
+        }
+
+        auto n = normal / length;
+
+        glm::vec2 p{n.x, n.y};
+        if (n.z < 0.0f)
+        {
+            p = (1.0f - glm::abs(glm::vec2{p.y, p.x})) * sign_not_zero(p);
+        }
+
+        return glm::packSnorm2x16(p);
+    }
+
+    glm::vec3 decode_octahedral(std::uint32_t packed)
+    {
+        auto p = glm::unpackSnorm2x16(packed);
+
+        glm::vec3 n{p.x, p.y, 1.0f - glm::abs(p.x) - glm::abs(p.y)};
+        if (n.z < 0.0f)
+        {
+            auto xy = (1.0f - glm::abs(glm::vec2{n.y, n.x})) * sign_not_zero(p);
+            n.x     = xy.x;
+            n.y     = xy.y;
+        }
+
+        return glm::normalize(n);
+    }
+
+    std::uint32_t encode_snorm_2_10_10_10(glm::vec3 const& normal)
+    {
+        return glm::packSnorm3x10_1x2(glm::vec4{normal, 0.0f});
+    }
+
+    glm::vec3 decode_snorm_2_10_10_10(std::uint32_t packed)
+    {
+        return glm::vec3{glm::unpackSnorm3x10_1x2(packed)};
+    }
+
+    PackedShape pack_shape(Shape const& shape, VertexStreamSettings const& settings)
+    {
+        // Indices are narrowed to 32 bits below.
+        assert(static_cast<std::uint64_t>(shape.vertices.size()) <=
+               (std::uint64_t{1} << 32));
+
+        PackedShape packed;
+        packed.vertex_count = shape.vertices.size();
+
+        auto& format = packed.format;
+        auto add     = [&](VertexAttribute attribute,
+                       ComponentType type,
+                       std::uint32_t components,
+                       bool normalised) {
+            std::uint32_t stream{0};
+            if (settings.layout == StreamLayout::split || format.strides.empty())
+            {
+                stream = static_cast<std::uint32_t>(format.strides.size());
+                format.strides.push_back(0);
+            }
+
+            auto& stride = format.strides[stream];
+            format.attributes.push_back(
+                {attribute, type, components, normalised, stream, stride});
+            stride += attribute_size(type, components);
+        };
+
+        add(VertexAttribute::position, ComponentType::float32, 3, false);
+        if (shape.has_normals)
+        {
+            add(VertexAttribute::normal,
+                normal_type(settings.normals),
+                normal_components(settings.normals),
+                settings.normals != NormalEncoding::float32);
+        }
+
+        if (shape.has_texture_coords)
+        {
+            auto type = (settings.tex_coords == TexCoordEncoding::float16)
+                            ? ComponentType::float16
+                            : ComponentType::float32;
+            add(VertexAttribute::tex_coord, type, 2, false);
+        }
+
+        packed.streams.resize(format.strides.size());
+        for (std::size_t i{0}; i < packed.streams.size(); ++i)
+        {
+            packed.streams[i].resize(format.strides[i] * packed.vertex_count);
+        }
+
+        for (auto const& attribute : format.attributes)
+        {
+            auto stride = format.strides[attribute.stream];
+            auto data   = packed.streams[attribute.stream].data() + attribute.offset;
+            for (auto const& vertex : shape.vertices)
+            {
+                switch (attribute.attribute)
+                {
+                case VertexAttribute::position:
+                    write(data, vertex.position);
+                    break;
+
+                case VertexAttribute::normal:
+                    if (settings.normals == NormalEncoding::octahedral)
+                    {
+                        write(data, encode_octahedral(vertex.normal));
+                    }
+                    else if (settings.normals == NormalEncoding::snorm_2_10_10_10)
+                    {
+                        write(data, encode_snorm_2_10_10_10(vertex.normal));
+                    }
+                    else
+                    {
+                        write(data, vertex.normal);
+                    }
+                    break;
+
+                case VertexAttribute::tex_coord:
+                    if (settings.tex_coords == TexCoordEncoding::float16)
+                    {
+                        write(data, glm::packHalf2x16(vertex.tex_coord));
+                    }
+                    else
+                    {
+                        write(data, vertex.tex_coord);
+                    }
+                    break;
+                }
+
+                data += stride;
+            }
+        }
+
+        // Index 0xFFFF is left out so it stays free for primitive restart.
+        packed.index_count = shape.indices.size();
+        if (settings.allow_16bit_indices &&
+            packed.vertex_count < std::numeric_limits<std::uint16_t>::max())
+        {
+            packed.index_type = IndexType::uint16;
+            packed.indices.resize(packed.index_count * sizeof(std::uint16_t));
+            auto data = packed.indices.data();
+            for (auto index : shape.indices)
+            {
+                write(data, static_cast<std::uint16_t>(index));
+                data += sizeof(std::uint16_t);
+            }
+        }
+        else
+        {
+            packed.index_type = IndexType::uint32;
+            packed.indices.resize(packed.index_count * sizeof(std::uint32_t));
+            auto data = packed.indices.data();
+            for (auto index : shape.indices)
+            {
+                write(data, static_cast<std::uint32_t>(index));
+                data += sizeof(std::uint32_t);
+            }
+        }
+
+        return packed;
+    }
+} // namespace atlas::utils
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "load_obj_file.hpp"
+
+#include <atlas/math/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace atlas::utils
+{
+    enum class VertexAttribute
+    {
+        position,
+        normal,
+        tex_coord
+    };
+
+    // How the components of an attribute are stored. These map directly to
+    // the vertex formats of the graphics APIs:
+    // * float32: GL_FLOAT.
+    // * float16: GL_HALF_FLOAT.
+    // * snorm16: GL_SHORT, normalised.
+    // * snorm_2_10_10_10: GL_INT_2_10_10_10_REV, normalised, with x in the
+    //   lowest bits.
+    enum class ComponentType
+    {
+        float32,
+        float16,
+        snorm16,
+        snorm_2_10_10_10
+    };
+
+    enum class NormalEncoding
+    {
+        float32,
+
+        // Two 16-bit components holding the normal mapped onto an octahedron,
+        // see decode_octahedral.
+        octahedral,
+
+        // x, y and z as 10-bit signed normalised values, stored as
+        // ComponentType::snorm_2_10_10_10. The 2-bit w component is 0.
+        snorm_2_10_10_10
+    };
+
+    enum class TexCoordEncoding
+    {
+        float32,
+        float16
+    };
+
+    enum class StreamLayout
+    {
+        // One stream with every attribute of a vertex next to each other.
+        interleaved,
+
+        // One stream per attribute, so passes that only need positions (such
+        // as depth or shadow passes) do not fetch the rest.
+        split
+    };
+
+    enum class IndexType
+    {
+        uint16,
+        uint32
+    };
+
+    struct AttributeFormat
+    {
+        VertexAttribute attribute;
+        ComponentType type;
+        std::uint32_t components;
+        bool normalised;
+
+        // Stream the attribute is read from, and its byte offset within a
+        // vertex of that stream.
+        std::uint32_t stream;
+        std::uint32_t offset;
+    };
+
+    struct VertexFormat
+    {
+        std::vector<AttributeFormat> attributes;
+
+        // Size in bytes of a vertex in each stream.
+        std::vector<std::uint32_t> strides;
+    };
+
+    struct VertexStreamSettings
+    {
+        StreamLayout layout{StreamLayout::interleaved};
+        NormalEncoding normals{NormalEncoding::octahedral};
+        TexCoordEncoding tex_coords{TexCoordEncoding::float16};
+
+        // Use 16-bit indices when every vertex can be addressed with them.
+        bool allow_16bit_indices{true};
+    };
+
+    // Vertex and index buffers for a shape, ready to be uploaded as they are.
+    // Normals and texture coordinates are only stored if the shape has them.
+    struct PackedShape
+    {
+        VertexFormat format;
+        std::vector<std::vector<std::byte>> streams;
+        std::size_t vertex_count{0};
+
+        IndexType index_type{IndexType::uint32};
+        std::vector<std::byte> indices;
+        std::size_t index_count{0};
+    };
+
+    // The shape must have at most 2^32 vertices so every index fits in 32 bits.
+    PackedShape pack_shape(Shape const& shape, VertexStreamSettings const& settings = {});
+
+    // Size in bytes of an attribute.
+    std::uint32_t attribute_size(ComponentType type, std::uint32_t components);
+
+    // Octahedral normal encoding from "A Survey of Efficient Representations
+    // for Independent Unit Vectors" (Cigolle et al., 2014). The packed value
+    // holds x in the low 16 bits and y in the high 16 bits, as snorm16.
+    // Decoding in a shader is:
+    //     vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    //     if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * sign_not_zero(n.xy);
+    //     n = normalize(n);
+    // A zero normal is encoded as +z.
+    std::uint32_t encode_octahedral(glm::vec3 const& normal);
+    glm::vec3 decode_octahedral(std::uint32_t packed);
+
+    std::uint32_t encode_snorm_2_10_10_10(glm::vec3 const& normal);
+    glm::vec3 decode_snorm_2_10_10_10(std::uint32_t packed);
+} // namespace atlas::utils
@@ -0,0 +1,115 @@
+#include <atlas/glx/capture.hpp>
+#include <atlas/glx/context.hpp>
+#include <atlas/glx/texture.hpp>
+
+#include <fmt/printf.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <vector>
+
+#if defined(ATLAS_BUILD_GL_TESTS)
+static void error_callback(int code, char const* message)
+{
+    fmt::print("error ({}):{}\n", code, message);
+}
+
+using namespace atlas::glx;
+
+TEST_CASE("[capture] - FramebufferCapture", "[glx]")
+{
+    REQUIRE(initialize_glfw(error_callback));
+
+    WindowSettings settings;
+    auto window = create_glfw_window(settings);
+    REQUIRE(window != nullptr);
+    glfwMakeContextCurrent(window);
+    REQUIRE(create_gl_context(window, settings.version));
+
+    {
+        // Render into a texture, since the contents of the default
+        // framebuffer of a hidden window are undefined.
+        auto texture = create_texture_2d(16, 8, 1, GL_RGBA32F);
+        GLuint framebuffer;
+        glCreateFramebuffers(1, &framebuffer);
+        glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT0, texture, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+        auto clear = [](float r, float g, float b) {
+            glClearColor(r, g, b, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+        };
+
+        SECTION("Ring")
+        {
+            FramebufferCapture capture{2};
+
+            clear(1.0f, 0.0f, 0.0f);
+            REQUIRE(capture.capture(0, 0, 16, 8) == 0);
+            clear(0.0f, 1.0f, 0.0f);
+            REQUIRE(capture.capture(2, 2, 4, 3, CaptureFormat::rgba8) == 1);
+
+            // Both buffers are in flight, so the next capture is dropped.
+            REQUIRE_FALSE(capture.capture(0, 0, 16, 8).has_value());
+            REQUIRE(capture.dropped() == 1);
+            REQUIRE(capture.pending() == 2);
+
+            std::vector<CapturedFrame> frames;
+            while (capture.pending() != 0)
+            {
+                for (auto& frame : capture.update())
+                {
+                    frames.push_back(std::move(frame));
+                }
+                glFinish();
+            }
+
+            REQUIRE(frames.size() == 2);
+            REQUIRE(frames[0].id == 0);
+            REQUIRE(frames[0].channels == 3);
+            REQUIRE(frames[0].pixels.size() == 16 * 8 * 3);
+            REQUIRE(frames[0].pixels[0] == 255);
+            REQUIRE(frames[0].pixels[1] == 0);
+
+            REQUIRE(frames[1].id == 1);
+            REQUIRE(frames[1].width == 4);
+            REQUIRE(frames[1].height == 3);
+            REQUIRE(frames[1].pixels.size() == 4 * 3 * 4);
+            REQUIRE(frames[1].pixels[0] == 0);
+            REQUIRE(frames[1].pixels[1] == 255);
+            REQUIRE(frames[1].pixels[3] == 255);
+
+            // The ring is free again.
+            REQUIRE(capture.capture(0, 0, 16, 8) == 2);
+            REQUIRE(capture.flush().size() == 1);
+        }
+
+        SECTION("Float")
+        {
+            FramebufferCapture capture;
+
+            clear(2.5f, 0.25f, 0.0f);
+            REQUIRE(capture.capture(0, 0, 16, 8, CaptureFormat::rgb32f).has_value());
+
+            auto frames = capture.flush();
+            REQUIRE(frames.size() == 1);
+            REQUIRE(frames[0].is_float);
+            REQUIRE(frames[0].pixels.size() == 16 * 8 * 3 * sizeof(float));
+
+            float pixel[3];
+            std::memcpy(pixel, frames[0].pixels.data(), sizeof(pixel));
+            REQUIRE(pixel[0] == 2.5f);
+            REQUIRE(pixel[1] == 0.25f);
+            REQUIRE(capture.pending() == 0);
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteTextures(1, &texture);
+    }
+
+    destroy_glfw_window(window);
+    terminate_glfw();
+}
+#endif
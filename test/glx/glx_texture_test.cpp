@@ -0,0 +1,158 @@
+#include <atlas/glx/context.hpp>
+#include <atlas/glx/texture.hpp>
+
+#include <fmt/printf.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <vector>
+
+#if defined(ATLAS_BUILD_GL_TESTS)
+static void error_callback(int code, char const* message)
+{
+    fmt::print("error ({}):{}\n", code, message);
+}
+
+using namespace atlas::glx;
+
+static std::vector<unsigned char> make_pixels(std::size_t size, unsigned char seed)
+{
+    std::vector<unsigned char> pixels(size);
+    for (std::size_t i{0}; i < size; ++i)
+    {
+        pixels[i] = static_cast<unsigned char>(i * 7 + seed);
+    }
+    return pixels;
+}
+
+TEST_CASE("[texture] - pixel_format", "[glx]")
+{
+    REQUIRE(pixel_format(1, true).format == GL_RED);
+    REQUIRE(pixel_format(3, true).internal_format == GL_SRGB8);
+    REQUIRE(pixel_format(3, false).internal_format == GL_RGB8);
+    REQUIRE(pixel_format(4, true).internal_format == GL_SRGB8_ALPHA8);
+    REQUIRE(pixel_format(4, false).format == GL_RGBA);
+
+    REQUIRE(compressed_format(1, false) != compressed_format(1, true));
+    REQUIRE(compressed_format(3, false) != compressed_format(3, true));
+    REQUIRE(compressed_format(4, true) == GL_COMPRESSED_RED_RGTC1);
+}
+
+TEST_CASE("[texture] - create_compressed_texture_2d", "[glx]")
+{
+    REQUIRE(initialize_glfw(error_callback));
+
+    WindowSettings settings;
+    auto window = create_glfw_window(settings);
+    REQUIRE(window != nullptr);
+    glfwMakeContextCurrent(window);
+    REQUIRE(create_gl_context(window, settings.version));
+
+    {
+        // BC5 blocks are 16 bytes, and a 6x5 level takes 2x2 of them.
+        auto base   = make_pixels(4 * 16, 3);
+        auto second = make_pixels(16, 4);
+        auto format = compressed_format(5, true);
+        REQUIRE(format == GL_COMPRESSED_RG_RGTC2);
+
+        auto texture = create_compressed_texture_2d(
+            format,
+            {{6, 5, base.data(), static_cast<GLsizei>(base.size())},
+             {3, 2, second.data(), static_cast<GLsizei>(second.size())}});
+        REQUIRE(texture != 0);
+
+        GLint compressed;
+        glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_COMPRESSED, &compressed);
+        REQUIRE(compressed == GL_TRUE);
+
+        std::vector<unsigned char> result(base.size());
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glGetCompressedTextureImage(
+            texture, 0, static_cast<GLsizei>(result.size()), result.data());
+        REQUIRE(result == base);
+
+        result.resize(second.size());
+        glGetCompressedTextureImage(
+            texture, 1, static_cast<GLsizei>(result.size()), result.data());
+        REQUIRE(result == second);
+
+        glDeleteTextures(1, &texture);
+    }
+
+    destroy_glfw_window(window);
+    terminate_glfw();
+}
+
+TEST_CASE("[texture] - TextureUploader", "[glx]")
+{
+    REQUIRE(initialize_glfw(error_callback));
+
+    WindowSettings settings;
+    auto window = create_glfw_window(settings);
+    REQUIRE(window != nullptr);
+    glfwMakeContextCurrent(window);
+    REQUIRE(create_gl_context(window, settings.version));
+
+    {
+        // The buffers are smaller than the larger levels, so they are split
+        // across several updates, and a row of the RGBA texture does not fit
+        // at all.
+        TextureUploader uploader{256, 2};
+
+        using Pixels = std::vector<unsigned char>;
+        auto rgb  = std::make_shared<Pixels>(make_pixels(37 * 23 * 3 + 18 * 11 * 3, 1));
+        auto rgba = std::make_shared<Pixels>(make_pixels(100 * 2 * 4, 2));
+
+        auto rgb_format  = pixel_format(3, false).internal_format;
+        auto rgba_format = pixel_format(4, false).internal_format;
+        auto first       = create_texture_2d(37, 23, 2, rgb_format);
+        auto second      = create_texture_2d(100, 2, 1, rgba_format);
+
+        uploader.queue(first,
+                       3,
+                       {{37, 23, rgb->data()}, {18, 11, rgb->data() + 37 * 23 * 3}},
+                       rgb);
+        uploader.queue(second, 4, {{100, 2, rgba->data()}}, rgba);
+        REQUIRE(uploader.pending() == 2);
+
+        std::vector<GLuint> finished;
+        std::size_t frames{0};
+        while (uploader.pending() != 0)
+        {
+            for (auto texture : uploader.update())
+            {
+                finished.push_back(texture);
+            }
+            glFinish();
+            ++frames;
+        }
+
+        REQUIRE(finished == std::vector<GLuint>{first, second});
+        REQUIRE(frames > 2);
+
+        std::vector<unsigned char> result(rgb->size());
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glGetTextureImage(
+            first, 0, GL_RGB, GL_UNSIGNED_BYTE, 37 * 23 * 3, result.data());
+        glGetTextureImage(first,
+                          1,
+                          GL_RGB,
+                          GL_UNSIGNED_BYTE,
+                          18 * 11 * 3,
+                          result.data() + 37 * 23 * 3);
+        REQUIRE(result == *rgb);
+
+        result.resize(rgba->size());
+        glGetTextureImage(
+            second, 0, GL_RGBA, GL_UNSIGNED_BYTE, 100 * 2 * 4, result.data());
+        REQUIRE(result == *rgba);
+
+        glDeleteTextures(1, &first);
+        glDeleteTextures(1, &second);
+    }
+
+    destroy_glfw_window(window);
+    terminate_glfw();
+}
+#endif
@@ -0,0 +1,157 @@
+#include <atlas/glx/context.hpp>
+#include <atlas/glx/vertex_layout.hpp>
+#include <atlas/math/glm.hpp>
+
+#include <fmt/printf.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+using namespace atlas::glx;
+
+namespace
+{
+    struct Vertex
+    {
+        glm::vec3 position;
+        glm::vec2 uv;
+        std::array<GLubyte, 4> colour;
+        std::int32_t id;
+    };
+
+    struct WideVertex
+    {
+        glm::vec3 position;
+        glm::vec2 uv;
+        std::array<GLubyte, 4> colour;
+        std::int32_t id;
+        float unused[4];
+    };
+
+    template<typename T>
+    constexpr auto make_layout()
+    {
+        return make_vertex_layout<T>(
+            vertex_attribute<decltype(T::position)>(0, offsetof(T, position)),
+            vertex_attribute<decltype(T::uv)>(1, offsetof(T, uv)),
+            vertex_attribute<decltype(T::colour)>(
+                2, offsetof(T, colour), AttributeKind::normalised),
+            vertex_attribute<decltype(T::id)>(3, offsetof(T, id)));
+    }
+
+    constexpr auto layout = make_layout<Vertex>();
+} // namespace
+
+TEST_CASE("[vertex_layout] - make_vertex_layout", "[glx]")
+{
+    STATIC_REQUIRE(layout.is_valid());
+    STATIC_REQUIRE(layout.attributes.size() == 4);
+    STATIC_REQUIRE(layout.stride == sizeof(Vertex));
+
+    STATIC_REQUIRE(layout.attributes[0].components == 3);
+    STATIC_REQUIRE(layout.attributes[0].type == GL_FLOAT);
+    STATIC_REQUIRE(layout.attributes[0].kind == AttributeKind::floating);
+    STATIC_REQUIRE(layout.attributes[0].offset == 0);
+
+    STATIC_REQUIRE(layout.attributes[1].components == 2);
+    STATIC_REQUIRE(layout.attributes[1].offset == offsetof(Vertex, uv));
+
+    STATIC_REQUIRE(layout.attributes[2].components == 4);
+    STATIC_REQUIRE(layout.attributes[2].type == GL_UNSIGNED_BYTE);
+    STATIC_REQUIRE(layout.attributes[2].kind == AttributeKind::normalised);
+
+    STATIC_REQUIRE(layout.attributes[3].components == 1);
+    STATIC_REQUIRE(layout.attributes[3].type == GL_INT);
+    STATIC_REQUIRE(layout.attributes[3].kind == AttributeKind::integer);
+    STATIC_REQUIRE(layout.attributes[3].size == sizeof(std::int32_t));
+
+    // The stride is not part of the attributes.
+    constexpr auto wide = make_layout<WideVertex>();
+    STATIC_REQUIRE(wide.attributes == layout.attributes);
+    STATIC_REQUIRE(wide.stride != layout.stride);
+
+    constexpr auto repeated = make_vertex_layout<Vertex>(
+        vertex_attribute<decltype(Vertex::position)>(0, offsetof(Vertex, position)),
+        vertex_attribute<decltype(Vertex::uv)>(0, offsetof(Vertex, uv)));
+    STATIC_REQUIRE_FALSE(repeated.is_valid());
+
+    constexpr auto outside =
+        make_vertex_layout<Vertex>(vertex_attribute<glm::vec3>(0, sizeof(Vertex)));
+    STATIC_REQUIRE_FALSE(outside.is_valid());
+}
+
+#if defined(ATLAS_BUILD_GL_TESTS)
+static void error_callback(int code, char const* message)
+{
+    fmt::print("error ({}):{}\n", code, message);
+}
+
+static GLint get_attribute(GLuint vao, GLuint location, GLenum name)
+{
+    GLint value;
+    glGetVertexArrayIndexediv(vao, location, name, &value);
+    return value;
+}
+
+TEST_CASE("[vertex_layout] - VertexFormatCache", "[glx]")
+{
+    REQUIRE(initialize_glfw(error_callback));
+
+    WindowSettings settings;
+    auto window = create_glfw_window(settings);
+    REQUIRE(window != nullptr);
+    glfwMakeContextCurrent(window);
+    REQUIRE(create_gl_context(window, settings.version));
+
+    {
+        VertexFormatCache cache;
+        auto vao = cache.get(layout);
+        REQUIRE(vao != 0);
+        REQUIRE(cache.get(make_layout<WideVertex>()) == vao);
+        REQUIRE(cache.size() == 1);
+
+        auto other = make_vertex_layout<Vertex>(
+            vertex_attribute<decltype(Vertex::position)>(0, offsetof(Vertex, position)));
+        REQUIRE(cache.get(other) != vao);
+        REQUIRE(cache.size() == 2);
+
+        REQUIRE(get_attribute(vao, 0, GL_VERTEX_ATTRIB_ARRAY_ENABLED) == GL_TRUE);
+        REQUIRE(get_attribute(vao, 0, GL_VERTEX_ATTRIB_ARRAY_SIZE) == 3);
+        REQUIRE(get_attribute(vao, 1, GL_VERTEX_ATTRIB_RELATIVE_OFFSET) ==
+                static_cast<GLint>(offsetof(Vertex, uv)));
+        REQUIRE(get_attribute(vao, 2, GL_VERTEX_ATTRIB_ARRAY_NORMALIZED) == GL_TRUE);
+        REQUIRE(get_attribute(vao, 2, GL_VERTEX_ATTRIB_ARRAY_TYPE) == GL_UNSIGNED_BYTE);
+        REQUIRE(get_attribute(vao, 3, GL_VERTEX_ATTRIB_ARRAY_INTEGER) == GL_TRUE);
+        REQUIRE(get_attribute(vao, 3, GL_VERTEX_ATTRIB_BINDING) == 0);
+
+        // Switching meshes only changes the buffer bindings.
+        GLuint buffers[3];
+        glCreateBuffers(3, buffers);
+        bind_vertex_buffers(vao, layout, buffers[0], buffers[1]);
+        REQUIRE(get_attribute(vao, 0, GL_VERTEX_BINDING_BUFFER) ==
+                static_cast<GLint>(buffers[0]));
+        REQUIRE(get_attribute(vao, 0, GL_VERTEX_BINDING_STRIDE) == layout.stride);
+
+        bind_vertex_buffers(vao, make_layout<WideVertex>(), buffers[2]);
+        REQUIRE(get_attribute(vao, 0, GL_VERTEX_BINDING_BUFFER) ==
+                static_cast<GLint>(buffers[2]));
+        REQUIRE(get_attribute(vao, 0, GL_VERTEX_BINDING_STRIDE) ==
+                static_cast<GLint>(sizeof(WideVertex)));
+
+        GLint elements;
+        glGetVertexArrayiv(vao, GL_ELEMENT_ARRAY_BUFFER_BINDING, &elements);
+        REQUIRE(elements == static_cast<GLint>(buffers[1]));
+
+        glDeleteBuffers(3, buffers);
+        cache.clear();
+        REQUIRE(cache.size() == 0);
+        REQUIRE(glIsVertexArray(vao) == GL_FALSE);
+    }
+
+    destroy_glfw_window(window);
+    terminate_glfw();
+}
+#endif
@@ -0,0 +1,391 @@
+#include <atlas/glx/capture.hpp>
+#include <atlas/glx/context.hpp>
+#include <atlas/glx/glsl.hpp>
+#include <atlas/glx/texture.hpp>
+#include <atlas/utils/image_compare.hpp>
+#include <atlas/utils/image_writer.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+#include <stb_image.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Golden image tests. Every registered scene is rendered offscreen, read back
+// and compared against its reference in ATLAS_GOLDEN_ROOT, and the time it
+// takes to draw is recorded alongside the result. The captures, diff images
+// and timings are written to golden/ in the working directory.
+//
+// Setting ATLAS_UPDATE_GOLDEN in the environment replaces the references
+// with the current captures. Otherwise a scene without a reference fails,
+// and its capture is left in golden/ to be reviewed and copied over.
+//
+// The scenes only need a 4.5 core context, so they run on llvmpipe
+// (LIBGL_ALWAYS_SOFTWARE=1); without a display, run under xvfb-run.
+//
+// The references are not checked in, since they depend on the Mesa version.
+// CI builds with ATLAS_BUILD_GOLDEN_TEST, runs this once with
+// ATLAS_UPDATE_GOLDEN when it has no references cached for the current
+// scenes, and from then on every run is held to the tolerances of each
+// scene against those.
+#if defined(ATLAS_BUILD_GOLDEN_TESTS)
+using namespace atlas;
+
+namespace
+{
+    constexpr GLsizei golden_width{256};
+    constexpr GLsizei golden_height{256};
+    constexpr int timed_frames{16};
+
+    struct GoldenDraw
+    {
+        // Draws a frame into the bound framebuffer.
+        std::function<void()> draw;
+        std::function<void()> destroy{[]() {}};
+    };
+
+    struct GoldenScene
+    {
+        std::string name;
+
+        // Creates the GL objects of the scene.
+        std::function<GoldenDraw()> create;
+
+        // Perceptual threshold of compare_images, and how many pixels (as a
+        // fraction of the image) and how much RMSE are tolerated above it.
+        float threshold{0.1f};
+        float tolerance{0.001f};
+        double max_rmse{2.0};
+    };
+
+    struct FrameTimes
+    {
+        double cpu_ms{0.0};
+        double gpu_ms{0.0};
+    };
+
+    GLuint create_program(std::string const& vertex, std::string const& fragment)
+    {
+        auto program = glCreateProgram();
+        for (auto [type, source] : {std::pair{GL_VERTEX_SHADER, &vertex},
+                                    std::pair{GL_FRAGMENT_SHADER, &fragment}})
+        {
+            auto shader = glCreateShader(type);
+            if (auto error = glx::compile_shader(*source, shader); error)
+            {
+                fmt::print(stderr, "error: {}\n", *error);
+            }
+            glAttachShader(program, shader);
+            glDeleteShader(shader);
+        }
+
+        if (auto error = glx::link_shaders(program); error)
+        {
+            fmt::print(stderr, "error: {}\n", *error);
+        }
+        return program;
+    }
+
+    // Draws a fullscreen triangle generated from gl_VertexID.
+    constexpr char const* fullscreen_vertex = R"(#version 450 core
+        out vec2 uv;
+        void main()
+        {
+            vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+            uv            = position;
+            gl_Position   = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+        })";
+
+    std::vector<GoldenScene> golden_scenes()
+    {
+        std::vector<GoldenScene> scenes;
+
+        scenes.push_back({"clear", []() {
+                              auto draw = []() {
+                                  glClearColor(0.2f, 0.4f, 0.6f, 1.0f);
+                                  glClear(GL_COLOR_BUFFER_BIT);
+                              };
+                              return GoldenDraw{draw};
+                          }});
+
+        scenes.push_back(
+            {"gradient", []() {
+                 GLuint vao;
+                 glCreateVertexArrays(1, &vao);
+                 auto program = create_program(fullscreen_vertex, R"(#version 450 core
+                    in vec2 uv;
+                    out vec4 colour;
+                    void main()
+                    {
+                        float rings = 0.5 + 0.5 * cos(40.0 * length(uv - 0.5));
+                        colour      = vec4(uv, rings, 1.0);
+                    })");
+
+                 auto draw = [vao, program]() {
+                     glBindVertexArray(vao);
+                     glUseProgram(program);
+                     glDrawArrays(GL_TRIANGLES, 0, 3);
+                 };
+                 auto destroy = [vao, program]() {
+                     glDeleteProgram(program);
+                     glDeleteVertexArrays(1, &vao);
+                 };
+                 return GoldenDraw{draw, destroy};
+             }});
+
+        // Overlapping instanced triangles, with depth testing and blending.
+        scenes.push_back(
+            {"triangles",
+             []() {
+                 GLuint vao;
+                 glCreateVertexArrays(1, &vao);
+                 auto program = create_program(R"(#version 450 core
+                    out vec4 tint;
+                    void main()
+                    {
+                        float angle  = 0.39269908 * float(gl_InstanceID);
+                        vec2 corners[3] =
+                            vec2[](vec2(0.0, 0.9), vec2(-0.1, 0.0), vec2(0.1, 0.0));
+                        vec2 p       = corners[gl_VertexID];
+                        mat2 rotate  = mat2(cos(angle), sin(angle),
+                                            -sin(angle), cos(angle));
+                        float depth  = float(gl_InstanceID % 5) / 5.0 - 0.5;
+                        gl_Position  = vec4(rotate * p, depth, 1.0);
+                        tint = vec4(fract(vec3(0.37, 0.61, 0.83) * gl_InstanceID), 0.6);
+                    })",
+                                               R"(#version 450 core
+                    in vec4 tint;
+                    out vec4 colour;
+                    void main()
+                    {
+                        colour = tint;
+                    })");
+
+                 auto draw = [vao, program]() {
+                     glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
+                     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                     glEnable(GL_DEPTH_TEST);
+                     glEnable(GL_BLEND);
+                     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                     glBindVertexArray(vao);
+                     glUseProgram(program);
+                     glDrawArraysInstanced(GL_TRIANGLES, 0, 3, 16);
+                     glDisable(GL_BLEND);
+                     glDisable(GL_DEPTH_TEST);
+                 };
+                 auto destroy = [vao, program]() {
+                     glDeleteProgram(program);
+                     glDeleteVertexArrays(1, &vao);
+                 };
+                 return GoldenDraw{draw, destroy};
+             },
+             0.1f,
+             0.002f,
+             3.0});
+
+        return scenes;
+    }
+
+    // Draws the scene a number of times, timing each frame on the CPU and,
+    // through timer queries, on the GPU.
+    FrameTimes time_frames(std::function<void()> const& draw)
+    {
+        std::vector<GLuint> queries(timed_frames);
+        glCreateQueries(GL_TIME_ELAPSED, timed_frames, queries.data());
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto query : queries)
+        {
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            draw();
+            glEndQuery(GL_TIME_ELAPSED);
+        }
+        glFinish();
+        auto end = std::chrono::steady_clock::now();
+
+        FrameTimes times;
+        times.cpu_ms = std::chrono::duration<double, std::milli>(end - start).count() /
+                       timed_frames;
+        for (auto query : queries)
+        {
+            GLuint64 elapsed;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+            times.gpu_ms += static_cast<double>(elapsed) * 1e-6 / timed_frames;
+        }
+
+        glDeleteQueries(timed_frames, queries.data());
+        return times;
+    }
+
+    // Captured rows are bottom to top; everything else here is top to
+    // bottom.
+    utils::ImageData to_image(glx::CapturedFrame const& frame)
+    {
+        utils::ImageData image;
+        image.width    = frame.width;
+        image.height   = frame.height;
+        image.channels = frame.channels;
+        image.pixels.resize(frame.pixels.size());
+
+        auto row = frame.pixels.size() / static_cast<std::size_t>(frame.height);
+        for (std::size_t y{0}; y < static_cast<std::size_t>(frame.height); ++y)
+        {
+            std::memcpy(image.pixels.data() + y * row,
+                        frame.pixels.data() + (frame.height - 1 - y) * row,
+                        row);
+        }
+        return image;
+    }
+
+    std::optional<utils::ImageData> load_reference(std::string const& path)
+    {
+        int width, height, channels;
+        auto data = stbi_load(path.c_str(), &width, &height, &channels, 3);
+        if (data == nullptr)
+        {
+            return {};
+        }
+
+        utils::ImageData image;
+        image.width    = width;
+        image.height   = height;
+        image.channels = 3;
+        image.pixels.assign(data, data + static_cast<std::size_t>(width) * height * 3);
+        stbi_image_free(data);
+        return image;
+    }
+
+    void error_callback(int code, char const* message)
+    {
+        fmt::print("error ({}):{}\n", code, message);
+    }
+} // namespace
+
+TEST_CASE("[golden] - scenes", "[golden]")
+{
+    REQUIRE(glx::initialize_glfw(error_callback));
+
+    glx::WindowSettings settings;
+    settings.size = {golden_width, golden_height};
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto window = glx::create_glfw_window(settings);
+    glfwDefaultWindowHints();
+    REQUIRE(window != nullptr);
+    glfwMakeContextCurrent(window);
+    REQUIRE(glx::create_gl_context(window, settings.version));
+
+    auto const reference_root = std::filesystem::path{ATLAS_GOLDEN_ROOT};
+    auto const output_root    = std::filesystem::current_path() / "golden";
+    bool const update         = std::getenv("ATLAS_UPDATE_GOLDEN") != nullptr;
+    std::filesystem::create_directories(output_root);
+    if (update)
+    {
+        std::filesystem::create_directories(reference_root);
+    }
+
+    // One JSON object per scene and line, for scripts to pick up.
+    std::ofstream timings{output_root / "timings.jsonl"};
+
+    {
+        auto colour = glx::create_texture_2d(golden_width, golden_height, 1, GL_RGBA8);
+        GLuint depth;
+        glCreateRenderbuffers(1, &depth);
+        glNamedRenderbufferStorage(
+            depth, GL_DEPTH_COMPONENT24, golden_width, golden_height);
+
+        GLuint framebuffer;
+        glCreateFramebuffers(1, &framebuffer);
+        glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT0, colour, 0);
+        glNamedFramebufferRenderbuffer(
+            framebuffer, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+        REQUIRE(glCheckNamedFramebufferStatus(framebuffer, GL_FRAMEBUFFER) ==
+                GL_FRAMEBUFFER_COMPLETE);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glViewport(0, 0, golden_width, golden_height);
+
+        glx::FramebufferCapture capture{1};
+        for (auto const& scene : golden_scenes())
+        {
+            INFO("scene " << scene.name);
+            auto [draw, destroy] = scene.create();
+
+            // The first frame pays for shader compilation.
+            draw();
+            glFinish();
+            auto times = time_frames(draw);
+
+            draw();
+            REQUIRE(capture.capture(0, 0, golden_width, golden_height).has_value());
+            auto frames = capture.flush();
+            destroy();
+            REQUIRE(frames.size() == 1);
+
+            auto image          = to_image(frames.front());
+            auto reference_path = (reference_root / (scene.name + ".png")).string();
+            auto output_path    = (output_root / (scene.name + ".png")).string();
+            CHECK(utils::write_image(output_path, image));
+            if (update)
+            {
+                CHECK(utils::write_image(reference_path, image));
+            }
+
+            std::optional<utils::ImageDiff> diff;
+            if (auto reference = load_reference(reference_path); reference)
+            {
+                diff = utils::compare_images(*reference, image, scene.threshold);
+                CHECK(diff.has_value());
+            }
+            else
+            {
+                FAIL_CHECK("no reference for " << scene.name << ", see " << output_path);
+            }
+
+            timings << fmt::format("{{\"scene\": \"{}\", \"cpu_ms\": {:.4f}, "
+                                   "\"gpu_ms\": {:.4f}",
+                                   scene.name,
+                                   times.cpu_ms,
+                                   times.gpu_ms);
+            if (diff)
+            {
+                timings << fmt::format(", \"rmse\": {:.4f}, \"max_error\": {}, "
+                                       "\"differing_pixels\": {}",
+                                       diff->rmse,
+                                       diff->max_error,
+                                       diff->differing_pixels);
+            }
+            timings << "}\n";
+
+            if (!diff)
+            {
+                continue;
+            }
+
+            auto diff_path = (output_root / (scene.name + "_diff.png")).string();
+            CHECK(utils::write_image(diff_path, diff->image));
+
+            auto fraction = static_cast<double>(diff->differing_pixels) /
+                            static_cast<double>(golden_width * golden_height);
+            INFO("rmse " << diff->rmse << ", max error " << diff->max_error
+                         << ", differing pixels " << diff->differing_pixels);
+            CHECK(diff->rmse <= scene.max_rmse);
+            CHECK(fraction <= scene.tolerance);
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(1, &depth);
+        glDeleteTextures(1, &colour);
+    }
+
+    glx::destroy_glfw_window(window);
+    glx::terminate_glfw();
+}
+#endif
@@ -0,0 +1,207 @@
+#include <atlas/jobs/job_system.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace atlas;
+
+TEST_CASE("[JobSystem] - jobs", "[jobs]")
+{
+    jobs::JobSystem system{4};
+    REQUIRE(system.thread_count() == 4);
+
+    SECTION("Submit and wait")
+    {
+        std::atomic<int> value{0};
+        auto job = system.submit([&]() {
+            value = 42;
+        });
+        system.wait(job);
+
+        REQUIRE(job.done());
+        REQUIRE(value == 42);
+    }
+
+    SECTION("Dependencies run first")
+    {
+        // Diamond: a -> (b, c) -> d.
+        std::atomic<int> counter{0};
+        std::array<int, 4> order{};
+
+        auto a = system.submit([&]() {
+            order[0] = counter++;
+        });
+        auto b = system.then(a, [&]() {
+            order[1] = counter++;
+        });
+        auto c = system.then(a, [&]() {
+            order[2] = counter++;
+        });
+        std::array deps{b, c};
+        auto d = system.submit(
+            [&]() {
+                order[3] = counter++;
+            },
+            deps);
+        system.wait(d);
+
+        REQUIRE(order[0] == 0);
+        REQUIRE(order[3] == 3);
+        REQUIRE(b.done());
+        REQUIRE(c.done());
+    }
+
+    SECTION("Depending on a finished job")
+    {
+        auto a = system.submit([]() {});
+        system.wait(a);
+
+        bool ran{false};
+        auto b = system.then(a, [&]() {
+            ran = true;
+        });
+        system.wait(b);
+        REQUIRE(ran);
+    }
+
+    SECTION("Exceptions are rethrown by wait")
+    {
+        auto job = system.submit([]() {
+            throw std::runtime_error{"fail"};
+        });
+        REQUIRE_THROWS_AS(system.wait(job), std::runtime_error);
+        REQUIRE(job.done());
+    }
+
+    SECTION("Many independent jobs")
+    {
+        std::atomic<int> count{0};
+        std::vector<jobs::JobHandle> handles;
+        for (int i{0}; i < 1000; ++i)
+        {
+            handles.push_back(system.submit([&]() {
+                ++count;
+            }));
+        }
+
+        for (auto const& handle : handles)
+        {
+            system.wait(handle);
+        }
+        REQUIRE(count == 1000);
+    }
+}
+
+TEST_CASE("[JobSystem] - main thread jobs", "[jobs]")
+{
+    jobs::JobSystem system{4};
+    auto main_id = std::this_thread::get_id();
+
+    SECTION("Run on request")
+    {
+        std::thread::id ran_on{};
+        auto job = system.submit_main([&]() {
+            ran_on = std::this_thread::get_id();
+        });
+
+        REQUIRE(system.run_main_thread_jobs() == 1);
+        REQUIRE(job.done());
+        REQUIRE(ran_on == main_id);
+        REQUIRE(system.run_main_thread_jobs() == 0);
+    }
+
+    SECTION("Continuation of worker job")
+    {
+        std::vector<int> data;
+        std::thread::id ran_on{};
+        auto produce = system.submit([&]() {
+            data.resize(100);
+            std::iota(data.begin(), data.end(), 0);
+        });
+        auto upload = system.submit_main(
+            [&]() {
+                ran_on = std::this_thread::get_id();
+            },
+            std::span{&produce, 1});
+
+        // Waiting on the main thread runs main-thread jobs as well.
+        system.wait(upload);
+        REQUIRE(ran_on == main_id);
+        REQUIRE(data.back() == 99);
+    }
+}
+
+TEST_CASE("[JobSystem] - parallel_for", "[jobs]")
+{
+    jobs::JobSystem system{4};
+
+    for (std::size_t grain : {0, 1, 7, 1000, 5000})
+    {
+        std::vector<std::atomic<int>> visits(1000);
+        std::atomic<bool> valid_chunks{true};
+        auto visit = [&](std::size_t begin, std::size_t end) {
+            if (end <= begin || (grain != 0 && end - begin > grain))
+            {
+                valid_chunks = false;
+            }
+
+            for (auto i = begin; i < end; ++i)
+            {
+                visits[i].fetch_add(1);
+            }
+        };
+
+        system.parallel_for(visits.size(), grain, visit);
+        REQUIRE(valid_chunks);
+
+        bool all_once{true};
+        for (auto const& v : visits)
+        {
+            all_once = all_once && (v.load() == 1);
+        }
+        REQUIRE(all_once);
+    }
+
+    SECTION("Nested loops")
+    {
+        std::atomic<int> count{0};
+        system.parallel_for(16, 1, [&](std::size_t, std::size_t) {
+            system.parallel_for(64, 4, [&](std::size_t begin, std::size_t end) {
+                count += static_cast<int>(end - begin);
+            });
+        });
+        REQUIRE(count == 16 * 64);
+    }
+
+    SECTION("Exceptions")
+    {
+        REQUIRE_THROWS_AS(system.parallel_for(100,
+                                              1,
+                                              [](std::size_t begin, std::size_t) {
+                                                  if (begin == 50)
+                                                  {
+                                                      throw std::runtime_error{"fail"};
+                                                  }
+                                              }),
+                          std::runtime_error);
+    }
+
+    SECTION("Single thread")
+    {
+        jobs::JobSystem serial{1};
+        std::size_t sum{0};
+        serial.parallel_for(100, 10, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i)
+            {
+                sum += i;
+            }
+        });
+        REQUIRE(sum == 4950);
+    }
+}
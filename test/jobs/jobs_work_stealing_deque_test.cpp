@@ -0,0 +1,119 @@
+#include <atlas/jobs/work_stealing_deque.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace atlas;
+
+TEST_CASE("[WorkStealingDeque] - single thread", "[jobs]")
+{
+    SECTION("Empty deque")
+    {
+        jobs::WorkStealingDeque<int> deque;
+        REQUIRE(deque.empty());
+        REQUIRE_FALSE(deque.pop().has_value());
+        REQUIRE_FALSE(deque.steal().has_value());
+    }
+
+    SECTION("Owner pops newest, thieves steal oldest")
+    {
+        jobs::WorkStealingDeque<int> deque;
+        for (int i{0}; i < 4; ++i)
+        {
+            deque.push(i);
+        }
+        REQUIRE(deque.size() == 4);
+
+        REQUIRE(deque.pop() == 3);
+        REQUIRE(deque.steal() == 0);
+        REQUIRE(deque.pop() == 2);
+        REQUIRE(deque.steal() == 1);
+        REQUIRE(deque.empty());
+    }
+
+    SECTION("Growth keeps every item")
+    {
+        jobs::WorkStealingDeque<int> deque{4};
+        REQUIRE(deque.capacity() == 4);
+
+        // Move the ends away from zero first so the copy wraps around.
+        deque.push(-1);
+        deque.push(-2);
+        REQUIRE(deque.steal() == -1);
+        REQUIRE(deque.steal() == -2);
+
+        for (int i{0}; i < 100; ++i)
+        {
+            deque.push(i);
+        }
+        REQUIRE(deque.capacity() >= 100);
+
+        for (int i{0}; i < 50; ++i)
+        {
+            REQUIRE(deque.steal() == i);
+        }
+        for (int i{99}; i >= 50; --i)
+        {
+            REQUIRE(deque.pop() == i);
+        }
+        REQUIRE(deque.empty());
+    }
+}
+
+TEST_CASE("[WorkStealingDeque] - concurrent", "[jobs]")
+{
+    constexpr int item_count{200000};
+    constexpr int thief_count{3};
+
+    jobs::WorkStealingDeque<int> deque{16};
+    std::vector<std::atomic<int>> taken(item_count);
+    std::atomic<bool> owner_done{false};
+
+    std::vector<std::thread> thieves;
+    for (int t{0}; t < thief_count; ++t)
+    {
+        thieves.emplace_back([&]() {
+            while (!owner_done.load() || !deque.empty())
+            {
+                if (auto item = deque.steal(); item)
+                {
+                    taken[*item].fetch_add(1);
+                }
+            }
+        });
+    }
+
+    // The owner interleaves pushes and pops so both ends are contended.
+    for (int i{0}; i < item_count; ++i)
+    {
+        deque.push(i);
+        if (i % 3 == 0)
+        {
+            if (auto item = deque.pop(); item)
+            {
+                taken[*item].fetch_add(1);
+            }
+        }
+    }
+
+    while (auto item = deque.pop())
+    {
+        taken[*item].fetch_add(1);
+    }
+    owner_done.store(true);
+
+    for (auto& thief : thieves)
+    {
+        thief.join();
+    }
+
+    bool all_once{true};
+    for (auto const& count : taken)
+    {
+        all_once = all_once && (count.load() == 1);
+    }
+    REQUIRE(all_once);
+}
@@ -3,6 +3,9 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <vector>
+
 using zeus::are_equal;
 using namespace atlas::math;
 
@@ -112,3 +115,209 @@ TEST_CASE("[coordinates] - polar_to_cartesian", "[math]")
     REQUIRE(are_equal(c2.x, 1.0f));
     REQUIRE(are_equal(c2.y, 1.0f));
 }
+
+TEST_CASE("[coordinates] - atan2 quadrants", "[math]")
+{
+    auto s = cartesian_to_spherical(glm::vec3{-1, 1, 0});
+    REQUIRE(are_equal(s.y, glm::radians(135.0f)));
+
+    auto x = cartesian_to_cylindrical(glm::vec3{-1, -1, 2});
+    REQUIRE(are_equal(x.y, glm::radians(-135.0f)));
+
+    auto p = cartesian_to_polar(glm::vec2{0, 1});
+    REQUIRE(are_equal(p.y, glm::radians(90.0f)));
+}
+
+namespace
+{
+    std::vector<glm::vec3> make_points(std::size_t count)
+    {
+        // Points spread over every octant and several orders of magnitude.
+        std::vector<glm::vec3> points;
+        for (std::size_t i{0}; i < count; ++i)
+        {
+            float t = static_cast<float>(i) / static_cast<float>(count);
+            float r = glm::pow(10.0f, static_cast<float>(i % 7) - 3.0f);
+            points.emplace_back(r * glm::cos(37.0f * t) * glm::sin(11.0f * t + 0.1f),
+                                r * glm::sin(37.0f * t) * glm::sin(11.0f * t + 0.1f),
+                                r * glm::cos(11.0f * t + 0.1f));
+        }
+        return points;
+    }
+
+    std::vector<glm::vec2> make_points_2d(std::size_t count)
+    {
+        std::vector<glm::vec2> points;
+        for (auto const& p : make_points(count))
+        {
+            points.emplace_back(p.x, p.y);
+        }
+        return points;
+    }
+
+    // Angles wrap at +-pi, so compare them on the circle.
+    float angle_error(float a, float b)
+    {
+        float e = glm::abs(a - b);
+        return glm::min(e, glm::two_pi<float>() - e);
+    }
+
+    float relative_error(float a, float b, float scale)
+    {
+        return glm::abs(a - b) / glm::max(scale, 1e-30f);
+    }
+
+    template<std::size_t W>
+    void check_batches()
+    {
+        constexpr float angle_tolerance{1e-6f};
+        constexpr float length_tolerance{1e-6f};
+
+        auto points = make_points(1001);
+        std::vector<glm::vec3> exact(points.size());
+        std::vector<glm::vec3> fast(points.size());
+
+        // Exact matches the scalar functions, fast is within the documented
+        // error.
+        {
+            cartesian_to_spherical_batch<W>(points, exact, Accuracy::exact);
+            cartesian_to_spherical_batch<W>(points, fast, Accuracy::fast);
+
+            bool matches_scalar{true};
+            float max_angle{0.0f};
+            float max_length{0.0f};
+            for (std::size_t i{0}; i < points.size(); ++i)
+            {
+                matches_scalar = matches_scalar
+                                 && (exact[i] == cartesian_to_spherical(points[i]));
+                max_length = glm::max(max_length,
+                                      relative_error(fast[i].x, exact[i].x, exact[i].x));
+                max_angle  = glm::max(max_angle, angle_error(fast[i].y, exact[i].y));
+                max_angle  = glm::max(max_angle, angle_error(fast[i].z, exact[i].z));
+            }
+            REQUIRE(matches_scalar);
+            REQUIRE(max_length < length_tolerance);
+            REQUIRE(max_angle < angle_tolerance);
+        }
+
+        {
+            auto spherical = exact;
+            spherical_to_cartesian_batch<W>(spherical, exact, Accuracy::exact);
+            spherical_to_cartesian_batch<W>(spherical, fast, Accuracy::fast);
+
+            bool matches_scalar{true};
+            float max_error{0.0f};
+            for (std::size_t i{0}; i < points.size(); ++i)
+            {
+                matches_scalar = matches_scalar
+                                 && (exact[i] == spherical_to_cartesian(spherical[i]));
+                auto scale = spherical[i].x;
+                max_error  = std::max({max_error,
+                                       relative_error(fast[i].x, exact[i].x, scale),
+                                       relative_error(fast[i].y, exact[i].y, scale),
+                                       relative_error(fast[i].z, exact[i].z, scale)});
+            }
+            REQUIRE(matches_scalar);
+            REQUIRE(max_error < length_tolerance);
+        }
+
+        {
+            cartesian_to_cylindrical_batch<W>(points, exact, Accuracy::exact);
+            cartesian_to_cylindrical_batch<W>(points, fast, Accuracy::fast);
+
+            bool matches_scalar{true};
+            float max_error{0.0f};
+            for (std::size_t i{0}; i < points.size(); ++i)
+            {
+                matches_scalar = matches_scalar
+                                 && (exact[i] == cartesian_to_cylindrical(points[i]));
+                max_error = glm::max(max_error,
+                                     relative_error(fast[i].x, exact[i].x, exact[i].x));
+                max_error = glm::max(max_error, angle_error(fast[i].y, exact[i].y));
+                max_error = glm::max(max_error, glm::abs(fast[i].z - exact[i].z));
+            }
+            REQUIRE(matches_scalar);
+            REQUIRE(max_error < angle_tolerance);
+
+            auto cylindrical = exact;
+            cylindrical_to_cartesian_batch<W>(cylindrical, exact, Accuracy::exact);
+            cylindrical_to_cartesian_batch<W>(cylindrical, fast, Accuracy::fast);
+
+            max_error = 0.0f;
+            for (std::size_t i{0}; i < points.size(); ++i)
+            {
+                auto expected  = cylindrical_to_cartesian(cylindrical[i]);
+                matches_scalar = matches_scalar && (exact[i] == expected);
+                auto scale     = cylindrical[i].x;
+                max_error      = std::max({max_error,
+                                           relative_error(fast[i].x, exact[i].x, scale),
+                                           relative_error(fast[i].y, exact[i].y, scale)});
+            }
+            REQUIRE(matches_scalar);
+            REQUIRE(max_error < length_tolerance);
+        }
+
+        {
+            auto points_2d = make_points_2d(1001);
+            std::vector<glm::vec2> exact_2d(points_2d.size());
+            std::vector<glm::vec2> fast_2d(points_2d.size());
+
+            cartesian_to_polar_batch<W>(points_2d, exact_2d, Accuracy::exact);
+            cartesian_to_polar_batch<W>(points_2d, fast_2d, Accuracy::fast);
+
+            bool matches_scalar{true};
+            float max_error{0.0f};
+            for (std::size_t i{0}; i < points_2d.size(); ++i)
+            {
+                auto const& e  = exact_2d[i];
+                auto expected  = cartesian_to_polar(points_2d[i]);
+                matches_scalar = matches_scalar && (e == expected);
+                max_error      = std::max({max_error,
+                                           relative_error(fast_2d[i].x, e.x, e.x),
+                                           angle_error(fast_2d[i].y, e.y)});
+            }
+            REQUIRE(matches_scalar);
+            REQUIRE(max_error < angle_tolerance);
+
+            // In place.
+            auto polar = exact_2d;
+            polar_to_cartesian_batch<W>(exact_2d, exact_2d, Accuracy::exact);
+            polar_to_cartesian_batch<W>(polar, polar, Accuracy::fast);
+
+            max_error = 0.0f;
+            for (std::size_t i{0}; i < points_2d.size(); ++i)
+            {
+                auto scale = glm::length(points_2d[i]);
+                max_error  = std::max({max_error,
+                                       relative_error(polar[i].x, exact_2d[i].x, scale),
+                                       relative_error(polar[i].y, exact_2d[i].y, scale)});
+            }
+            REQUIRE(max_error < length_tolerance);
+        }
+    }
+} // namespace
+
+TEST_CASE("[coordinates] - batch conversions", "[math]")
+{
+    SECTION("Width 4")
+    {
+        check_batches<4>();
+    }
+
+    SECTION("Width 8")
+    {
+        check_batches<8>();
+    }
+
+    SECTION("Width 16")
+    {
+        check_batches<16>();
+    }
+
+    SECTION("Empty input")
+    {
+        std::vector<glm::vec3> empty;
+        cartesian_to_spherical_batch(empty, empty, Accuracy::fast);
+        REQUIRE(empty.empty());
+    }
+}
@@ -0,0 +1,283 @@
+#include "test_helpers.hpp"
+
+#include <atlas/math/intersections.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <vector>
+
+using namespace atlas::math;
+
+namespace
+{
+    template<std::size_t N, typename Primitive, typename Scalar>
+    void check_packets(std::vector<Ray<glm::vec3>> const& rays,
+                       Primitive const& prim,
+                       Scalar&& scalar)
+    {
+        std::size_t hits{0};
+        for (std::size_t first{0}; first < rays.size(); first += N)
+        {
+            auto count = std::min(N, rays.size() - first);
+            auto packet =
+                RayPacket<float, N>::load({rays.data() + first, count}, 0.0f, 100.0f);
+
+            simd::Pack<float, N> t;
+            auto mask = intersect(packet, prim, t);
+            for (std::size_t lane{0}; lane < N; ++lane)
+            {
+                bool lane_hit = (mask.bits() >> lane) & 1u;
+                if (lane >= count)
+                {
+                    REQUIRE_FALSE(lane_hit);
+                    continue;
+                }
+
+                std::optional<float> expected = scalar(rays[first + lane]);
+                INFO("ray " << first + lane);
+                REQUIRE(lane_hit == expected.has_value());
+                if (lane_hit)
+                {
+                    REQUIRE(std::abs(t[lane] - *expected) <= 1e-4f * (1.0f + *expected));
+                    ++hits;
+                }
+            }
+        }
+
+        // Make sure the test rays actually exercise both outcomes.
+        REQUIRE(hits > 0);
+        REQUIRE(hits < rays.size());
+    }
+
+    template<std::size_t N>
+    void check_all_primitives(std::vector<Ray<glm::vec3>> const& rays)
+    {
+        Sphere sphere{glm::vec3{0.2f, -0.1f, 0.0f}, 0.75f};
+        check_packets<N>(rays, sphere, [&](Ray<glm::vec3> const& r) {
+            return intersect(r, sphere, 0.0f, 100.0f);
+        });
+
+        Plane plane{glm::vec3{0.5f, 0.0f, 0.0f},
+                    glm::normalize(glm::vec3{1.0f, 0.3f, 0.0f})};
+        check_packets<N>(rays, plane, [&](Ray<glm::vec3> const& r) {
+            return intersect(r, plane, 0.0f, 100.0f);
+        });
+
+        AABB box{glm::vec3{-0.5f, -0.25f, -0.5f}, glm::vec3{0.5f, 0.75f, 0.25f}};
+        check_packets<N>(rays, box, [&](Ray<glm::vec3> const& r) {
+            return intersect(r, box, 0.0f, 100.0f);
+        });
+
+        Triangle tri{glm::vec3{-1.0f, -1.0f, 0.0f},
+                     glm::vec3{1.0f, -0.5f, 0.2f},
+                     glm::vec3{0.0f, 1.0f, -0.2f}};
+        check_packets<N>(rays, tri, [&](Ray<glm::vec3> const& r) {
+            auto hit = intersect(r, tri, 0.0f, 100.0f);
+            return hit ? std::optional<float>{hit->t} : std::optional<float>{};
+        });
+    }
+} // namespace
+
+TEST_CASE("[intersections] - sphere", "[math]")
+{
+    Sphere s{glm::vec3{0.0f, 0.0f, 5.0f}, 1.0f};
+    Ray<glm::vec3> r{glm::vec3{0.0f}, glm::vec3{0.0f, 0.0f, 1.0f}};
+
+    REQUIRE(*intersect(r, s, 0.0f, 100.0f) == 4.0f);
+    REQUIRE(*intersect(r, s, 4.5f, 100.0f) == 6.0f);
+    REQUIRE_FALSE(intersect(r, s, 0.0f, 3.0f));
+
+    r.d = glm::vec3{0.0f, 1.0f, 0.0f};
+    REQUIRE_FALSE(intersect(r, s, 0.0f, 100.0f));
+}
+
+TEST_CASE("[intersections] - plane", "[math]")
+{
+    Plane p{glm::vec3{0.0f, 2.0f, 0.0f}, glm::vec3{0.0f, 1.0f, 0.0f}};
+    Ray<glm::vec3> r{glm::vec3{0.0f}, glm::vec3{0.0f, 0.5f, 0.0f}};
+
+    REQUIRE(*intersect(r, p, 0.0f, 100.0f) == 4.0f);
+
+    r.d = glm::vec3{1.0f, 0.0f, 0.0f};
+    REQUIRE_FALSE(intersect(r, p, 0.0f, 100.0f));
+}
+
+TEST_CASE("[intersections] - AABB", "[math]")
+{
+    AABB box{glm::vec3{-1.0f}, glm::vec3{1.0f}};
+    Ray<glm::vec3> r{glm::vec3{0.0f, 0.0f, -5.0f}, glm::vec3{0.0f, 0.0f, 1.0f}};
+
+    REQUIRE(*intersect(r, box, 0.0f, 100.0f) == 4.0f);
+    REQUIRE_FALSE(intersect(r, box, 0.0f, 3.0f));
+
+    // Axis-aligned rays lying exactly on a slab boundary.
+    r.o = glm::vec3{1.0f, 0.0f, -5.0f};
+    REQUIRE(*intersect(r, box, 0.0f, 100.0f) == 4.0f);
+
+    r.o = glm::vec3{0.0f};
+    REQUIRE(*intersect(r, box, 0.0f, 100.0f) == 0.0f);
+
+    r.o = glm::vec3{2.0f, 0.0f, -5.0f};
+    REQUIRE_FALSE(intersect(r, box, 0.0f, 100.0f));
+}
+
+TEST_CASE("[intersections] - triangle", "[math]")
+{
+    Triangle tri{glm::vec3{0.0f, 0.0f, 2.0f},
+                 glm::vec3{1.0f, 0.0f, 2.0f},
+                 glm::vec3{0.0f, 1.0f, 2.0f}};
+    Ray<glm::vec3> r{glm::vec3{0.25f, 0.5f, 0.0f}, glm::vec3{0.0f, 0.0f, 1.0f}};
+
+    for (auto hit :
+         {intersect(r, tri, 0.0f, 100.0f), intersect_watertight(r, tri, 0.0f, 100.0f)})
+    {
+        REQUIRE(hit);
+        REQUIRE(hit->t == 2.0f);
+        REQUIRE(hit->u == 0.25f);
+        REQUIRE(hit->v == 0.5f);
+    }
+
+    r.o = glm::vec3{0.75f, 0.5f, 0.0f};
+    REQUIRE_FALSE(intersect(r, tri, 0.0f, 100.0f));
+    REQUIRE_FALSE(intersect_watertight(r, tri, 0.0f, 100.0f));
+}
+
+TEST_CASE("[intersections] - watertight shared edges", "[math]")
+{
+    // A quad split along its diagonal. Every ray through the quad has to hit
+    // at least one of the two halves, including those through the diagonal.
+    glm::vec3 a{-1.0f, -1.0f, 1.0f};
+    glm::vec3 b{1.0f, -1.0f, 1.3f};
+    glm::vec3 c{1.0f, 1.0f, 1.0f};
+    glm::vec3 d{-1.0f, 1.0f, 0.7f};
+    Triangle t0{a, b, c};
+    Triangle t1{a, c, d};
+
+    std::vector<Ray<glm::vec3>> rays;
+    for (int i{0}; i <= 64; ++i)
+    {
+        float s = -0.95f + 1.9f * static_cast<float>(i) / 64.0f;
+        glm::vec3 target{s, s, 1.0f};
+        glm::vec3 o{0.1f, -0.3f, -2.0f};
+        rays.push_back({o, target - o});
+    }
+
+    for (auto const& r : rays)
+    {
+        INFO("target " << r.o.x + r.d.x);
+        bool hit = intersect_watertight(r, t0, 0.0f, 100.0f).has_value()
+                   || intersect_watertight(r, t1, 0.0f, 100.0f).has_value();
+        REQUIRE(hit);
+    }
+
+    for (std::size_t first{0}; first < rays.size(); first += 4)
+    {
+        auto count  = std::min<std::size_t>(4, rays.size() - first);
+        auto packet = RayPacket<float, 4>::load({rays.data() + first, count});
+        simd::Pack<float, 4> t, u, v;
+        auto hit = intersect_watertight(packet, t0, t, u, v)
+                   | intersect_watertight(packet, t1, t, u, v);
+        REQUIRE(hit.bits() == simd::first_lanes<float, 4>(count).bits());
+    }
+}
+
+TEST_CASE("[intersections] - packets", "[math]")
+{
+    // 1000 is deliberately not a multiple of any packet width.
+    auto rays = atlas::test::make_primitive_rays(1000);
+
+    check_all_primitives<4>(rays);
+    check_all_primitives<8>(rays);
+    check_all_primitives<16>(rays);
+}
+
+TEST_CASE("[intersections] - packet watertight", "[math]")
+{
+    auto rays = atlas::test::make_primitive_rays(256);
+    Triangle tri{glm::vec3{-1.0f, -1.0f, 0.0f},
+                 glm::vec3{1.0f, -0.5f, 0.2f},
+                 glm::vec3{0.0f, 1.0f, -0.2f}};
+
+    for (std::size_t first{0}; first < rays.size(); first += 8)
+    {
+        auto packet = RayPacket<float, 8>::load({rays.data() + first, 8});
+        simd::Pack<float, 8> t, u, v;
+        auto mask = intersect_watertight(packet, tri, t, u, v);
+        for (std::size_t lane{0}; lane < 8; ++lane)
+        {
+            auto expected = intersect_watertight(rays[first + lane], tri, 0.0f, 1e30f);
+            REQUIRE(((mask.bits() >> lane) & 1u) == expected.has_value());
+            if (expected)
+            {
+                REQUIRE(std::abs(t[lane] - expected->t) < 1e-4f);
+                REQUIRE(std::abs(u[lane] - expected->u) < 1e-4f);
+                REQUIRE(std::abs(v[lane] - expected->v) < 1e-4f);
+            }
+        }
+    }
+}
+
+TEST_CASE("[intersections] - packet edge function", "[math]")
+{
+    // In the first lane (1 + 2^-12)^2 rounds to 1 + 2^-11 in float, so the
+    // products tie although the exact result is 2^-24. The second lane is
+    // exactly 0, and the rest can be evaluated in float.
+    constexpr float e = 1.0f / 4096.0f;
+    std::array<float, 4> x0{1.0f + e, 2.0f, 3.0f, -1.5f};
+    std::array<float, 4> y0{1.0f + 2.0f * e, 4.0f, 0.25f, 2.0f};
+    std::array<float, 4> x1{1.0f, 1.0f, 0.5f, 0.75f};
+    std::array<float, 4> y1{1.0f + e, 2.0f, 7.0f, -3.0f};
+
+    using pack_type = simd::Pack<float, 4>;
+    auto edge       = detail::edge_function(pack_type::load(x0.data()),
+                                            pack_type::load(y0.data()),
+                                            pack_type::load(x1.data()),
+                                            pack_type::load(y1.data()));
+    for (std::size_t i{0}; i < 4; ++i)
+    {
+        auto expected = static_cast<float>(static_cast<double>(x0[i]) * y1[i] -
+                                           static_cast<double>(y0[i]) * x1[i]);
+        REQUIRE(edge[i] == expected);
+    }
+    REQUIRE(edge[0] > 0.0f);
+    REQUIRE(edge[1] == 0.0f);
+}
+
+TEST_CASE("[intersections] - intersect_stream", "[math]")
+{
+    std::vector<Sphere> spheres{{glm::vec3{0.0f, 0.0f, 5.0f}, 1.0f},
+                                {glm::vec3{0.0f, 0.0f, 3.0f}, 1.0f},
+                                {glm::vec3{10.0f, 0.0f, 3.0f}, 1.0f}};
+
+    constexpr std::size_t count{19};
+    std::vector<float> ox(count), oy(count), oz(count, 0.0f);
+    std::vector<float> dx(count, 0.0f), dy(count, 0.0f), dz(count, 1.0f);
+    std::vector<float> t_min(count, 0.0f), t_max(count, 100.0f);
+    for (std::size_t i{0}; i < count; ++i)
+    {
+        ox[i] = static_cast<float>(i) * 0.6f;
+    }
+
+    std::vector<std::int32_t> ids(count, -1);
+    RayStream<float> stream{{ox, oy, oz}, {dx, dy, dz}, t_min, t_max};
+    intersect_stream<float>(stream, std::span<Sphere const>{spheres}, ids);
+
+    for (std::size_t i{0}; i < count; ++i)
+    {
+        Ray<glm::vec3> r{glm::vec3{ox[i], oy[i], oz[i]}, glm::vec3{0.0f, 0.0f, 1.0f}};
+        std::int32_t closest{-1};
+        float closest_t{100.0f};
+        for (std::size_t s{0}; s < spheres.size(); ++s)
+        {
+            if (auto t = intersect(r, spheres[s], 0.0f, closest_t))
+            {
+                closest   = static_cast<std::int32_t>(s);
+                closest_t = *t;
+            }
+        }
+
+        REQUIRE(ids[i] == closest);
+        REQUIRE(std::abs(t_max[i] - closest_t) < 1e-5f);
+    }
+}
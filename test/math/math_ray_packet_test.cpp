@@ -0,0 +1,68 @@
+#include <atlas/math/ray_packet.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+using namespace atlas::math;
+
+TEST_CASE("[RayPacket] - load", "[math]")
+{
+    std::vector<Ray<glm::vec3>> rays{
+        {glm::vec3{0.0f}, glm::vec3{1.0f, 0.0f, 0.0f}},
+        {glm::vec3{1.0f, 2.0f, 3.0f}, glm::vec3{0.0f, 2.0f, 0.0f}},
+        {glm::vec3{-1.0f}, glm::vec3{0.0f, 0.0f, -4.0f}}};
+
+    auto packet = RayPacket<float, 4>::load(rays, 0.5f, 10.0f);
+
+    REQUIRE(packet.active.bits() == 0b0111);
+    for (std::size_t i{0}; i < rays.size(); ++i)
+    {
+        REQUIRE(packet.ray(i) == rays[i]);
+        REQUIRE(packet.t_min[i] == 0.5f);
+        REQUIRE(packet.t_max[i] == 10.0f);
+    }
+
+    REQUIRE(packet.inv_d.y[1] == 0.5f);
+    REQUIRE(packet.inv_d.z[2] == -0.25f);
+}
+
+TEST_CASE("[RayPacket] - operator()", "[math]")
+{
+    std::vector<Ray<glm::vec3>> rays(8, {glm::vec3{1.0f}, glm::vec3{1.0f}});
+    auto packet = RayPacket<float, 8>::load(rays);
+
+    auto p = packet(simd::Pack<float, 8>{1.0f});
+    for (std::size_t i{0}; i < 8; ++i)
+    {
+        REQUIRE(glm::vec3{p.x[i], p.y[i], p.z[i]} == rays[i](1.0f));
+    }
+}
+
+TEST_CASE("[RayStream] - packet", "[math]")
+{
+    constexpr std::size_t count{11};
+    std::vector<float> ox(count), oy(count), oz(count);
+    std::vector<float> dx(count), dy(count), dz(count);
+    std::vector<float> t_min(count, 0.0f), t_max(count);
+    for (std::size_t i{0}; i < count; ++i)
+    {
+        ox[i]    = static_cast<float>(i);
+        dz[i]    = 1.0f;
+        t_max[i] = 100.0f + static_cast<float>(i);
+    }
+
+    RayStream<float> stream{{ox, oy, oz}, {dx, dy, dz}, t_min, t_max};
+    REQUIRE(stream.size() == count);
+
+    auto packet = stream.packet<4>(8);
+    REQUIRE(packet.active.bits() == 0b0111);
+    REQUIRE(packet.o.x[2] == 10.0f);
+    REQUIRE(packet.t_max[1] == 109.0f);
+
+    packet.t_max = simd::Pack<float, 4>{1.0f};
+    stream.store_t_max(packet, 8);
+    REQUIRE(t_max[7] == 107.0f);
+    REQUIRE(t_max[8] == 1.0f);
+    REQUIRE(t_max[10] == 1.0f);
+}
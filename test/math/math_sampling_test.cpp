@@ -0,0 +1,56 @@
+#include <atlas/math/sampling.hpp>
+#include <atlas/math/sequences.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace atlas::math;
+
+TEST_CASE("[sampling] - square_to_disk", "[math]")
+{
+    REQUIRE(square_to_disk({0.5f, 0.5f}) == glm::vec2{0.0f});
+
+    for (std::uint32_t i{0}; i < 256; ++i)
+    {
+        glm::vec2 u{sobol_sample<float>(i, 0), sobol_sample<float>(i, 1)};
+        auto p = square_to_disk(u);
+        REQUIRE(glm::length(p) <= 1.0f + 1e-5f);
+    }
+}
+
+TEST_CASE("[sampling] - square_to_uniform_sphere", "[math]")
+{
+    for (std::uint32_t i{0}; i < 256; ++i)
+    {
+        glm::vec2 u{sobol_sample<float>(i, 0), sobol_sample<float>(i, 1)};
+        auto p = square_to_uniform_sphere(u);
+        REQUIRE(glm::abs(glm::length(p) - 1.0f) < 1e-5f);
+    }
+}
+
+TEST_CASE("[sampling] - square_to_uniform_hemisphere", "[math]")
+{
+    for (std::uint32_t i{0}; i < 256; ++i)
+    {
+        glm::vec2 u{sobol_sample<float>(i, 0), sobol_sample<float>(i, 1)};
+        auto p = square_to_uniform_hemisphere(u);
+        REQUIRE(glm::abs(glm::length(p) - 1.0f) < 1e-5f);
+        REQUIRE(p.z >= 0.0f);
+    }
+}
+
+TEST_CASE("[sampling] - square_to_cosine_hemisphere", "[math]")
+{
+    // The average of cos(theta) under a cosine-weighted distribution is 2/3.
+    float sum{0.0f};
+    constexpr std::uint32_t count{1024};
+    for (std::uint32_t i{0}; i < count; ++i)
+    {
+        glm::vec2 u{sobol_sample<float>(i, 0), sobol_sample<float>(i, 1)};
+        auto p = square_to_cosine_hemisphere(u);
+        REQUIRE(glm::abs(glm::length(p) - 1.0f) < 1e-5f);
+        REQUIRE(p.z >= 0.0f);
+        sum += p.z;
+    }
+
+    REQUIRE(glm::abs(sum / count - 2.0f / 3.0f) < 1e-2f);
+}
@@ -0,0 +1,144 @@
+#include <atlas/math/sequences.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace atlas::math;
+
+namespace
+{
+    // Checks that the first 2^k samples place exactly one point in each of
+    // the 2^k equally sized intervals of [0, 1).
+    template<typename Fn>
+    bool is_stratified(std::uint32_t log2_count, Fn&& fn)
+    {
+        std::uint32_t count = 1u << log2_count;
+        std::vector<int> bins(count, 0);
+        for (std::uint32_t i{0}; i < count; ++i)
+        {
+            double x = fn(i);
+            if (x < 0.0 || x >= 1.0)
+            {
+                return false;
+            }
+
+            ++bins[static_cast<std::size_t>(x * count)];
+        }
+
+        return std::all_of(bins.begin(), bins.end(), [](int b) {
+            return b == 1;
+        });
+    }
+} // namespace
+
+TEST_CASE("[sequences] - sobol_sample: first dimension", "[math]")
+{
+    REQUIRE(sobol_sample<double>(0, 0) == 0.0);
+    REQUIRE(sobol_sample<double>(1, 0) == 0.5);
+    REQUIRE(sobol_sample<double>(2, 0) == 0.25);
+    REQUIRE(sobol_sample<double>(3, 0) == 0.75);
+}
+
+TEST_CASE("[sequences] - sobol_sample: stratification", "[math]")
+{
+    for (std::size_t d{0}; d < sobol_max_dimensions; ++d)
+    {
+        REQUIRE(is_stratified(10, [d](std::uint32_t i) {
+            return sobol_sample<double>(i, d);
+        }));
+    }
+}
+
+TEST_CASE("[sequences] - sobol_sample: (0, 2)-sequence", "[math]")
+{
+    // The first two dimensions form a (0, 2)-sequence, so every elementary
+    // interval of area 1/16 contains exactly one of the first 16 points.
+    constexpr std::uint32_t count{16};
+    for (std::uint32_t bx{0}; bx <= 4; ++bx)
+    {
+        std::uint32_t nx = 1u << bx;
+        std::uint32_t ny = count / nx;
+        std::vector<int> cells(count, 0);
+        for (std::uint32_t i{0}; i < count; ++i)
+        {
+            auto x = static_cast<std::uint32_t>(sobol_sample<double>(i, 0) * nx);
+            auto y = static_cast<std::uint32_t>(sobol_sample<double>(i, 1) * ny);
+            ++cells[y * nx + x];
+        }
+
+        REQUIRE(std::all_of(cells.begin(), cells.end(), [](int c) {
+            return c == 1;
+        }));
+    }
+}
+
+TEST_CASE("[sequences] - owen_sobol_sample", "[math]")
+{
+    for (std::size_t d{0}; d < sobol_max_dimensions; ++d)
+    {
+        REQUIRE(is_stratified(8, [d](std::uint32_t i) {
+            return owen_sobol_sample<double>(i, d, 1234);
+        }));
+    }
+
+    REQUIRE(owen_sobol_sample<float>(5, 3, 1) != owen_sobol_sample<float>(5, 3, 2));
+    REQUIRE(owen_sobol_sample<float>(5, 3, 7) == owen_sobol_sample<float>(5, 3, 7));
+}
+
+TEST_CASE("[sequences] - halton_sample", "[math]")
+{
+    REQUIRE(halton_sample<double>(1, 0) == 0.5);
+    REQUIRE(halton_sample<double>(3, 0) == 0.75);
+    REQUIRE(halton_sample<double>(1, 1) == 1.0 / 3.0);
+    REQUIRE(halton_sample<double>(2, 1) == 2.0 / 3.0);
+    REQUIRE(halton_sample<double>(3, 1) == 1.0 / 9.0);
+    REQUIRE(halton_sample<double>(1, 2) == 1.0 / 5.0);
+
+    for (std::uint32_t i{0}; i < 64; ++i)
+    {
+        REQUIRE(halton_sample<double>(i, 0) == sobol_sample<double>(i, 0));
+    }
+}
+
+TEST_CASE("[sequences] - r2_sample", "[math]")
+{
+    REQUIRE(r2_sample<double>(0, 0) == 0.5);
+    REQUIRE(r2_sample<double>(0, 1) == 0.5);
+
+    double a1 = 0.7548776662466927;
+    double a2 = 0.5698402909980532;
+    for (std::uint32_t i{1}; i < 1000; i += 37)
+    {
+        double x = 0.5 + i * a1;
+        double y = 0.5 + i * a2;
+        REQUIRE(std::abs(r2_sample<double>(i, 0) - (x - std::floor(x))) < 1e-6);
+        REQUIRE(std::abs(r2_sample<double>(i, 1) - (y - std::floor(y))) < 1e-6);
+    }
+}
+
+TEST_CASE("[sequences] - generate_samples", "[math]")
+{
+    for (auto type : {SequenceType::sobol,
+                      SequenceType::owen_sobol,
+                      SequenceType::halton,
+                      SequenceType::r2})
+    {
+        std::vector<float> samples(100);
+        generate_samples(type, std::span<float>{samples}, 1, 17, 42);
+        for (std::uint32_t i{0}; i < samples.size(); ++i)
+        {
+            REQUIRE(samples[i] == sample_sequence<float>(type, i + 17, 1, 42));
+        }
+
+        std::vector<glm::vec2> points(100);
+        generate_samples(type, std::span<glm::vec2>{points}, 0, 3, 42);
+        for (std::uint32_t i{0}; i < points.size(); ++i)
+        {
+            REQUIRE(points[i].x == sample_sequence<float>(type, i + 3, 0, 42));
+            REQUIRE(points[i].y == sample_sequence<float>(type, i + 3, 1, 42));
+        }
+    }
+}
@@ -0,0 +1,229 @@
+#include <atlas/math/glm.hpp>
+#include <atlas/math/simd.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <numeric>
+#include <vector>
+
+using namespace atlas::math::simd;
+
+namespace
+{
+    template<typename T, std::size_t N>
+    void check_pack()
+    {
+        using P = Pack<T, N>;
+
+        std::array<T, N> a;
+        std::array<T, N> b;
+        for (std::size_t i{0}; i < N; ++i)
+        {
+            a[i] = static_cast<T>(i) - static_cast<T>(N) / T{2};
+            b[i] = static_cast<T>(i % 3) + T{1};
+        }
+
+        P pa = P::load(a.data());
+        P pb = P::load(b.data());
+
+        std::array<T, N> out;
+        (pa + pb * T{2}).store(out.data());
+        for (std::size_t i{0}; i < N; ++i)
+        {
+            REQUIRE(out[i] == a[i] + b[i] * T{2});
+        }
+
+        (-pa / pb).store(out.data());
+        for (std::size_t i{0}; i < N; ++i)
+        {
+            REQUIRE(out[i] == -a[i] / b[i]);
+        }
+
+        abs(pa).store(out.data());
+        for (std::size_t i{0}; i < N; ++i)
+        {
+            REQUIRE(out[i] == std::abs(a[i]));
+        }
+
+        sqrt(pb).store(out.data());
+        for (std::size_t i{0}; i < N; ++i)
+        {
+            REQUIRE(out[i] == std::sqrt(b[i]));
+        }
+
+        auto m = pa < P{T{0}};
+        select(m, pa, pb).store(out.data());
+        for (std::size_t i{0}; i < N; ++i)
+        {
+            REQUIRE(out[i] == ((a[i] < T{0}) ? a[i] : b[i]));
+            REQUIRE(((m.bits() >> i) & 1u) == static_cast<std::uint64_t>(a[i] < T{0}));
+            REQUIRE(pa[i] == a[i]);
+        }
+
+        REQUIRE(any(m));
+        REQUIRE_FALSE(all(m));
+        REQUIRE(all(m | !m));
+        REQUIRE(none(m & !m));
+
+        min(pa, pb).store(out.data());
+        for (std::size_t i{0}; i < N; ++i)
+        {
+            REQUIRE(out[i] == std::min(a[i], b[i]));
+        }
+
+        max(pa, pb).store(out.data());
+        for (std::size_t i{0}; i < N; ++i)
+        {
+            REQUIRE(out[i] == std::max(a[i], b[i]));
+        }
+    }
+
+    // Largest absolute error of a fast function against the double-precision
+    // reference over the given inputs.
+    template<std::size_t N, typename Fast, typename Reference>
+    double max_error(std::vector<float> const& x, Fast&& fast, Reference&& reference)
+    {
+        using P = Pack<float, N>;
+
+        double error{0.0};
+        std::array<float, N> out;
+        for (std::size_t i{0}; i + N <= x.size(); i += N)
+        {
+            fast(P::load(x.data() + i)).store(out.data());
+            for (std::size_t k{0}; k < N; ++k)
+            {
+                error = std::max(
+                    error,
+                    std::abs(static_cast<double>(out[k])
+                             - reference(static_cast<double>(x[i + k]))));
+            }
+        }
+        return error;
+    }
+
+    template<std::size_t N>
+    void check_fast_functions()
+    {
+        using P = Pack<float, N>;
+
+        std::vector<float> unit(1 << 16);
+        std::vector<float> angles(1 << 16);
+        for (std::size_t i{0}; i < unit.size(); ++i)
+        {
+            auto t    = static_cast<double>(i) / static_cast<double>(unit.size() - 1);
+            unit[i]   = static_cast<float>(-1.0 + 2.0 * t);
+            angles[i] = static_cast<float>(-8192.0 + 16384.0 * t);
+        }
+
+        auto acos_error = max_error<N>(
+            unit,
+            [](P x) {
+                return fast_acos(x);
+            },
+            [](double x) {
+                return std::acos(x);
+            });
+        REQUIRE(acos_error < 4.4e-7);
+
+        auto sin_error = max_error<N>(
+            angles,
+            [](P x) {
+                P s, c;
+                fast_sincos(x, s, c);
+                return s;
+            },
+            [](double x) {
+                return std::sin(x);
+            });
+        auto cos_error = max_error<N>(
+            angles,
+            [](P x) {
+                P s, c;
+                fast_sincos(x, s, c);
+                return c;
+            },
+            [](double x) {
+                return std::cos(x);
+            });
+        REQUIRE(sin_error < 9.3e-8);
+        REQUIRE(cos_error < 9.3e-8);
+
+        // Sweep the full circle at several radii. The reference uses the
+        // rounded float inputs, so only the approximation is measured.
+        double atan_error{0.0};
+        std::array<float, N> y;
+        std::array<float, N> x;
+        std::array<float, N> out;
+        for (std::size_t i{0}; i + N <= angles.size(); i += N)
+        {
+            for (std::size_t k{0}; k < N; ++k)
+            {
+                double t = glm::pi<double>() * static_cast<double>(unit[i + k]);
+                double r = std::pow(10.0, static_cast<double>((i + k) % 13) - 6.0);
+                y[k]     = static_cast<float>(r * std::sin(t));
+                x[k]     = static_cast<float>(r * std::cos(t));
+            }
+
+            fast_atan2(P::load(y.data()), P::load(x.data())).store(out.data());
+            for (std::size_t k{0}; k < N; ++k)
+            {
+                double ref =
+                    std::atan2(static_cast<double>(y[k]), static_cast<double>(x[k]));
+                double e   = std::abs(static_cast<double>(out[k]) - ref);
+                atan_error = std::max(atan_error, std::min(e, glm::two_pi<double>() - e));
+            }
+        }
+        REQUIRE(atan_error < 3.1e-7);
+
+        // The axes and the origin.
+        std::array<float, N> ys;
+        std::array<float, N> xs;
+        ys.fill(0.0f);
+        xs.fill(0.0f);
+        ys[0] = 1.0f;
+        ys[1] = -1.0f;
+        if constexpr (N > 3)
+        {
+            xs[2] = -1.0f;
+            xs[3] = 1.0f;
+        }
+        fast_atan2(P::load(ys.data()), P::load(xs.data())).store(out.data());
+        REQUIRE(out[0] == glm::half_pi<float>());
+        REQUIRE(out[1] == -glm::half_pi<float>());
+        if constexpr (N > 3)
+        {
+            REQUIRE(out[2] == glm::pi<float>());
+            REQUIRE(out[3] == 0.0f);
+        }
+    }
+} // namespace
+
+TEST_CASE("[simd] - Pack: float", "[math]")
+{
+    check_pack<float, 4>();
+    check_pack<float, 8>();
+    check_pack<float, 16>();
+    check_pack<float, 3>();
+}
+
+TEST_CASE("[simd] - Pack: double", "[math]")
+{
+    check_pack<double, 2>();
+    check_pack<double, 4>();
+    check_pack<double, 8>();
+}
+
+TEST_CASE("[simd] - native_width", "[math]")
+{
+    REQUIRE(native_width<float> >= 4);
+    REQUIRE(native_width<double> >= 2);
+    REQUIRE(native_width<float> >= native_width<double>);
+}
+
+TEST_CASE("[simd] - fast transcendentals", "[math]")
+{
+    check_fast_functions<4>();
+    check_fast_functions<8>();
+    check_fast_functions<16>();
+    check_fast_functions<native_width<float>>();
+}
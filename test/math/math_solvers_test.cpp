@@ -3,6 +3,9 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <vector>
+
 using namespace atlas::math;
 using zeus::are_equal;
 
@@ -166,3 +169,354 @@ TEST_CASE("[solvers] - solve_quartic", "[math]")
         }
     }
 }
+
+TEST_CASE("[solvers] - solve_quadratic: fixed size", "[math]")
+{
+    {
+        std::array<double, 3> coefficients{1.0, 0.0, -1.0};
+        std::array<double, 2> roots{};
+        auto num_roots = solve_quadratic(coefficients, roots);
+
+        REQUIRE(num_roots == 2);
+        REQUIRE(are_equal(roots[0], 1.0));
+        REQUIRE(are_equal(roots[1], -1.0));
+    }
+
+    {
+        std::array<double, 3> coefficients{1.0, 0.0, 1.0};
+        std::array<double, 2> roots{};
+        REQUIRE(solve_polynomial(coefficients, roots) == 0);
+    }
+
+    // x^2 - 5x + 6: roots 3, 2.
+    constexpr auto roots = [] {
+        std::array<double, 3> coefficients{6.0, -5.0, 1.0};
+        std::array<double, 2> r{};
+        solve_quadratic(coefficients, r);
+        return r;
+    }();
+    STATIC_REQUIRE(roots[0] > 2.999999 && roots[0] < 3.000001);
+    STATIC_REQUIRE(roots[1] > 1.999999 && roots[1] < 2.000001);
+}
+
+TEST_CASE("[solvers] - solve_cubic: fixed size", "[math]")
+{
+    {
+        std::array<double, 4> coefficients{-6.0, 11.0, -6.0, 1.0};
+        std::array<double, 3> roots{};
+        auto num_roots = solve_cubic(coefficients, roots);
+
+        REQUIRE(num_roots == 3);
+        REQUIRE(are_equal(roots[0], 3.0));
+        REQUIRE(are_equal(roots[1], 2.0));
+        REQUIRE(are_equal(roots[2], 1.0));
+    }
+
+    constexpr auto roots = [] {
+        std::array<double, 4> coefficients{-6.0, 11.0, -6.0, 1.0};
+        std::array<double, 3> r{};
+        solve_cubic(coefficients, r);
+        return r;
+    }();
+    STATIC_REQUIRE(roots[0] > 2.999999 && roots[0] < 3.000001);
+    STATIC_REQUIRE(roots[1] > 1.999999 && roots[1] < 2.000001);
+    STATIC_REQUIRE(roots[2] > 0.999999 && roots[2] < 1.000001);
+}
+
+TEST_CASE("[solvers] - solve_quartic: fixed size", "[math]")
+{
+    {
+        std::array<double, 5> coefficients{24.0, -50.0, 35.0, -10.0, 1.0};
+        std::array<double, 4> roots{};
+        auto num_roots = solve_quartic(coefficients, roots);
+
+        REQUIRE(num_roots == 4);
+        REQUIRE(are_equal(roots[0], 2.0));
+        REQUIRE(are_equal(roots[1], 1.0));
+        REQUIRE(are_equal(roots[2], 4.0));
+        REQUIRE(are_equal(roots[3], 3.0));
+    }
+
+    {
+        std::array<double, 5> coefficients{2.0, -3.0, 3.0, -3.0, 1.0};
+        std::array<double, 4> roots{};
+        auto num_roots = solve_polynomial(coefficients, roots);
+
+        REQUIRE(num_roots == 2);
+        REQUIRE(are_equal(roots[0], 2.0));
+        REQUIRE(are_equal(roots[1], 1.0));
+    }
+}
+
+TEST_CASE("[solvers] - fixed size matches std::vector", "[math]")
+{
+    // Sweep a family of polynomials that exercises every branch and make
+    // sure the allocation-free versions give bit-identical results.
+    for (int i{-20}; i <= 20; ++i)
+    {
+        double a = i * 0.37;
+        double b = 1.0 - i * 0.11;
+
+        std::vector<double> vq{a, b, 1.0};
+        std::vector<double> vq_roots;
+        std::array<double, 3> aq{a, b, 1.0};
+        std::array<double, 2> aq_roots{};
+        auto nq = solve_quadratic(vq, vq_roots);
+        REQUIRE(nq == solve_quadratic(aq, aq_roots));
+        for (std::size_t r{0}; r < nq; ++r)
+        {
+            REQUIRE(vq_roots[r] == aq_roots[r]);
+        }
+
+        std::vector<double> vc{a, b, -a * b, 1.0};
+        std::vector<double> vc_roots;
+        std::array<double, 4> ac{a, b, -a * b, 1.0};
+        std::array<double, 3> ac_roots{};
+        auto nc = solve_cubic(vc, vc_roots);
+        REQUIRE(nc == solve_cubic(ac, ac_roots));
+        for (std::size_t r{0}; r < nc; ++r)
+        {
+            REQUIRE(vc_roots[r] == ac_roots[r]);
+        }
+
+        std::vector<double> vr{a, b, -4.0, a * 0.5, 1.0};
+        std::vector<double> vr_roots;
+        std::array<double, 5> ar{a, b, -4.0, a * 0.5, 1.0};
+        std::array<double, 4> ar_roots{};
+        auto nr = solve_quartic(vr, vr_roots);
+        REQUIRE(nr == solve_quartic(ar, ar_roots));
+        for (std::size_t r{0}; r < nr; ++r)
+        {
+            REQUIRE(vr_roots[r] == ar_roots[r]);
+        }
+    }
+}
+
+namespace
+{
+    // Builds a deterministic set of random monic polynomials. These almost
+    // never have multiple roots, see make_repeated_roots for those.
+    template<typename T>
+    std::vector<std::vector<T>> make_batch_coefficients(std::size_t degree,
+                                                        std::size_t count)
+    {
+        std::vector<std::vector<T>> coeffs(degree + 1, std::vector<T>(count));
+        std::uint32_t state{12345};
+        auto next = [&state]() {
+            state = state * 1664525u + 1013904223u;
+            return static_cast<T>(state >> 8) / static_cast<T>(1 << 24) * T{8} - T{4};
+        };
+
+        for (std::size_t i{0}; i < count; ++i)
+        {
+            for (std::size_t k{0}; k < degree; ++k)
+            {
+                coeffs[k][i] = next();
+            }
+            coeffs[degree][i] = T{1};
+        }
+
+        return coeffs;
+    }
+
+    // Roots of monic polynomials with multiple roots. They are small dyadic
+    // fractions, so the coefficients are exact and the discriminants end
+    // up far below the is_zero thresholds instead of right on them. Most
+    // of them sum to 0, which keeps the depressed form exact as well.
+    template<typename T>
+    std::vector<std::vector<T>> make_repeated_roots(std::size_t degree)
+    {
+        switch (degree)
+        {
+        case 2:
+            return {{0.5, 0.5}, {-0.25, -0.25}, {0.0, 0.0}, {1.0, 1.0}};
+
+        case 3:
+            return {{0.0, 0.0, 0.0},
+                    {0.5, 0.5, -1.0},
+                    {-0.25, -0.25, 0.5},
+                    {0.25, 0.25, 0.25}};
+
+        default:
+            return {{0.5, 0.5, -0.5, -0.5},
+                    {0.5, 0.5, 0.0, -1.0},
+                    {0.0, 0.0, 0.5, -0.5},
+                    {0.25, 0.25, 0.25, -0.75}};
+        }
+    }
+
+    // Replaces every other polynomial of a random batch with one that has
+    // repeated roots, so each pack mixes lanes from both kinds. Returns
+    // the number of distinct roots of each replaced polynomial, or 0 for
+    // the untouched ones.
+    template<typename T>
+    std::vector<std::size_t> add_repeated_roots(std::vector<std::vector<T>>& coeffs)
+    {
+        auto degree     = coeffs.size() - 1;
+        auto root_sets  = make_repeated_roots<T>(degree);
+        auto count      = coeffs[0].size();
+        std::vector<std::size_t> distinct(count, 0);
+        for (std::size_t i{1}; i < count; i += 2)
+        {
+            auto const& roots = root_sets[(i / 2) % root_sets.size()];
+
+            // Expand (x - r0)(x - r1)... one root at a time.
+            std::vector<T> c{T{1}};
+            for (auto root : roots)
+            {
+                c.insert(c.begin(), T{0});
+                for (std::size_t k{0}; k + 1 < c.size(); ++k)
+                {
+                    c[k] -= root * c[k + 1];
+                }
+            }
+
+            for (std::size_t k{0}; k <= degree; ++k)
+            {
+                coeffs[k][i] = c[k];
+            }
+
+            std::vector<T> unique{roots};
+            std::sort(unique.begin(), unique.end());
+            distinct[i] = static_cast<std::size_t>(
+                std::unique(unique.begin(), unique.end()) - unique.begin());
+        }
+
+        return distinct;
+    }
+
+    template<typename T,
+             std::size_t W,
+             std::size_t Degree,
+             typename Batch,
+             typename Scalar>
+    std::vector<std::size_t> check_batch(std::vector<std::vector<T>> const& coeffs,
+                                         Batch&& batch,
+                                         Scalar&& scalar,
+                                         T tolerance)
+    {
+        auto count = coeffs[0].size();
+
+        std::array<std::span<T const>, Degree + 1> coeff_spans;
+        for (std::size_t k{0}; k <= Degree; ++k)
+        {
+            coeff_spans[k] = coeffs[k];
+        }
+
+        std::vector<std::vector<T>> roots(Degree, std::vector<T>(count));
+        std::array<std::span<T>, Degree> root_spans;
+        for (std::size_t k{0}; k < Degree; ++k)
+        {
+            root_spans[k] = roots[k];
+        }
+
+        std::vector<std::size_t> num_roots(count);
+        batch(coeff_spans, root_spans, std::span<std::size_t>{num_roots});
+
+        for (std::size_t i{0}; i < count; ++i)
+        {
+            std::array<T, Degree + 1> c;
+            for (std::size_t k{0}; k <= Degree; ++k)
+            {
+                c[k] = coeffs[k][i];
+            }
+
+            std::array<T, Degree> r{};
+            auto num = scalar(c, r);
+            INFO("equation " << i);
+            REQUIRE(num_roots[i] == num);
+            for (std::size_t k{0}; k < num; ++k)
+            {
+                REQUIRE(std::abs(roots[k][i] - r[k]) <= tolerance);
+            }
+        }
+
+        return num_roots;
+    }
+
+    template<typename T, std::size_t W>
+    void check_all_batches(T tolerance, bool repeated = false)
+    {
+        constexpr std::size_t count{67};
+
+        // The quadratic and cubic solvers report every distinct root once,
+        // the quartic one may report a double root twice.
+        auto check_distinct = [](std::vector<std::size_t> const& num_roots,
+                                 std::vector<std::size_t> const& distinct) {
+            for (std::size_t i{0}; i < distinct.size(); ++i)
+            {
+                INFO("equation " << i);
+                REQUIRE((distinct[i] == 0 || num_roots[i] == distinct[i]));
+            }
+        };
+
+        auto quadratic = make_batch_coefficients<T>(2, count);
+        auto distinct  = repeated ? add_repeated_roots(quadratic)
+                                  : std::vector<std::size_t>(count, 0);
+        auto num_roots = check_batch<T, W, 2>(
+            quadratic,
+            [](auto const& c, auto const& r, auto n) {
+                solve_quadratic_batch<T, W>(c, r, n);
+            },
+            [](std::array<T, 3> const& c, std::array<T, 2>& r) {
+                return solve_quadratic(c, r);
+            },
+            tolerance);
+        check_distinct(num_roots, distinct);
+
+        auto cubic = make_batch_coefficients<T>(3, count);
+        distinct   = repeated ? add_repeated_roots(cubic)
+                              : std::vector<std::size_t>(count, 0);
+        num_roots  = check_batch<T, W, 3>(
+            cubic,
+            [](auto const& c, auto const& r, auto n) {
+                solve_cubic_batch<T, W>(c, r, n);
+            },
+            [](std::array<T, 4> const& c, std::array<T, 3>& r) {
+                return solve_cubic(c, r);
+            },
+            tolerance);
+        check_distinct(num_roots, distinct);
+
+        auto quartic = make_batch_coefficients<T>(4, count);
+        if (repeated)
+        {
+            add_repeated_roots(quartic);
+        }
+        check_batch<T, W, 4>(
+            quartic,
+            [](auto const& c, auto const& r, auto n) {
+                solve_quartic_batch<T, W>(c, r, n);
+            },
+            [](std::array<T, 5> const& c, std::array<T, 4>& r) {
+                return solve_quartic(c, r);
+            },
+            tolerance);
+    }
+} // namespace
+
+TEST_CASE("[solvers] - batch solvers: double", "[math]")
+{
+    check_all_batches<double, 2>(1e-9);
+    check_all_batches<double, 4>(1e-9);
+    check_all_batches<double, 8>(1e-9);
+    check_all_batches<double, simd::native_width<double>>(1e-9);
+}
+
+TEST_CASE("[solvers] - batch solvers: float", "[math]")
+{
+    check_all_batches<float, 4>(1e-3f);
+    check_all_batches<float, 8>(1e-3f);
+    check_all_batches<float, 16>(1e-3f);
+    check_all_batches<float, simd::native_width<float>>(1e-3f);
+}
+
+TEST_CASE("[solvers] - batch solvers: repeated roots", "[math]")
+{
+    check_all_batches<double, 2>(1e-9, true);
+    check_all_batches<double, 4>(1e-9, true);
+    check_all_batches<double, 8>(1e-9, true);
+    check_all_batches<float, 4>(1e-3f, true);
+    check_all_batches<float, 8>(1e-3f, true);
+    check_all_batches<float, 16>(1e-3f, true);
+}
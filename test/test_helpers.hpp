@@ -0,0 +1,205 @@
+#pragma once
+
+#include <atlas/math/ray.hpp>
+#include <atlas/math/sampling.hpp>
+#include <atlas/math/sequences.hpp>
+#include <atlas/utils/cameras.hpp>
+#include <atlas/utils/image_writer.hpp>
+#include <atlas/utils/texture_loader.hpp>
+
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Fixtures shared by the tests and benchmarks.
+namespace atlas::test
+{
+    inline std::string temp_path(std::string const& name)
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    // Gradient in red and green, with the row number in blue.
+    inline std::vector<unsigned char> make_pixels(int width, int height, int channels)
+    {
+        std::vector<unsigned char> pixels(static_cast<std::size_t>(width) * height *
+                                          channels);
+        for (int y{0}; y < height; ++y)
+        {
+            for (int x{0}; x < width; ++x)
+            {
+                auto pixel = pixels.data() + (static_cast<std::size_t>(y) * width + x) *
+                                                 channels;
+                unsigned char values[]{static_cast<unsigned char>(x * 255 / width),
+                                       static_cast<unsigned char>(y * 255 / height),
+                                       static_cast<unsigned char>(y),
+                                       static_cast<unsigned char>(255 - x)};
+                std::copy(values, values + channels, pixel);
+            }
+        }
+        return pixels;
+    }
+
+    // Writes make_pixels to a PNG in the temporary directory and returns its
+    // path.
+    inline std::string
+    write_png(std::string const& name, int width, int height, int channels)
+    {
+        auto path   = temp_path(name);
+        auto pixels = make_pixels(width, height, channels);
+        stbi_write_png(path.c_str(), width, height, channels, pixels.data(), 0);
+        return path;
+    }
+
+    inline utils::ImageData make_image(int width, int height, int channels)
+    {
+        utils::ImageData image;
+        image.width    = width;
+        image.height   = height;
+        image.channels = channels;
+        image.pixels.resize(static_cast<std::size_t>(width) * height * channels);
+        for (std::size_t i{0}; i < image.pixels.size(); ++i)
+        {
+            image.pixels[i] = static_cast<unsigned char>(i * 31 + i / 7);
+        }
+        return image;
+    }
+
+    // Uniform noise from a linear congruential generator, so that different
+    // seeds give images that differ everywhere.
+    inline utils::ImageData
+    make_noise_image(int width, int height, int channels, unsigned seed)
+    {
+        utils::ImageData image;
+        image.width    = width;
+        image.height   = height;
+        image.channels = channels;
+        image.pixels.resize(static_cast<std::size_t>(width) * height * channels);
+        for (auto& value : image.pixels)
+        {
+            seed  = seed * 1664525u + 1013904223u;
+            value = static_cast<unsigned char>(seed >> 24);
+        }
+        return image;
+    }
+
+    // RMSE and largest difference over all channels, one value at a time.
+    inline std::pair<double, int> scalar_image_errors(utils::ImageData const& a,
+                                                      utils::ImageData const& b)
+    {
+        double sum{0.0};
+        int largest{0};
+        for (std::size_t i{0}; i < a.pixels.size(); ++i)
+        {
+            int d = a.pixels[i] - b.pixels[i];
+            sum += d * d;
+            largest = std::max(largest, std::abs(d));
+        }
+        return {std::sqrt(sum / static_cast<double>(a.pixels.size())), largest};
+    }
+
+    // Smooth colours with some texture, close to what photos look like at
+    // the scale of a block.
+    inline utils::TextureLevel make_texture_level(int width, int height, int channels)
+    {
+        utils::TextureLevel level;
+        level.width  = width;
+        level.height = height;
+        level.pixels.resize(static_cast<std::size_t>(width) * height * channels);
+        for (int y{0}; y < height; ++y)
+        {
+            for (int x{0}; x < width; ++x)
+            {
+                auto u     = static_cast<float>(x) / static_cast<float>(width);
+                auto v     = static_cast<float>(y) / static_cast<float>(height);
+                auto noise = 8.0f * std::sin(static_cast<float>(x * 7 + y * 13));
+                float values[]{200.0f * u + 20.0f + noise,
+                               180.0f * v + 30.0f,
+                               128.0f + 100.0f * std::sin(6.0f * (u + v)),
+                               255.0f * (1.0f - u)};
+
+                auto pixel = level.pixels.data() +
+                             (static_cast<std::size_t>(y) * width + x) * channels;
+                for (int c{0}; c < channels; ++c)
+                {
+                    pixel[c] = static_cast<unsigned char>(
+                        std::clamp(values[c], 0.0f, 255.0f));
+                }
+            }
+        }
+        return level;
+    }
+
+    inline void wait_for(utils::TextureLoader const& loader)
+    {
+        while (loader.pending() != 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+
+    class LookAtCamera : public utils::Camera
+    {
+    public:
+        LookAtCamera(glm::vec3 const& eye, glm::vec3 const& target) :
+            m_eye{eye},
+            m_target{target}
+        {}
+
+        glm::mat4 compute_view_matrix() const override
+        {
+            return glm::lookAt(m_eye, m_target, glm::vec3{0.0f, 1.0f, 0.0f});
+        }
+
+    private:
+        glm::vec3 m_eye;
+        glm::vec3 m_target;
+    };
+
+    // Rays from points around the origin towards points on a sphere, so a
+    // good fraction of them hit and miss each of the test primitives.
+    inline std::vector<math::Ray<glm::vec3>> make_primitive_rays(std::size_t count)
+    {
+        std::vector<math::Ray<glm::vec3>> rays;
+        rays.reserve(count);
+        for (std::uint32_t i{0}; i < count; ++i)
+        {
+            glm::vec3 o{math::sobol_sample<float>(i, 2) - 0.5f,
+                        math::sobol_sample<float>(i, 3) - 0.5f,
+                        -3.0f};
+            glm::vec2 u{math::sobol_sample<float>(i, 0), math::sobol_sample<float>(i, 1)};
+            glm::vec3 target = 1.5f * math::square_to_uniform_sphere(u);
+            rays.push_back({o, target - o});
+        }
+        return rays;
+    }
+
+    // Rays from a sphere of radius 4 towards points on a sphere of radius
+    // 1.2, both around the origin, for the scene from make_sphere_pair.
+    inline std::vector<math::Ray<glm::vec3>> make_scene_rays(std::size_t count)
+    {
+        std::vector<math::Ray<glm::vec3>> rays;
+        rays.reserve(count);
+        for (std::uint32_t i{0}; i < count; ++i)
+        {
+            glm::vec4 u{math::sobol_sample<float>(i, 0),
+                        math::sobol_sample<float>(i, 1),
+                        math::sobol_sample<float>(i, 2),
+                        math::sobol_sample<float>(i, 3)};
+            glm::vec3 o = 4.0f * math::square_to_uniform_sphere({u.x, u.y});
+            glm::vec3 t = 1.2f * math::square_to_uniform_sphere({u.z, u.w});
+            rays.push_back({o, t - o});
+        }
+        return rays;
+    }
+} // namespace atlas::test
@@ -0,0 +1,476 @@
+#pragma once
+
+#include <atlas/math/glm.hpp>
+#include <atlas/utils/load_obj_file.hpp>
+
+#include <fmt/printf.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Meshes and mesh files shared by the tests and benchmarks.
+namespace atlas::test
+{
+    namespace detail
+    {
+        inline void add_triangle(utils::Shape& shape,
+                                 std::size_t a,
+                                 std::size_t b,
+                                 std::size_t c)
+        {
+            auto face = shape.indices.size() / 3;
+            for (auto index : {a, b, c})
+            {
+                auto& vertex = shape.vertices[index];
+                if (vertex.face_id == std::numeric_limits<std::size_t>::max())
+                {
+                    vertex.face_id = face;
+                }
+                shape.indices.push_back(index);
+            }
+
+            shape.material_ids.push_back(0);
+            shape.smoothing_group_ids.push_back(1);
+        }
+
+        inline void add_vertex(utils::Shape& shape,
+                               glm::vec3 const& position,
+                               glm::vec3 const& normal,
+                               glm::vec2 const& uv)
+        {
+            utils::Vertex vertex;
+            vertex.position  = position;
+            vertex.normal    = normal;
+            vertex.tex_coord = uv;
+            vertex.index     = shape.vertices.size();
+            vertex.face_id   = std::numeric_limits<std::size_t>::max();
+            shape.vertices.push_back(vertex);
+        }
+    } // namespace detail
+
+    // UV sphere with 2 * rings segments around the z axis and outward facing
+    // triangles. Each pole is a single point, so the triangles around them
+    // are degenerate, and the seam at phi = 0 has its own vertices, like most
+    // exported spheres. The degenerate triangles start at a pole, which gives
+    // them an edge of length 0 from their first corner, so ray intersection
+    // tests see a determinant of exactly 0 and miss them.
+    inline utils::Shape make_sphere(std::size_t rings,
+                                    float radius            = 1.0f,
+                                    glm::vec3 const& centre = glm::vec3{0.0f})
+    {
+        utils::Shape shape;
+        auto segments = 2 * rings;
+        for (std::size_t r{0}; r <= rings; ++r)
+        {
+            for (std::size_t s{0}; s <= segments; ++s)
+            {
+                auto u     = static_cast<float>(s) / segments;
+                auto v     = static_cast<float>(r) / rings;
+                auto theta = glm::pi<float>() * v;
+                auto phi   = glm::two_pi<float>() * u;
+
+                auto sin_theta = (r == 0 || r == rings) ? 0.0f : glm::sin(theta);
+                glm::vec3 n{sin_theta * glm::cos(phi),
+                            sin_theta * glm::sin(phi),
+                            glm::cos(theta)};
+                detail::add_vertex(shape, centre + n * radius, n, glm::vec2{u, v});
+            }
+        }
+
+        for (std::size_t r{0}; r < rings; ++r)
+        {
+            for (std::size_t s{0}; s < segments; ++s)
+            {
+                auto a = r * (segments + 1) + s;
+                auto b = a + segments + 1;
+                detail::add_triangle(shape, b, b + 1, a);
+                detail::add_triangle(shape, a, b + 1, a + 1);
+            }
+        }
+        return shape;
+    }
+
+    // Two overlapping spheres with a bit of noise on the radius so that the
+    // triangles aren't all the same size. A ray along z would hit every
+    // triangle around a pole at the same t, so the poles are turned onto y
+    // to keep the closest face unambiguous.
+    inline utils::ObjMesh make_sphere_pair(std::size_t rings)
+    {
+        utils::ObjMesh mesh;
+        mesh.shapes.push_back(make_sphere(rings));
+        mesh.shapes.push_back(make_sphere(rings / 2, 0.5f, glm::vec3{1.5f, 0.0f, 0.5f}));
+
+        for (auto& shape : mesh.shapes)
+        {
+            for (auto& v : shape.vertices)
+            {
+                std::swap(v.position.y, v.position.z);
+                std::swap(v.normal.y, v.normal.z);
+
+                // Keep each pole on a single point.
+                if (v.tex_coord.y == 0.0f || v.tex_coord.y == 1.0f)
+                {
+                    continue;
+                }
+
+                float theta = glm::pi<float>() * v.tex_coord.y;
+                float phi   = glm::two_pi<float>() * v.tex_coord.x;
+                v.position += 0.05f * glm::sin(13.0f * theta) * glm::cos(7.0f * phi)
+                              * v.normal;
+            }
+        }
+        return mesh;
+    }
+
+    // A unit sphere resting on a large floor quad at y = -1, which has no
+    // normals or texture coordinates.
+    inline utils::ObjMesh make_sphere_on_floor(std::size_t rings)
+    {
+        utils::ObjMesh mesh;
+        mesh.shapes.push_back(make_sphere(rings));
+
+        utils::Shape floor;
+        floor.has_normals        = false;
+        floor.has_texture_coords = false;
+        for (glm::vec2 corner : {glm::vec2{-10, -10},
+                                 glm::vec2{10, -10},
+                                 glm::vec2{10, 10},
+                                 glm::vec2{-10, 10}})
+        {
+            utils::Vertex v;
+            v.position = {corner.x, -1.0f, corner.y};
+            v.index    = floor.vertices.size();
+            floor.vertices.push_back(v);
+        }
+        floor.indices = {0, 2, 1, 0, 3, 2};
+        mesh.shapes.push_back(floor);
+
+        return mesh;
+    }
+
+    // Grid of size x size quads over [0, size]^2 in the xy plane, facing +z,
+    // with its triangles in row order. Columns at or after split get their
+    // own copies of the vertices, which makes a seam along x = split. Every
+    // vertex on one side of the seam has the texture coordinate (0, 0) and
+    // on the other (1, 0).
+    inline utils::Shape
+    make_grid(std::size_t size,
+              std::size_t split = std::numeric_limits<std::size_t>::max())
+    {
+        utils::Shape shape;
+        auto const row    = size + 1;
+        auto const charts = (split < size) ? 2u : 1u;
+        for (std::size_t chart{0}; chart < charts; ++chart)
+        {
+            for (std::size_t y{0}; y <= size; ++y)
+            {
+                for (std::size_t x{0}; x <= size; ++x)
+                {
+                    detail::add_vertex(shape,
+                                       glm::vec3{x, y, 0.0f},
+                                       glm::vec3{0.0f, 0.0f, 1.0f},
+                                       glm::vec2{static_cast<float>(chart), 0.0f});
+                }
+            }
+        }
+
+        for (std::size_t y{0}; y < size; ++y)
+        {
+            for (std::size_t x{0}; x < size; ++x)
+            {
+                auto a = y * row + x + ((x < split) ? 0 : row * row);
+                auto b = a + row;
+                detail::add_triangle(shape, a, a + 1, b + 1);
+                detail::add_triangle(shape, a, b + 1, b);
+            }
+        }
+        return shape;
+    }
+
+    // Writes a size x size grid of quads over [0, 1]^2 to an OBJ file in the
+    // temporary directory, with normals and texture coordinates, and returns
+    // its path.
+    inline std::string write_obj_grid(std::string const& name, std::size_t size)
+    {
+        auto path = (std::filesystem::temp_directory_path() / name).string();
+        std::ofstream stream{path};
+
+        auto step = 1.0f / static_cast<float>(size);
+        for (std::size_t y{0}; y <= size; ++y)
+        {
+            for (std::size_t x{0}; x <= size; ++x)
+            {
+                auto u = static_cast<float>(x) * step;
+                auto v = static_cast<float>(y) * step;
+                stream << fmt::format("v {} {} 0\nvt {} {}\n", u, v, u, v);
+            }
+        }
+        stream << "vn 0 0 1\n";
+
+        for (std::size_t y{0}; y < size; ++y)
+        {
+            for (std::size_t x{0}; x < size; ++x)
+            {
+                auto a = y * (size + 1) + x + 1;
+                auto b = a + size + 1;
+                stream << fmt::format(
+                    "f {0}/{0}/1 {1}/{1}/1 {2}/{2}/1 {3}/{3}/1\n", a, a + 1, b + 1, b);
+            }
+        }
+
+        return path;
+    }
+
+    // Writes contents to a file in the temporary directory and returns its
+    // path.
+    inline std::string write_file(std::string const& name, std::string const& contents)
+    {
+        auto path = (std::filesystem::temp_directory_path() / name).string();
+        std::ofstream stream{path, std::ios::binary};
+        stream << contents;
+        return path;
+    }
+
+    enum class PlyFormat
+    {
+        ascii,
+        little_endian,
+        big_endian
+    };
+
+    template<typename T>
+    void write_ply_value(std::ofstream& stream, T value, PlyFormat format)
+    {
+        if (format == PlyFormat::ascii)
+        {
+            stream << fmt::format("{} ", value);
+            return;
+        }
+
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        if ((format == PlyFormat::big_endian) !=
+            (std::endian::native == std::endian::big))
+        {
+            std::reverse(bytes, bytes + sizeof(T));
+        }
+        stream.write(bytes, sizeof(T));
+    }
+
+    // Writes a size x size grid of quads, the same as write_obj_grid. With
+    // extra set, positions are doubles, indices are 16-bit and both elements
+    // have a property that has to be skipped.
+    inline std::string write_ply_grid(std::string const& name,
+                                      std::size_t size,
+                                      PlyFormat format,
+                                      bool extra)
+    {
+        auto path = (std::filesystem::temp_directory_path() / name).string();
+        std::ofstream stream{path, std::ios::binary};
+
+        auto names = std::array{"ascii", "binary_little_endian", "binary_big_endian"};
+        auto type  = extra ? "double" : "float";
+        stream << fmt::format("ply\nformat {} 1.0\ncomment atlas test\n",
+                              names[static_cast<int>(format)]);
+        stream << fmt::format("element vertex {}\n", (size + 1) * (size + 1));
+        stream << fmt::format("property {0} x\nproperty {0} y\nproperty {0} z\n", type);
+        if (extra)
+        {
+            stream << "property uchar red\n";
+        }
+        stream << "property float nx\nproperty float ny\nproperty float nz\n"
+                  "property float u\nproperty float v\n";
+        stream << fmt::format("element face {}\n", size * size);
+        if (extra)
+        {
+            stream << "property uchar flags\n";
+        }
+        stream << fmt::format("property list uchar {} vertex_indices\n",
+                              extra ? "ushort" : "int");
+        stream << "element edge 1\nproperty int a\nproperty int b\nend_header\n";
+
+        auto step = 1.0f / static_cast<float>(size);
+        for (std::size_t y{0}; y <= size; ++y)
+        {
+            for (std::size_t x{0}; x <= size; ++x)
+            {
+                auto u = static_cast<float>(x) * step;
+                auto v = static_cast<float>(y) * step;
+                if (extra)
+                {
+                    write_ply_value<double>(stream, u, format);
+                    write_ply_value<double>(stream, v, format);
+                    write_ply_value<double>(stream, 0.0, format);
+                    write_ply_value<std::uint8_t>(stream, 255, format);
+                }
+                else
+                {
+                    write_ply_value(stream, u, format);
+                    write_ply_value(stream, v, format);
+                    write_ply_value(stream, 0.0f, format);
+                }
+
+                for (auto value : {0.0f, 0.0f, 1.0f, u, v})
+                {
+                    write_ply_value(stream, value, format);
+                }
+                stream << ((format == PlyFormat::ascii) ? "\n" : "");
+            }
+        }
+
+        for (std::size_t y{0}; y < size; ++y)
+        {
+            for (std::size_t x{0}; x < size; ++x)
+            {
+                auto a = y * (size + 1) + x;
+                auto b = a + size + 1;
+                if (extra)
+                {
+                    write_ply_value<std::uint8_t>(stream, 1, format);
+                }
+                write_ply_value<std::uint8_t>(stream, 4, format);
+                for (auto index : {a, a + 1, b + 1, b})
+                {
+                    if (extra)
+                    {
+                        write_ply_value(
+                            stream, static_cast<std::uint16_t>(index), format);
+                    }
+                    else
+                    {
+                        write_ply_value(
+                            stream, static_cast<std::int32_t>(index), format);
+                    }
+                }
+                stream << ((format == PlyFormat::ascii) ? "\n" : "");
+            }
+        }
+
+        write_ply_value<std::int32_t>(stream, 0, format);
+        write_ply_value<std::int32_t>(stream, 1, format);
+        return path;
+    }
+
+    using StlTriangle = std::array<glm::vec3, 3>;
+
+    // Triangles of a size x size grid of quads over [0, 1]^2, split the same
+    // way the OBJ loaders split them.
+    inline std::vector<StlTriangle> grid_triangles(std::size_t size)
+    {
+        auto grid = make_grid(size);
+        auto step = 1.0f / static_cast<float>(size);
+
+        std::vector<StlTriangle> triangles;
+        for (std::size_t i{0}; i < grid.indices.size(); i += 3)
+        {
+            StlTriangle triangle;
+            for (std::size_t k{0}; k < 3; ++k)
+            {
+                triangle[k] = grid.vertices[grid.indices[i + k]].position * step;
+            }
+            triangles.push_back(triangle);
+        }
+        return triangles;
+    }
+
+    // Binary files start with "solid" on purpose, since plenty of exporters
+    // do that.
+    inline std::string write_stl_binary(std::string const& name,
+                                        std::vector<StlTriangle> const& triangles,
+                                        glm::vec3 const& normal)
+    {
+        auto path = (std::filesystem::temp_directory_path() / name).string();
+        std::ofstream stream{path, std::ios::binary};
+
+        std::string header(80, ' ');
+        header.replace(0, 11, "solid atlas");
+        stream.write(header.data(), 80);
+
+        auto count = static_cast<std::uint32_t>(triangles.size());
+        stream.write(reinterpret_cast<char const*>(&count), 4);
+        for (auto const& triangle : triangles)
+        {
+            std::uint16_t attributes{0};
+            stream.write(reinterpret_cast<char const*>(&normal), 12);
+            stream.write(reinterpret_cast<char const*>(triangle.data()), 36);
+            stream.write(reinterpret_cast<char const*>(&attributes), 2);
+        }
+        return path;
+    }
+
+    inline std::string stl_ascii_solid(std::string const& name,
+                                       std::vector<StlTriangle> const& triangles,
+                                       glm::vec3 const& normal)
+    {
+        auto text = fmt::format("solid {}\n", name);
+        for (auto const& triangle : triangles)
+        {
+            text += fmt::format("  facet normal {} {} {}\n    outer loop\n",
+                                normal.x,
+                                normal.y,
+                                normal.z);
+            for (auto const& p : triangle)
+            {
+                text += fmt::format("      vertex {} {} {}\n", p.x, p.y, p.z);
+            }
+            text += "    endloop\n  endfacet\n";
+        }
+        return text + fmt::format("endsolid {}\n", name);
+    }
+
+    // Adds a triangle whose material and smoothing group come from its face
+    // number, so that reordering the faces can be checked.
+    inline void
+    add_tagged_triangle(utils::Shape& shape, std::size_t a, std::size_t b, std::size_t c)
+    {
+        auto face = shape.indices.size() / 3;
+        for (auto index : {a, b, c})
+        {
+            auto& vertex = shape.vertices[index];
+            if (vertex.face_id == std::numeric_limits<std::size_t>::max())
+            {
+                vertex.face_id = face;
+            }
+            shape.indices.push_back(index);
+        }
+
+        shape.material_ids.push_back(static_cast<int>(face % 7));
+        shape.smoothing_group_ids.push_back(static_cast<unsigned int>(face));
+    }
+
+    // Puts the triangles in a fixed random order and tags them again with
+    // add_tagged_triangle.
+    inline void shuffle_triangles(utils::Shape& shape)
+    {
+        using Triangle = std::array<std::size_t, 3>;
+        std::vector<Triangle> triangles(shape.indices.size() / 3);
+        std::copy(shape.indices.begin(),
+                  shape.indices.end(),
+                  reinterpret_cast<std::size_t*>(triangles.data()));
+        std::shuffle(triangles.begin(), triangles.end(), std::mt19937{42});
+
+        auto vertices  = std::move(shape.vertices);
+        shape          = {};
+        shape.vertices = std::move(vertices);
+        for (auto& vertex : shape.vertices)
+        {
+            vertex.face_id = std::numeric_limits<std::size_t>::max();
+        }
+
+        for (auto const& [a, b, c] : triangles)
+        {
+            add_tagged_triangle(shape, a, b, c);
+        }
+    }
+} // namespace atlas::test
@@ -0,0 +1,135 @@
+#include "test_helpers.hpp"
+#include "test_shapes.hpp"
+
+#include <atlas/utils/bvh.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace atlas;
+
+namespace
+{
+    std::optional<utils::BvhHit> brute_force(utils::ObjMesh const& mesh,
+                                             math::Ray<glm::vec3> const& ray)
+    {
+        std::optional<utils::BvhHit> result;
+        float t_max = std::numeric_limits<float>::max();
+        for (std::size_t s{0}; s < mesh.shapes.size(); ++s)
+        {
+            auto const& shape = mesh.shapes[s];
+            for (std::size_t f{0}; f < shape.indices.size(); f += 3)
+            {
+                math::Triangle tri{shape.vertices[shape.indices[f + 0]].position,
+                                   shape.vertices[shape.indices[f + 1]].position,
+                                   shape.vertices[shape.indices[f + 2]].position};
+                if (auto hit = math::intersect(ray, tri, 0.0f, t_max))
+                {
+                    t_max  = hit->t;
+                    result = utils::BvhHit{hit->t,
+                                           hit->u,
+                                           hit->v,
+                                           static_cast<std::uint32_t>(s),
+                                           static_cast<std::uint32_t>(f / 3)};
+                }
+            }
+        }
+        return result;
+    }
+
+    template<std::size_t Width>
+    void check_bvh(jobs::JobSystem& system, utils::BvhSettings const& settings)
+    {
+        auto mesh = test::make_sphere_pair(24);
+        utils::Bvh<Width> bvh{mesh, system, settings};
+
+        REQUIRE(bvh.triangle_count() == 24 * 48 * 2 + 12 * 24 * 2);
+        REQUIRE_FALSE(bvh.nodes().empty());
+
+        std::size_t hits{0};
+        for (auto const& ray : test::make_scene_rays(512))
+        {
+            auto expected = brute_force(mesh, ray);
+            auto hit      = bvh.closest_hit(ray);
+            REQUIRE(hit.has_value() == expected.has_value());
+            REQUIRE(bvh.any_hit(ray) == expected.has_value());
+            if (!expected)
+            {
+                continue;
+            }
+
+            ++hits;
+            REQUIRE(hit->t == expected->t);
+            REQUIRE(hit->shape_id == expected->shape_id);
+            REQUIRE(hit->face_id == expected->face_id);
+
+            // Shortening the ray to just before the hit must miss.
+            REQUIRE_FALSE(bvh.any_hit(ray, 0.0f, expected->t * 0.999f));
+        }
+
+        REQUIRE(hits > 0);
+    }
+} // namespace
+
+TEST_CASE("[bvh] - empty mesh", "[utils]")
+{
+    jobs::JobSystem system;
+    utils::Bvh4 bvh{utils::ObjMesh{}, system};
+    math::Ray<glm::vec3> ray{glm::vec3{0.0f}, glm::vec3{0.0f, 0.0f, 1.0f}};
+
+    REQUIRE(bvh.nodes().empty());
+    REQUIRE_FALSE(bvh.closest_hit(ray));
+    REQUIRE_FALSE(bvh.any_hit(ray));
+}
+
+TEST_CASE("[bvh] - single triangle", "[utils]")
+{
+    utils::Shape shape;
+    for (auto p : {glm::vec3{0.0f, 0.0f, 1.0f},
+                   glm::vec3{1.0f, 0.0f, 1.0f},
+                   glm::vec3{0.0f, 1.0f, 1.0f}})
+    {
+        utils::Vertex v;
+        v.position = p;
+        shape.vertices.push_back(v);
+    }
+    shape.indices = {0, 1, 2};
+
+    utils::ObjMesh mesh;
+    mesh.shapes.push_back(shape);
+    jobs::JobSystem system;
+    utils::Bvh8 bvh{mesh, system};
+
+    glm::vec3 o{0.25f, 0.25f, 0.0f};
+    auto hit = bvh.closest_hit({o, glm::vec3{0.0f, 0.0f, 1.0f}});
+    REQUIRE(hit);
+    REQUIRE(hit->t == 1.0f);
+    REQUIRE(hit->shape_id == 0);
+    REQUIRE(hit->face_id == 0);
+
+    REQUIRE_FALSE(bvh.any_hit({o, glm::vec3{0.0f, 0.0f, -1.0f}}));
+}
+
+TEST_CASE("[bvh] - closest and any hit: BVH4", "[utils]")
+{
+    jobs::JobSystem system;
+    check_bvh<4>(system, {});
+}
+
+TEST_CASE("[bvh] - closest and any hit: BVH8", "[utils]")
+{
+    jobs::JobSystem system;
+    check_bvh<8>(system, {});
+}
+
+TEST_CASE("[bvh] - parallel build", "[utils]")
+{
+    // Force the parallel paths with a tiny threshold.
+    utils::BvhSettings settings;
+    settings.parallel_threshold = 64;
+    settings.bin_count          = 8;
+    settings.max_leaf_size      = 2;
+
+    jobs::JobSystem system{4};
+    check_bvh<4>(system, settings);
+    check_bvh<8>(system, settings);
+}
@@ -0,0 +1,98 @@
+#include "test_helpers.hpp"
+
+#include <atlas/utils/image_compare.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdlib>
+
+using namespace atlas;
+
+TEST_CASE("[image_compare] - compare_images", "[utils]")
+{
+    SECTION("Identical")
+    {
+        auto image = test::make_noise_image(37, 19, 4, 1);
+        auto diff  = utils::compare_images(image, image);
+        REQUIRE(diff.has_value());
+        REQUIRE(diff->rmse == 0.0);
+        REQUIRE(diff->max_error == 0);
+        REQUIRE(diff->differing_pixels == 0);
+        REQUIRE(diff->image.channels == 3);
+        REQUIRE(diff->image.pixels.size() == 37 * 19 * 3);
+    }
+
+    SECTION("Errors match a scalar reference")
+    {
+        for (int channels : {1, 2, 3, 4})
+        {
+            auto a = test::make_noise_image(61, 7, channels, 2);
+            auto b = test::make_noise_image(61, 7, channels, 3);
+
+            auto diff = utils::compare_images(a, b);
+            REQUIRE(diff.has_value());
+
+            auto [rmse, largest] = test::scalar_image_errors(a, b);
+            REQUIRE(std::abs(diff->rmse - rmse) < 1e-6 * rmse);
+            REQUIRE(diff->max_error == largest);
+        }
+    }
+
+    SECTION("Perceptual threshold")
+    {
+        utils::ImageData black;
+        black.width    = 8;
+        black.height   = 8;
+        black.channels = 3;
+        black.pixels.assign(8 * 8 * 3, 0);
+
+        // A slight change everywhere and a large one in a single pixel.
+        auto changed = black;
+        for (auto& value : changed.pixels)
+        {
+            value = 4;
+        }
+        changed.pixels[3 * 19 + 0] = 255;
+        changed.pixels[3 * 19 + 1] = 255;
+        changed.pixels[3 * 19 + 2] = 255;
+
+        auto diff = utils::compare_images(black, changed);
+        REQUIRE(diff.has_value());
+        REQUIRE(diff->differing_pixels == 1);
+        REQUIRE(diff->max_error == 255);
+        REQUIRE(diff->image.pixels[3 * 19 + 0] == 255);
+        REQUIRE(diff->image.pixels[3 * 19 + 1] == 0);
+        REQUIRE(diff->image.pixels[0] == diff->image.pixels[1]);
+
+        REQUIRE(utils::compare_images(black, changed, 0.0f)->differing_pixels == 64);
+        REQUIRE(utils::compare_images(black, changed, 1.0f)->differing_pixels == 0);
+    }
+
+    SECTION("Transparent pixels")
+    {
+        // Fully transparent colours all look the same over white.
+        auto a = test::make_noise_image(4, 4, 4, 4);
+        auto b = test::make_noise_image(4, 4, 4, 5);
+        for (std::size_t i{3}; i < a.pixels.size(); i += 4)
+        {
+            a.pixels[i] = b.pixels[i] = 0;
+        }
+
+        auto diff = utils::compare_images(a, b);
+        REQUIRE(diff->differing_pixels == 0);
+        REQUIRE(diff->max_error > 0);
+    }
+
+    SECTION("Mismatched images")
+    {
+        auto image   = test::make_noise_image(8, 8, 3, 6);
+        auto shorter = test::make_noise_image(8, 7, 3, 6);
+        auto rgba    = test::make_noise_image(8, 8, 4, 6);
+        REQUIRE_FALSE(utils::compare_images(image, shorter).has_value());
+        REQUIRE_FALSE(utils::compare_images(image, rgba).has_value());
+
+        auto truncated = image;
+        truncated.pixels.pop_back();
+        REQUIRE_FALSE(utils::compare_images(image, truncated).has_value());
+    }
+}
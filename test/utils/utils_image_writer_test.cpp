@@ -0,0 +1,152 @@
+#include "test_helpers.hpp"
+
+#include <atlas/utils/image_writer.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+#include <stb_image.h>
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace atlas;
+
+namespace
+{
+    std::vector<unsigned char> load_png(std::string const& path, int channels)
+    {
+        int width, height, file_channels;
+        auto data = stbi_load(path.c_str(), &width, &height, &file_channels, channels);
+        if (data == nullptr)
+        {
+            return {};
+        }
+
+        std::vector<unsigned char> pixels(
+            data, data + static_cast<std::size_t>(width) * height * channels);
+        stbi_image_free(data);
+        return pixels;
+    }
+} // namespace
+
+TEST_CASE("[image_writer] - write_image", "[utils]")
+{
+    auto directory = std::filesystem::temp_directory_path() / "atlas_image_writer";
+    std::filesystem::create_directories(directory);
+
+    SECTION("Formats")
+    {
+        auto image = test::make_image(13, 7, 3);
+        for (auto name : {"image.png", "image.JPG", "image.bmp", "image.tga"})
+        {
+            auto path = (directory / name).string();
+            REQUIRE(utils::write_image(path, image));
+            REQUIRE(std::filesystem::file_size(path) > 0);
+        }
+
+        REQUIRE(load_png((directory / "image.png").string(), 3) == image.pixels);
+
+        REQUIRE_FALSE(utils::write_image((directory / "image.xyz").string(), image));
+        REQUIRE_FALSE(utils::write_image((directory / "image.hdr").string(), image));
+
+        image.pixels.pop_back();
+        REQUIRE_FALSE(utils::write_image((directory / "image.png").string(), image));
+    }
+
+    SECTION("HDR")
+    {
+        std::vector<float> floats(8 * 4 * 3, 1.5f);
+        utils::ImageData image;
+        image.width    = 8;
+        image.height   = 4;
+        image.channels = 3;
+        image.is_float = true;
+        image.pixels.resize(floats.size() * sizeof(float));
+        std::memcpy(image.pixels.data(), floats.data(), image.pixels.size());
+
+        auto path = (directory / "image.hdr").string();
+        REQUIRE(utils::write_image(path, image));
+        REQUIRE_FALSE(utils::write_image((directory / "image.png").string(), image));
+
+        int width, height, channels;
+        auto data = stbi_loadf(path.c_str(), &width, &height, &channels, 3);
+        REQUIRE(data != nullptr);
+        REQUIRE(width == 8);
+        REQUIRE(data[0] == 1.5f);
+        stbi_image_free(data);
+    }
+
+    SECTION("Flipped rows")
+    {
+        auto image            = test::make_image(5, 4, 4);
+        image.flip_vertically = true;
+
+        auto path = (directory / "flipped.png").string();
+        REQUIRE(utils::write_image(path, image));
+
+        auto pixels = load_png(path, 4);
+        REQUIRE(pixels.size() == image.pixels.size());
+        for (std::size_t y{0}; y < 4; ++y)
+        {
+            REQUIRE(std::memcmp(pixels.data() + y * 20,
+                                image.pixels.data() + (3 - y) * 20,
+                                20) == 0);
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("[image_writer] - ImageWriter", "[utils]")
+{
+    auto directory = std::filesystem::temp_directory_path() / "atlas_image_sequence";
+    std::filesystem::remove_all(directory);
+
+    SECTION("Sequence")
+    {
+        std::size_t accepted{0};
+        {
+            jobs::JobSystem system{3};
+            utils::ImageWriter writer{system, 4};
+            utils::ImageSequence sequence{writer, directory.string(), "frame"};
+            for (int i{0}; i < 20; ++i)
+            {
+                accepted += sequence.add(test::make_image(64, 32, 3)) ? 1 : 0;
+            }
+
+            REQUIRE(accepted >= 4);
+            REQUIRE(sequence.frame_count() == accepted);
+            REQUIRE(sequence.dropped() == 20 - accepted);
+            REQUIRE(writer.dropped() == sequence.dropped());
+
+            writer.wait();
+            REQUIRE(writer.pending() == 0);
+            REQUIRE(writer.written() == accepted);
+            REQUIRE(writer.failed() == 0);
+        }
+
+        // Dropped frames leave no gaps.
+        for (std::size_t i{0}; i < accepted; ++i)
+        {
+            auto name = fmt::format("frame_{:06}.png", i);
+            REQUIRE(load_png((directory / name).string(), 3).size() == 64 * 32 * 3);
+        }
+        REQUIRE_FALSE(std::filesystem::exists(
+            directory / fmt::format("frame_{:06}.png", accepted)));
+    }
+
+    SECTION("Failures")
+    {
+        jobs::JobSystem system{2};
+        utils::ImageWriter writer{system};
+        REQUIRE(
+            writer.write((directory / "image.xyz").string(), test::make_image(4, 4, 3)));
+        writer.wait();
+        REQUIRE(writer.failed() == 1);
+        REQUIRE(writer.written() == 0);
+    }
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,535 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/load_obj_file.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+using namespace atlas;
+
+namespace
+{
+    // Writes a grid large enough to be split into several chunks, which
+    // switches objects, materials and smoothing groups every few rows and
+    // refers to the previous row with relative indices.
+    std::string write_scene(std::string const& name, std::size_t size)
+    {
+        auto dir = std::filesystem::temp_directory_path();
+        std::ofstream{dir / "atlas_scene.mtl"} << "newmtl red\nKd 1 0 0\n"
+                                                  "newmtl blue\nKd 0 0 1\n";
+
+        auto path = (dir / name).string();
+        std::ofstream stream{path};
+        stream << "mtllib atlas_scene.mtl\nvn 0 0 1\r\n";
+
+        auto row = size + 1;
+        for (std::size_t y{0}; y <= size; ++y)
+        {
+            for (std::size_t x{0}; x <= size; ++x)
+            {
+                stream << fmt::format("v {} {} {}\nvt {} {}\n", x, y, x % 3, x, y);
+            }
+
+            if (y == 0)
+            {
+                continue;
+            }
+
+            if (y % 7 == 0)
+            {
+                stream << fmt::format("usemtl {}\n", (y % 3 == 0) ? "red" : "blue");
+            }
+            if (y % 11 == 0)
+            {
+                stream << ((y % 2 == 0) ? "s off\n" : fmt::format("s {}\n", y));
+            }
+            if (y % 13 == 0)
+            {
+                stream << fmt::format("o row_{}\ng group_{}\n", y, y);
+            }
+
+            for (std::size_t x{0}; x < size; ++x)
+            {
+                if (y % 2 == 0)
+                {
+                    auto a = static_cast<long long>(2 * row - x);
+                    auto b = a - row;
+                    stream << fmt::format(
+                        "f -{0}/-{0}/1 -{1}/-{1}/1 -{2}/-{2}/1 -{3}/-{3}/1\n",
+                        a,
+                        a - 1,
+                        b - 1,
+                        b);
+                }
+                else
+                {
+                    auto a = (y - 1) * row + x + 1;
+                    stream << fmt::format(
+                        "f {0}/{0} {1}/{1} {2}/{2}\n", a, a + 1, a + row + 1);
+                }
+            }
+        }
+
+        return path;
+    }
+
+    void check_equal(utils::ObjMesh const& lhs, utils::ObjMesh const& rhs)
+    {
+        REQUIRE(lhs.shapes.size() == rhs.shapes.size());
+        REQUIRE(lhs.materials.size() == rhs.materials.size());
+        for (std::size_t m{0}; m < lhs.materials.size(); ++m)
+        {
+            REQUIRE(lhs.materials[m].name == rhs.materials[m].name);
+        }
+
+        for (std::size_t s{0}; s < lhs.shapes.size(); ++s)
+        {
+            auto const& a = lhs.shapes[s];
+            auto const& b = rhs.shapes[s];
+            REQUIRE(a.has_normals == b.has_normals);
+            REQUIRE(a.has_texture_coords == b.has_texture_coords);
+            REQUIRE(a.indices == b.indices);
+            REQUIRE(a.material_ids == b.material_ids);
+            REQUIRE(a.smoothing_group_ids == b.smoothing_group_ids);
+            REQUIRE(a.vertices.size() == b.vertices.size());
+
+            bool same_vertices{true};
+            for (std::size_t v{0}; v < a.vertices.size(); ++v)
+            {
+                auto const& p = a.vertices[v];
+                auto const& q = b.vertices[v];
+                same_vertices = same_vertices && p.position == q.position &&
+                                p.normal == q.normal && p.tex_coord == q.tex_coord &&
+                                p.index == q.index && p.face_id == q.face_id;
+            }
+            REQUIRE(same_vertices);
+        }
+    }
+} // namespace
+
+TEST_CASE("[load_obj_file] - load_obj_mesh", "[utils]")
+{
+    SECTION("Missing file")
+    {
+        REQUIRE_FALSE(utils::load_obj_mesh("atlas_missing_file.obj").has_value());
+    }
+
+    SECTION("Shared vertices")
+    {
+        auto path = test::write_file("atlas_quads.obj",
+                                     "o first\n"
+                                     "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+                                     "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+                                     "vn 0 0 1\n"
+                                     "f 1/1/1 2/2/1 3/3/1 4/4/1\n"
+                                     "o second\n"
+                                     "f 1 2 3\n");
+
+        auto mesh = utils::load_obj_mesh(path);
+        std::filesystem::remove(path);
+        REQUIRE(mesh.has_value());
+        REQUIRE(mesh->shapes.size() == 2);
+        REQUIRE(mesh->materials.size() == 1);
+
+        // The quad is split into two triangles that share a diagonal.
+        auto const& quad = mesh->shapes[0];
+        REQUIRE(quad.has_normals);
+        REQUIRE(quad.has_texture_coords);
+        REQUIRE(quad.vertices.size() == 4);
+        REQUIRE(quad.indices.size() == 6);
+        REQUIRE(quad.material_ids.size() == 2);
+        REQUIRE(quad.smoothing_group_ids.size() == 2);
+
+        for (std::size_t i{0}; i < quad.vertices.size(); ++i)
+        {
+            REQUIRE(quad.vertices[i].index == i);
+            REQUIRE(quad.vertices[i].normal == glm::vec3{0.0f, 0.0f, 1.0f});
+            REQUIRE(quad.vertices[i].tex_coord == glm::vec2{quad.vertices[i].position});
+        }
+
+        for (auto index : quad.indices)
+        {
+            REQUIRE(index < quad.vertices.size());
+        }
+
+        auto const& triangle = mesh->shapes[1];
+        REQUIRE_FALSE(triangle.has_normals);
+        REQUIRE_FALSE(triangle.has_texture_coords);
+        REQUIRE(triangle.vertices.size() == 3);
+        REQUIRE(triangle.indices == std::vector<std::size_t>{0, 1, 2});
+    }
+}
+
+TEST_CASE("[load_obj_file] - welding", "[utils]")
+{
+    SECTION("Distinct attributes are kept")
+    {
+        // Two faces of a cube that share an edge, with their own normals and
+        // texture coordinates.
+        auto path =
+            test::write_file("atlas_edge.obj",
+                               "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 1 0 -1\nv 1 1 -1\n"
+                               "vn 0 0 1\nvn 1 0 0\nvt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+                               "f 1/1/1 2/2/1 3/3/1 4/4/1\n"
+                               "f 2/1/2 5/2/2 6/3/2 3/4/2\n");
+
+        jobs::JobSystem system{2};
+        auto meshes = {utils::load_obj_mesh(path),
+                       utils::load_obj_mesh_parallel(path, system)};
+        for (auto const& mesh : meshes)
+        {
+            REQUIRE(mesh.has_value());
+            auto const& shape = mesh->shapes[0];
+            REQUIRE(shape.vertices.size() == 8);
+            REQUIRE(shape.indices.size() == 12);
+        }
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Tolerance")
+    {
+        utils::Shape shape;
+        for (std::size_t i{0}; i < 6; ++i)
+        {
+            utils::Vertex vertex;
+            vertex.index = i;
+
+            // Three pairs of nearly identical vertices, one of them straddling
+            // a cell boundary.
+            auto offset     = (i % 2 == 0) ? 0.0f : 1e-5f;
+            vertex.position = glm::vec3{static_cast<float>(i / 2) - offset, 0.0f, 0.0f};
+            shape.vertices.push_back(vertex);
+        }
+        shape.indices = {0, 2, 4, 1, 3, 5};
+
+        auto exact = shape;
+        utils::weld_vertices(exact, 0.0f);
+        REQUIRE(exact.vertices.size() == 6);
+
+        utils::weld_vertices(shape, 1e-4f);
+        REQUIRE(shape.vertices.size() == 3);
+        REQUIRE(shape.indices == std::vector<std::size_t>{0, 1, 2, 0, 1, 2});
+        for (std::size_t i{0}; i < shape.vertices.size(); ++i)
+        {
+            REQUIRE(shape.vertices[i].index == i);
+        }
+
+        // Vertices with different normals stay apart.
+        shape.vertices[1].position = shape.vertices[0].position;
+        shape.vertices[1].normal   = glm::vec3{0.0f, 1.0f, 0.0f};
+        utils::weld_vertices(shape, 1e-4f);
+        REQUIRE(shape.vertices.size() == 3);
+
+        // The tolerance only applies to positions, so texture coordinates
+        // closer than it are still a seam.
+        shape.vertices[2].position  = shape.vertices[0].position;
+        shape.vertices[2].tex_coord = glm::vec2{1e-5f, 0.0f};
+        utils::weld_vertices(shape, 1e-4f);
+        REQUIRE(shape.vertices.size() == 3);
+    }
+
+    SECTION("While loading")
+    {
+        auto path = test::write_file("atlas_weld.obj",
+                                     "v 0 0 0\nv 1 0 0\nv 1 1 0\n"
+                                     "v 1.00001 1 0\nv 0 1 0\nv 0 0.00001 0\n"
+                                     "f 1 2 3\nf 4 5 6\n");
+
+        auto exact    = utils::load_obj_mesh(path);
+        auto welded   = utils::load_obj_mesh(path, {}, 1e-4f);
+        jobs::JobSystem system{2};
+        auto parallel = utils::load_obj_mesh_parallel(path, system, {}, 1e-4f);
+        std::filesystem::remove(path);
+
+        REQUIRE(exact->shapes[0].vertices.size() == 6);
+        REQUIRE(welded->shapes[0].vertices.size() == 4);
+        REQUIRE(parallel->shapes[0].indices == welded->shapes[0].indices);
+    }
+}
+
+TEST_CASE("[load_obj_file] - load_obj_mesh_parallel", "[utils]")
+{
+    jobs::JobSystem system{2};
+
+    SECTION("Missing file")
+    {
+        REQUIRE_FALSE(
+            utils::load_obj_mesh_parallel("atlas_missing_file.obj", system).has_value());
+    }
+
+    SECTION("Invalid face")
+    {
+        auto path = test::write_file("atlas_invalid.obj",
+                                     "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 0 1\nf 1 2 3\n");
+        auto mesh = utils::load_obj_mesh_parallel(path, system);
+        std::filesystem::remove(path);
+
+        REQUIRE(mesh.has_value());
+        REQUIRE(mesh->shapes.size() == 1);
+        REQUIRE(mesh->shapes[0].indices == std::vector<std::size_t>{0, 1, 2});
+    }
+
+    SECTION("Out of range face matches load_obj_mesh")
+    {
+        // tinyobjloader drops the second quad, which refers to a vertex that
+        // does not exist, and keeps the rest of the file.
+        auto path = test::write_file("atlas_out_of_range.obj",
+                                     "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+                                     "f 1 2 3 4\nf 1 2 3 9\nf -4 -2 -1\n");
+        auto expected = utils::load_obj_mesh(path);
+        REQUIRE(expected.has_value());
+        REQUIRE(expected->shapes[0].indices.size() == 9);
+
+        auto mesh = utils::load_obj_mesh_parallel(path, system);
+        REQUIRE(mesh.has_value());
+        check_equal(*mesh, *expected);
+
+        utils::ObjMesh streamed;
+        utils::ObjStreamCallbacks callbacks;
+        callbacks.shape_callback = [&](utils::Shape&& shape) {
+            streamed.shapes.push_back(std::move(shape));
+        };
+        callbacks.materials_callback = [&](auto const& materials) {
+            streamed.materials = materials;
+        };
+        REQUIRE(utils::stream_obj_mesh(path, callbacks, system) ==
+                utils::ObjStreamStatus::finished);
+        std::filesystem::remove(path);
+        check_equal(streamed, *expected);
+    }
+
+    SECTION("Matches load_obj_mesh")
+    {
+        auto path     = write_scene("atlas_scene.obj", 256);
+        auto expected = utils::load_obj_mesh(path);
+        REQUIRE(expected.has_value());
+        REQUIRE(expected->shapes.size() > 1);
+        REQUIRE(expected->materials.size() == 2);
+
+        for (std::size_t threads : {1, 4})
+        {
+            jobs::JobSystem threaded{threads};
+            auto mesh = utils::load_obj_mesh_parallel(path, threaded);
+            REQUIRE(mesh.has_value());
+            check_equal(*mesh, *expected);
+        }
+
+        std::filesystem::remove(path);
+        std::filesystem::remove(std::filesystem::temp_directory_path() /
+                                "atlas_scene.mtl");
+    }
+
+    SECTION("Concave polygons")
+    {
+        // A U shape, which cannot be split as a fan from its first corner.
+        auto path = test::write_file("atlas_concave.obj",
+                                     "v 0 0 0\nv 3 0 0\nv 3 3 0\nv 2 3 0\n"
+                                     "v 2 1 0\nv 1 1 0\nv 1 3 0\nv 0 3 0\n"
+                                     "f 1 2 3 4 5 6 7 8\n");
+        auto mesh = utils::load_obj_mesh_parallel(path, system);
+        std::filesystem::remove(path);
+        REQUIRE(mesh.has_value());
+
+        auto const& shape = mesh->shapes[0];
+        REQUIRE(shape.indices.size() == 18);
+
+        float area{0.0f};
+        for (std::size_t i{0}; i < shape.indices.size(); i += 3)
+        {
+            auto a = shape.vertices[shape.indices[i + 0]].position;
+            auto b = shape.vertices[shape.indices[i + 1]].position;
+            auto c = shape.vertices[shape.indices[i + 2]].position;
+
+            auto triangle_area = glm::cross(b - a, c - a).z * 0.5f;
+            REQUIRE(triangle_area > 0.0f);
+            area += triangle_area;
+        }
+        REQUIRE(area == 7.0f);
+    }
+}
+
+TEST_CASE("[load_obj_file] - stream_obj_mesh", "[utils]")
+{
+    jobs::JobSystem system{2};
+
+    SECTION("Missing file")
+    {
+        REQUIRE(utils::stream_obj_mesh("atlas_missing_file.obj", {}, system) ==
+                utils::ObjStreamStatus::failed);
+    }
+
+    SECTION("Matches load_obj_mesh")
+    {
+        auto path     = write_scene("atlas_stream.obj", 256);
+        auto expected = utils::load_obj_mesh(path);
+        REQUIRE(expected.has_value());
+
+        for (std::size_t threads : {1, 4})
+        {
+            utils::ObjMesh mesh;
+            std::size_t last_bytes{0};
+            std::size_t total_bytes{0};
+
+            utils::ObjStreamCallbacks callbacks;
+            callbacks.shape_callback = [&](utils::Shape&& shape) {
+                mesh.shapes.push_back(std::move(shape));
+            };
+            callbacks.materials_callback = [&](auto const& materials) {
+                mesh.materials = materials;
+            };
+            callbacks.progress_callback = [&](std::size_t bytes, std::size_t total) {
+                REQUIRE(bytes > last_bytes);
+                last_bytes  = bytes;
+                total_bytes = total;
+            };
+
+            // Small blocks, so shapes, polygons and relative indices all end
+            // up spanning several of them.
+            utils::ObjStreamSettings settings;
+            settings.block_size = 4096;
+
+            jobs::JobSystem threaded{threads};
+            auto status = utils::stream_obj_mesh(path, callbacks, threaded, settings);
+            REQUIRE(status == utils::ObjStreamStatus::finished);
+            REQUIRE(last_bytes == std::filesystem::file_size(path));
+            REQUIRE(total_bytes == last_bytes);
+            check_equal(mesh, *expected);
+        }
+
+        std::filesystem::remove(path);
+        std::filesystem::remove(std::filesystem::temp_directory_path() /
+                                "atlas_scene.mtl");
+    }
+
+    SECTION("Shape size limit")
+    {
+        auto path = test::write_obj_grid("atlas_stream_grid.obj", 64);
+
+        std::size_t face_count{0};
+        std::size_t shape_count{0};
+        utils::ObjStreamCallbacks callbacks;
+        callbacks.shape_callback = [&](utils::Shape&& shape) {
+            REQUIRE(shape.indices.size() <= 3 * 100);
+            face_count += shape.indices.size() / 3;
+            ++shape_count;
+        };
+
+        utils::ObjStreamSettings settings;
+        settings.max_shape_faces = 100;
+        auto status = utils::stream_obj_mesh(path, callbacks, system, settings);
+        std::filesystem::remove(path);
+
+        REQUIRE(status == utils::ObjStreamStatus::finished);
+        REQUIRE(face_count == 64 * 64 * 2);
+        REQUIRE(shape_count > 64 * 64 * 2 / 100);
+    }
+
+    SECTION("Cancellation")
+    {
+        auto path = test::write_obj_grid("atlas_stream_cancel.obj", 256);
+
+        std::stop_source source;
+        std::size_t processed{0};
+        utils::ObjStreamCallbacks callbacks;
+        callbacks.progress_callback = [&](std::size_t bytes, std::size_t) {
+            processed = bytes;
+            source.request_stop();
+        };
+
+        utils::ObjStreamSettings settings;
+        settings.block_size = 4096;
+        auto status = utils::stream_obj_mesh(
+            path, callbacks, system, settings, source.get_token());
+
+        REQUIRE(status == utils::ObjStreamStatus::cancelled);
+        REQUIRE(processed < std::filesystem::file_size(path));
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Invalid face")
+    {
+        auto path = test::write_file("atlas_stream_invalid.obj",
+                                     "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 0 1\nf 1 2 4\n"
+                                     "f 1 2 3\n");
+
+        std::size_t face_count{0};
+        utils::ObjStreamCallbacks callbacks;
+        callbacks.shape_callback = [&](utils::Shape&& shape) {
+            face_count += shape.indices.size() / 3;
+        };
+        REQUIRE(utils::stream_obj_mesh(path, callbacks, system) ==
+                utils::ObjStreamStatus::finished);
+        REQUIRE(face_count == 1);
+        std::filesystem::remove(path);
+    }
+}
+
+TEST_CASE("[load_obj_file] - ObjStream", "[utils]")
+{
+    jobs::JobSystem system{2};
+
+    SECTION("Background loading")
+    {
+        auto path     = write_scene("atlas_background.obj", 256);
+        auto expected = utils::load_obj_mesh(path);
+        REQUIRE(expected.has_value());
+
+        // Only a couple of shapes are queued at a time, so the loader has to
+        // wait for them to be taken.
+        utils::ObjStreamSettings settings;
+        settings.block_size        = 4096;
+        settings.max_queued_shapes = 2;
+
+        utils::ObjMesh mesh;
+        {
+            utils::ObjStream stream{path, system, settings};
+            while (stream.status() == utils::ObjStreamStatus::loading)
+            {
+                for (auto& shape : stream.take_shapes())
+                {
+                    mesh.shapes.push_back(std::move(shape));
+                }
+                std::this_thread::yield();
+            }
+
+            for (auto& shape : stream.take_shapes())
+            {
+                mesh.shapes.push_back(std::move(shape));
+            }
+
+            REQUIRE(stream.status() == utils::ObjStreamStatus::finished);
+            REQUIRE(stream.progress().shape_count == mesh.shapes.size());
+            REQUIRE(stream.progress().bytes == std::filesystem::file_size(path));
+            mesh.materials = stream.materials();
+        }
+        check_equal(mesh, *expected);
+
+        std::filesystem::remove(path);
+        std::filesystem::remove(std::filesystem::temp_directory_path() /
+                                "atlas_scene.mtl");
+    }
+
+    SECTION("Destroyed while loading")
+    {
+        auto path = test::write_obj_grid("atlas_abandoned.obj", 256);
+        {
+            utils::ObjStreamSettings settings;
+            settings.block_size        = 4096;
+            settings.max_shape_faces   = 16;
+            settings.max_queued_shapes = 1;
+            utils::ObjStream stream{path, system, settings};
+
+            // Nothing is ever taken, so the loader is left waiting.
+            while (stream.progress().shape_count == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        std::filesystem::remove(path);
+    }
+}
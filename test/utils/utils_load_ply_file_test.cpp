@@ -0,0 +1,202 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/load_ply_file.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace atlas;
+
+namespace
+{
+    // Same triangles in the same order, with the same attributes at every
+    // corner, regardless of how the vertices are numbered.
+    void check_same_triangles(utils::Shape const& lhs, utils::Shape const& rhs)
+    {
+        REQUIRE(lhs.has_normals == rhs.has_normals);
+        REQUIRE(lhs.has_texture_coords == rhs.has_texture_coords);
+        REQUIRE(lhs.indices.size() == rhs.indices.size());
+        REQUIRE(lhs.material_ids == rhs.material_ids);
+        REQUIRE(lhs.smoothing_group_ids == rhs.smoothing_group_ids);
+
+        bool same{true};
+        for (std::size_t c{0}; c < lhs.indices.size(); ++c)
+        {
+            auto const& a = lhs.vertices[lhs.indices[c]];
+            auto const& b = rhs.vertices[rhs.indices[c]];
+            same          = same && a.position == b.position && a.normal == b.normal &&
+                            a.tex_coord == b.tex_coord;
+        }
+        REQUIRE(same);
+    }
+} // namespace
+
+TEST_CASE("[load_ply_file] - load_ply_mesh", "[utils]")
+{
+    SECTION("Missing file")
+    {
+        REQUIRE_FALSE(utils::load_ply_mesh("atlas_missing_file.ply").has_value());
+    }
+
+    SECTION("Matches load_obj_mesh")
+    {
+        auto obj_path = test::write_obj_grid("atlas_ply_grid.obj", 16);
+        auto expected = utils::load_obj_mesh(obj_path);
+        std::filesystem::remove(obj_path);
+        REQUIRE(expected.has_value());
+
+        for (auto format : {test::PlyFormat::ascii,
+                            test::PlyFormat::little_endian,
+                            test::PlyFormat::big_endian})
+        {
+            for (auto extra : {false, true})
+            {
+                auto path = test::write_ply_grid("atlas_grid.ply", 16, format, extra);
+                auto mesh = utils::load_ply_mesh(path);
+                std::filesystem::remove(path);
+
+                REQUIRE(mesh.has_value());
+                REQUIRE(mesh->shapes.size() == 1);
+                REQUIRE(mesh->materials.size() == 1);
+
+                auto const& shape = mesh->shapes[0];
+                REQUIRE(shape.vertices.size() == 17 * 17);
+                for (std::size_t i{0}; i < shape.vertices.size(); ++i)
+                {
+                    REQUIRE(shape.vertices[i].index == i);
+                }
+                check_same_triangles(shape, expected->shapes[0]);
+            }
+        }
+    }
+
+    SECTION("Positions only")
+    {
+        auto path =
+            test::write_file("atlas_triangle.ply",
+                             "ply\nformat ascii 1.0\nelement vertex 4\n"
+                             "property float x\nproperty float y\nproperty float z\n"
+                             "element face 1\nproperty list uchar int vertex_index\n"
+                             "end_header\n0 0 0\n1 0 0\n1 1 0\n5 5 5\n3 0 1 2\n");
+        auto mesh = utils::load_ply_mesh(path);
+        std::filesystem::remove(path);
+
+        REQUIRE(mesh.has_value());
+        auto const& shape = mesh->shapes[0];
+        REQUIRE_FALSE(shape.has_normals);
+        REQUIRE_FALSE(shape.has_texture_coords);
+        REQUIRE(shape.indices == std::vector<std::size_t>{0, 1, 2});
+
+        // Unused vertices are kept.
+        REQUIRE(shape.vertices.size() == 4);
+        REQUIRE(shape.vertices[3].position == glm::vec3{5.0f});
+    }
+
+    SECTION("Invalid files")
+    {
+        auto header = std::string{"ply\nformat ascii 1.0\nelement vertex 1\n"
+                                  "property float x\nproperty float y\n"
+                                  "property float z\nelement face 1\n"
+                                  "property list uchar int vertex_indices\n"
+                                  "end_header\n"};
+
+        for (auto contents : {std::string{"not a ply file\n"},
+                              std::string{"ply\nformat binary 1.0\nend_header\n"},
+                              header + "0 0 0\n3 0 1 2\n",
+                              header + "0 0 0\n3 0 0\n"})
+        {
+            auto path = test::write_file("atlas_invalid.ply", contents);
+            REQUIRE_FALSE(utils::load_ply_mesh(path).has_value());
+            std::filesystem::remove(path);
+        }
+    }
+
+    SECTION("Vertex count larger than the file")
+    {
+        // Would need terabytes if the vertices were allocated up front.
+        for (auto format : {std::string{"ascii"}, std::string{"binary_little_endian"}})
+        {
+            auto contents = fmt::format("ply\nformat {} 1.0\n"
+                                        "element vertex 100000000000\n"
+                                        "property float x\nproperty float y\n"
+                                        "property float z\nend_header\n"
+                                        "0 0 0\n",
+                                        format);
+            auto path     = test::write_file("atlas_huge.ply", contents);
+            REQUIRE_FALSE(utils::load_ply_mesh(path).has_value());
+            std::filesystem::remove(path);
+        }
+    }
+
+    SECTION("Unknown elements")
+    {
+        auto header = [](std::string const& format, std::string const& element) {
+            return fmt::format("ply\nformat {} 1.0\n{}element vertex 3\n"
+                               "property float x\nproperty float y\n"
+                               "property float z\nelement face 1\n"
+                               "property list uchar int vertex_indices\n"
+                               "end_header\n",
+                               format,
+                               element);
+        };
+
+        // Empty elements are skipped however many there are, but elements
+        // with properties must fit in the file.
+        auto empty = header("ascii", "element marker 100000000000\n") +
+                     "0 0 0\n1 0 0\n1 1 0\n3 0 1 2\n";
+        auto path  = test::write_file("atlas_empty_element.ply", empty);
+        auto mesh  = utils::load_ply_mesh(path);
+        std::filesystem::remove(path);
+        REQUIRE(mesh.has_value());
+        REQUIRE(mesh->shapes[0].indices.size() == 3);
+
+        for (auto format : {std::string{"ascii"}, std::string{"binary_little_endian"}})
+        {
+            auto contents = header(format,
+                                   "element marker 100000000000\n"
+                                   "property list uchar int values\n") +
+                            "0 0 0\n";
+            path = test::write_file("atlas_huge_element.ply", contents);
+            REQUIRE_FALSE(utils::load_ply_mesh(path).has_value());
+            std::filesystem::remove(path);
+        }
+    }
+
+    SECTION("Face list count larger than the file")
+    {
+        // Faces with a property besides the index list go through the
+        // general path in both formats.
+        for (auto format : {test::PlyFormat::ascii, test::PlyFormat::little_endian})
+        {
+            auto path =
+                (std::filesystem::temp_directory_path() / "atlas_huge_face.ply").string();
+            {
+                std::ofstream stream{path, std::ios::binary};
+                stream << fmt::format(
+                    "ply\nformat {} 1.0\nelement vertex 3\n"
+                    "property float x\nproperty float y\nproperty float z\n"
+                    "element face 1\nproperty uchar flags\n"
+                    "property list uint int vertex_indices\nend_header\n",
+                    format == test::PlyFormat::ascii ? "ascii" : "binary_little_endian");
+                for (std::size_t i{0}; i < 9; ++i)
+                {
+                    test::write_ply_value(stream, 0.0f, format);
+                }
+                test::write_ply_value<std::uint8_t>(stream, 0, format);
+                test::write_ply_value<std::uint32_t>(stream, 0xFFFFFFFF, format);
+                for (std::int32_t index : {0, 1, 2})
+                {
+                    test::write_ply_value(stream, index, format);
+                }
+            }
+
+            REQUIRE_FALSE(utils::load_ply_mesh(path).has_value());
+            std::filesystem::remove(path);
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/load_stl_file.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace atlas;
+
+namespace
+{
+    using Triangle = test::StlTriangle;
+
+    void check_triangles(utils::Shape const& shape, std::vector<Triangle> const& expected)
+    {
+        REQUIRE(shape.has_normals);
+        REQUIRE_FALSE(shape.has_texture_coords);
+        REQUIRE(shape.indices.size() == 3 * expected.size());
+        REQUIRE(shape.material_ids.size() == expected.size());
+        REQUIRE(shape.smoothing_group_ids.size() == expected.size());
+
+        bool same{true};
+        for (std::size_t c{0}; c < shape.indices.size(); ++c)
+        {
+            auto const& position = shape.vertices[shape.indices[c]].position;
+            same                 = same && position == expected[c / 3][c % 3];
+        }
+        REQUIRE(same);
+
+        for (std::size_t i{0}; i < shape.vertices.size(); ++i)
+        {
+            REQUIRE(shape.vertices[i].index == i);
+        }
+    }
+} // namespace
+
+TEST_CASE("[load_stl_file] - load_stl_mesh", "[utils]")
+{
+    auto triangles = test::grid_triangles(16);
+    glm::vec3 up{0.0f, 0.0f, 1.0f};
+
+    SECTION("Missing file")
+    {
+        REQUIRE_FALSE(utils::load_stl_mesh("atlas_missing_file.stl").has_value());
+    }
+
+    SECTION("Binary")
+    {
+        auto path = test::write_stl_binary("atlas_grid.stl", triangles, up);
+        auto mesh = utils::load_stl_mesh(path);
+        std::filesystem::remove(path);
+
+        REQUIRE(mesh.has_value());
+        REQUIRE(mesh->shapes.size() == 1);
+        REQUIRE(mesh->materials.size() == 1);
+
+        // Corners that share a position and normal become one vertex.
+        auto const& shape = mesh->shapes[0];
+        check_triangles(shape, triangles);
+        REQUIRE(shape.vertices.size() == 17 * 17);
+        REQUIRE(shape.vertices[0].normal == up);
+    }
+
+    SECTION("ASCII")
+    {
+        std::vector<Triangle> first{triangles.begin(), triangles.begin() + 10};
+        std::vector<Triangle> second{triangles.begin() + 10, triangles.end()};
+        auto path = test::write_file("atlas_grid_ascii.stl",
+                                     test::stl_ascii_solid("first", first, up) +
+                                         test::stl_ascii_solid("second", second, up));
+        auto mesh = utils::load_stl_mesh(path);
+        std::filesystem::remove(path);
+
+        REQUIRE(mesh.has_value());
+        REQUIRE(mesh->shapes.size() == 2);
+        check_triangles(mesh->shapes[0], first);
+        check_triangles(mesh->shapes[1], second);
+    }
+
+    SECTION("Missing normals")
+    {
+        auto path =
+            test::write_stl_binary("atlas_no_normals.stl", triangles, glm::vec3{0.0f});
+        auto mesh = utils::load_stl_mesh(path);
+        std::filesystem::remove(path);
+
+        REQUIRE(mesh.has_value());
+        for (auto const& vertex : mesh->shapes[0].vertices)
+        {
+            REQUIRE(vertex.normal == up);
+        }
+    }
+
+    SECTION("Invalid files")
+    {
+        for (auto contents :
+             {std::string{"not an stl file"},
+              std::string{"solid a\nfacet normal 0 0 1\nouter loop\nvertex 0 0\n"},
+              std::string{"solid a\nfacet normal 0 0 1\nouter loop\nvertex 0 0 0\n"
+                          "endloop\nendfacet\nendsolid a\n"}})
+        {
+            auto path = test::write_file("atlas_invalid.stl", contents);
+            REQUIRE_FALSE(utils::load_stl_mesh(path).has_value());
+            std::filesystem::remove(path);
+        }
+    }
+}
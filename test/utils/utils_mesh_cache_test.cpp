@@ -0,0 +1,219 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/mesh_cache.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace atlas;
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    utils::ObjMesh make_mesh()
+    {
+        utils::ObjMesh mesh;
+        for (std::size_t s{0}; s < 2; ++s)
+        {
+            auto& shape              = mesh.shapes.emplace_back();
+            shape.has_texture_coords = (s == 0);
+            for (std::size_t i{0}; i < 4 + s; ++i)
+            {
+                utils::Vertex vertex;
+                vertex.position  = glm::vec3{i, s, 1.0f};
+                vertex.normal    = glm::vec3{0.0f, 0.0f, 1.0f};
+                vertex.tex_coord = glm::vec2{i, 0.5f};
+                vertex.index     = i;
+                vertex.face_id   = i / 3;
+                shape.vertices.push_back(vertex);
+            }
+            shape.indices             = {0, 1, 2, 0, 2, 3};
+            shape.material_ids        = {0, static_cast<int>(s)};
+            shape.smoothing_group_ids = {1, 2};
+        }
+
+        tinyobj::material_t material;
+        material.name                     = "red";
+        material.diffuse[0]               = 1.0f;
+        material.shininess                = 32.0f;
+        material.diffuse_texname          = "red.png";
+        material.unknown_parameter["Pcr"] = "0.5";
+        mesh.materials.push_back(material);
+
+        material.name = "green";
+        material.unknown_parameter.clear();
+        mesh.materials.push_back(material);
+        return mesh;
+    }
+
+    void check_equal(utils::ObjMesh const& lhs, utils::ObjMesh const& rhs)
+    {
+        REQUIRE(lhs.shapes.size() == rhs.shapes.size());
+        for (std::size_t s{0}; s < lhs.shapes.size(); ++s)
+        {
+            auto const& a = lhs.shapes[s];
+            auto const& b = rhs.shapes[s];
+            REQUIRE(a.has_normals == b.has_normals);
+            REQUIRE(a.has_texture_coords == b.has_texture_coords);
+            REQUIRE(a.indices == b.indices);
+            REQUIRE(a.material_ids == b.material_ids);
+            REQUIRE(a.smoothing_group_ids == b.smoothing_group_ids);
+            REQUIRE(a.vertices.size() == b.vertices.size());
+            for (std::size_t v{0}; v < a.vertices.size(); ++v)
+            {
+                REQUIRE(a.vertices[v].position == b.vertices[v].position);
+                REQUIRE(a.vertices[v].normal == b.vertices[v].normal);
+                REQUIRE(a.vertices[v].tex_coord == b.vertices[v].tex_coord);
+                REQUIRE(a.vertices[v].index == b.vertices[v].index);
+                REQUIRE(a.vertices[v].face_id == b.vertices[v].face_id);
+            }
+        }
+
+        REQUIRE(lhs.materials.size() == rhs.materials.size());
+        for (std::size_t m{0}; m < lhs.materials.size(); ++m)
+        {
+            auto const& a = lhs.materials[m];
+            auto const& b = rhs.materials[m];
+            REQUIRE(a.name == b.name);
+            REQUIRE(a.diffuse[0] == b.diffuse[0]);
+            REQUIRE(a.shininess == b.shininess);
+            REQUIRE(a.diffuse_texname == b.diffuse_texname);
+            REQUIRE(a.unknown_parameter == b.unknown_parameter);
+        }
+    }
+
+    template<typename T>
+    bool is_aligned(std::span<T const> stream)
+    {
+        return reinterpret_cast<std::uintptr_t>(stream.data()) % 64 == 0;
+    }
+
+} // namespace
+
+TEST_CASE("[mesh_cache] - binary meshes", "[utils]")
+{
+    auto path = (fs::temp_directory_path() / "atlas_mesh.amesh").string();
+
+    SECTION("Round trip")
+    {
+        auto mesh = make_mesh();
+        REQUIRE(utils::save_binary_mesh(mesh, path, {"mesh.obj", 10, 20}));
+
+        auto binary = utils::load_binary_mesh(path);
+        REQUIRE(binary.has_value());
+        REQUIRE(binary->source() == utils::MeshSource{"mesh.obj", 10, 20});
+
+        for (auto const& shape : binary->shapes())
+        {
+            REQUIRE(is_aligned(shape.vertices));
+            REQUIRE(is_aligned(shape.indices));
+            REQUIRE(is_aligned(shape.material_ids));
+            REQUIRE(is_aligned(shape.smoothing_group_ids));
+        }
+
+        check_equal(binary->to_obj_mesh(), mesh);
+
+        // The streams stay valid when the mesh is moved.
+        auto moved = std::move(*binary);
+        check_equal(moved.to_obj_mesh(), mesh);
+    }
+
+    SECTION("Empty mesh")
+    {
+        REQUIRE(utils::save_binary_mesh(utils::ObjMesh{}, path));
+        auto binary = utils::load_binary_mesh(path);
+        REQUIRE(binary.has_value());
+        REQUIRE(binary->shapes().empty());
+        REQUIRE(binary->materials().empty());
+    }
+
+    SECTION("Invalid files")
+    {
+        REQUIRE_FALSE(utils::load_binary_mesh("atlas_missing_file.amesh").has_value());
+
+        std::ofstream{path} << "not a mesh";
+        REQUIRE_FALSE(utils::load_binary_mesh(path).has_value());
+
+        // Cut a valid file short.
+        REQUIRE(utils::save_binary_mesh(make_mesh(), path));
+        fs::resize_file(path, fs::file_size(path) - 16);
+        REQUIRE_FALSE(utils::load_binary_mesh(path).has_value());
+    }
+
+    fs::remove(path);
+}
+
+TEST_CASE("[mesh_cache] - load_obj_mesh_cached", "[utils]")
+{
+    auto dir       = fs::temp_directory_path();
+    auto cache_dir = (dir / "atlas_mesh_cache").string();
+    auto path      = (dir / "atlas_cached.obj").string();
+    fs::remove_all(cache_dir);
+
+    std::ofstream{path} << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf 1 2 3\n";
+    jobs::JobSystem system{2};
+
+    SECTION("Cache directory")
+    {
+        auto mesh = utils::load_obj_mesh_cached(path, system, cache_dir);
+        REQUIRE(mesh.has_value());
+        REQUIRE(mesh->shapes()[0].indices.size() == 3);
+        REQUIRE(mesh->source().path == fs::absolute(path).string());
+
+        std::vector<fs::path> entries{fs::directory_iterator{cache_dir}, {}};
+        REQUIRE(entries.size() == 1);
+        auto written = fs::last_write_time(entries[0]);
+
+        // A second load uses the cache as is.
+        mesh = utils::load_obj_mesh_cached(path, system, cache_dir);
+        REQUIRE(mesh.has_value());
+        REQUIRE(fs::last_write_time(entries[0]) == written);
+
+        // Changing the file rebuilds the cache.
+        std::ofstream{path, std::ios::app} << "f 1 3 4\n";
+        mesh = utils::load_obj_mesh_cached(path, system, cache_dir);
+        REQUIRE(mesh.has_value());
+        REQUIRE(mesh->shapes()[0].indices.size() == 6);
+    }
+
+    SECTION("Next to the file")
+    {
+        auto mesh = utils::load_obj_mesh_cached(path, system);
+        REQUIRE(mesh.has_value());
+        REQUIRE(fs::exists(path + ".amesh"));
+        fs::remove(path + ".amesh");
+    }
+
+    SECTION("Missing file")
+    {
+        REQUIRE_FALSE(
+            utils::load_obj_mesh_cached("atlas_missing_file.obj", system).has_value());
+    }
+
+    SECTION("Unwritable cache")
+    {
+        // A directory below a regular file can never be created.
+        auto blocker = (dir / "atlas_mesh_cache_blocker").string();
+        std::ofstream{blocker} << "not a directory";
+
+        auto mesh = utils::load_obj_mesh_cached(path, system, blocker + "/cache");
+        REQUIRE(mesh.has_value());
+        REQUIRE(mesh->shapes()[0].indices.size() == 3);
+        REQUIRE(mesh->shapes()[0].vertices[1].position == glm::vec3{1.0f, 0.0f, 0.0f});
+        REQUIRE(mesh->source().path == fs::absolute(path).string());
+
+        // Moving the mesh must not invalidate its streams.
+        auto moved = std::move(mesh);
+        REQUIRE(moved->to_obj_mesh().shapes[0].indices.size() == 3);
+        fs::remove(blocker);
+    }
+
+    fs::remove(path);
+    fs::remove_all(cache_dir);
+}
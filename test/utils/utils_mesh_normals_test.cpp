@@ -0,0 +1,322 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/mesh_normals.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <set>
+#include <tuple>
+#include <vector>
+
+using namespace atlas;
+
+namespace
+{
+    utils::Shape make_cube(unsigned int smoothing_group)
+    {
+        utils::Shape shape;
+        for (std::size_t i{0}; i < 8; ++i)
+        {
+            utils::Vertex vertex;
+            vertex.position = glm::vec3{(i & 1) ? 1.0f : -1.0f,
+                                        (i & 2) ? 1.0f : -1.0f,
+                                        (i & 4) ? 1.0f : -1.0f};
+            vertex.index    = i;
+            shape.vertices.push_back(vertex);
+        }
+
+        // Counter-clockwise seen from outside.
+        shape.indices = {0, 2, 3, 0, 3, 1, 4, 5, 7, 4, 7, 6, 0, 1, 5, 0, 5, 4,
+                         2, 6, 7, 2, 7, 3, 0, 4, 6, 0, 6, 2, 1, 3, 7, 1, 7, 5};
+        shape.smoothing_group_ids.assign(12, smoothing_group);
+        shape.has_normals        = false;
+        shape.has_texture_coords = false;
+        return shape;
+    }
+
+    // Two quads side by side in the xy plane, the second with its texture
+    // mirrored in u.
+    utils::Shape make_mirrored_strip()
+    {
+        utils::Shape shape;
+        for (std::size_t i{0}; i < 6; ++i)
+        {
+            auto x = static_cast<float>(i % 3);
+            auto y = static_cast<float>(i / 3);
+
+            utils::Vertex vertex;
+            vertex.position  = glm::vec3{x, y, 0.0f};
+            vertex.tex_coord = glm::vec2{(x > 1.0f) ? 2.0f - x : x, y};
+            vertex.index     = i;
+            shape.vertices.push_back(vertex);
+        }
+
+        shape.indices = {0, 1, 4, 0, 4, 3, 1, 2, 5, 1, 5, 4};
+        shape.smoothing_group_ids.assign(4, 1);
+        shape.has_normals = false;
+        return shape;
+    }
+
+    // Triangles in the xy plane facing +z, with the given texture
+    // coordinates.
+    utils::Shape make_flat(std::vector<glm::vec2> const& positions,
+                           std::vector<glm::vec2> const& tex_coords,
+                           std::vector<std::size_t> const& indices)
+    {
+        utils::Shape shape;
+        for (std::size_t i{0}; i < positions.size(); ++i)
+        {
+            utils::Vertex vertex;
+            vertex.position  = glm::vec3{positions[i], 0.0f};
+            vertex.normal    = glm::vec3{0.0f, 0.0f, 1.0f};
+            vertex.tex_coord = tex_coords[i];
+            vertex.index     = i;
+            shape.vertices.push_back(vertex);
+        }
+
+        shape.indices = indices;
+        shape.smoothing_group_ids.assign(indices.size() / 3, 1);
+        return shape;
+    }
+
+    bool same_tangent(glm::vec4 const& a, glm::vec4 const& b)
+    {
+        return glm::length(a - b) < 1e-5f;
+    }
+
+    std::size_t count_normals(utils::Shape const& shape)
+    {
+        std::set<std::tuple<float, float, float>> normals;
+        for (auto const& vertex : shape.vertices)
+        {
+            auto const& n = vertex.normal;
+            normals.emplace(n.x, n.y, n.z);
+        }
+        return normals.size();
+    }
+
+    void check_vertices(utils::Shape const& shape)
+    {
+        for (std::size_t i{0}; i < shape.vertices.size(); ++i)
+        {
+            REQUIRE(shape.vertices[i].index == i);
+        }
+
+        for (std::size_t c{0}; c < shape.indices.size(); ++c)
+        {
+            REQUIRE(shape.indices[c] < shape.vertices.size());
+            REQUIRE(shape.vertices[shape.indices[c]].face_id <= c / 3);
+        }
+    }
+} // namespace
+
+TEST_CASE("[mesh_normals] - generate_normals", "[utils]")
+{
+    jobs::JobSystem system{4};
+
+    SECTION("Flat cube")
+    {
+        auto shape = make_cube(0);
+        utils::generate_normals(shape, system);
+        check_vertices(shape);
+
+        REQUIRE(shape.has_normals);
+        REQUIRE(shape.vertices.size() == 24);
+        REQUIRE(count_normals(shape) == 6);
+        for (std::size_t f{0}; f < 12; ++f)
+        {
+            auto const& a = shape.vertices[shape.indices[3 * f + 0]];
+            auto const& b = shape.vertices[shape.indices[3 * f + 1]];
+            auto const& c = shape.vertices[shape.indices[3 * f + 2]];
+            auto n = glm::normalize(glm::cross(b.position - a.position,
+                                               c.position - a.position));
+            REQUIRE(glm::dot(a.normal, n) > 0.9999f);
+            REQUIRE(a.normal == b.normal);
+            REQUIRE(a.normal == c.normal);
+        }
+    }
+
+    SECTION("Smooth cube")
+    {
+        auto shape = make_cube(1);
+        utils::generate_normals(shape, system);
+        check_vertices(shape);
+
+        REQUIRE(shape.vertices.size() == 8);
+        for (auto const& vertex : shape.vertices)
+        {
+            auto expected = glm::normalize(vertex.position);
+            REQUIRE(glm::dot(vertex.normal, expected) > 0.9999f);
+        }
+    }
+
+    SECTION("Angle threshold")
+    {
+        utils::NormalSettings settings;
+        settings.use_smoothing_groups = false;
+        settings.angle_threshold      = glm::radians(60.0f);
+
+        auto shape = make_cube(0);
+        utils::generate_normals(shape, system, settings);
+        REQUIRE(shape.vertices.size() == 24);
+
+        settings.angle_threshold = glm::radians(100.0f);
+        shape                    = make_cube(0);
+        utils::generate_normals(shape, system, settings);
+        REQUIRE(shape.vertices.size() == 8);
+    }
+
+    SECTION("Sphere")
+    {
+        auto shape = test::make_sphere(16);
+        utils::generate_normals(shape, system);
+        check_vertices(shape);
+
+        // Smoothing goes across the texture seam, so nothing is split.
+        REQUIRE(shape.vertices.size() == 17 * 33);
+        for (auto const& vertex : shape.vertices)
+        {
+            REQUIRE(glm::dot(vertex.normal, vertex.position) > 0.995f);
+        }
+    }
+
+    SECTION("Thread count")
+    {
+        auto serial = test::make_sphere(32);
+        auto shape  = serial;
+        jobs::JobSystem single{1};
+        utils::generate_normals(serial, single);
+        utils::generate_normals(shape, system);
+
+        REQUIRE(shape.indices == serial.indices);
+        REQUIRE(shape.vertices.size() == serial.vertices.size());
+        for (std::size_t i{0}; i < shape.vertices.size(); ++i)
+        {
+            REQUIRE(shape.vertices[i].normal == serial.vertices[i].normal);
+            REQUIRE(shape.vertices[i].face_id == serial.vertices[i].face_id);
+        }
+    }
+}
+
+TEST_CASE("[mesh_normals] - generate_tangents", "[utils]")
+{
+    jobs::JobSystem system{4};
+
+    SECTION("Sphere")
+    {
+        auto shape = test::make_sphere(16);
+        utils::generate_normals(shape, system);
+        auto tangents = utils::generate_tangents(shape, system);
+        check_vertices(shape);
+
+        REQUIRE(tangents.size() == shape.vertices.size());
+        for (std::size_t i{0}; i < tangents.size(); ++i)
+        {
+            glm::vec3 t{tangents[i]};
+            auto const& n = shape.vertices[i].normal;
+            REQUIRE(glm::abs(glm::length(t) - 1.0f) < 1e-4f);
+            REQUIRE(glm::abs(glm::dot(t, n)) < 1e-4f);
+            REQUIRE(glm::abs(tangents[i].w) == 1.0f);
+        }
+    }
+
+    SECTION("Mirrored texture coordinates")
+    {
+        auto shape = make_mirrored_strip();
+        utils::generate_normals(shape, system);
+        REQUIRE(shape.vertices.size() == 6);
+
+        auto tangents = utils::generate_tangents(shape, system);
+        check_vertices(shape);
+
+        // The middle column is split between the two halves.
+        REQUIRE(shape.vertices.size() == 8);
+        for (std::size_t f{0}; f < 4; ++f)
+        {
+            auto mirrored = f >= 2;
+            for (std::size_t k{0}; k < 3; ++k)
+            {
+                auto v = shape.indices[3 * f + k];
+                glm::vec3 t{tangents[v]};
+                auto w = tangents[v].w;
+                REQUIRE(w == (mirrored ? -1.0f : 1.0f));
+                REQUIRE(glm::dot(t, glm::vec3{mirrored ? -1.0f : 1.0f, 0.0f, 0.0f}) >
+                        0.9999f);
+
+                // The bitangent always points along v.
+                auto bitangent = w * glm::cross(shape.vertices[v].normal, t);
+                REQUIRE(glm::dot(bitangent, glm::vec3{0.0f, 1.0f, 0.0f}) > 0.9999f);
+            }
+        }
+    }
+
+    SECTION("Mirrored quad")
+    {
+        // A parallelogram with its texture flipped in u. MikkTSpace gives
+        // every corner the direction of increasing u, which is -x, and a
+        // negative sign so the bitangent still follows v.
+        auto shape = make_flat({{0.0f, 0.0f}, {2.0f, 0.0f}, {3.0f, 1.0f}, {1.0f, 1.0f}},
+                               {{1.0f, 0.0f}, {0.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 1.0f}},
+                               {0, 1, 2, 0, 2, 3});
+
+        auto tangents = utils::generate_tangents(shape, system);
+        check_vertices(shape);
+
+        REQUIRE(shape.vertices.size() == 4);
+        for (auto const& tangent : tangents)
+        {
+            REQUIRE(same_tangent(tangent, glm::vec4{-1.0f, 0.0f, 0.0f, -1.0f}));
+        }
+    }
+
+    SECTION("Angle weighting")
+    {
+        // Two faces across the edge from p to e. The first has a right angle
+        // at p and a tangent along x, the second has half that angle at p and
+        // a tangent along x + y, and the other way around at e.
+        auto shape = make_flat({{0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}, {-1.0f, 1.0f}},
+                               {{0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}, {-1.0f, 2.0f}},
+                               {0, 1, 2, 0, 2, 3});
+
+        auto tangents = utils::generate_tangents(shape, system);
+        check_vertices(shape);
+
+        REQUIRE(shape.vertices.size() == 4);
+        auto x    = glm::vec3{1.0f, 0.0f, 0.0f};
+        auto xy   = glm::normalize(glm::vec3{1.0f, 1.0f, 0.0f});
+        auto at_p = glm::vec4{glm::normalize(2.0f * x + xy), 1.0f};
+        auto at_e = glm::vec4{glm::normalize(x + 2.0f * xy), 1.0f};
+        REQUIRE(same_tangent(tangents[shape.indices[0]], at_p));
+        REQUIRE(same_tangent(tangents[shape.indices[1]], glm::vec4{x, 1.0f}));
+        REQUIRE(same_tangent(tangents[shape.indices[2]], at_e));
+        REQUIRE(same_tangent(tangents[shape.indices[5]], glm::vec4{xy, 1.0f}));
+    }
+
+    SECTION("Faces that only share a vertex")
+    {
+        // Faces are only grouped through edges, so the shared vertex is split
+        // and each face keeps its own tangent.
+        auto shape = make_flat(
+            {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {-1.0f, -1.0f}, {0.0f, -1.0f}},
+            {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}, {-1.0f, 0.0f}},
+            {0, 1, 2, 0, 3, 4});
+
+        auto tangents = utils::generate_tangents(shape, system);
+        check_vertices(shape);
+
+        REQUIRE(shape.vertices.size() == 6);
+        glm::vec4 const first{1.0f, 0.0f, 0.0f, 1.0f};
+        glm::vec4 const second{0.0f, 1.0f, 0.0f, 1.0f};
+        for (std::size_t k{0}; k < 3; ++k)
+        {
+            REQUIRE(same_tangent(tangents[shape.indices[k]], first));
+            REQUIRE(same_tangent(tangents[shape.indices[3 + k]], second));
+        }
+    }
+
+    SECTION("Missing attributes")
+    {
+        auto shape = make_cube(1);
+        REQUIRE(utils::generate_tangents(shape, system).empty());
+    }
+}
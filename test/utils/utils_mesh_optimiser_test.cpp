@@ -0,0 +1,210 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/mesh_optimiser.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+using namespace atlas;
+
+namespace
+{
+    void add_vertex(utils::Shape& shape, glm::vec3 const& position)
+    {
+        utils::Vertex vertex;
+        vertex.position = position;
+        vertex.index    = shape.vertices.size();
+        vertex.face_id  = std::numeric_limits<std::size_t>::max();
+        shape.vertices.push_back(vertex);
+    }
+
+    // Adds a sphere with outward facing triangles.
+    void add_sphere(utils::Shape& shape, float radius, std::size_t rings)
+    {
+        auto sphere = test::make_sphere(rings, radius);
+        auto first  = shape.vertices.size();
+        for (auto const& vertex : sphere.vertices)
+        {
+            add_vertex(shape, vertex.position);
+        }
+
+        auto const& indices = sphere.indices;
+        for (std::size_t i{0}; i < indices.size(); i += 3)
+        {
+            test::add_tagged_triangle(shape,
+                                      first + indices[i + 0],
+                                      first + indices[i + 1],
+                                      first + indices[i + 2]);
+        }
+    }
+
+    std::vector<std::array<glm::vec3, 3>> sorted_triangles(utils::Shape const& shape)
+    {
+        std::vector<std::array<glm::vec3, 3>> triangles;
+        for (std::size_t i{0}; i < shape.indices.size(); i += 3)
+        {
+            triangles.push_back({shape.vertices[shape.indices[i + 0]].position,
+                                 shape.vertices[shape.indices[i + 1]].position,
+                                 shape.vertices[shape.indices[i + 2]].position});
+        }
+
+        auto less = [](auto const& lhs, auto const& rhs) {
+            for (std::size_t k{0}; k < 3; ++k)
+            {
+                for (int i{0}; i < 3; ++i)
+                {
+                    if (lhs[k][i] != rhs[k][i])
+                    {
+                        return lhs[k][i] < rhs[k][i];
+                    }
+                }
+            }
+            return false;
+        };
+        std::sort(triangles.begin(), triangles.end(), less);
+        return triangles;
+    }
+
+    // The ids must still belong to the same triangles, and every vertex must
+    // be used by the face it names.
+    void check_shape(utils::Shape const& shape, utils::Shape const& original)
+    {
+        REQUIRE(sorted_triangles(shape) == sorted_triangles(original));
+        REQUIRE(shape.material_ids.size() == shape.indices.size() / 3);
+
+        for (std::size_t t{0}; t < shape.material_ids.size(); ++t)
+        {
+            auto face = shape.smoothing_group_ids[t];
+            REQUIRE(shape.material_ids[t] == static_cast<int>(face % 7));
+            for (std::size_t k{0}; k < 3; ++k)
+            {
+                REQUIRE(shape.vertices[shape.indices[3 * t + k]].position ==
+                        original.vertices[original.indices[3 * face + k]].position);
+            }
+        }
+
+        for (std::size_t v{0}; v < shape.vertices.size(); ++v)
+        {
+            auto const& vertex = shape.vertices[v];
+            REQUIRE(vertex.index == v);
+
+            auto first = shape.indices.begin() + 3 * vertex.face_id;
+            REQUIRE(std::find(first, first + 3, v) != first + 3);
+        }
+    }
+} // namespace
+
+TEST_CASE("[mesh_optimiser] - analyse_vertex_cache", "[utils]")
+{
+    std::vector<std::size_t> indices{0, 1, 2, 0, 2, 3};
+    auto statistics = utils::analyse_vertex_cache(indices, 4);
+    REQUIRE(statistics.vertices_transformed == 4);
+    REQUIRE(statistics.acmr == 2.0f);
+    REQUIRE(statistics.atvr == 1.0f);
+
+    // With three entries, 3 pushes 0 out, 0 pushes 1 out and so on.
+    indices    = {0, 1, 2, 3, 0, 1};
+    statistics = utils::analyse_vertex_cache(indices, 4, 3);
+    REQUIRE(statistics.vertices_transformed == 6);
+    REQUIRE(statistics.atvr == 1.5f);
+
+    statistics = utils::analyse_vertex_cache({}, 0);
+    REQUIRE(statistics.acmr == 0.0f);
+    REQUIRE(statistics.atvr == 0.0f);
+}
+
+TEST_CASE("[mesh_optimiser] - optimise_vertex_cache", "[utils]")
+{
+    auto original = test::make_grid(64);
+    test::shuffle_triangles(original);
+
+    auto shape  = original;
+    auto before = utils::analyse_vertex_cache(shape.indices, shape.vertices.size());
+    utils::optimise_vertex_cache(shape);
+    auto after = utils::analyse_vertex_cache(shape.indices, shape.vertices.size());
+
+    check_shape(shape, original);
+    REQUIRE(before.acmr > 2.0f);
+    REQUIRE(after.acmr < 0.75f);
+    REQUIRE(after.atvr < 1.5f);
+
+    utils::Shape empty;
+    utils::optimise_vertex_cache(empty);
+    REQUIRE(empty.indices.empty());
+}
+
+TEST_CASE("[mesh_optimiser] - optimise_overdraw", "[utils]")
+{
+    // An inner sphere listed first is hidden behind the outer one, so the
+    // outer one should be drawn first.
+    utils::Shape original;
+    add_sphere(original, 0.5f, 16);
+    auto inner = original.indices.size() / 3;
+    add_sphere(original, 1.0f, 16);
+
+    auto shape = original;
+    utils::optimise_vertex_cache(shape);
+    auto cached = utils::analyse_vertex_cache(shape.indices, shape.vertices.size());
+    utils::optimise_overdraw(shape, 1.05f);
+    auto sorted = utils::analyse_vertex_cache(shape.indices, shape.vertices.size());
+
+    check_shape(shape, original);
+    REQUIRE(sorted.acmr <= cached.acmr * 1.1f);
+
+    double inner_position{0.0};
+    double outer_position{0.0};
+    for (std::size_t t{0}; t < shape.smoothing_group_ids.size(); ++t)
+    {
+        auto is_inner = shape.smoothing_group_ids[t] < inner;
+        (is_inner ? inner_position : outer_position) += static_cast<double>(t);
+    }
+
+    auto outer = shape.smoothing_group_ids.size() - inner;
+    REQUIRE(outer_position / outer < inner_position / inner);
+}
+
+TEST_CASE("[mesh_optimiser] - optimise_vertex_fetch", "[utils]")
+{
+    auto original = test::make_grid(16);
+    test::shuffle_triangles(original);
+
+    // A vertex no triangle uses.
+    auto shape = original;
+    add_vertex(shape, glm::vec3{-1.0f});
+    shape.vertices.back().face_id = 0;
+    std::rotate(shape.vertices.begin(), shape.vertices.end() - 1, shape.vertices.end());
+    for (auto& index : shape.indices)
+    {
+        ++index;
+    }
+
+    utils::optimise_vertex_fetch(shape);
+    REQUIRE(shape.vertices.back().position == glm::vec3{-1.0f});
+    REQUIRE(shape.vertices.back().index == shape.vertices.size() - 1);
+    shape.vertices.pop_back();
+    check_shape(shape, original);
+
+    std::size_t next{0};
+    for (auto index : shape.indices)
+    {
+        REQUIRE(index <= next);
+        next = std::max(next, index + 1);
+    }
+}
+
+TEST_CASE("[mesh_optimiser] - optimise_mesh", "[utils]")
+{
+    auto original = test::make_grid(32);
+    test::shuffle_triangles(original);
+
+    auto shape  = original;
+    auto report = utils::optimise_mesh(shape);
+    check_shape(shape, original);
+    REQUIRE(report.before.acmr > 2.0f);
+    REQUIRE(report.after.acmr < 0.8f);
+    REQUIRE(report.after.vertices_transformed < report.before.vertices_transformed);
+}
@@ -0,0 +1,189 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/mesh_simplifier.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+#include <algorithm>
+
+using namespace atlas;
+
+namespace
+{
+    float area(utils::Shape const& shape)
+    {
+        float total{0.0f};
+        for (std::size_t i{0}; i < shape.indices.size(); i += 3)
+        {
+            auto const& a = shape.vertices[shape.indices[i + 0]].position;
+            auto const& b = shape.vertices[shape.indices[i + 1]].position;
+            auto const& c = shape.vertices[shape.indices[i + 2]].position;
+            total += glm::cross(b - a, c - a).z * 0.5f;
+        }
+        return total;
+    }
+
+    void check_shape(utils::Shape const& shape)
+    {
+        auto const face_count = shape.indices.size() / 3;
+        REQUIRE(shape.material_ids.size() == face_count);
+        REQUIRE(shape.smoothing_group_ids.size() == face_count);
+
+        for (std::size_t t{0}; t < face_count; ++t)
+        {
+            auto const& a = shape.vertices[shape.indices[3 * t + 0]].position;
+            auto const& b = shape.vertices[shape.indices[3 * t + 1]].position;
+            auto const& c = shape.vertices[shape.indices[3 * t + 2]].position;
+            REQUIRE(a != b);
+            REQUIRE(b != c);
+            REQUIRE(a != c);
+        }
+
+        for (std::size_t v{0}; v < shape.vertices.size(); ++v)
+        {
+            auto const& vertex = shape.vertices[v];
+            REQUIRE(vertex.index == v);
+
+            auto first = shape.indices.begin() + 3 * vertex.face_id;
+            REQUIRE(std::find(first, first + 3, v) != first + 3);
+        }
+    }
+} // namespace
+
+TEST_CASE("[mesh_simplifier] - simplify_shape", "[utils]")
+{
+    SECTION("Locked borders")
+    {
+        auto shape = test::make_grid(16, 17);
+        auto error = utils::simplify_shape(shape, 0.2f);
+
+        check_shape(shape);
+        REQUIRE(shape.indices.size() / 3 <= 102);
+        REQUIRE(error < 1e-4f);
+        REQUIRE(glm::abs(area(shape) - 256.0f) < 1e-3f);
+
+        // Every border vertex is still there.
+        std::size_t border{0};
+        for (auto const& vertex : shape.vertices)
+        {
+            auto const& p = vertex.position;
+            if (p.x == 0.0f || p.y == 0.0f || p.x == 16.0f || p.y == 16.0f)
+            {
+                ++border;
+            }
+        }
+        REQUIRE(border == 64);
+    }
+
+    SECTION("Free borders")
+    {
+        utils::SimplifySettings settings;
+        settings.lock_borders = false;
+
+        auto shape = test::make_grid(16, 17);
+        auto error = utils::simplify_shape(shape, 0.02f, settings);
+
+        check_shape(shape);
+        REQUIRE(shape.indices.size() / 3 <= 10);
+        REQUIRE(error < 1e-4f);
+        REQUIRE(glm::abs(area(shape) - 256.0f) < 1e-3f);
+    }
+
+    SECTION("Seams")
+    {
+        auto shape = test::make_grid(16, 8);
+        utils::simplify_shape(shape, 0.1f);
+
+        check_shape(shape);
+        REQUIRE(shape.indices.size() / 3 < 512 / 4);
+        REQUIRE(glm::abs(area(shape) - 256.0f) < 1e-3f);
+
+        // Triangles stay on their side of the seam and keep their texture
+        // coordinates.
+        for (std::size_t i{0}; i < shape.indices.size(); i += 3)
+        {
+            auto const& a = shape.vertices[shape.indices[i + 0]];
+            auto const& b = shape.vertices[shape.indices[i + 1]];
+            auto const& c = shape.vertices[shape.indices[i + 2]];
+            REQUIRE(a.tex_coord == b.tex_coord);
+            REQUIRE(a.tex_coord == c.tex_coord);
+
+            auto side = (a.tex_coord.x == 0.0f) ? 1.0f : -1.0f;
+            for (auto const* v : {&a, &b, &c})
+            {
+                REQUIRE(side * (8.0f - v->position.x) >= 0.0f);
+            }
+        }
+    }
+
+    SECTION("Curved surfaces")
+    {
+        auto sphere = test::make_sphere(32, 1.0f);
+        auto count  = sphere.indices.size() / 3;
+
+        auto shape = sphere;
+        auto error = utils::simplify_shape(shape, 0.25f);
+        check_shape(shape);
+        REQUIRE(shape.indices.size() / 3 <= count / 4);
+        REQUIRE(error > 0.0f);
+        REQUIRE(error < 0.05f);
+
+        // Nothing can be removed without some error.
+        utils::SimplifySettings settings;
+        settings.max_error = error / 4.0f;
+        shape              = sphere;
+        auto bounded       = utils::simplify_shape(shape, 0.25f, settings);
+        check_shape(shape);
+        REQUIRE(shape.indices.size() / 3 > count / 4);
+        REQUIRE(bounded <= settings.max_error);
+    }
+
+    SECTION("Nothing to do")
+    {
+        auto shape = test::make_grid(4, 5);
+        REQUIRE(utils::simplify_shape(shape, 1.0f) == 0.0f);
+        REQUIRE(shape.indices.size() == 32 * 3);
+
+        utils::Shape empty;
+        REQUIRE(utils::simplify_shape(empty, 0.5f) == 0.0f);
+    }
+}
+
+TEST_CASE("[mesh_simplifier] - generate_lods", "[utils]")
+{
+    utils::ObjMesh mesh;
+    mesh.shapes.push_back(test::make_sphere(32, 1.0f));
+    mesh.shapes.push_back(test::make_sphere(16, 2.0f));
+
+    std::vector<float> ratios{0.5f, 0.25f, 0.125f};
+    jobs::JobSystem system{2};
+    auto lods = utils::generate_lods(mesh, ratios, system);
+    REQUIRE(lods.size() == 2);
+
+    for (std::size_t s{0}; s < lods.size(); ++s)
+    {
+        auto const& chain = lods[s];
+        REQUIRE(chain.size() == 4);
+        REQUIRE(chain[0].ratio == 1.0f);
+        REQUIRE(chain[0].error == 0.0f);
+        REQUIRE(chain[0].shape.indices == mesh.shapes[s].indices);
+
+        auto count = static_cast<float>(mesh.shapes[s].indices.size() / 3);
+        for (std::size_t i{1}; i < chain.size(); ++i)
+        {
+            check_shape(chain[i].shape);
+            REQUIRE(chain[i].ratio <= ratios[i - 1]);
+            REQUIRE(chain[i].ratio * count == chain[i].shape.indices.size() / 3);
+            REQUIRE(chain[i].error >= chain[i - 1].error);
+        }
+    }
+
+    auto const& chain = lods[0];
+    REQUIRE(utils::select_lod(chain, 0.0f, 0.001f) == 0);
+    REQUIRE(utils::select_lod(chain, 1e6f, 0.001f) == 3);
+
+    auto distance = chain[2].error / 0.001f;
+    REQUIRE(utils::select_lod(chain, distance, 0.001f) == 2);
+    REQUIRE(utils::select_lod({}, 1.0f, 0.001f) == 0);
+}
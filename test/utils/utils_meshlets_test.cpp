@@ -0,0 +1,166 @@
+#include "test_shapes.hpp"
+
+#include <atlas/utils/meshlets.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+using namespace atlas;
+
+namespace
+{
+    using Triangle = std::array<std::size_t, 3>;
+
+    std::vector<Triangle> meshlet_triangles(utils::Meshlets const& meshlets,
+                                            std::size_t meshlet)
+    {
+        std::vector<Triangle> triangles;
+        auto vertices  = meshlets.vertices.data() + meshlets.vertex_offsets[meshlet];
+        auto locals    = meshlets.triangles.data() + meshlets.triangle_offsets[meshlet];
+        auto const end = locals + 3 * meshlets.triangle_counts[meshlet];
+        for (; locals != end; locals += 3)
+        {
+            triangles.push_back(
+                {vertices[locals[0]], vertices[locals[1]], vertices[locals[2]]});
+        }
+        return triangles;
+    }
+
+    void check_meshlets(utils::Meshlets const& meshlets,
+                        utils::Shape const& shape,
+                        utils::MeshletSettings const& settings)
+    {
+        REQUIRE(meshlets.vertex_counts.size() == meshlets.size());
+        REQUIRE(meshlets.triangle_offsets.size() == meshlets.size());
+        REQUIRE(meshlets.triangle_counts.size() == meshlets.size());
+        REQUIRE(meshlets.spheres.size() == meshlets.size());
+        REQUIRE(meshlets.cones.size() == meshlets.size());
+        REQUIRE(meshlets.cone_apexes.size() == meshlets.size());
+
+        std::vector<Triangle> triangles;
+        for (std::size_t m{0}; m < meshlets.size(); ++m)
+        {
+            REQUIRE(meshlets.vertex_counts[m] <= settings.max_vertices);
+            REQUIRE(meshlets.triangle_counts[m] <= settings.max_triangles);
+            REQUIRE(meshlets.triangle_offsets[m] % 4 == 0);
+
+            auto const& sphere = meshlets.spheres[m];
+            auto first         = meshlets.vertices.begin() + meshlets.vertex_offsets[m];
+            for (auto v = first; v != first + meshlets.vertex_counts[m]; ++v)
+            {
+                auto const& p = shape.vertices[*v].position;
+                REQUIRE(glm::distance(p, glm::vec3{sphere}) <= sphere.w);
+            }
+
+            auto local = meshlet_triangles(meshlets, m);
+            triangles.insert(triangles.end(), local.begin(), local.end());
+        }
+
+        // Every triangle ends up in exactly one meshlet, corners in order.
+        std::vector<Triangle> expected(shape.indices.size() / 3);
+        std::copy(shape.indices.begin(),
+                  shape.indices.end(),
+                  reinterpret_cast<std::size_t*>(expected.data()));
+        std::sort(expected.begin(), expected.end());
+        std::sort(triangles.begin(), triangles.end());
+        REQUIRE(triangles == expected);
+    }
+} // namespace
+
+TEST_CASE("[meshlets] - build_meshlets", "[utils]")
+{
+    auto shape = test::make_sphere(32);
+
+    SECTION("Default limits")
+    {
+        utils::MeshletSettings settings;
+        auto meshlets = utils::build_meshlets(shape, settings);
+        check_meshlets(meshlets, shape, settings);
+
+        // Most meshlets should be close to full.
+        auto triangles = shape.indices.size() / 3;
+        REQUIRE(meshlets.size() < triangles / 124 * 2);
+    }
+
+    SECTION("Small limits")
+    {
+        utils::MeshletSettings settings;
+        settings.max_vertices  = 8;
+        settings.max_triangles = 5;
+        auto meshlets          = utils::build_meshlets(shape, settings);
+        check_meshlets(meshlets, shape, settings);
+    }
+
+    SECTION("Empty shape")
+    {
+        auto meshlets = utils::build_meshlets(utils::Shape{});
+        REQUIRE(meshlets.size() == 0);
+        REQUIRE(meshlets.vertices.empty());
+    }
+}
+
+TEST_CASE("[meshlets] - culling", "[utils]")
+{
+    auto shape    = test::make_sphere(32);
+    auto meshlets = utils::build_meshlets(shape);
+
+    SECTION("Normal cones")
+    {
+        // A meshlet is only culled if every one of its triangles faces away
+        // from the camera.
+        std::mt19937 engine{7};
+        std::uniform_real_distribution<float> dist{-4.0f, 4.0f};
+        std::size_t culled{0};
+        for (int i{0}; i < 64; ++i)
+        {
+            glm::vec3 camera{dist(engine), dist(engine), dist(engine)};
+            for (std::size_t m{0}; m < meshlets.size(); ++m)
+            {
+                if (!utils::is_meshlet_backfacing(meshlets, m, camera))
+                {
+                    continue;
+                }
+
+                ++culled;
+                for (auto const& [a, b, c] : meshlet_triangles(meshlets, m))
+                {
+                    auto const& p0 = shape.vertices[a].position;
+                    auto const& p1 = shape.vertices[b].position;
+                    auto const& p2 = shape.vertices[c].position;
+                    auto n         = glm::cross(p1 - p0, p2 - p0);
+                    REQUIRE(glm::dot(p0 - camera, n) >= -1e-6f);
+                }
+            }
+        }
+
+        // Roughly half of a sphere faces away from an outside camera.
+        REQUIRE(culled > 64 * meshlets.size() / 8);
+    }
+
+    SECTION("Frustum")
+    {
+        glm::vec3 camera{0.0f, 0.0f, 5.0f};
+        auto view   = glm::lookAt(camera, glm::vec3{0.0f}, glm::vec3{0.0f, 1.0f, 0.0f});
+        auto planes = utils::frustum_planes(
+            glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f) * view);
+
+        // Looking straight at the sphere keeps the front half.
+        auto visible = utils::cull_meshlets(meshlets, camera, planes);
+        REQUIRE_FALSE(visible.empty());
+        REQUIRE(visible.size() < meshlets.size());
+        for (auto m : visible)
+        {
+            REQUIRE_FALSE(utils::is_meshlet_outside(meshlets, m, planes));
+        }
+
+        // Looking away culls everything.
+        view = glm::lookAt(
+            camera, glm::vec3{0.0f, 0.0f, 10.0f}, glm::vec3{0.0f, 1.0f, 0.0f});
+        planes = utils::frustum_planes(
+            glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f) * view);
+        REQUIRE(utils::cull_meshlets(meshlets, camera, planes).empty());
+    }
+}
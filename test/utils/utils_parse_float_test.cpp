@@ -0,0 +1,111 @@
+#include <atlas/utils/parse_float.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace atlas;
+
+namespace
+{
+    // Parses the whole of text and returns how many characters were used.
+    std::size_t parse(std::string const& text, float& value)
+    {
+        auto first = text.data();
+        return static_cast<std::size_t>(
+            utils::detail::parse_float(first, first + text.size(), value) - first);
+    }
+
+    bool same_bits(float a, float b)
+    {
+        return std::memcmp(&a, &b, sizeof(float)) == 0;
+    }
+} // namespace
+
+TEST_CASE("[parse_float] - parse_float", "[utils]")
+{
+    SECTION("Decimals")
+    {
+        std::vector<std::string> texts{"0",
+                                       "-0",
+                                       "1",
+                                       "0.5",
+                                       ".5",
+                                       "5.",
+                                       "-1.25",
+                                       "0.000001",
+                                       "3.1415927",
+                                       "16777216",
+                                       "16777217",
+                                       "0.1",
+                                       "123456789012345678901234567890",
+                                       "0.30000000000000000000000000000001",
+                                       "1e10",
+                                       "1E-10",
+                                       "-2.5e+3",
+                                       "1.17549435e-38",
+                                       "3.40282347e+38"};
+        for (auto const& text : texts)
+        {
+            INFO(text);
+            float value{};
+            REQUIRE(parse(text, value) == text.size());
+            REQUIRE(same_bits(value, std::strtof(text.c_str(), nullptr)));
+        }
+    }
+
+    SECTION("Rounding")
+    {
+        // Both paths must round the same way strtof does.
+        std::uint32_t state{1};
+        bool same{true};
+        for (int i{0}; i < 20000; ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            auto mantissa = state >> (state % 24);
+            auto exponent = static_cast<int>(state % 41) - 20;
+            auto text     = fmt::format("{}e{}", mantissa, exponent);
+
+            float value{};
+            same = same && parse(text, value) == text.size() &&
+                   same_bits(value, std::strtof(text.c_str(), nullptr));
+        }
+        REQUIRE(same);
+    }
+
+    SECTION("End of the number")
+    {
+        float value{};
+        REQUIRE(parse("1.5 2", value) == 3);
+        REQUIRE(value == 1.5f);
+        REQUIRE(parse("2e", value) == 1);
+        REQUIRE(value == 2.0f);
+        REQUIRE(parse("3e+x", value) == 1);
+        REQUIRE(parse("4/5", value) == 1);
+        REQUIRE(parse("-inf", value) == 4);
+        REQUIRE(std::isinf(value));
+        REQUIRE(parse("nan ", value) == 3);
+        REQUIRE(std::isnan(value));
+    }
+
+    SECTION("No number")
+    {
+        for (std::string text : {"", "-", ".", "+1", " 1", "e5", "x"})
+        {
+            INFO(text);
+            float value{7.0f};
+            REQUIRE(parse(text, value) == 0);
+            REQUIRE(value == 7.0f);
+        }
+
+        float value{7.0f};
+        REQUIRE(parse("1e50", value) == 0);
+        REQUIRE(value == 7.0f);
+    }
+}
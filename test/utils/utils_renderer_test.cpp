@@ -0,0 +1,116 @@
+#include "test_helpers.hpp"
+#include "test_shapes.hpp"
+
+#include <atlas/utils/renderer.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+
+using namespace atlas;
+
+namespace
+{
+    float luminance(glm::vec3 const& c)
+    {
+        return (c.r + c.g + c.b) / 3.0f;
+    }
+} // namespace
+
+TEST_CASE("[Renderer] - render", "[utils]")
+{
+    jobs::JobSystem system{4};
+    auto mesh = test::make_sphere_on_floor(32);
+    utils::MeshScene scene{mesh, system};
+    test::LookAtCamera camera{glm::vec3{0.0f, 0.0f, 5.0f}, glm::vec3{0.0f}};
+
+    utils::RenderSettings settings;
+    settings.width      = 64;
+    settings.height     = 48;
+    settings.tile_size  = 8;
+    settings.background = glm::vec3{0.0f, 0.0f, 1.0f};
+
+    SECTION("Sphere, floor, and background")
+    {
+        utils::Renderer renderer{system, settings};
+        renderer.render(scene, camera, 4);
+        REQUIRE(renderer.sample_count() == 4);
+
+        auto image = renderer.image();
+        REQUIRE(image.size() == 64 * 48);
+
+        // The top of the image sees the sky, the centre the sphere facing the
+        // camera, and the bottom the open floor in front of it.
+        auto sky    = image[0];
+        auto centre = image[24 * 64 + 32];
+        auto floor  = image[47 * 64 + 32];
+        REQUIRE(sky == glm::vec3{0.0f, 0.0f, 1.0f});
+        REQUIRE(centre.r == centre.b);
+        REQUIRE(luminance(centre) > 0.4f);
+        REQUIRE(floor.r == floor.b);
+        REQUIRE(luminance(floor) > luminance(centre));
+    }
+
+    SECTION("Progressive accumulation")
+    {
+        utils::Renderer renderer{system, settings};
+        renderer.render(scene, camera);
+        renderer.render(scene, camera);
+        REQUIRE(renderer.sample_count() == 2);
+
+        // Moving the camera restarts accumulation.
+        test::LookAtCamera moved{glm::vec3{0.0f, 1.0f, 5.0f}, glm::vec3{0.0f}};
+        renderer.render(scene, moved);
+        REQUIRE(renderer.sample_count() == 1);
+
+        renderer.reset();
+        REQUIRE(renderer.sample_count() == 0);
+        REQUIRE(renderer.image()[0] == glm::vec3{0.0f});
+    }
+
+    SECTION("Result does not depend on the thread count")
+    {
+        jobs::JobSystem single{1};
+        utils::Renderer serial{single, settings};
+        serial.render(scene, camera, 2);
+
+        utils::Renderer parallel{system, settings};
+        parallel.render(scene, camera);
+        parallel.render(scene, camera);
+
+        REQUIRE(serial.image() == parallel.image());
+    }
+
+    SECTION("Custom shading")
+    {
+        utils::Renderer renderer{system, settings};
+        renderer.set_shade_function([](utils::Scene const&,
+                                       math::Ray<glm::vec3> const&,
+                                       utils::SurfaceHit const& hit,
+                                       glm::vec2 const&) {
+            return hit.normal * 0.5f + 0.5f;
+        });
+        renderer.render(scene, camera);
+
+        auto centre = renderer.image()[24 * 64 + 32];
+        REQUIRE(centre.z > 0.9f);
+    }
+
+    SECTION("Saving")
+    {
+        utils::Renderer renderer{system, settings};
+        renderer.render(scene, camera);
+
+        auto dir = std::filesystem::temp_directory_path();
+        for (auto name :
+             {"atlas_render.png", "atlas_render.hdr", "atlas_render.Hdr"})
+        {
+            auto path = (dir / name).string();
+            REQUIRE(renderer.save_image(path));
+            REQUIRE(std::filesystem::file_size(path) > 0);
+            std::filesystem::remove(path);
+        }
+
+        REQUIRE_FALSE(renderer.save_image((dir / "atlas_render.xyz").string()));
+    }
+}
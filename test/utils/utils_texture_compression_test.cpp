@@ -0,0 +1,317 @@
+#include "test_helpers.hpp"
+
+#include <atlas/utils/texture_compression.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/printf.h>
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace atlas;
+
+namespace
+{
+    using Block = std::array<unsigned char, 64>;
+
+    Block decode(utils::BlockFormat format, Block const& rgba)
+    {
+        std::array<unsigned char, 16> block;
+        switch (format)
+        {
+        case utils::BlockFormat::bc1:
+            utils::encode_bc1_block(rgba.data(), block.data());
+            break;
+        case utils::BlockFormat::bc3:
+            utils::encode_bc3_block(rgba.data(), block.data());
+            break;
+        case utils::BlockFormat::bc4:
+            utils::encode_bc4_block(rgba.data(), block.data());
+            break;
+        case utils::BlockFormat::bc5:
+            utils::encode_bc5_block(rgba.data(), block.data());
+            break;
+        }
+
+        Block result;
+        utils::decode_block(format, block.data(), result.data());
+        return result;
+    }
+
+    int max_error(Block const& a, Block const& b, std::size_t channel)
+    {
+        int error{0};
+        for (std::size_t i{0}; i < 16; ++i)
+        {
+            error = std::max(error, std::abs(a[4 * i + channel] - b[4 * i + channel]));
+        }
+        return error;
+    }
+
+    // Root mean square error over the channels present in the format.
+    double rmse(std::vector<unsigned char> const& rgba,
+                utils::TextureLevel const& level,
+                int channels,
+                int compared)
+    {
+        double total{0.0};
+        auto count = static_cast<std::size_t>(level.width) * level.height;
+        for (std::size_t i{0}; i < count; ++i)
+        {
+            for (int c{0}; c < compared; ++c)
+            {
+                double d = rgba[4 * i + c] - level.pixels[i * channels + c];
+                total += d * d;
+            }
+        }
+        return std::sqrt(total / static_cast<double>(count * compared));
+    }
+} // namespace
+
+TEST_CASE("[texture_compression] - blocks", "[utils]")
+{
+    SECTION("Block sizes")
+    {
+        REQUIRE(utils::block_bytes(utils::BlockFormat::bc1) == 8);
+        REQUIRE(utils::block_bytes(utils::BlockFormat::bc3) == 16);
+        REQUIRE(utils::block_bytes(utils::BlockFormat::bc4) == 8);
+        REQUIRE(utils::block_bytes(utils::BlockFormat::bc5) == 16);
+    }
+
+    SECTION("Solid colour")
+    {
+        Block rgba;
+        for (std::size_t i{0}; i < 16; ++i)
+        {
+            std::array<unsigned char, 4> pixel{201, 87, 13, 255};
+            std::copy(pixel.begin(), pixel.end(), rgba.begin() + 4 * i);
+        }
+
+        auto result = decode(utils::BlockFormat::bc1, rgba);
+        REQUIRE(max_error(rgba, result, 0) <= 4);
+        REQUIRE(max_error(rgba, result, 1) <= 2);
+        REQUIRE(max_error(rgba, result, 2) <= 4);
+        REQUIRE(max_error(rgba, result, 3) == 0);
+    }
+
+    SECTION("Two exact colours")
+    {
+        // Both colours survive 5:6:5 quantisation unchanged.
+        Block rgba;
+        for (std::size_t i{0}; i < 16; ++i)
+        {
+            std::array<unsigned char, 4> pixel{255, 0, 0, 255};
+            if (i % 3 == 0)
+            {
+                pixel = {0, 0, 255, 255};
+            }
+            std::copy(pixel.begin(), pixel.end(), rgba.begin() + 4 * i);
+        }
+
+        REQUIRE(decode(utils::BlockFormat::bc1, rgba) == rgba);
+    }
+
+    SECTION("Single channel ramps")
+    {
+        // Eight evenly spaced values are exactly the palette of a BC4 block.
+        Block rgba{};
+        for (std::size_t i{0}; i < 16; ++i)
+        {
+            rgba[4 * i + 0] = static_cast<unsigned char>(32 * (i % 8));
+            rgba[4 * i + 1] = static_cast<unsigned char>(100 + 4 * i);
+            rgba[4 * i + 3] = static_cast<unsigned char>(255 - 32 * (i % 8));
+        }
+
+        auto bc4 = decode(utils::BlockFormat::bc4, rgba);
+        REQUIRE(max_error(rgba, bc4, 0) == 0);
+        REQUIRE(max_error(Block{}, bc4, 1) == 0);
+
+        // The second channel spans 60 values over 8 steps.
+        auto bc5 = decode(utils::BlockFormat::bc5, rgba);
+        REQUIRE(max_error(rgba, bc5, 0) == 0);
+        REQUIRE(max_error(rgba, bc5, 1) <= 5);
+
+        auto bc3 = decode(utils::BlockFormat::bc3, rgba);
+        REQUIRE(max_error(rgba, bc3, 3) == 0);
+    }
+}
+
+TEST_CASE("[texture_compression] - compress_level", "[utils]")
+{
+    jobs::JobSystem system{4};
+
+    SECTION("Image error")
+    {
+        auto level = test::make_texture_level(64, 48, 4);
+
+        auto bc1 = utils::compress_level(level, 4, utils::BlockFormat::bc1, system);
+        auto bc3 = utils::compress_level(level, 4, utils::BlockFormat::bc3, system);
+        auto bc4 = utils::compress_level(level, 4, utils::BlockFormat::bc4, system);
+        auto bc5 = utils::compress_level(level, 4, utils::BlockFormat::bc5, system);
+        REQUIRE(bc1.blocks.size() == 16 * 12 * 8);
+        REQUIRE(bc3.blocks.size() == 16 * 12 * 16);
+
+        auto bc1_pixels = utils::decompress_level(bc1, utils::BlockFormat::bc1);
+        auto bc3_pixels = utils::decompress_level(bc3, utils::BlockFormat::bc3);
+        REQUIRE(rmse(bc1_pixels, level, 4, 3) < 4.0);
+        REQUIRE(rmse(bc3_pixels, level, 4, 4) < 4.0);
+        REQUIRE(rmse(utils::decompress_level(bc4, utils::BlockFormat::bc4), level, 4, 1) <
+                2.0);
+        REQUIRE(rmse(utils::decompress_level(bc5, utils::BlockFormat::bc5), level, 4, 2) <
+                2.0);
+    }
+
+    SECTION("Partial blocks and channels")
+    {
+        for (int channels : {1, 2, 3})
+        {
+            auto level = test::make_texture_level(5, 3, channels);
+            auto bc5 =
+                utils::compress_level(level, channels, utils::BlockFormat::bc5, system);
+            REQUIRE(bc5.width == 5);
+            REQUIRE(bc5.height == 3);
+            REQUIRE(bc5.blocks.size() == 2 * 16);
+
+            // The gradient is steep at this size, so the ramp steps are wide.
+            auto pixels = utils::decompress_level(bc5, utils::BlockFormat::bc5);
+            REQUIRE(pixels.size() == 5 * 3 * 4);
+            REQUIRE(rmse(pixels, level, channels, 1) < 8.0);
+        }
+    }
+
+    SECTION("Independent of the thread count")
+    {
+        jobs::JobSystem single{1};
+        auto level = test::make_texture_level(128, 64, 4);
+        for (auto format : {utils::BlockFormat::bc1,
+                            utils::BlockFormat::bc3,
+                            utils::BlockFormat::bc4,
+                            utils::BlockFormat::bc5})
+        {
+            REQUIRE(utils::compress_level(level, 4, format, system).blocks ==
+                    utils::compress_level(level, 4, format, single).blocks);
+        }
+    }
+
+    SECTION("Memory")
+    {
+        utils::TextureData texture;
+        texture.channels = 4;
+        texture.levels   = utils::generate_mips(
+            test::make_texture_level(256, 256, 4), 4, true, system);
+
+        std::size_t uncompressed{0};
+        for (auto const& level : texture.levels)
+        {
+            uncompressed += level.pixels.size();
+        }
+
+        auto bc1 = utils::compress_texture(texture, utils::BlockFormat::bc1, system);
+        auto bc3 = utils::compress_texture(texture, utils::BlockFormat::bc3, system);
+        auto bc5 = utils::compress_texture(texture, utils::BlockFormat::bc5, system);
+        REQUIRE(bc1.levels.size() == texture.levels.size());
+        REQUIRE(bc1.is_srgb);
+        REQUIRE_FALSE(bc5.is_srgb);
+
+        // The smallest levels still take a whole block.
+        REQUIRE(static_cast<double>(uncompressed) / bc1.size() > 7.9);
+        REQUIRE(static_cast<double>(uncompressed) / bc3.size() > 3.9);
+    }
+}
+
+TEST_CASE("[texture_compression] - cache", "[utils]")
+{
+    jobs::JobSystem system{2};
+    auto directory = std::filesystem::temp_directory_path() / "atlas_texture_cache";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    SECTION("Save and load")
+    {
+        utils::TextureData texture;
+        texture.channels = 4;
+        texture.levels   = utils::generate_mips(
+            test::make_texture_level(20, 12, 4), 4, true, system);
+        auto compressed =
+            utils::compress_texture(texture, utils::BlockFormat::bc3, system);
+
+        auto path = (directory / "texture.atex").string();
+        REQUIRE(utils::save_compressed_texture(compressed, path, 42));
+
+        auto loaded = utils::load_compressed_texture(path, 42);
+        REQUIRE(loaded.has_value());
+        REQUIRE(loaded->format == utils::BlockFormat::bc3);
+        REQUIRE(loaded->is_srgb);
+        REQUIRE(loaded->levels.size() == compressed.levels.size());
+        for (std::size_t i{0}; i < compressed.levels.size(); ++i)
+        {
+            REQUIRE(loaded->levels[i].width == compressed.levels[i].width);
+            REQUIRE(loaded->levels[i].height == compressed.levels[i].height);
+            REQUIRE(loaded->levels[i].blocks == compressed.levels[i].blocks);
+        }
+
+        REQUIRE(utils::load_compressed_texture(path).has_value());
+        REQUIRE_FALSE(utils::load_compressed_texture(path, 43).has_value());
+
+        // Truncated files are rejected.
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+        REQUIRE_FALSE(utils::load_compressed_texture(path).has_value());
+    }
+
+    SECTION("load_texture_cached")
+    {
+        auto image  = (directory / "albedo.png").string();
+        auto level  = test::make_texture_level(32, 32, 4);
+        auto update = [&]() {
+            stbi_write_png(image.c_str(), 32, 32, 4, level.pixels.data(), 0);
+        };
+        auto count = [&]() {
+            return std::distance(std::filesystem::directory_iterator{directory},
+                                 std::filesystem::directory_iterator{});
+        };
+        update();
+
+        auto first = utils::load_texture_cached(image, utils::BlockFormat::bc1, system);
+        REQUIRE(first.has_value());
+        REQUIRE(first->levels.size() == 6);
+        REQUIRE(count() == 2);
+
+        auto second = utils::load_texture_cached(image, utils::BlockFormat::bc1, system);
+        REQUIRE(second.has_value());
+        REQUIRE(second->levels[0].blocks == first->levels[0].blocks);
+        REQUIRE(count() == 2);
+
+        // Other settings and changed contents get their own entries.
+        REQUIRE(utils::load_texture_cached(image, utils::BlockFormat::bc3, system)
+                    .has_value());
+        REQUIRE(count() == 3);
+
+        level.pixels[0] ^= 0xFF;
+        update();
+        REQUIRE(utils::load_texture_cached(image, utils::BlockFormat::bc1, system)
+                    .has_value());
+        REQUIRE(count() == 4);
+
+        REQUIRE_FALSE(utils::load_texture_cached((directory / "missing.png").string(),
+                                                 utils::BlockFormat::bc1,
+                                                 system)
+                          .has_value());
+
+        // Cache directories are created on demand.
+        auto cache_directory = directory / "cache" / "textures";
+        REQUIRE(utils::load_texture_cached(
+                    image, utils::BlockFormat::bc1, system, cache_directory.string())
+                    .has_value());
+        REQUIRE(std::distance(std::filesystem::directory_iterator{cache_directory},
+                              std::filesystem::directory_iterator{}) == 1);
+    }
+
+    std::filesystem::remove_all(directory);
+}
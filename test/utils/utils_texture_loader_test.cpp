@@ -0,0 +1,197 @@
+#include "test_helpers.hpp"
+
+#include <atlas/utils/texture_loader.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <stb_image_resize.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace atlas;
+
+TEST_CASE("[texture_loader] - mip_count", "[utils]")
+{
+    REQUIRE(utils::mip_count(1, 1) == 1);
+    REQUIRE(utils::mip_count(2, 1) == 2);
+    REQUIRE(utils::mip_count(256, 256) == 9);
+    REQUIRE(utils::mip_count(300, 17) == 9);
+}
+
+TEST_CASE("[texture_loader] - generate_mips", "[utils]")
+{
+    jobs::JobSystem system{4};
+
+    for (int channels : {1, 3, 4})
+    {
+        utils::TextureLevel base;
+        base.width  = 300;
+        base.height = 171;
+        base.pixels = test::make_pixels(base.width, base.height, channels);
+
+        auto levels = utils::generate_mips(base, channels, true, system, 7);
+        REQUIRE(levels.size() == utils::mip_count(base.width, base.height));
+        REQUIRE(levels[0].pixels == base.pixels);
+        REQUIRE(levels.back().width == 1);
+        REQUIRE(levels.back().height == 1);
+
+        // Splitting the rows across jobs gives the same result as resizing
+        // each level in one call.
+        for (std::size_t i{1}; i < levels.size(); ++i)
+        {
+            auto const& previous = levels[i - 1];
+            auto const& level    = levels[i];
+            REQUIRE(level.width == std::max(1, previous.width / 2));
+            REQUIRE(level.height == std::max(1, previous.height / 2));
+
+            std::vector<unsigned char> expected(level.pixels.size());
+            stbir_resize_uint8_srgb(previous.pixels.data(),
+                                    previous.width,
+                                    previous.height,
+                                    0,
+                                    expected.data(),
+                                    level.width,
+                                    level.height,
+                                    0,
+                                    channels,
+                                    (channels == 4) ? 3 : STBIR_ALPHA_CHANNEL_NONE,
+                                    0);
+            REQUIRE(level.pixels == expected);
+        }
+    }
+}
+
+TEST_CASE("[texture_loader] - load_texture", "[utils]")
+{
+    jobs::JobSystem system{2};
+
+    SECTION("Missing file")
+    {
+        REQUIRE_FALSE(
+            utils::load_texture("atlas_missing_texture.png", system).has_value());
+    }
+
+    SECTION("Channels and orientation")
+    {
+        auto path = test::write_png("atlas_texture.png", 8, 4, 3);
+        auto file = test::make_pixels(8, 4, 3);
+
+        utils::TextureSettings settings;
+        settings.generate_mips = false;
+        auto flipped           = utils::load_texture(path, system, settings);
+
+        settings.channels        = 0;
+        settings.flip_vertically = false;
+        auto original            = utils::load_texture(path, system, settings);
+        std::filesystem::remove(path);
+
+        REQUIRE(original.has_value());
+        REQUIRE(original->channels == 3);
+        REQUIRE(original->levels.size() == 1);
+        REQUIRE(original->levels[0].pixels == file);
+
+        // Converted to RGBA, with the last row of the file first.
+        REQUIRE(flipped.has_value());
+        REQUIRE(flipped->channels == 4);
+        auto const& level = flipped->levels[0];
+        REQUIRE(level.width == 8);
+        REQUIRE(level.height == 4);
+        for (int x{0}; x < 8; ++x)
+        {
+            auto pixel = level.pixels.data() + 4 * x;
+            REQUIRE(pixel[0] == file[(3 * 8 + x) * 3]);
+            REQUIRE(pixel[2] == 3);
+            REQUIRE(pixel[3] == 255);
+        }
+    }
+
+    SECTION("Mips")
+    {
+        auto path    = test::write_png("atlas_texture.png", 64, 16, 4);
+        auto texture = utils::load_texture(path, system);
+        std::filesystem::remove(path);
+
+        REQUIRE(texture.has_value());
+        REQUIRE(texture->levels.size() == 7);
+        REQUIRE(texture->levels[6].width == 1);
+        REQUIRE(texture->levels[6].pixels.size() == 4);
+    }
+}
+
+TEST_CASE("[texture_loader] - TextureLoader", "[utils]")
+{
+    auto directory = std::filesystem::temp_directory_path() / "atlas_textures";
+    std::filesystem::create_directories(directory);
+    auto path    = (directory / "albedo.png").string();
+    auto normals = (directory / "normals.png").string();
+    test::write_png("atlas_textures/albedo.png", 32, 32, 4);
+    test::write_png("atlas_textures/normals.png", 32, 32, 3);
+
+    // The loaders are polled, so decoding needs a worker besides this thread.
+    jobs::JobSystem system{3};
+
+    SECTION("Deduplicates requests")
+    {
+        utils::TextureLoader loader{system};
+        auto handle = loader.request(path);
+        auto same   = loader.request((directory / ".." / "atlas_textures" / "albedo.png")
+                                       .string());
+        auto linear = loader.request(path, false);
+        REQUIRE(handle == same);
+        REQUIRE(handle != linear);
+
+        test::wait_for(loader);
+        auto ready = loader.take_ready();
+        REQUIRE(ready.size() == 2);
+        REQUIRE(loader.take_ready().empty());
+
+        REQUIRE(loader.status(handle) == utils::TextureStatus::ready);
+        auto data = loader.data(handle);
+        REQUIRE(data != nullptr);
+        REQUIRE(data->is_srgb);
+        REQUIRE(data->levels.size() == 6);
+        REQUIRE_FALSE(loader.data(linear)->is_srgb);
+
+        loader.release(handle);
+        REQUIRE(loader.data(handle) == nullptr);
+        REQUIRE(loader.status(handle) == utils::TextureStatus::ready);
+        REQUIRE(data->levels.size() == 6);
+    }
+
+    SECTION("Missing files fail")
+    {
+        utils::TextureLoader loader{system};
+        auto handle = loader.request(test::temp_path("atlas_missing_texture.png"));
+        test::wait_for(loader);
+        REQUIRE(loader.take_ready() == std::vector<utils::TextureHandle>{handle});
+        REQUIRE(loader.status(handle) == utils::TextureStatus::failed);
+        REQUIRE(loader.data(handle) == nullptr);
+    }
+
+    SECTION("Materials")
+    {
+        std::vector<tinyobj::material_t> materials(3);
+        materials[0].diffuse_texname = "albedo.png";
+        materials[0].bump_texname    = "normals.png";
+        materials[1].diffuse_texname = "albedo.png";
+        materials[1].normal_texname  = "normals.png";
+
+        utils::TextureLoader loader{system};
+        auto textures = loader.request_materials(materials, directory.string());
+        REQUIRE(textures.size() == 3);
+        REQUIRE(textures[0].diffuse == textures[1].diffuse);
+        REQUIRE(textures[0].normal == textures[1].normal);
+        REQUIRE(textures[0].diffuse.has_value());
+        REQUIRE(textures[0].normal.has_value());
+        REQUIRE_FALSE(textures[0].specular.has_value());
+        REQUIRE_FALSE(textures[2].diffuse.has_value());
+
+        test::wait_for(loader);
+        REQUIRE(loader.take_ready().size() == 2);
+        REQUIRE(loader.data(*textures[0].diffuse)->is_srgb);
+        REQUIRE_FALSE(loader.data(*textures[0].normal)->is_srgb);
+    }
+
+    std::filesystem::remove_all(directory);
+}
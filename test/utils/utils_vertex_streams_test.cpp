@@ -0,0 +1,206 @@
+#include <atlas/utils/vertex_streams.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <cstring>
+
+using namespace atlas;
+
+namespace
+{
+    utils::Shape make_shape(std::size_t vertex_count)
+    {
+        utils::Shape shape;
+        for (std::size_t i{0}; i < vertex_count; ++i)
+        {
+            auto t = static_cast<float>(i);
+
+            utils::Vertex vertex;
+            vertex.position  = glm::vec3{t, t * 0.5f, -t};
+            vertex.normal    = glm::normalize(glm::vec3{glm::sin(t), glm::cos(t), 0.5f});
+            vertex.tex_coord = glm::vec2{t / vertex_count, 1.0f - t / vertex_count};
+            shape.vertices.push_back(vertex);
+        }
+
+        for (std::size_t i{0}; i + 2 < vertex_count; ++i)
+        {
+            shape.indices.insert(shape.indices.end(), {i, i + 1, i + 2});
+        }
+        return shape;
+    }
+
+    template<typename T>
+    T read(utils::PackedShape const& packed,
+           utils::AttributeFormat const& attribute,
+           std::size_t vertex)
+    {
+        auto stride = packed.format.strides[attribute.stream];
+        T value;
+        std::memcpy(&value,
+                    packed.streams[attribute.stream].data() + vertex * stride +
+                        attribute.offset,
+                    sizeof(T));
+        return value;
+    }
+
+    void check_shape(utils::PackedShape const& packed, utils::Shape const& shape)
+    {
+        REQUIRE(packed.vertex_count == shape.vertices.size());
+        for (auto const& attribute : packed.format.attributes)
+        {
+            for (std::size_t v{0}; v < shape.vertices.size(); ++v)
+            {
+                auto const& vertex = shape.vertices[v];
+                switch (attribute.attribute)
+                {
+                case utils::VertexAttribute::position:
+                    REQUIRE(read<glm::vec3>(packed, attribute, v) == vertex.position);
+                    break;
+
+                case utils::VertexAttribute::normal:
+                {
+                    auto normal = utils::decode_octahedral(
+                        read<std::uint32_t>(packed, attribute, v));
+                    REQUIRE(glm::dot(normal, vertex.normal) > 0.9999f);
+                    break;
+                }
+
+                case utils::VertexAttribute::tex_coord:
+                {
+                    auto uv =
+                        glm::unpackHalf2x16(read<std::uint32_t>(packed, attribute, v));
+                    REQUIRE(glm::abs(uv.x - vertex.tex_coord.x) < 1e-3f);
+                    REQUIRE(glm::abs(uv.y - vertex.tex_coord.y) < 1e-3f);
+                    break;
+                }
+                }
+            }
+        }
+    }
+} // namespace
+
+TEST_CASE("[vertex_streams] - normal encodings", "[utils]")
+{
+    float octahedral{0.0f};
+    float snorm{0.0f};
+    for (int i{0}; i < 64; ++i)
+    {
+        for (int j{0}; j <= 32; ++j)
+        {
+            auto phi   = static_cast<float>(i) / 64.0f * glm::two_pi<float>();
+            auto theta = static_cast<float>(j) / 32.0f * glm::pi<float>();
+            glm::vec3 n{glm::sin(theta) * glm::cos(phi),
+                        glm::sin(theta) * glm::sin(phi),
+                        glm::cos(theta)};
+
+            auto a = utils::decode_octahedral(utils::encode_octahedral(n));
+            auto b = utils::decode_snorm_2_10_10_10(utils::encode_snorm_2_10_10_10(n));
+            octahedral = glm::max(octahedral, glm::length(a - n));
+            snorm      = glm::max(snorm, glm::length(b - n));
+        }
+    }
+
+    REQUIRE(octahedral < 1e-4f);
+    REQUIRE(snorm < 4e-3f);
+
+    // Degenerate normals must not turn into NaN.
+    auto zero = utils::encode_octahedral(glm::vec3{0.0f});
+    REQUIRE(zero == utils::encode_octahedral(glm::vec3{0.0f, 0.0f, 1.0f}));
+    REQUIRE(utils::decode_octahedral(zero) == glm::vec3{0.0f, 0.0f, 1.0f});
+}
+
+TEST_CASE("[vertex_streams] - pack_shape", "[utils]")
+{
+    auto shape = make_shape(16);
+
+    SECTION("Interleaved")
+    {
+        auto packed = utils::pack_shape(shape);
+
+        auto const& format = packed.format;
+        REQUIRE(format.strides == std::vector<std::uint32_t>{20});
+        REQUIRE(format.attributes.size() == 3);
+        REQUIRE(format.attributes[0].offset == 0);
+        REQUIRE(format.attributes[1].offset == 12);
+        REQUIRE(format.attributes[1].normalised);
+        REQUIRE(format.attributes[2].offset == 16);
+        REQUIRE(packed.streams[0].size() == 20 * 16);
+
+        check_shape(packed, shape);
+    }
+
+    SECTION("Split")
+    {
+        utils::VertexStreamSettings settings;
+        settings.layout = utils::StreamLayout::split;
+        auto packed     = utils::pack_shape(shape, settings);
+
+        auto const& format = packed.format;
+        REQUIRE(format.strides == std::vector<std::uint32_t>{12, 4, 4});
+        for (std::uint32_t i{0}; i < 3; ++i)
+        {
+            REQUIRE(format.attributes[i].stream == i);
+            REQUIRE(format.attributes[i].offset == 0);
+        }
+
+        check_shape(packed, shape);
+    }
+
+    SECTION("Full precision")
+    {
+        utils::VertexStreamSettings settings;
+        settings.normals    = utils::NormalEncoding::float32;
+        settings.tex_coords = utils::TexCoordEncoding::float32;
+        auto packed         = utils::pack_shape(shape, settings);
+
+        REQUIRE(packed.format.strides == std::vector<std::uint32_t>{32});
+        auto const& normal = packed.format.attributes[1];
+        REQUIRE_FALSE(normal.normalised);
+        REQUIRE(read<glm::vec3>(packed, normal, 3) == shape.vertices[3].normal);
+    }
+
+    SECTION("Missing attributes")
+    {
+        shape.has_normals        = false;
+        shape.has_texture_coords = false;
+        auto packed              = utils::pack_shape(shape);
+
+        REQUIRE(packed.format.attributes.size() == 1);
+        REQUIRE(packed.format.strides == std::vector<std::uint32_t>{12});
+        check_shape(packed, shape);
+    }
+}
+
+TEST_CASE("[vertex_streams] - index types", "[utils]")
+{
+    SECTION("16-bit")
+    {
+        auto shape  = make_shape(100);
+        auto packed = utils::pack_shape(shape);
+        REQUIRE(packed.index_type == utils::IndexType::uint16);
+        REQUIRE(packed.index_count == shape.indices.size());
+        REQUIRE(packed.indices.size() == shape.indices.size() * 2);
+
+        std::uint16_t last;
+        std::memcpy(&last, packed.indices.data() + packed.indices.size() - 2, 2);
+        REQUIRE(last == shape.indices.back());
+    }
+
+    SECTION("32-bit")
+    {
+        auto shape  = make_shape(70000);
+        auto packed = utils::pack_shape(shape);
+        REQUIRE(packed.index_type == utils::IndexType::uint32);
+        REQUIRE(packed.indices.size() == shape.indices.size() * 4);
+
+        std::uint32_t last;
+        std::memcpy(&last, packed.indices.data() + packed.indices.size() - 4, 4);
+        REQUIRE(last == shape.indices.back());
+
+        utils::VertexStreamSettings settings;
+        settings.allow_16bit_indices = false;
+        REQUIRE(utils::pack_shape(make_shape(16), settings).index_type ==
+                utils::IndexType::uint32);
+    }
+}